@@ -16,6 +16,7 @@
 #include "dawn/AST/Offsets.h"
 #include "dawn/CodeGen/CXXNaive-ico/ASTStencilFunctionParamVisitor.h"
 #include "dawn/CodeGen/CXXUtil.h"
+#include "dawn/CodeGen/Cuda-ico/LocToStringUtils.h"
 #include "dawn/IIR/AST.h"
 #include "dawn/IIR/ASTExpr.h"
 #include "dawn/IIR/StencilFunctionInstantiation.h"
@@ -52,6 +53,19 @@ static std::string nbhChainToVectorString(const std::vector<dawn::ast::LocationT
   return ss.str();
 }
 
+// neighborhoods along chains passing a vertex may be incomplete (pentagons)
+static bool hasIrregularPentagons(const std::vector<dawn::ast::LocationType>& chain) {
+  return std::count(chain.begin(), chain.end() - 1, dawn::ast::LocationType::Vertices) != 0;
+}
+
+// weights given by (possibly negated) literals can be evaluated at compile time
+static bool isLiteralWeight(const std::shared_ptr<dawn::ast::Expr>& weight) {
+  if(auto unaryOp = std::dynamic_pointer_cast<dawn::ast::UnaryOperator>(weight))
+    return (unaryOp->getOp() == "-" || unaryOp->getOp() == "+") &&
+           isLiteralWeight(unaryOp->getOperand());
+  return std::dynamic_pointer_cast<dawn::ast::LiteralAccessExpr>(weight) != nullptr;
+}
+
 namespace dawn {
 namespace codegen {
 namespace cxxnaiveico {
@@ -103,7 +117,7 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::BlockStmt>& stmt) {
   }
   indent_ -= DAWN_PRINT_INDENT;
 
-  if(parentIsForLoop_) {
+  if(parentIsForLoop_ && !flatNeighborTables_) {
     ss_ << ASTStencilBody::LoopLinearIndexVarName() << "++;";
   }
 
@@ -111,11 +125,34 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::BlockStmt>& stmt) {
   scopeDepth_--;
 }
 
+void ASTStencilBody::visit(const std::shared_ptr<ast::ExprStmt>& stmt) {
+  generateMergedReductionLoops(stmt);
+  Base::visit(stmt);
+}
+
+void ASTStencilBody::visit(const std::shared_ptr<ast::VarDeclStmt>& stmt) {
+  generateMergedReductionLoops(stmt);
+  Base::visit(stmt);
+}
+
 void ASTStencilBody::visit(const std::shared_ptr<ast::LoopStmt>& stmt) {
   const auto maybeChainPtr =
       dynamic_cast<const ast::ChainIterationDescr*>(stmt->getIterationDescrPtr());
   DAWN_ASSERT_MSG(maybeChainPtr, "general loop concept not implemented yet!\n");
 
+  if(flatNeighborTables_) {
+    generateFlatNeighborLoopHead(maybeChainPtr->getIterSpace(), ASTStencilBody::StageIndexVarName(),
+                                 ASTStencilBody::LoopLinearIndexVarName(),
+                                 ASTStencilBody::LoopNeighborIndexVarName());
+    parentIsForLoop_ = true;
+    currentChain_ = maybeChainPtr->getChain();
+    stmt->getBlockStmt()->accept(*this);
+    currentChain_.clear();
+    parentIsForLoop_ = false;
+    ss_ << "}\n";
+    return;
+  }
+
   ss_ << "{";
   ss_ << "int " << ASTStencilBody::LoopLinearIndexVarName() << " = 0;";
   ss_ << "for (auto " << ASTStencilBody::LoopNeighborIndexVarName()
@@ -352,44 +389,30 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::FieldAccessExpr>& expr) {
   }
 }
 
-void ASTStencilBody::visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) {
-  bool hasWeights = expr->getWeights().has_value();
-
-  std::string sigArg;
-  if(parentIsReduction_) { // does stage or parent reduceOverNeighborExpr determine argname?
-    sigArg = ASTStencilBody::ReductionIndexVarName(reductionDepth_);
+std::string ASTStencilBody::reductionAnchorName() const {
+  // does stage or parent reduceOverNeighborExpr determine argname?
+  if(parentIsReduction_) {
+    return ASTStencilBody::ReductionIndexVarName(reductionDepth_);
   } else {
     if(parentIsForLoop_) {
-      sigArg = ASTStencilBody::LoopNeighborIndexVarName();
+      return ASTStencilBody::LoopNeighborIndexVarName();
     } else {
-      sigArg = ASTStencilBody::StageIndexVarName();
+      return ASTStencilBody::StageIndexVarName();
     }
   }
+}
 
-  ss_ << std::string(indent_, ' ') << "reduce(LibTag{}, m_mesh," << sigArg << ", ";
-  expr->getInit()->accept(*this);
-
-  ss_ << ", " << nbhChainToVectorString(expr->getNbhChain());
-  if(hasWeights) {
-    ss_ << ", [&, " + ASTStencilBody::ReductionSparseIndexVarName(reductionDepth_) +
-               " = int(0)](auto& "
-               "lhs, auto "
-        << ASTStencilBody::ReductionIndexVarName(reductionDepth_ + 1)
-        << ", auto const& weight) mutable {\n";
-  } else {
-    ss_ << ", [&, " + ASTStencilBody::ReductionSparseIndexVarName(reductionDepth_) +
-               " = int(0)](auto& lhs, auto "
-        << ASTStencilBody::ReductionIndexVarName(reductionDepth_ + 1) << ") mutable { ";
-  }
-
+void ASTStencilBody::generateReductionUpdate(
+    const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr, const std::string& lhs,
+    const std::string& weight) {
   if(!expr->isArithmetic()) {
-    ss_ << "lhs = " << expr->getOp() << "(lhs, ";
+    ss_ << lhs << " = " << expr->getOp() << "(" << lhs << ", ";
   } else {
-    ss_ << "lhs " << expr->getOp() << "= ";
+    ss_ << lhs << " " << expr->getOp() << "= ";
   }
 
-  if(hasWeights) {
-    ss_ << "weight * ";
+  if(expr->getWeights().has_value()) {
+    ss_ << weight << " * ";
   }
 
   auto argName = denseArgName_;
@@ -418,28 +441,173 @@ void ASTStencilBody::visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>
     ss_ << ")";
   }
   ss_ << ";\n";
-  ss_ << ASTStencilBody::ReductionSparseIndexVarName(reductionDepth_) << "++;\n";
-  ss_ << "return lhs;\n";
-  ss_ << "}";
-  if(hasWeights) {
-    auto weights = expr->getWeights().value();
-    bool first = true;
+}
+
+void ASTStencilBody::generateReductionWeights(
+    const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) {
+  if(!expr->getWeights().has_value())
+    return;
 
-    ss_ << ", std::vector<::dawn::float_type>({";
-    for(auto const& weight : weights) {
-      if(!first) {
-        ss_ << ", ";
+  const auto& weights = *expr->getWeights();
+  ss_ << (std::all_of(weights.begin(), weights.end(), isLiteralWeight)
+              ? "static constexpr ::dawn::float_type "
+              : "const ::dawn::float_type ")
+      << ASTStencilBody::ReductionWeightsVarName(expr->getID()) << "[] = {";
+  bool first = true;
+  for(auto const& weight : weights) {
+    if(!first) {
+      ss_ << ", ";
+    }
+    weight->accept(*this);
+    first = false;
+  }
+  ss_ << "};\n";
+}
+
+void ASTStencilBody::generateFlatNeighborLoopHead(const ast::UnstructuredIterationSpace& space,
+                                                  const std::string& anchor,
+                                                  const std::string& iterVar,
+                                                  const std::string& nbhVar) {
+  ss_ << "for(int " << iterVar << " = 0; " << iterVar << " < "
+      << cudaico::chainToSparseSizeString(space) << "; ++" << iterVar << ") {\n";
+  ss_ << "int " << nbhVar << " = " << cudaico::chainToTableString(space) << "[" << anchor
+      << " + m_mesh." << cudaico::locToStrideString(space.Chain.front()) << " * " << iterVar
+      << "];\n";
+  if(hasIrregularPentagons(space.Chain) || atlasCompatible_) {
+    ss_ << "if(" << nbhVar << " == DEVICE_MISSING_VALUE) { continue; }\n";
+  }
+}
+
+void ASTStencilBody::generateMergedReductionLoops(const std::shared_ptr<ast::Stmt>& stmt) {
+  if(mergedReductionLoops_.empty() || reductionDepth_ != 0)
+    return;
+
+  FindReduceOverNeighborExpr reductionFinder;
+  stmt->accept(reductionFinder);
+  if(!reductionFinder.hasReduceOverNeighborExpr())
+    return;
+
+  for(const auto& reduction : reductionFinder.reduceOverNeighborExprs()) {
+    auto groupIt = mergedReductionLoops_.find(reduction->getID());
+    if(groupIt == mergedReductionLoops_.end())
+      continue;
+    const ReductionMergeGroup& group = groupIt->second;
+
+    // accumulators (and weights) of all reductions of the group
+    for(const auto& expr : group) {
+      ss_ << "auto " << ASTStencilBody::ReductionAccumulatorVarName(expr->getID()) << " = ";
+      expr->getInit()->accept(*this);
+      ss_ << ";\n";
+      generateReductionWeights(expr);
+    }
+
+    // single neighbor loop updating all accumulators
+    const std::string sparseIdx = ASTStencilBody::ReductionSparseIndexVarName(reductionDepth_);
+    if(flatNeighborTables_) {
+      generateFlatNeighborLoopHead(group.front()->getIterSpace(), reductionAnchorName(), sparseIdx,
+                                   ASTStencilBody::ReductionIndexVarName(reductionDepth_ + 1));
+      for(const auto& expr : group) {
+        generateReductionUpdate(expr, ASTStencilBody::ReductionAccumulatorVarName(expr->getID()),
+                                ASTStencilBody::ReductionWeightsVarName(expr->getID()) + "[" +
+                                    sparseIdx + "]");
       }
-      weight->accept(*this);
-      first = false;
+      ss_ << "}\n";
+      continue;
     }
+    ss_ << "{\n";
+    ss_ << "int " << sparseIdx << " = 0;\n";
+    const auto& first = group.front();
+    ss_ << "for(auto " << ASTStencilBody::ReductionIndexVarName(reductionDepth_ + 1)
+        << " : getNeighbors(LibTag{}, m_mesh, " << nbhChainToVectorString(first->getNbhChain())
+        << ", " << reductionAnchorName()
+        << (first->getIncludeCenter() ? ", /*include center*/ true" : "") << ")) {\n";
+    for(const auto& expr : group) {
+      generateReductionUpdate(expr, ASTStencilBody::ReductionAccumulatorVarName(expr->getID()),
+                              ASTStencilBody::ReductionWeightsVarName(expr->getID()) + "[" +
+                                  sparseIdx + "]");
+    }
+    ss_ << sparseIdx << "++;\n";
+    ss_ << "}\n";
+    ss_ << "}\n";
+  }
+}
+
+void ASTStencilBody::visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) {
+  if(mergedReductions_.count(expr->getID())) {
+    // already computed by a merged neighbor loop
+    ss_ << ASTStencilBody::ReductionAccumulatorVarName(expr->getID());
+    return;
+  }
 
-    ss_ << "})";
+  std::string sigArg = reductionAnchorName();
+
+  if(flatNeighborTables_) {
+    // immediately invoked lambda looping over the neighbor table
+    const std::string sparseIdx = ASTStencilBody::ReductionSparseIndexVarName(reductionDepth_);
+    const std::string weights = ASTStencilBody::ReductionWeightsVarName(expr->getID());
+    ss_ << "[&]() {\n";
+    ss_ << "auto lhs = ";
+    expr->getInit()->accept(*this);
+    ss_ << ";\n";
+    generateReductionWeights(expr);
+    generateFlatNeighborLoopHead(expr->getIterSpace(), sigArg, sparseIdx,
+                                 ASTStencilBody::ReductionIndexVarName(reductionDepth_ + 1));
+    generateReductionUpdate(expr, "lhs", weights + "[" + sparseIdx + "]");
+    ss_ << "}\n";
+    ss_ << "return lhs;\n";
+    ss_ << "}()";
+    return;
   }
+
+  // the weights are declared in front of the reduction (in an immediately invoked lambda) and
+  // indexed by the position of the neighbor instead of being passed to the library as a vector,
+  // which saves an allocation per reduction and lets the compiler fold literal weights
+  const bool hasWeights = expr->getWeights().has_value();
+  const std::string sparseIdx = ASTStencilBody::ReductionSparseIndexVarName(reductionDepth_);
+  if(hasWeights) {
+    ss_ << "[&]() {\n";
+    generateReductionWeights(expr);
+    ss_ << "return ";
+  }
+  ss_ << std::string(indent_, ' ') << "reduce(LibTag{}, m_mesh," << sigArg << ", ";
+  expr->getInit()->accept(*this);
+
+  ss_ << ", " << nbhChainToVectorString(expr->getNbhChain());
+  ss_ << ", [&, " + sparseIdx + " = int(0)](auto& lhs, auto "
+      << ASTStencilBody::ReductionIndexVarName(reductionDepth_ + 1) << ") mutable {\n";
+  generateReductionUpdate(expr, "lhs",
+                          ASTStencilBody::ReductionWeightsVarName(expr->getID()) + "[" +
+                              sparseIdx + "]");
+  ss_ << sparseIdx << "++;\n";
+  ss_ << "return lhs;\n";
+  ss_ << "}";
   if(expr->getIncludeCenter()) {
     ss_ << ", /*include center*/ true";
   }
   ss_ << ")";
+  if(hasWeights) {
+    ss_ << ";\n}()";
+  }
+}
+
+void ASTStencilBody::setReductionMergeGroups(const MergeGroupMap& mergeGroups) {
+  mergedReductionLoops_.clear();
+  mergedReductions_.clear();
+  for(const auto& blockGroups : mergeGroups) {
+    for(const auto& group : blockGroups.second) {
+      // nothing to gain for a single reduction
+      if(group.size() < 2)
+        continue;
+      mergedReductionLoops_.emplace(group.front()->getID(), group);
+      for(const auto& expr : group)
+        mergedReductions_.insert(expr->getID());
+    }
+  }
+}
+
+void ASTStencilBody::setFlatNeighborTables(bool flatNeighborTables, bool atlasCompatible) {
+  flatNeighborTables_ = flatNeighborTables;
+  atlasCompatible_ = atlasCompatible;
 }
 
 void ASTStencilBody::setCurrentStencilFunction(
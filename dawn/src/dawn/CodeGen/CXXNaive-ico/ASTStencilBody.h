@@ -16,9 +16,12 @@
 
 #include "dawn/CodeGen/ASTCodeGenCXX.h"
 #include "dawn/CodeGen/CodeGenProperties.h"
+#include "dawn/CodeGen/ReductionMerger.h"
 #include "dawn/IIR/Interval.h"
 #include "dawn/Support/StringUtil.h"
 #include "driver-includes/unstructured_interface.hpp"
+#include <algorithm>
+#include <set>
 #include <stack>
 #include <unordered_map>
 
@@ -32,20 +35,50 @@ class StencilMetaInformation;
 namespace codegen {
 namespace cxxnaiveico {
 
-// quick visitor to check whether a statement contains a reduceOverNeighborExpr
+// quick visitor to check whether a statement contains a reduceOverNeighborExpr (collects the
+// outermost ones, in order of appearance)
 class FindReduceOverNeighborExpr : public ast::ASTVisitorForwardingNonConst {
-  std::optional<std::shared_ptr<ast::ReductionOverNeighborExpr>> foundReduction_ = std::nullopt;
+  std::vector<std::shared_ptr<ast::ReductionOverNeighborExpr>> foundReductions_;
 
 public:
   void visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& stmt) override {
-    foundReduction_ = stmt;
+    foundReductions_.push_back(stmt);
     return;
   }
-  bool hasReduceOverNeighborExpr() const { return foundReduction_.has_value(); }
+  bool hasReduceOverNeighborExpr() const { return !foundReductions_.empty(); }
   const ast::ReductionOverNeighborExpr& foundReduceOverNeighborExpr() {
-    DAWN_ASSERT(foundReduction_.has_value());
-    return *foundReduction_.value();
+    DAWN_ASSERT(hasReduceOverNeighborExpr());
+    return *foundReductions_.back();
   }
+  const std::vector<std::shared_ptr<ast::ReductionOverNeighborExpr>>&
+  reduceOverNeighborExprs() const {
+    return foundReductions_;
+  }
+};
+
+// collects the iteration spaces of all reductions and loops over neighbors (in order of first
+// appearance)
+class CollectIterationSpaces : public ast::ASTVisitorForwardingNonConst {
+  std::vector<ast::UnstructuredIterationSpace> spaces_;
+
+  void insert(const ast::UnstructuredIterationSpace& space) {
+    if(std::find(spaces_.begin(), spaces_.end(), space) == spaces_.end())
+      spaces_.push_back(space);
+  }
+
+public:
+  void visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) override {
+    insert(expr->getIterSpace());
+    ast::ASTVisitorForwardingNonConst::visit(expr);
+  }
+  void visit(const std::shared_ptr<ast::LoopStmt>& stmt) override {
+    if(auto chainDescr =
+           dynamic_cast<const ast::ChainIterationDescr*>(stmt->getIterationDescrPtr())) {
+      insert(chainDescr->getIterSpace());
+    }
+    ast::ASTVisitorForwardingNonConst::visit(stmt);
+  }
+  const std::vector<ast::UnstructuredIterationSpace>& getSpaces() const { return spaces_; }
 };
 
 /// @brief ASTVisitor to generate C++ naive code for the stencil and stencil function bodies
@@ -65,6 +98,17 @@ protected:
 
   size_t reductionDepth_ = 0;
 
+  /// Merged reductions (ID of the first reduction of the group -> group), computed in a single
+  /// neighbor loop in front of the statement containing the first reduction
+  std::map<int, ReductionMergeGroup> mergedReductionLoops_;
+  /// IDs of all reductions whose result is read from an accumulator of a merged loop
+  std::set<int> mergedReductions_;
+
+  /// Index the flat neighbor tables looked up at the beginning of the stencil run method instead of
+  /// querying the neighbors through the library interface
+  bool flatNeighborTables_ = false;
+  bool atlasCompatible_ = false;
+
   /// The stencil function we are currently generating or NULL
   std::shared_ptr<iir::StencilFunctionInstantiation> currentFunction_;
 
@@ -97,6 +141,27 @@ protected:
   std::string makeIndexString(const std::shared_ptr<ast::FieldAccessExpr>& expr,
                               std::string kiterStr);
 
+  /// @brief name of the location the outermost reduction of a statement is anchored at
+  std::string reductionAnchorName() const;
+
+  /// @brief generates the update of the accumulator `lhs` for one neighbor of the reduction
+  void generateReductionUpdate(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr,
+                               const std::string& lhs, const std::string& weight);
+
+  /// @brief generates the declaration of the weights array of the reduction (if it has weights),
+  /// indexed by the position of the neighbor. Literal weights become a `static constexpr` array.
+  void generateReductionWeights(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr);
+
+  /// @brief generates the head of a loop over the flat neighbor table of `space`, declaring the
+  /// position in the table `iterVar` and the neighbor `nbhVar` of `anchor` (the caller closes the
+  /// loop body)
+  void generateFlatNeighborLoopHead(const ast::UnstructuredIterationSpace& space,
+                                    const std::string& anchor, const std::string& iterVar,
+                                    const std::string& nbhVar);
+
+  /// @brief generates the merged neighbor loops starting in the given statement
+  void generateMergedReductionLoops(const std::shared_ptr<ast::Stmt>& stmt);
+
 public:
   using Base = ASTCodeGenCXX;
   using Base::visit;
@@ -110,6 +175,12 @@ public:
     return "sparse_dimension_idx" + std::to_string(level);
   }
   static std::string StageIndexVarName() { return "loc"; }
+  static std::string ReductionAccumulatorVarName(int reductionID) {
+    return "red_acc" + std::to_string(reductionID);
+  }
+  static std::string ReductionWeightsVarName(int reductionID) {
+    return "red_weights" + std::to_string(reductionID);
+  }
 
   /// @brief constructor
   ASTStencilBody(const iir::StencilMetaInformation& metadata, StencilContext stencilContext);
@@ -119,6 +190,8 @@ public:
   /// @name Statement implementation
   /// @{
   void visit(const std::shared_ptr<ast::BlockStmt>& stmt) override;
+  void visit(const std::shared_ptr<ast::ExprStmt>& stmt) override;
+  void visit(const std::shared_ptr<ast::VarDeclStmt>& stmt) override;
   void visit(const std::shared_ptr<ast::ReturnStmt>& stmt) override;
   void visit(const std::shared_ptr<ast::LoopStmt>& stmt) override;
   void visit(const std::shared_ptr<ast::VerticalRegionDeclStmt>& stmt) override;
@@ -135,6 +208,13 @@ public:
   void visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) override;
   /// @}
 
+  /// @brief Evaluate the reductions of each merge group in a single neighbor loop
+  void setReductionMergeGroups(const MergeGroupMap& mergeGroups);
+
+  /// @brief Index the flat, padded neighbor tables of the mesh directly. Missing neighbors are
+  /// skipped for chains with irregular neighborhoods or for all chains if `atlasCompatible`
+  void setFlatNeighborTables(bool flatNeighborTables, bool atlasCompatible);
+
   /// @brief Set the current stencil function (can be NULL)
   void setCurrentStencilFunction(
       const std::shared_ptr<iir::StencilFunctionInstantiation>& currentFunction);
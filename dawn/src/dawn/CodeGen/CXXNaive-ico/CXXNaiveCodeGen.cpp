@@ -18,16 +18,24 @@
 #include "dawn/CodeGen/CXXNaive-ico/ASTStencilDesc.h"
 #include "dawn/CodeGen/CXXUtil.h"
 #include "dawn/CodeGen/CodeGenProperties.h"
+#include "dawn/CodeGen/Cuda-ico/LocToStringUtils.h"
 #include "dawn/CodeGen/IcoChainSizes.h"
+#include "dawn/CodeGen/ReductionMerger.h"
+#include "dawn/IIR/IIRNodeIterator.h"
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/SIR/SIR.h"
 #include "dawn/Support/Assert.h"
 #include "dawn/Support/Exception.h"
+#include "dawn/Support/FileSystem.h"
 #include "dawn/Support/Logger.h"
 #include "dawn/Support/StringUtil.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
 #include <optional>
+#include <stdexcept>
 #include <vector>
 
 namespace dawn {
@@ -93,18 +101,62 @@ std::string makeKLoop(bool isBackward, iir::Interval const& interval) {
   return isBackward ? makeLoopImpl(0, 0, "k", upper, lower, ">=", "--")
                     : makeLoopImpl(0, 0, "k", lower, upper, "<=", "++");
 }
+
+/// @brief Loop over the first levels of blocks of `levelsPerBlock` levels of the interval
+std::string makeKBlockLoop(iir::Interval const& interval, int levelsPerBlock) {
+  const std::string lower = makeIntervalBound(interval, iir::Interval::Bound::lower);
+  const std::string upper = makeIntervalBound(interval, iir::Interval::Bound::upper) + "-1";
+  return "for(int kBlock = " + lower + "; kBlock <= " + upper +
+         "; kBlock += " + std::to_string(levelsPerBlock) + ")";
+}
+
+/// @brief Last level of the block starting at `kBlock`
+std::string makeKBlockEnd(iir::Interval const& interval, int levelsPerBlock) {
+  const std::string upper = makeIntervalBound(interval, iir::Interval::Bound::upper) + "-1";
+  const std::string last = "kBlock+" + std::to_string(levelsPerBlock - 1);
+  return "const int kEnd = (" + last + " < " + upper + " ? " + last + " : " + upper + ")";
+}
+
+/// @brief Whether each stage of the multistage can compute a block of levels before the next
+/// stage starts, i.e. the multistage is parallel and no field it writes is accessed with a vertical
+/// offset (which would read levels of other blocks)
+bool hasIndependentLevels(const iir::MultiStage& multiStage) {
+  if(multiStage.getLoopOrder() != iir::LoopOrderKind::Parallel)
+    return false;
+  for(const auto& [accessID, field] : multiStage.getFields())
+    if(field.getIntend() != iir::Field::IntendKind::Input &&
+       !field.getExtents().verticalExtent().isPointwise())
+      return false;
+  return true;
+}
 } // namespace
 
 std::unique_ptr<TranslationUnit>
 run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
         stencilInstantiationMap,
     const Options& options) {
-  CXXNaiveIcoCodeGen CG(stencilInstantiationMap, options.MaxHaloSize);
+  CXXNaiveIcoCodeGen CG(
+      stencilInstantiationMap, options.MaxHaloSize, options.FlatNeighborTables,
+      options.AtlasCompatible,
+      options.OutputCHeader == "" ? std::nullopt : std::make_optional(options.OutputCHeader),
+      options.LevelsPerThread);
   return CG.generateCode();
 } // namespace cxxnaiveico
 
-CXXNaiveIcoCodeGen::CXXNaiveIcoCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint)
-    : CodeGen(ctx, maxHaloPoint) {}
+CXXNaiveIcoCodeGen::CXXNaiveIcoCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                                       bool flatNeighborTables, bool atlasCompatible,
+                                       std::optional<std::string> outputCHeader,
+                                       int levelsPerThread)
+    : CodeGen(ctx, maxHaloPoint), flatNeighborTables_(flatNeighborTables),
+      atlasCompatible_(atlasCompatible), outputCHeader_(std::move(outputCHeader)),
+      levelsPerThread_(levelsPerThread) {
+  // The raw pointer interface runs the stencils on the flat neighbor tables of `NoLibCpuTag`
+  if(hasRawInterface() && !flatNeighborTables_)
+    throw std::runtime_error(
+        "The raw pointer interface of the c++-naive-ico backend requires flat neighbor tables");
+  if(levelsPerThread_ < 1)
+    throw std::invalid_argument("The number of levels per thread must be positive");
+}
 
 CXXNaiveIcoCodeGen::~CXXNaiveIcoCodeGen() {}
 
@@ -142,6 +194,9 @@ std::string CXXNaiveIcoCodeGen::generateStencilInstantiation(
   cxxnaiveNamespace.commit();
   dawnNamespace.commit();
 
+  if(hasRawInterface())
+    generateRawInterface(ssSW, stencilInstantiation, /*onlyDecl*/ false);
+
   return ssSW.str();
 }
 
@@ -396,6 +451,10 @@ void CXXNaiveIcoCodeGen::generateStencilClasses(
 
     ASTStencilBody stencilBodyCXXVisitor(stencilInstantiation->getMetaData(),
                                          StencilContext::SC_Stencil);
+    // reductions over the same neighbor chain are computed in a single neighbor loop
+    stencilBodyCXXVisitor.setReductionMergeGroups(
+        ReductionMergeGroupsComputer::ComputeReductionMergeGroups(stencilInstantiation));
+    stencilBodyCXXVisitor.setFlatNeighborTables(flatNeighborTables_, atlasCompatible_);
 
     auto fieldInfoToDeclString = [](iir::Stencil::FieldInfo info) {
       if(info.field.getFieldDimensions().isVertical()) {
@@ -499,6 +558,24 @@ void CXXNaiveIcoCodeGen::generateStencilClasses(
     // TODO the generic deref should be moved to a different namespace
     StencilRunMethod.addStatement("using ::dawn::deref");
 
+    if(flatNeighborTables_) {
+      // look up the neighbor tables once, the loops over neighbors index them directly
+      CollectIterationSpaces spaceCollector;
+      for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*stencil)) {
+        doMethod->getAST().accept(spaceCollector);
+      }
+      for(const auto& space : spaceCollector.getSpaces()) {
+        StencilRunMethod.addStatement("constexpr int " + cudaico::chainToSparseSizeString(space) +
+                                      " = " + std::to_string(ICOChainSize(space.Chain)) +
+                                      (space.IncludeCenter ? " + 1" : ""));
+        StencilRunMethod.addStatement(
+            "const int* " + cudaico::chainToTableString(space) +
+            " = m_mesh.NeighborTables.at(::dawn::UnstructuredIterationSpace{" +
+            cudaico::chainToVectorString(space.Chain) + ", " +
+            (space.IncludeCenter ? "true" : "false") + "})");
+      }
+    }
+
     // StencilRunMethod.addStatement("sync_storages()");
     for(const auto& multiStagePtr : stencil->getChildren()) {
       StencilRunMethod.ss() << "{\n";
@@ -582,32 +659,57 @@ void CXXNaiveIcoCodeGen::generateStencilClasses(
         }
       };
 
+      auto generateStage = [&](const iir::Stage& stage, const iir::Interval& interval,
+                               bool isKBlocked) {
+        DAWN_ASSERT_MSG(stage.getLocationType().has_value(), "Stage must have a location type");
+        auto doMethodGenerator = [&] {
+          // Generate Do-Method
+          for(const auto& doMethodPtr : stage.getChildren()) {
+            const iir::DoMethod& doMethod = *doMethodPtr;
+            if(!doMethod.getInterval().overlaps(interval))
+              continue;
+
+            for(const auto& stmt : doMethod.getAST().getStatements()) {
+              stmt->accept(stencilBodyCXXVisitor);
+              StencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
+            }
+          }
+        };
+        std::string loopCode =
+            getLoop(*stage.getLocationType(), stage.getUnstructuredIterationSpace());
+        StencilRunMethod.addBlockStatement(loopCode, [&] {
+          if(isKBlocked)
+            StencilRunMethod.addBlockStatement("for(int k = kBlock; k <= kEnd; ++k)",
+                                               doMethodGenerator);
+          else
+            doMethodGenerator();
+        });
+      };
+
+      // Blocks of levels are computed by the threads, each stage sweeps the horizontal elements
+      // once per block and computes all levels of the block of an element in a row
+      const bool isKBlocked = levelsPerThread_ > 1 && hasIndependentLevels(multiStage);
+      if(levelsPerThread_ > 1 && !isKBlocked)
+        DAWN_LOG(INFO) << stencilInstantiation->getName() << ": multistage " << multiStage.getID()
+                       << " has dependencies between levels, they are not blocked";
+
       for(auto interval : partitionIntervals) {
-        StencilRunMethod.addBlockStatement(
-            makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval), [&] {
-              // for each interval, we generate naive nested loops
-              for(const auto& stagePtr : multiStage.getChildren()) {
-                const iir::Stage& stage = *stagePtr;
-
-                DAWN_ASSERT_MSG(stage.getLocationType().has_value(),
-                                "Stage must have a location type");
-                std::string loopCode =
-                    getLoop(*stage.getLocationType(), stage.getUnstructuredIterationSpace());
-                StencilRunMethod.addBlockStatement(loopCode, [&] {
-                  // Generate Do-Method
-                  for(const auto& doMethodPtr : stage.getChildren()) {
-                    const iir::DoMethod& doMethod = *doMethodPtr;
-                    if(!doMethod.getInterval().overlaps(interval))
-                      continue;
-
-                    for(const auto& stmt : doMethod.getAST().getStatements()) {
-                      stmt->accept(stencilBodyCXXVisitor);
-                      StencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
-                    }
-                  }
-                });
-              }
-            });
+        if(isKBlocked) {
+          StencilRunMethod.addPreprocessorDirective("pragma omp parallel for");
+          StencilRunMethod.addBlockStatement(makeKBlockLoop(interval, levelsPerThread_), [&] {
+            StencilRunMethod.addStatement(makeKBlockEnd(interval, levelsPerThread_));
+            for(const auto& stagePtr : multiStage.getChildren())
+              generateStage(*stagePtr, interval, true);
+          });
+        } else {
+          StencilRunMethod.addBlockStatement(
+              makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval),
+              [&] {
+                // for each interval, we generate naive nested loops
+                for(const auto& stagePtr : multiStage.getChildren())
+                  generateStage(*stagePtr, interval, false);
+              });
+        }
       }
       StencilRunMethod.ss() << "}";
     }
@@ -715,6 +817,96 @@ void CXXNaiveIcoCodeGen::generateStencilFunctions(
   }
 }
 
+void CXXNaiveIcoCodeGen::generateRawInterface(
+    std::stringstream& ss, const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+    bool onlyDecl) const {
+  const auto& metadata = stencilInstantiation->getMetaData();
+  const auto& globalsMap = stencilInstantiation->getIIR()->getGlobalVariableMap();
+  const std::string& wrapperName = stencilInstantiation->getName();
+
+  ss << "extern \"C\" {\n";
+
+  // Dense fields store element `idx` of level `k` at `f[k * f_stride + idx]`, sparse fields
+  // neighbor `nbh` at `f[(k * <sparse size> + nbh) * f_stride + idx]`
+  MemberFunction runFun("void", "run_" + wrapperName, ss, 0, onlyDecl);
+  runFun.addArg("::dawn::GlobalCpuTriMesh* mesh");
+  runFun.addArg("int k_size");
+  for(const auto& global : globalsMap) {
+    if(global.second.isConstexpr())
+      continue;
+    if(global.second.getType() == ast::Value::Kind::String) {
+      throw SemanticError(std::string("Raw pointer interface of stencil '") + wrapperName +
+                              "' does not support string globals",
+                          metadata.getFileName(), metadata.getStencilLocation());
+    }
+    runFun.addArg(std::string(ast::Value::typeToString(global.second.getType())) + " " +
+                  global.first);
+  }
+  for(const auto& fieldID : metadata.getAPIFields()) {
+    const std::string name = metadata.getFieldNameFromAccessID(fieldID);
+    runFun.addArg("::dawn::float_type* " + name);
+    if(!metadata.getFieldDimensions(fieldID).isVertical())
+      runFun.addArg("int " + name + "_stride");
+  }
+  runFun.finishArgs();
+
+  if(!onlyDecl) {
+    std::vector<std::string> fieldArgs;
+    for(const auto& fieldID : metadata.getAPIFields()) {
+      const std::string name = metadata.getFieldNameFromAccessID(fieldID);
+      const auto& dims = metadata.getFieldDimensions(fieldID);
+      std::string view;
+      if(dims.isVertical()) {
+        view = "::dawn::cpu_vertical_field<::dawn::float_type> " + name + "_view(" + name + ")";
+      } else {
+        const auto& hdims = ast::dimension_cast<const ast::UnstructuredFieldDimension&>(
+            dims.getHorizontalFieldDimension());
+        view = hdims.isDense() ? "::dawn::cpu_dense_field<::dawn::float_type> " + name +
+                                     "_view(" + name + ", " + name + "_stride)"
+                               : "::dawn::cpu_sparse_field<::dawn::float_type> " + name +
+                                     "_view(" + name + ", " + name + "_stride, " +
+                                     std::to_string(ICOChainSize(hdims.getNeighborChain()) +
+                                                    (hdims.getIncludeCenter() ? 1 : 0)) +
+                                     ")";
+      }
+      runFun.addStatement(view);
+      fieldArgs.push_back(name + "_view");
+    }
+    runFun.addStatement("dawn_generated::cxxnaiveico::" + wrapperName +
+                        "<::dawn::NoLibCpuTag> stencil(*mesh, k_size" +
+                        RangeToString(", ", fieldArgs.empty() ? "" : ", ", "")(fieldArgs) + ")");
+    for(const auto& global : globalsMap) {
+      if(!global.second.isConstexpr())
+        runFun.addStatement("stencil.set_" + global.first + "(" + global.first + ")");
+    }
+    runFun.addBlockStatement(
+        "for(const auto& keyIndex : mesh->HorizontalDomain.splitter_index_map())", [&]() {
+          runFun.addStatement("stencil.set_splitter_index(std::get<0>(keyIndex.first), "
+                              "std::get<1>(keyIndex.first), std::get<2>(keyIndex.first), "
+                              "keyIndex.second)");
+        });
+    runFun.addStatement("stencil.run()");
+  }
+  runFun.commit();
+
+  ss << "}\n";
+}
+
+std::string CXXNaiveIcoCodeGen::generateCHeader() const {
+  std::stringstream ss;
+  ss << "#pragma once\n";
+  ss << "#include \"driver-includes/defs.hpp\"\n";
+  ss << "namespace dawn {\n";
+  ss << "struct GlobalCpuTriMesh;\n";
+  ss << "}\n";
+
+  for(const auto& nameStencilCtxPair : context_) {
+    generateRawInterface(ss, nameStencilCtxPair.second, /*onlyDecl*/ true);
+  }
+
+  return ss.str();
+}
+
 std::unique_ptr<TranslationUnit> CXXNaiveIcoCodeGen::generateCode() {
   DAWN_LOG(INFO) << "Starting code generation for GTClang ...";
 
@@ -727,6 +919,18 @@ std::unique_ptr<TranslationUnit> CXXNaiveIcoCodeGen::generateCode() {
     stencils.emplace(nameStencilCtxPair.first, std::move(code));
   }
 
+  if(hasRawInterface()) {
+    fs::path filePath = *outputCHeader_;
+    std::ofstream headerFile;
+    headerFile.open(filePath);
+    if(headerFile) {
+      headerFile << generateCHeader();
+      headerFile.close();
+    } else {
+      throw std::runtime_error("Error writing to " + filePath.string() + ": " + strerror(errno));
+    }
+  }
+
   std::string globals = generateGlobals(context_, "dawn_generated", "cxxnaiveico");
 
   std::vector<std::string> ppDefines;
@@ -738,6 +942,9 @@ std::unique_ptr<TranslationUnit> CXXNaiveIcoCodeGen::generateCode() {
   ppDefines.push_back("#include <driver-includes/unstructured_interface.hpp>");
   ppDefines.push_back("#include <driver-includes/unstructured_domain.hpp>");
   ppDefines.push_back("#include <driver-includes/math.hpp>");
+  if(flatNeighborTables_) {
+    ppDefines.push_back("#include <driver-includes/cpu_mesh.hpp>");
+  }
   DAWN_LOG(INFO) << "Done generating code";
 
   std::string filename = generateFileName(context_);
@@ -19,7 +19,10 @@
 #include "dawn/CodeGen/Options.h"
 #include "dawn/IIR/Interval.h"
 #include "dawn/Support/IndexRange.h"
+#include <optional>
 #include <set>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -43,11 +46,37 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 class CXXNaiveIcoCodeGen : public CodeGen {
 public:
   ///@brief constructor
-  CXXNaiveIcoCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint);
+  CXXNaiveIcoCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                     bool flatNeighborTables = false, bool atlasCompatible = false,
+                     std::optional<std::string> outputCHeader = std::nullopt,
+                     int levelsPerThread = 1);
   virtual ~CXXNaiveIcoCodeGen();
   virtual std::unique_ptr<TranslationUnit> generateCode() override;
 
 private:
+  /// Index the flat, padded neighbor tables of the mesh (`NoLibCpuTag`) instead of querying the
+  /// neighbors through the library interface
+  bool flatNeighborTables_;
+  /// Assume incomplete neighborhoods for all chains (only relevant for flat neighbor tables)
+  bool atlasCompatible_;
+  /// Write the declarations of the raw pointer interface to this C header (enables the interface)
+  std::optional<std::string> outputCHeader_;
+  /// Number of levels of the blocks computed by each thread in parallel multistages (1 iterates
+  /// the levels in the outermost loop)
+  int levelsPerThread_;
+
+  bool hasRawInterface() const { return outputCHeader_.has_value(); }
+
+  /// @brief Generate the `extern "C"` raw pointer interface of a stencil instantiation
+  ///
+  /// The stencil is run on a `GlobalCpuTriMesh`, the caller's arrays are wrapped into the
+  /// `cpu_*_field` views of `NoLibCpuTag` and updated in place, no data is copied.
+  void generateRawInterface(std::stringstream& ss,
+                            const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+                            bool onlyDecl) const;
+
+  std::string generateCHeader() const;
+
   std::string generateStencilInstantiation(
       const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation);
 
@@ -25,9 +25,10 @@ namespace cxxnaive {
 
 ASTStencilDesc::ASTStencilDesc(
     const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
-    CodeGenProperties const& codeGenProperties)
+    CodeGenProperties const& codeGenProperties, bool rawFields)
     : ASTCodeGenCXX(), instantiation_(stencilInstantiation),
-      metadata_(instantiation_->getMetaData()), codeGenProperties_(codeGenProperties) {}
+      metadata_(instantiation_->getMetaData()), codeGenProperties_(codeGenProperties),
+      rawFields_(rawFields) {}
 
 ASTStencilDesc::~ASTStencilDesc() {}
 
@@ -72,7 +73,8 @@ void ASTStencilDesc::visit(const std::shared_ptr<ast::StencilCallDeclStmt>& stmt
 
   ss_ << fieldArgs(nonTempFields, [&](const std::pair<const int, iir::Stencil::FieldInfo>& fieldp) {
     if(metadata_.isAccessType(iir::FieldAccessType::InterStencilTemporary, fieldp.first)) {
-      return "m_" + fieldp.second.Name;
+      return rawFields_ ? "make_raw_field(m_" + fieldp.second.Name + ")"
+                        : "m_" + fieldp.second.Name;
     } else {
       return fieldp.second.Name;
     }
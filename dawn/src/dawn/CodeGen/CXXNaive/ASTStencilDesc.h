@@ -38,12 +38,15 @@ protected:
 
   const CodeGenProperties& codeGenProperties_;
 
+  /// Stencils are called with `raw_field`s instead of storages
+  const bool rawFields_;
+
 public:
   using Base = ASTCodeGenCXX;
   using Base::visit;
 
   ASTStencilDesc(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
-                 const CodeGenProperties& CodeGenProperties);
+                 const CodeGenProperties& CodeGenProperties, bool rawFields = false);
 
   virtual ~ASTStencilDesc();
 
@@ -19,6 +19,7 @@
 #include "dawn/CodeGen/CXXNaive/ASTStencilDesc.h"
 #include "dawn/CodeGen/CXXUtil.h"
 #include "dawn/CodeGen/CodeGenProperties.h"
+#include "dawn/CodeGen/F90Util.h"
 #include "dawn/IIR/Extents.h"
 #include "dawn/IIR/IIRNodeIterator.h"
 #include "dawn/IIR/Interval.h"
@@ -27,9 +28,14 @@
 #include "dawn/SIR/SIR.h"
 #include "dawn/Support/Assert.h"
 #include "dawn/Support/Exception.h"
+#include "dawn/Support/FileSystem.h"
 #include "dawn/Support/Logger.h"
 #include "dawn/Support/StringUtil.h"
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -75,6 +81,31 @@ std::string makeIntervalBoundExplicit(std::string dim, const iir::Interval& inte
   return dom + "." + dim + "minus() + " + std::to_string(notEnd + interval.offset(bound));
 }
 
+/// Which of the i, j and k dimensions a cartesian field has
+std::array<bool, 3> getCartesianDimensionMask(const ast::FieldDimensions& dimensions) {
+  if(dimensions.isVertical())
+    return {false, false, dimensions.K()};
+  const auto& horizontal = ast::dimension_cast<const ast::CartesianFieldDimension&>(
+      dimensions.getHorizontalFieldDimension());
+  return {horizontal.I(), horizontal.J(), dimensions.K()};
+}
+
+FortranAPI::InterfaceType globalTypeToFortType(const ast::Global& global) {
+  switch(global.getType()) {
+  case ast::Value::Kind::Boolean:
+    return FortranAPI::InterfaceType::BOOLEAN;
+  case ast::Value::Kind::Double:
+    return FortranAPI::InterfaceType::DOUBLE;
+  case ast::Value::Kind::Float:
+    return FortranAPI::InterfaceType::FLOAT;
+  case ast::Value::Kind::Integer:
+    return FortranAPI::InterfaceType::INTEGER;
+  case ast::Value::Kind::String:
+  default:
+    throw std::runtime_error("string globals not supported in the raw pointer interface");
+  }
+}
+
 std::string makeKLoop(bool isBackward, iir::Interval const& interval) {
 
   const std::string lower = makeIntervalBoundReadable("k", interval, iir::Interval::Bound::lower);
@@ -89,16 +120,77 @@ std::unique_ptr<TranslationUnit>
 run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
         stencilInstantiationMap,
     const Options& options) {
-  CXXNaiveCodeGen CG(stencilInstantiationMap, options.MaxHaloSize);
+  const Array3i domainSize{options.DomainSizeI, options.DomainSizeJ, options.DomainSizeK};
+  CXXNaiveCodeGen CG(
+      stencilInstantiationMap, options.MaxHaloSize, domainSize,
+      options.OutputCHeader == "" ? std::nullopt : std::make_optional(options.OutputCHeader),
+      options.OutputFortranInterface == "" ? std::nullopt
+                                           : std::make_optional(options.OutputFortranInterface),
+      options.HaloExchange);
 
   return CG.generateCode();
 }
 
-CXXNaiveCodeGen::CXXNaiveCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint)
-    : CodeGen(ctx, maxHaloPoint) {}
+CXXNaiveCodeGen::CXXNaiveCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                                 const Array3i& domainSize,
+                                 std::optional<std::string> outputCHeader,
+                                 std::optional<std::string> outputFortranInterface,
+                                 bool haloExchange)
+    : CodeGen(ctx, maxHaloPoint),
+      codeGenOptions_{domainSize, outputCHeader, outputFortranInterface, haloExchange} {}
 
 CXXNaiveCodeGen::~CXXNaiveCodeGen() {}
 
+void CXXNaiveCodeGen::generateLoopBounds(MemberFunction& stencilRunMethod) const {
+  const std::array<std::string, 3> dims{"i", "j", "k"};
+  for(int dim = 0; dim < 3; ++dim) {
+    const std::string& d = dims[dim];
+    const int size = codeGenOptions_.domainSize[dim];
+    if(size > 0) {
+      // The domain constructor sets the horizontal halos to `halo::value` and the vertical ones
+      // to 0, generateDomainSizeChecks makes sure the runtime domain agrees.
+      const std::string halo = dim < 2 ? "halo::value" : "0";
+      stencilRunMethod.addStatement("constexpr int " + d + "Min = " + halo);
+      stencilRunMethod.addStatement("constexpr int " + d + "Max = " + std::to_string(size) +
+                                    " - " + halo + " - 1");
+    } else {
+      stencilRunMethod.addStatement("int " + d + "Min = m_dom." + d + "minus()");
+      stencilRunMethod.addStatement("int " + d + "Max = m_dom." + d + "size() - m_dom." + d +
+                                    "plus() - 1");
+    }
+  }
+}
+
+bool CXXNaiveCodeGen::hasFixedDomainSize() const {
+  const Array3i& domainSize = codeGenOptions_.domainSize;
+  return std::any_of(domainSize.begin(), domainSize.end(), [](int size) { return size > 0; });
+}
+
+void CXXNaiveCodeGen::generateDomainSizeChecks(MemberFunction& stencilWrapperCtr) const {
+  const std::array<std::string, 3> dims{"i", "j", "k"};
+  for(int dim = 0; dim < 3; ++dim) {
+    const std::string& d = dims[dim];
+    const int size = codeGenOptions_.domainSize[dim];
+    if(size <= 0)
+      continue;
+    const std::string halo = dim < 2 ? "halo::value" : "0";
+    const std::string expected = d + "size() == " + std::to_string(size) + ", " + d +
+                                 "minus() == " + d + "plus() == " + halo;
+    stencilWrapperCtr.addStatement("if(dom." + d + "size() != " + std::to_string(size) +
+                                   " || dom." + d + "minus() != " + halo + " || dom." + d +
+                                   "plus() != " + halo +
+                                   ") throw std::invalid_argument(\"stencil generated for a "
+                                   "fixed domain size (" +
+                                   expected + ")\")");
+  }
+}
+
+std::vector<bool> CXXNaiveCodeGen::getRunMethodVariants() const {
+  if(hasRawInterface())
+    return {false, true};
+  return {false};
+}
+
 std::string CXXNaiveCodeGen::generateStencilInstantiation(
     const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation) {
   using namespace codegen;
@@ -127,11 +219,21 @@ std::string CXXNaiveCodeGen::generateStencilInstantiation(
 
   generateStencilWrapperRun(stencilWrapperClass, stencilInstantiation, codeGenProperties);
 
+  if(codeGenOptions_.haloExchange)
+    generateStencilWrapperHaloExchange(stencilWrapperClass, stencilInstantiation,
+                                       codeGenProperties);
+
   stencilWrapperClass.commit();
 
+  if(hasRawInterface())
+    generateRawInterfaceInstance(ssSW, stencilInstantiation);
+
   cxxnaiveNamespace.commit();
   dawnNamespace.commit();
 
+  if(hasRawInterface())
+    generateRawInterface(ssSW, stencilInstantiation, "cxxnaive", /*onlyDecl*/ false);
+
   return ssSW.str();
 }
 
@@ -142,30 +244,119 @@ void CXXNaiveCodeGen::generateStencilWrapperRun(
 
   const auto& metadata = stencilInstantiation->getMetaData();
 
-  // Generate the run method by generate code for the stencil description AST
-  MemberFunction runMethod = stencilWrapperClass.addMemberFunction("void", "run", "");
+  for(bool rawFields : getRunMethodVariants()) {
+    // Generate the run method by generate code for the stencil description AST
+    MemberFunction runMethod = stencilWrapperClass.addMemberFunction("void", "run", "");
 
-  for(const auto& fieldID : metadata.getAPIFields()) {
-    std::string name = metadata.getFieldNameFromAccessID(fieldID);
-    runMethod.addArg(codeGenProperties.getParamType(stencilInstantiation, name) + " " + name);
+    for(const auto& fieldID : metadata.getAPIFields()) {
+      std::string name = metadata.getFieldNameFromAccessID(fieldID);
+      runMethod.addArg((rawFields ? "raw_field<::dawn::float_type>"
+                                  : codeGenProperties.getParamType(stencilInstantiation, name)) +
+                       " " + name);
+    }
+
+    runMethod.finishArgs();
+
+    // generate the control flow code executing each inner stencil
+    ASTStencilDesc stencilDescCGVisitor(stencilInstantiation, codeGenProperties, rawFields);
+    stencilDescCGVisitor.setIndent(runMethod.getIndent());
+    for(const auto& statement :
+        stencilInstantiation->getIIR()->getControlFlowDescriptor().getStatements()) {
+      statement->accept(stencilDescCGVisitor);
+      auto str = stencilDescCGVisitor.getCodeAndResetStream();
+      if(str.back() == ';')
+        str.pop_back();
+      runMethod.addStatement(str);
+    }
+
+    runMethod.commit();
   }
+}
+void CXXNaiveCodeGen::generateStencilWrapperHaloExchange(
+    Class& stencilWrapperClass,
+    const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
+    const CodeGenProperties& codeGenProperties) const {
+  MemberFunction setHaloExchange =
+      stencilWrapperClass.addMemberFunction("void", "set_halo_exchange");
+  setHaloExchange.addArg(c_dgt + "halo_exchange* comm");
+  setHaloExchange.startBody();
+  for(const auto& stencil : stencilInstantiation->getStencils()) {
+    if(stencil->isEmpty() || computeHaloExchange(*stencil).Fields.empty())
+      continue;
+    const std::string stencilName =
+        codeGenProperties.getStencilName(StencilContext::SC_Stencil, stencil->getStencilID());
+    setHaloExchange.addStatement("m_" + stencilName + ".set_halo_exchange(comm)");
+  }
+  setHaloExchange.commit();
+}
 
-  runMethod.finishArgs();
-
-  // generate the control flow code executing each inner stencil
-  ASTStencilDesc stencilDescCGVisitor(stencilInstantiation, codeGenProperties);
-  stencilDescCGVisitor.setIndent(runMethod.getIndent());
-  for(const auto& statement :
-      stencilInstantiation->getIIR()->getControlFlowDescriptor().getStatements()) {
-    statement->accept(stencilDescCGVisitor);
-    auto str = stencilDescCGVisitor.getCodeAndResetStream();
-    if(str.back() == ';')
-      str.pop_back();
-    runMethod.addStatement(str);
+void CXXNaiveCodeGen::generateHaloExchange(MemberFunction& stencilRunMethod,
+                                           const HaloExchange& haloExchange,
+                                           const iir::StencilMetaInformation& metadata,
+                                           bool rawFields,
+                                           const std::function<void()>& generateStencil) const {
+  auto toString = [](const std::array<int, 4>& width) {
+    return "{" + std::to_string(width[0]) + ", " + std::to_string(width[1]) + ", " +
+           std::to_string(width[2]) + ", " + std::to_string(width[3]) + "}";
+  };
+
+  stencilRunMethod.addBlockStatement("if(m_halo_exchange)", [&]() {
+    for(const auto& [accessID, width] : haloExchange.Fields) {
+      const std::string name = metadata.getFieldNameFromAccessID(accessID);
+      stencilRunMethod.addStatement("m_halo_exchange->start(" +
+                                    (rawFields ? name : "make_raw_field(" + name + "_)") +
+                                    ", m_dom, " + toString(width) + ")");
+    }
+    if(!haloExchange.CanOverlap)
+      stencilRunMethod.addStatement("m_halo_exchange->finish()");
+  });
+  if(!haloExchange.CanOverlap) {
+    generateStencil();
+    return;
   }
 
-  runMethod.commit();
+  // The whole stencil runs on a subdomain (shadowing the loop bounds) and computes the stage
+  // extents around it redundantly. Shrunk by the halo widths, the subdomain only reads points of
+  // the compute domain and can be computed while the halos are exchanged.
+  stencilRunMethod.addBlockStatement("auto runOnSubdomain = [&](int iMin, int iMax, int jMin, "
+                                     "int jMax)",
+                                     generateStencil);
+  stencilRunMethod.ss() << ";";
+
+  const std::array<int, 4>& w = haloExchange.Width;
+  const std::string interiorJ =
+      "jMin + " + std::to_string(w[2]) + ", jMax - " + std::to_string(w[3]);
+  stencilRunMethod.addBlockStatement(
+      "if(m_halo_exchange && iMax - iMin >= " + std::to_string(w[0] + w[1]) +
+          " && jMax - jMin >= " + std::to_string(w[2] + w[3]) + ")",
+      [&]() {
+        stencilRunMethod.addStatement("runOnSubdomain(iMin + " + std::to_string(w[0]) +
+                                      ", iMax - " + std::to_string(w[1]) + ", " + interiorJ +
+                                      ")");
+        stencilRunMethod.addStatement("m_halo_exchange->finish()");
+        // Boundary strips, the ones along i including the corners
+        if(w[2] > 0)
+          stencilRunMethod.addStatement("runOnSubdomain(iMin, iMax, jMin, jMin + " +
+                                        std::to_string(w[2] - 1) + ")");
+        if(w[3] > 0)
+          stencilRunMethod.addStatement("runOnSubdomain(iMin, iMax, jMax - " +
+                                        std::to_string(w[3] - 1) + ", jMax)");
+        if(w[0] > 0)
+          stencilRunMethod.addStatement("runOnSubdomain(iMin, iMin + " + std::to_string(w[0] - 1) +
+                                        ", " + interiorJ + ")");
+        if(w[1] > 0)
+          stencilRunMethod.addStatement("runOnSubdomain(iMax - " + std::to_string(w[1] - 1) +
+                                        ", iMax, " + interiorJ + ")");
+      });
+  // Subdomains too small to have an interior
+  stencilRunMethod.addBlockStatement("else", [&]() {
+    stencilRunMethod.addBlockStatement("if(m_halo_exchange)", [&]() {
+      stencilRunMethod.addStatement("m_halo_exchange->finish()");
+    });
+    stencilRunMethod.addStatement("runOnSubdomain(iMin, iMax, jMin, jMax)");
+  });
 }
+
 void CXXNaiveCodeGen::generateStencilWrapperCtr(
     Class& stencilWrapperClass,
     const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
@@ -217,6 +408,7 @@ void CXXNaiveCodeGen::generateStencilWrapperCtr(
   StencilWrapperConstructor.addStatement("assert(dom.jsize() >= dom.jminus() + dom.jplus())");
   StencilWrapperConstructor.addStatement("assert(dom.ksize() >= dom.kminus() + dom.kplus())");
   StencilWrapperConstructor.addStatement("assert(dom.ksize() >= 1)");
+  generateDomainSizeChecks(StencilWrapperConstructor);
   StencilWrapperConstructor.commit();
 
   StencilWrapperConstructor.commit();
@@ -231,6 +423,7 @@ void CXXNaiveCodeGen::generateStencilWrapperMembers(
 
   stencilWrapperClass.addMember("static constexpr const char* s_name =",
                                 "\"" + stencilWrapperClass.getName() + "\"");
+  generateFieldAccessCounts(stencilWrapperClass, *stencilInstantiation);
 
   if(!globalsMap.empty()) {
     stencilWrapperClass.addMember("globals", "m_globals");
@@ -311,6 +504,13 @@ void CXXNaiveCodeGen::generateStencilClasses(
       stencilClass.addMember("const globals&", "m_globals");
     }
 
+    const HaloExchange haloExchange =
+        codeGenOptions_.haloExchange ? computeHaloExchange(stencil) : HaloExchange();
+    const bool exchangesHalos = !haloExchange.Fields.empty();
+    if(exchangesHalos) {
+      stencilClass.addMember(c_dgt + "halo_exchange*", "m_halo_exchange");
+    }
+
     stencilClass.addComment("Input/Output storages");
 
     addTmpStorageDeclaration(stencilClass, tempFields);
@@ -331,6 +531,9 @@ void CXXNaiveCodeGen::generateStencilClasses(
     if(!globalsMap.empty()) {
       stencilClassCtr.addArg("m_globals(globals_)");
     }
+    if(exchangesHalos) {
+      stencilClassCtr.addInit("m_halo_exchange(nullptr)");
+    }
     for(auto& stage : iterateIIROver<iir::Stage>(stencil)) {
       if(stage->getIterationSpace()[0].has_value()) {
         stencilClassCtr.addInit(
@@ -361,6 +564,13 @@ void CXXNaiveCodeGen::generateStencilClasses(
     addTmpStorageInit(stencilClassCtr, stencil, tempFields);
     stencilClassCtr.commit();
 
+    if(exchangesHalos) {
+      MemberFunction setHaloExchange = stencilClass.addMemberFunction("void", "set_halo_exchange");
+      setHaloExchange.addArg(c_dgt + "halo_exchange* comm");
+      setHaloExchange.addStatement("m_halo_exchange = comm");
+      setHaloExchange.commit();
+    }
+
     // virtual dtor
 
     // synchronize storages method
@@ -371,128 +581,145 @@ void CXXNaiveCodeGen::generateStencilClasses(
     //
     // Run-Method
     //
-    MemberFunction stencilRunMethod = stencilClass.addMemberFunction("void", "run", "");
-    for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
-      std::string type = stencilProperties->paramNameToType_.at((*it).second.Name);
-      stencilRunMethod.addArg(type + "& " + (*it).second.Name + "_");
-    }
-
-    stencilRunMethod.startBody();
-    // Compute the loop bounds for readability
-    stencilRunMethod.addStatement("int iMin = m_dom.iminus()");
-    stencilRunMethod.addStatement("int iMax = m_dom.isize() - m_dom.iplus() - 1");
-    stencilRunMethod.addStatement("int jMin = m_dom.jminus()");
-    stencilRunMethod.addStatement("int jMax = m_dom.jsize() - m_dom.jplus() - 1");
-    stencilRunMethod.addStatement("int kMin = m_dom.kminus()");
-    stencilRunMethod.addStatement("int kMax = m_dom.ksize() - m_dom.kplus() - 1");
-
-    for(const auto& fieldPair : nonTempFields) {
-      stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
-    }
-    for(const auto& multiStagePtr : stencil.getChildren()) {
-
-      stencilRunMethod.ss() << "{";
-
-      const iir::MultiStage& multiStage = *multiStagePtr;
-
-      // create all the data views
+    // The raw pointer interface needs a second run method operating on `raw_field`s
+    for(bool rawFields : getRunMethodVariants()) {
+      MemberFunction stencilRunMethod = stencilClass.addMemberFunction("void", "run", "");
       for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
-        const auto fieldName = (*it).second.Name;
-        std::string type = stencilProperties->paramNameToType_.at(fieldName);
-        stencilRunMethod.addStatement(c_gt + "data_view<" + type + "> " + fieldName + "= " + c_gt +
-                                      "make_host_view(" + fieldName + "_)");
-        stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
-      }
-      for(const auto& fieldPair : tempFields) {
-        const auto fieldName = fieldPair.second.Name;
-        stencilRunMethod.addStatement(c_gt + "data_view<tmp_storage_t> " + fieldName + "= " + c_gt +
-                                      "make_host_view(m_" + fieldName + ")");
-        stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+        if(rawFields) {
+          stencilRunMethod.addArg("raw_field<::dawn::float_type> " + (*it).second.Name);
+        } else {
+          std::string type = stencilProperties->paramNameToType_.at((*it).second.Name);
+          stencilRunMethod.addArg(type + "& " + (*it).second.Name + "_");
+        }
       }
 
-      auto intervals_set = multiStage.getIntervals();
-      std::vector<iir::Interval> intervals_v;
-      std::copy(intervals_set.begin(), intervals_set.end(), std::back_inserter(intervals_v));
-
-      // compute the partition of the intervals
-      auto partitionIntervals = iir::Interval::computePartition(intervals_v);
-      if((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward))
-        std::reverse(partitionIntervals.begin(), partitionIntervals.end());
+      stencilRunMethod.startBody();
+      // Compute the loop bounds for readability
+      generateLoopBounds(stencilRunMethod);
 
-      for(auto interval : partitionIntervals) {
-
-        // for each interval, we generate naive nested loops
-        stencilRunMethod.addBlockStatement(
-            makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval),
-            [&]() {
-              for(const auto& stagePtr : multiStage.getChildren()) {
-                iir::Stage& stage = *stagePtr;
-
-                auto const& extents = iir::extent_cast<iir::CartesianExtent const&>(
-                    stage.getExtents().horizontalExtent());
-
-                // Check if we need to execute this statement:
-                bool hasOverlappingInterval = false;
-                for(const auto& doMethodPtr : stage.getChildren()) {
-                  hasOverlappingInterval |= (doMethodPtr->getInterval().overlaps(interval));
-                }
-
-                if(hasOverlappingInterval) {
-                  auto doMethodGenerator = [&]() {
-                    // Generate Do-Method
+      for(const auto& fieldPair : nonTempFields) {
+        if(!rawFields)
+          stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
+      }
+      auto generateMultiStages = [&]() {
+        for(const auto& multiStagePtr : stencil.getChildren()) {
+
+          stencilRunMethod.ss() << "{";
+
+          const iir::MultiStage& multiStage = *multiStagePtr;
+
+          // create all the data views, raw fields are accessed directly
+          for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
+            const auto fieldName = (*it).second.Name;
+            if(!rawFields) {
+              std::string type = stencilProperties->paramNameToType_.at(fieldName);
+              stencilRunMethod.addStatement(c_gt + "data_view<" + type + "> " + fieldName + "= " +
+                                            c_gt + "make_host_view(" + fieldName + "_)");
+            }
+            stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+          }
+          for(const auto& fieldPair : tempFields) {
+            const auto fieldName = fieldPair.second.Name;
+            stencilRunMethod.addStatement(c_gt + "data_view<tmp_storage_t> " + fieldName + "= " +
+                                          c_gt + "make_host_view(m_" + fieldName + ")");
+            stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+          }
+
+          auto intervals_set = multiStage.getIntervals();
+          std::vector<iir::Interval> intervals_v;
+          std::copy(intervals_set.begin(), intervals_set.end(), std::back_inserter(intervals_v));
+
+          // compute the partition of the intervals
+          auto partitionIntervals = iir::Interval::computePartition(intervals_v);
+          if((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward))
+            std::reverse(partitionIntervals.begin(), partitionIntervals.end());
+
+          for(auto interval : partitionIntervals) {
+
+            // for each interval, we generate naive nested loops
+            stencilRunMethod.addBlockStatement(
+                makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval),
+                [&]() {
+                  for(const auto& stagePtr : multiStage.getChildren()) {
+                    iir::Stage& stage = *stagePtr;
+
+                    auto const& extents = iir::extent_cast<iir::CartesianExtent const&>(
+                        stage.getExtents().horizontalExtent());
+
+                    // Check if we need to execute this statement:
+                    bool hasOverlappingInterval = false;
                     for(const auto& doMethodPtr : stage.getChildren()) {
-                      const iir::DoMethod& doMethod = *doMethodPtr;
-                      if(!doMethod.getInterval().overlaps(interval))
-                        continue;
-                      for(const auto& stmt : doMethod.getAST().getStatements()) {
-                        stmt->accept(stencilBodyCXXVisitor);
-                        stencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
-                      }
+                      hasOverlappingInterval |= (doMethodPtr->getInterval().overlaps(interval));
                     }
-                  };
-
-                  stencilRunMethod.addBlockStatement(
-                      makeIJLoop(extents.iMinus(), extents.iPlus(), "m_dom", "i"), [&]() {
-                        stencilRunMethod.addBlockStatement(
-                            makeIJLoop(extents.jMinus(), extents.jPlus(), "m_dom", "j"), [&] {
-                              if(std::any_of(stage.getIterationSpace().cbegin(),
-                                             stage.getIterationSpace().cend(),
-                                             [](const auto& p) -> bool { return p.has_value(); })) {
-                                std::string conditional = "if(";
-                                if(stage.getIterationSpace()[0]) {
-                                  conditional += "checkOffset(stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalIIndices[0], stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalIIndices[1], globalOffsets[0] + i)";
-                                }
-                                if(stage.getIterationSpace()[1]) {
-                                  if(stage.getIterationSpace()[0]) {
-                                    conditional += " && ";
+
+                    if(hasOverlappingInterval) {
+                      auto doMethodGenerator = [&]() {
+                        // Generate Do-Method
+                        for(const auto& doMethodPtr : stage.getChildren()) {
+                          const iir::DoMethod& doMethod = *doMethodPtr;
+                          if(!doMethod.getInterval().overlaps(interval))
+                            continue;
+                          for(const auto& stmt : doMethod.getAST().getStatements()) {
+                            stmt->accept(stencilBodyCXXVisitor);
+                            stencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
+                          }
+                        }
+                      };
+
+                      stencilRunMethod.addBlockStatement(
+                          makeIJLoop(extents.iMinus(), extents.iPlus(), "m_dom", "i"), [&]() {
+                            stencilRunMethod.addBlockStatement(
+                                makeIJLoop(extents.jMinus(), extents.jPlus(), "m_dom", "j"), [&] {
+                                  if(std::any_of(
+                                         stage.getIterationSpace().cbegin(),
+                                         stage.getIterationSpace().cend(),
+                                         [](const auto& p) -> bool { return p.has_value(); })) {
+                                    std::string conditional = "if(";
+                                    if(stage.getIterationSpace()[0]) {
+                                      conditional += "checkOffset(stage" +
+                                                     std::to_string(stage.getStageID()) +
+                                                     "GlobalIIndices[0], stage" +
+                                                     std::to_string(stage.getStageID()) +
+                                                     "GlobalIIndices[1], globalOffsets[0] + i)";
+                                    }
+                                    if(stage.getIterationSpace()[1]) {
+                                      if(stage.getIterationSpace()[0]) {
+                                        conditional += " && ";
+                                      }
+                                      conditional += "checkOffset(stage" +
+                                                     std::to_string(stage.getStageID()) +
+                                                     "GlobalJIndices[0], stage" +
+                                                     std::to_string(stage.getStageID()) +
+                                                     "GlobalJIndices[1], globalOffsets[1] + j)";
+                                    }
+                                    conditional += ")";
+                                    stencilRunMethod.addBlockStatement(conditional,
+                                                                       doMethodGenerator);
+                                  } else {
+                                    doMethodGenerator();
                                   }
-                                  conditional += "checkOffset(stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalJIndices[0], stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalJIndices[1], globalOffsets[1] + j)";
-                                }
-                                conditional += ")";
-                                stencilRunMethod.addBlockStatement(conditional, doMethodGenerator);
-                              } else {
-                                doMethodGenerator();
-                              }
-                            });
-                      });
-                }
-              }
-            });
+                                });
+                          });
+                    }
+                  }
+                });
+          }
+          stencilRunMethod.ss() << "}";
+        }
+      };
+
+      if(!exchangesHalos) {
+        generateMultiStages();
+      } else {
+        generateHaloExchange(stencilRunMethod, haloExchange, stencilInstantiation->getMetaData(),
+                             rawFields, generateMultiStages);
       }
-      stencilRunMethod.ss() << "}";
-    }
-    for(const auto& fieldPair : nonTempFields) {
-      stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
+      for(const auto& fieldPair : nonTempFields) {
+        if(!rawFields)
+          stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
+      }
+      stencilRunMethod.commit();
     }
-    stencilRunMethod.commit();
   }
 }
 
@@ -599,6 +826,208 @@ void CXXNaiveCodeGen::generateStencilFunctions(
   }
 }
 
+void CXXNaiveCodeGen::generateRawInterfaceInstance(
+    std::stringstream& ss,
+    const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation) const {
+  const std::string& wrapperName = stencilInstantiation->getName();
+  ss << "static std::unique_ptr<" << wrapperName << "> " << wrapperName << "_instance;\n";
+}
+
+void CXXNaiveCodeGen::generateRawInterface(
+    std::stringstream& ss, const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+    const std::string& backendNamespace, bool onlyDecl) const {
+  const auto& metadata = stencilInstantiation->getMetaData();
+  const auto& globalsMap = stencilInstantiation->getIIR()->getGlobalVariableMap();
+  const std::string& wrapperName = stencilInstantiation->getName();
+  const std::string fullWrapperName = "dawn_generated::" + backendNamespace + "::" + wrapperName;
+  const std::string instanceName = fullWrapperName + "_instance";
+
+  // Stencil functions access their arguments through gridtools data views
+  if(!metadata.getStencilFunctionInstantiations().empty()) {
+    throw SemanticError(std::string("Raw pointer interface of stencil '") + wrapperName +
+                            "' requires stencil functions to be inlined",
+                        metadata.getFileName(), metadata.getStencilLocation());
+  }
+
+  ss << "extern \"C\" {\n";
+
+  const std::array<std::string, 3> dims{"i", "j", "k"};
+  MemberFunction setupFun("void", "setup_" + wrapperName, ss, 0, onlyDecl);
+  for(const auto& dim : dims) {
+    setupFun.addArg("int " + dim + "size");
+  }
+  for(const auto& dim : dims) {
+    setupFun.addArg("int " + dim + "minus");
+    setupFun.addArg("int " + dim + "plus");
+  }
+  setupFun.finishArgs();
+  if(!onlyDecl) {
+    setupFun.addStatement(c_dgt + "domain dom(isize, jsize, ksize)");
+    setupFun.addStatement("dom.set_halos(iminus, iplus, jminus, jplus, kminus, kplus)");
+    setupFun.addStatement(instanceName + " = std::make_unique<" + fullWrapperName + ">(dom)");
+  }
+  setupFun.commit();
+
+  MemberFunction runFun("void", "run_" + wrapperName, ss, 0, onlyDecl);
+  for(const auto& global : globalsMap) {
+    if(global.second.isConstexpr())
+      continue;
+    if(global.second.getType() == ast::Value::Kind::String) {
+      throw SemanticError(std::string("Raw pointer interface of stencil '") + wrapperName +
+                              "' does not support string globals",
+                          metadata.getFileName(), metadata.getStencilLocation());
+    }
+    runFun.addArg(std::string(ast::Value::typeToString(global.second.getType())) + " " +
+                  global.first);
+  }
+  for(const auto& fieldID : metadata.getAPIFields()) {
+    const std::string name = metadata.getFieldNameFromAccessID(fieldID);
+    runFun.addArg("::dawn::float_type* " + name);
+    for(const auto& dim : dims) {
+      runFun.addArg("int " + name + "_stride_" + dim);
+    }
+  }
+  runFun.finishArgs();
+  if(!onlyDecl) {
+    runFun.addStatement("assert(" + instanceName + " && \"setup_" + wrapperName +
+                        " has not been called\")");
+    for(const auto& global : globalsMap) {
+      if(!global.second.isConstexpr())
+        runFun.addStatement(instanceName + "->set_" + global.first + "(" + global.first + ")");
+    }
+    std::vector<std::string> fieldArgs;
+    for(const auto& fieldID : metadata.getAPIFields()) {
+      const std::string name = metadata.getFieldNameFromAccessID(fieldID);
+      fieldArgs.push_back("raw_field<::dawn::float_type>(" + name + ", " + name + "_stride_i, " +
+                          name + "_stride_j, " + name + "_stride_k)");
+    }
+    runFun.addStatement(instanceName + "->run(" + RangeToString(", ", "", "")(fieldArgs) + ")");
+  }
+  runFun.commit();
+
+  MemberFunction freeFun("void", "free_" + wrapperName, ss, 0, onlyDecl);
+  freeFun.finishArgs();
+  if(!onlyDecl) {
+    freeFun.addStatement(instanceName + ".reset()");
+  }
+  freeFun.commit();
+
+  ss << "}\n";
+}
+
+std::string CXXNaiveCodeGen::generateCHeader() const {
+  std::stringstream ss;
+  ss << "#pragma once\n";
+  ss << "#include \"driver-includes/defs.hpp\"\n";
+
+  for(const auto& nameStencilCtxPair : context_) {
+    generateRawInterface(ss, nameStencilCtxPair.second, "", /*onlyDecl*/ true);
+  }
+
+  return ss.str();
+}
+
+std::string CXXNaiveCodeGen::generateF90Interface(const std::string& moduleName) const {
+  const std::array<std::string, 3> dims{"i", "j", "k"};
+  std::stringstream ss;
+  IndentedStringStream iss(ss);
+
+  FortranInterfaceModuleGen fimGen(iss, moduleName, /*useOpenACC*/ false);
+
+  for(const auto& nameStencilCtxPair : context_) {
+    const auto& stencilInstantiation = nameStencilCtxPair.second;
+    const auto& metadata = stencilInstantiation->getMetaData();
+    const auto& globalsMap = stencilInstantiation->getIIR()->getGlobalVariableMap();
+    const std::string& wrapperName = stencilInstantiation->getName();
+
+    FortranInterfaceAPI setupAPI("setup_" + wrapperName);
+    for(const auto& dim : dims) {
+      setupAPI.addArg(dim + "size", FortranAPI::InterfaceType::INTEGER);
+    }
+    for(const auto& dim : dims) {
+      setupAPI.addArg(dim + "minus", FortranAPI::InterfaceType::INTEGER);
+      setupAPI.addArg(dim + "plus", FortranAPI::InterfaceType::INTEGER);
+    }
+    fimGen.addInterfaceAPI(std::move(setupAPI));
+
+    FortranInterfaceAPI runAPI("run_" + wrapperName);
+    // Fortran arrays are column major, the first dimension is contiguous. The wrapper computes
+    // the strides from the shape of the (assumed-shape) arrays.
+    FortranWrapperAPI runWrapper("wrap_run_" + wrapperName);
+    std::vector<std::string> callArgs;
+    for(const auto& global : globalsMap) {
+      if(global.second.isConstexpr())
+        continue;
+      runAPI.addArg(global.first, globalTypeToFortType(global.second));
+      runWrapper.addArg(global.first, globalTypeToFortType(global.second));
+      callArgs.push_back(global.first);
+    }
+    for(const auto& fieldID : metadata.getAPIFields()) {
+      const std::string name = metadata.getFieldNameFromAccessID(fieldID);
+      const auto mask = getCartesianDimensionMask(metadata.getFieldDimensions(fieldID));
+      const int rank = std::count(mask.begin(), mask.end(), true);
+
+      runAPI.addArg(name, FortranAPI::InterfaceType::DOUBLE, rank);
+      runWrapper.addArg(name, FortranAPI::InterfaceType::DOUBLE, rank);
+      callArgs.push_back(name);
+
+      // masked dimensions are absent in the Fortran array and get a stride of 0
+      std::string stride = "1";
+      int fortranDim = 0;
+      for(int dim = 0; dim < 3; ++dim) {
+        runAPI.addArg(name + "_stride_" + dims[dim], FortranAPI::InterfaceType::INTEGER);
+        callArgs.push_back(mask[dim] ? stride : "0");
+        if(mask[dim]) {
+          const std::string extent = "size(" + name + ", " + std::to_string(++fortranDim) + ")";
+          stride = stride == "1" ? extent : stride + " * " + extent;
+        }
+      }
+    }
+    fimGen.addInterfaceAPI(std::move(runAPI));
+
+    runWrapper.addBodyLine("call run_" + wrapperName + " &");
+    runWrapper.addBodyLine("( &");
+    for(std::size_t i = 0; i < callArgs.size(); ++i) {
+      runWrapper.addBodyLine("   " + callArgs[i] + (i + 1 == callArgs.size() ? " &" : ", &"));
+    }
+    runWrapper.addBodyLine(")");
+    fimGen.addWrapperAPI(std::move(runWrapper));
+
+    fimGen.addInterfaceAPI(FortranInterfaceAPI("free_" + wrapperName));
+  }
+
+  fimGen.commit();
+
+  return iss.str();
+}
+
+void CXXNaiveCodeGen::writeRawInterfaceFiles() const {
+  if(codeGenOptions_.outputCHeader) {
+    fs::path filePath = *codeGenOptions_.outputCHeader;
+    std::ofstream headerFile;
+    headerFile.open(filePath);
+    if(headerFile) {
+      headerFile << generateCHeader();
+      headerFile.close();
+    } else {
+      throw std::runtime_error("Error writing to " + filePath.string() + ": " + strerror(errno));
+    }
+  }
+
+  if(codeGenOptions_.outputFortranInterface) {
+    fs::path filePath = *codeGenOptions_.outputFortranInterface;
+    std::string moduleName = filePath.filename().replace_extension("").string();
+    std::ofstream interfaceFile;
+    interfaceFile.open(filePath);
+    if(interfaceFile) {
+      interfaceFile << generateF90Interface(moduleName);
+      interfaceFile.close();
+    } else {
+      throw std::runtime_error("Error writing to " + filePath.string() + ": " + strerror(errno));
+    }
+  }
+}
+
 std::unique_ptr<TranslationUnit> CXXNaiveCodeGen::generateCode() {
   DAWN_LOG(INFO) << "Starting code generation for GTClang ...";
 
@@ -611,6 +1040,8 @@ std::unique_ptr<TranslationUnit> CXXNaiveCodeGen::generateCode() {
     stencils.emplace(nameStencilCtxPair.first, std::move(code));
   }
 
+  writeRawInterfaceFiles();
+
   std::string globals = generateGlobals(context_, "dawn_generated", "cxxnaive");
 
   std::vector<std::string> ppDefines;
@@ -630,6 +1061,8 @@ std::unique_ptr<TranslationUnit> CXXNaiveCodeGen::generateCode() {
   CodeGen::addMplIfdefs(ppDefines, 30);
   ppDefines.push_back("#include <driver-includes/gridtools_includes.hpp>");
   ppDefines.push_back("using namespace gridtools::dawn;");
+  if(hasFixedDomainSize())
+    ppDefines.push_back("#include <stdexcept>");
   DAWN_LOG(INFO) << "Done generating code";
 
   std::string filename = generateFileName(context_);
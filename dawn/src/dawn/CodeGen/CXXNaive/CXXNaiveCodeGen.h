@@ -18,8 +18,12 @@
 #include "dawn/CodeGen/CodeGenProperties.h"
 #include "dawn/CodeGen/Options.h"
 #include "dawn/IIR/Interval.h"
+#include "dawn/Support/Array.h"
 #include "dawn/Support/IndexRange.h"
+#include <functional>
+#include <optional>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -43,11 +47,68 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 class CXXNaiveCodeGen : public CodeGen {
 public:
   ///@brief constructor
-  CXXNaiveCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint);
+  CXXNaiveCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                  const Array3i& domainSize = {0, 0, 0},
+                  std::optional<std::string> outputCHeader = std::nullopt,
+                  std::optional<std::string> outputFortranInterface = std::nullopt,
+                  bool haloExchange = false);
   virtual ~CXXNaiveCodeGen();
   virtual std::unique_ptr<TranslationUnit> generateCode() override;
 
+  struct CXXNaiveCodeGenOptions {
+    /// Compile-time domain size, a dimension with size 0 is only known at runtime
+    Array3i domainSize;
+    /// Files receiving the C header and the Fortran module of the raw pointer interface
+    std::optional<std::string> outputCHeader;
+    std::optional<std::string> outputFortranInterface;
+    /// Exchange the halos of the fields read by the stencils through a `halo_exchange`
+    bool haloExchange;
+  };
+
 protected:
+  CXXNaiveCodeGenOptions codeGenOptions_;
+
+  /// @brief Emit the loop bounds `iMin`, `iMax`, ... at the beginning of a stencil run method
+  ///
+  /// Dimensions with a domain size known at code generation time are emitted as `constexpr`.
+  void generateLoopBounds(MemberFunction& stencilRunMethod) const;
+
+  /// @brief Whether the size of at least one dimension is known at code generation time
+  bool hasFixedDomainSize() const;
+
+  /// @brief Check that the runtime domain matches the compile-time domain size (if any)
+  ///
+  /// A mismatch throws `std::invalid_argument` when the stencil wrapper is constructed, also in
+  /// release builds, since the fixed loop bounds would otherwise access memory out of bounds.
+  void generateDomainSizeChecks(MemberFunction& stencilWrapperCtr) const;
+
+  /// @brief Whether the raw pointer interface (`setup_`, `run_` and `free_` functions with C
+  /// linkage) is generated
+  bool hasRawInterface() const {
+    return codeGenOptions_.outputCHeader || codeGenOptions_.outputFortranInterface;
+  }
+
+  /// @brief Run method flavours to generate, `true` denotes the overload taking `raw_field`s
+  std::vector<bool> getRunMethodVariants() const;
+
+  /// @brief Generate the `extern "C"` raw pointer interface of a stencil instantiation
+  ///
+  /// The caller's arrays are wrapped into `raw_field`s and updated in place, no data is copied.
+  void generateRawInterface(std::stringstream& ss,
+                            const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+                            const std::string& backendNamespace, bool onlyDecl) const;
+
+  /// @brief Generate the stencil wrapper instance used by the raw pointer interface
+  void generateRawInterfaceInstance(
+      std::stringstream& ss,
+      const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation) const;
+
+  std::string generateCHeader() const;
+  std::string generateF90Interface(const std::string& moduleName) const;
+
+  /// @brief Write the C header and Fortran module if requested by the options
+  void writeRawInterfaceFiles() const;
+
   std::string generateStencilInstantiation(
       const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation);
 
@@ -69,6 +130,20 @@ protected:
                             const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
                             const CodeGenProperties& codeGenProperties) const;
 
+  /// @brief Exchange the halos around the code of a stencil emitted by `generateStencil`
+  ///
+  /// If possible, the stencil is run on the interior while the halos are exchanged and on the
+  /// boundary strips afterwards.
+  void generateHaloExchange(MemberFunction& stencilRunMethod, const HaloExchange& haloExchange,
+                            const iir::StencilMetaInformation& metadata, bool rawFields,
+                            const std::function<void()>& generateStencil) const;
+
+  /// @brief Generate `set_halo_exchange` forwarding the communicator to the stencils
+  void generateStencilWrapperHaloExchange(
+      Class& stencilWrapperClass,
+      const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
+      const CodeGenProperties& codeGenProperties) const;
+
   void
   generateStencilWrapperRun(Class& stencilWrapperClass,
                             const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
@@ -16,6 +16,7 @@
 #include "dawn/AST/GridType.h"
 #include "dawn/AST/Offsets.h"
 #include "dawn/CodeGen/CXXNaive/ASTStencilBody.h"
+#include "dawn/CodeGen/CXXNaive/ASTStencilDesc.h"
 #include "dawn/CodeGen/CXXUtil.h"
 #include "dawn/CodeGen/CodeGenProperties.h"
 #include "dawn/IIR/Extents.h"
@@ -27,6 +28,10 @@
 #include "dawn/Support/Exception.h"
 #include "dawn/Support/Logger.h"
 #include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -35,26 +40,75 @@ namespace codegen {
 namespace cxxopt {
 
 namespace {
+/// Name of the backend in the tuning database
+const std::string tuningBackendName = "c++-opt";
+
+std::string makeParallelPragma(bool isTaskloop, const std::string& clauses) {
+  return "\n#pragma omp " + std::string(isTaskloop ? "taskloop" : "parallel for") + clauses + "\n";
+}
+
 std::string makeLoopImpl(int lowerExtent, int upperExtent, const std::string& dim,
                          const std::string& lower, const std::string& upper,
                          const std::string& comparison, const std::string& increment,
-                         bool isParallel = false, bool isVectorized = false) {
+                         bool isParallel = false, bool isVectorized = false,
+                         bool isTaskloop = false, const std::string& clauses = "") {
   std::string loopCode = "";
-  std::string pragma = "#pragma omp ";
   if(isParallel)
-    loopCode = "\n" + pragma + "parallel for\n";
+    loopCode = makeParallelPragma(isTaskloop, clauses);
   else if(isVectorized)
-    loopCode = pragma + "simd\n";
+    loopCode = "#pragma omp simd\n";
   loopCode += "for(int " + dim + " = " + lower + "+" + std::to_string(lowerExtent) + "; " + dim +
               " " + comparison + " " + upper + "+" + std::to_string(upperExtent) + "; " +
               increment + dim + ")";
   return loopCode;
 }
 
-std::string makeIJLoop(int lowerExtent, int upperExtent, const std::string dom,
-                       const std::string& dim, bool parallelize = false) {
+std::string makeIJLoop(int lowerExtent, int upperExtent, const std::string& dim,
+                       bool vectorize = false) {
   return makeLoopImpl(lowerExtent, upperExtent, dim, dim + "Min", dim + "Max", " <= ", "++", false,
-                      parallelize);
+                      vectorize);
+}
+
+/// Headers of the horizontal loop nest of a stage, from the outermost to the innermost loop.
+///
+/// Tiled dimensions get an outer loop over the tiles, the tile loops enclose the loops over the
+/// points. The innermost loop is vectorized. If `isParallel`, the outermost loop is parallelized
+/// (collapsed with the second one if both are tile loops).
+std::vector<std::string> makeHorizontalLoops(const iir::CartesianExtent& extents,
+                                             const TuningConfiguration& tuning, bool isParallel,
+                                             bool isTaskloop, const std::string& clauses) {
+  const std::array<int, 2> dims = tuning.LoopOrder == "ji" ? std::array<int, 2>{1, 0}
+                                                           : std::array<int, 2>{0, 1};
+  const std::array<std::string, 2> names{"i", "j"};
+  const std::array<int, 2> lowerExtents{extents.iMinus(), extents.jMinus()};
+  const std::array<int, 2> upperExtents{extents.iPlus(), extents.jPlus()};
+
+  std::vector<std::string> tileLoops, pointLoops;
+  for(int dim : dims) {
+    const std::string& name = names[dim];
+    const int tileSize = tuning.TileSize[dim];
+    if(tileSize <= 0) {
+      pointLoops.push_back(makeIJLoop(lowerExtents[dim], upperExtents[dim], name));
+      continue;
+    }
+    const std::string tile = name + "Tile";
+    const std::string upper = name + "Max+" + std::to_string(upperExtents[dim]);
+    const std::string tileEnd = tile + "+" + std::to_string(tileSize - 1);
+    tileLoops.push_back("for(int " + tile + " = " + name + "Min+" +
+                        std::to_string(lowerExtents[dim]) + "; " + tile + " <= " + upper + "; " +
+                        tile + " += " + std::to_string(tileSize) + ")");
+    pointLoops.push_back("for(int " + name + " = " + tile + "; " + name + " <= (" + tileEnd +
+                         " < " + upper + " ? " + tileEnd + " : " + upper + "); ++" + name + ")");
+  }
+
+  std::vector<std::string> loops = tileLoops;
+  loops.insert(loops.end(), pointLoops.begin(), pointLoops.end());
+  loops.back() = "#pragma omp simd\n" + loops.back();
+  if(isParallel)
+    loops.front() = makeParallelPragma(isTaskloop, tileLoops.size() == 2 ? clauses + " collapse(2)"
+                                                                          : clauses) +
+                    loops.front();
+  return loops;
 }
 
 std::string makeIntervalBoundReadable(std::string dim, const iir::Interval& interval,
@@ -81,26 +135,210 @@ std::string makeIntervalBoundExplicit(std::string dim, const iir::Interval& inte
   return dom + "." + dim + "minus() + " + std::to_string(notEnd + interval.offset(bound));
 }
 
-std::string makeKLoop(bool isBackward, iir::Interval const& interval, bool isParallel = false) {
+std::string makeKLoop(bool isBackward, iir::Interval const& interval, bool isParallel = false,
+                      bool isTaskloop = false, const std::string& clauses = "") {
 
   const std::string lower = makeIntervalBoundReadable("k", interval, iir::Interval::Bound::lower);
   const std::string upper = makeIntervalBoundReadable("k", interval, iir::Interval::Bound::upper);
 
-  return isBackward ? makeLoopImpl(0, 0, "k", upper, lower, ">=", "--", isParallel)
-                    : makeLoopImpl(0, 0, "k", lower, upper, "<=", "++", isParallel);
+  return isBackward
+             ? makeLoopImpl(0, 0, "k", upper, lower, ">=", "--", isParallel, false, isTaskloop,
+                            clauses)
+             : makeLoopImpl(0, 0, "k", lower, upper, "<=", "++", isParallel, false, isTaskloop,
+                            clauses);
+}
+
+/// Fields read (`In`) and written (`InOut`) by a task of the generated OpenMP task graph
+struct TaskAccesses {
+  std::set<int> In;
+  std::set<int> InOut;
+};
+
+void addAccess(TaskAccesses& accesses, int accessID, iir::Field::IntendKind intend) {
+  if(intend == iir::Field::IntendKind::Input)
+    accesses.In.insert(accessID);
+  else
+    accesses.InOut.insert(accessID);
+}
+
+/// Accesses of a stencil call in the wrapper run method. Stencil temporaries are private to the
+/// stencil object, the object itself is treated as written by every call of the stencil (its
+/// temporaries can't be shared by two calls running concurrently).
+TaskAccesses getStencilCallAccesses(const iir::StencilInstantiation& stencilInstantiation,
+                                    const std::shared_ptr<ast::StencilCallDeclStmt>& stmt) {
+  const int stencilID = stencilInstantiation.getMetaData().getStencilIDFromStencilCallStmt(stmt);
+  const iir::Stencil& stencil = stencilInstantiation.getIIR()->getStencil(stencilID);
+
+  TaskAccesses accesses;
+  for(const auto& fieldPair : stencil.getFields()) {
+    if(!fieldPair.second.IsTemporary)
+      addAccess(accesses, fieldPair.first, fieldPair.second.field.getIntend());
+  }
+  // negative ids can't clash with access ids
+  accesses.InOut.insert(-1 - stencilID);
+  return accesses;
+}
+
+TaskAccesses getMultiStageAccesses(const iir::MultiStage& multiStage) {
+  TaskAccesses accesses;
+  for(const auto& fieldPair : multiStage.getFields())
+    addAccess(accesses, fieldPair.first, fieldPair.second.getIntend());
+  return accesses;
+}
+
+bool dependsOn(const TaskAccesses& task, const TaskAccesses& predecessor) {
+  auto intersects = [](const std::set<int>& a, const std::set<int>& b) {
+    return std::any_of(a.begin(), a.end(), [&](int id) { return b.count(id); });
+  };
+  return intersects(predecessor.InOut, task.In) || intersects(predecessor.InOut, task.InOut) ||
+         intersects(predecessor.In, task.InOut);
+}
+
+/// A sequence of tasks is serialized if every task (transitively) depends on its predecessor
+bool isSerialized(const std::vector<TaskAccesses>& tasks) {
+  std::vector<std::set<std::size_t>> reachable(tasks.size());
+  for(std::size_t i = 1; i < tasks.size(); ++i) {
+    for(std::size_t j = 0; j < i; ++j) {
+      if(dependsOn(tasks[i], tasks[j])) {
+        reachable[i].insert(j);
+        reachable[i].insert(reachable[j].begin(), reachable[j].end());
+      }
+    }
+    if(!reachable[i].count(i - 1))
+      return false;
+  }
+  return true;
+}
+
+/// Map each accessed field to an element of the dependency token array of the task graph
+std::map<int, int> makeDependencyTokens(const std::vector<TaskAccesses>& tasks) {
+  std::map<int, int> tokens;
+  for(const auto& task : tasks) {
+    for(const auto* ids : {&task.In, &task.InOut})
+      for(int id : *ids)
+        tokens.emplace(id, 0);
+  }
+  int index = 0;
+  for(auto& token : tokens)
+    token.second = index++;
+  return tokens;
+}
+
+std::string makeDependClauses(const TaskAccesses& task, const std::map<int, int>& tokens,
+                              const std::string& tokenArray) {
+  std::string clauses;
+  for(int id : task.In)
+    clauses += " depend(in: " + tokenArray + "[" + std::to_string(tokens.at(id)) + "])";
+  for(int id : task.InOut)
+    clauses += " depend(inout: " + tokenArray + "[" + std::to_string(tokens.at(id)) + "])";
+  return clauses;
+}
+
+/// @brief Check whether the columns of a multistage are computed independently of each other
+bool hasIndependentColumns(const iir::MultiStage& multiStage) {
+  for(const auto& stage : multiStage.getChildren()) {
+    const auto& iterationSpace = stage->getIterationSpace();
+    if(!stage->getExtents().isHorizontalPointwise() ||
+       std::any_of(iterationSpace.cbegin(), iterationSpace.cend(),
+                   [](const auto& p) -> bool { return p.has_value(); }))
+      return false;
+  }
+  return std::all_of(multiStage.getFields().begin(), multiStage.getFields().end(),
+                     [](const std::pair<const int, iir::Field>& fieldPair) {
+                       return fieldPair.second.getExtents().isHorizontalPointwise();
+                     });
+}
+
+/// @brief Check whether `forward` and the following multistage `backward` form a vertical solver
+/// (e.g. the two sweeps of the Thomas algorithm): the backward sweep reads the results of the
+/// forward sweep and every column is computed independently of the others.
+bool isVerticalSolver(const iir::MultiStage& forward, const iir::MultiStage& backward) {
+  if(forward.getLoopOrder() != iir::LoopOrderKind::Forward ||
+     backward.getLoopOrder() != iir::LoopOrderKind::Backward || !hasIndependentColumns(forward) ||
+     !hasIndependentColumns(backward))
+    return false;
+  return std::any_of(backward.getFields().begin(), backward.getFields().end(),
+                     [&](const std::pair<const int, iir::Field>& fieldPair) {
+                       auto it = forward.getFields().find(fieldPair.first);
+                       return it != forward.getFields().end() &&
+                              it->second.getIntend() != iir::Field::IntendKind::Input;
+                     });
+}
+
+/// @brief Levels of a column buffer of a temporary below `kMin` and above `kMax`
+struct ColumnBufferHalo {
+  int Below = 0;
+  int Above = 0;
+};
+
+/// @brief Temporaries of a vertical solver which are kept in column buffers instead of 3D
+/// storages, i.e. the temporaries only accessed by the two sweeps of the solver
+std::map<int, ColumnBufferHalo> getColumnBufferedTemporaries(const iir::Stencil& stencil,
+                                                             const iir::MultiStage& forward,
+                                                             const iir::MultiStage& backward) {
+  // stencil functions get the 3D storages of their arguments
+  if(!stencil.getMetadata().getExprToStencilFunctionInstantiation().empty())
+    return {};
+
+  std::map<int, ColumnBufferHalo> buffered;
+  for(const auto* multiStage : {&forward, &backward}) {
+    // levels outside of the compute domain
+    const iir::Interval interval = multiStage->getEnclosingInterval();
+    const int below = interval.lowerLevel() == ast::Interval::Start ? -interval.lowerOffset() : 0;
+    const int above = interval.upperLevel() == ast::Interval::End ? interval.upperOffset() : 0;
+
+    for(const auto& [accessID, field] : multiStage->getFields()) {
+      if(!stencil.getFields().at(accessID).IsTemporary)
+        continue;
+      const iir::Extent& extent = field.getExtents().verticalExtent();
+      ColumnBufferHalo& halo = buffered[accessID];
+      halo.Below = std::max({halo.Below, below - extent.minus(), 0});
+      halo.Above = std::max({halo.Above, above + extent.plus(), 0});
+    }
+  }
+  for(const auto& multiStage : stencil.getChildren()) {
+    if(multiStage.get() == &forward || multiStage.get() == &backward)
+      continue;
+    for(const auto& fieldPair : multiStage->getFields())
+      buffered.erase(fieldPair.first);
+  }
+  return buffered;
 }
 } // namespace
 
 std::unique_ptr<TranslationUnit>
 run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
         stencilInstantiationMap, const Options& options) {
-  CXXOptCodeGen CG(stencilInstantiationMap, options.MaxHaloSize);
+  const Array3i domainSize{options.DomainSizeI, options.DomainSizeJ, options.DomainSizeK};
+  if(options.LoopOrder != "ij" && options.LoopOrder != "ji")
+    throw std::invalid_argument("Loop order '" + options.LoopOrder + "' not supported");
+  TuningConfiguration tuning;
+  tuning.TileSize = {options.TileSizeI, options.TileSizeJ};
+  tuning.LoopOrder = options.LoopOrder;
+  tuning.KParallel = options.KParallel;
+  tuning.NumThreads = options.NumThreads;
+
+  CXXOptCodeGen CG(
+      stencilInstantiationMap, options.MaxHaloSize, domainSize,
+      options.OutputCHeader == "" ? std::nullopt : std::make_optional(options.OutputCHeader),
+      options.OutputFortranInterface == "" ? std::nullopt
+                                           : std::make_optional(options.OutputFortranInterface),
+      options.TaskParallel, tuning,
+      options.TuningDatabaseFile == "" ? TuningDatabase()
+                                       : TuningDatabase::load(options.TuningDatabaseFile),
+      options.SolverBatchSize);
 
   return CG.generateCode();
 }
 
-CXXOptCodeGen::CXXOptCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint)
-    : CXXNaiveCodeGen(ctx, maxHaloPoint) {}
+CXXOptCodeGen::CXXOptCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                             const Array3i& domainSize, std::optional<std::string> outputCHeader,
+                             std::optional<std::string> outputFortranInterface,
+                             bool taskParallel, const TuningConfiguration& tuning,
+                             TuningDatabase tuningDatabase, int solverBatchSize)
+    : CXXNaiveCodeGen(ctx, maxHaloPoint, domainSize, outputCHeader, outputFortranInterface),
+      taskParallel_(taskParallel), tuning_(tuning), tuningDatabase_(std::move(tuningDatabase)),
+      solverBatchSize_(solverBatchSize) {}
 
 CXXOptCodeGen::~CXXOptCodeGen() {}
 
@@ -122,7 +360,11 @@ std::string CXXOptCodeGen::generateStencilInstantiation(
 
   generateStencilFunctions(stencilWrapperClass, stencilInstantiation, codeGenProperties);
 
-  generateStencilClasses(stencilInstantiation, stencilWrapperClass, codeGenProperties);
+  const bool useTasks = useTaskParallelism(*stencilInstantiation);
+  const TuningConfiguration tuning = getTuningConfiguration(*stencilInstantiation);
+
+  generateStencilClasses(stencilInstantiation, stencilWrapperClass, codeGenProperties, useTasks,
+                         tuning);
 
   generateStencilWrapperMembers(stencilWrapperClass, stencilInstantiation, codeGenProperties);
 
@@ -130,19 +372,27 @@ std::string CXXOptCodeGen::generateStencilInstantiation(
 
   generateGlobalsAPI(stencilWrapperClass, globalsMap, codeGenProperties);
 
-  generateStencilWrapperRun(stencilWrapperClass, stencilInstantiation, codeGenProperties);
+  generateStencilWrapperRun(stencilWrapperClass, stencilInstantiation, codeGenProperties,
+                            useTasks, tuning);
 
   stencilWrapperClass.commit();
 
+  if(hasRawInterface())
+    generateRawInterfaceInstance(ssSW, stencilInstantiation);
+
   cxxoptNamespace.commit();
   dawnNamespace.commit();
 
+  if(hasRawInterface())
+    generateRawInterface(ssSW, stencilInstantiation, "cxxopt", /*onlyDecl*/ false);
+
   return ssSW.str();
 }
 
 void CXXOptCodeGen::generateStencilClasses(
     const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
-    Class& stencilWrapperClass, const CodeGenProperties& codeGenProperties) const {
+    Class& stencilWrapperClass, const CodeGenProperties& codeGenProperties, bool useTasks,
+    const TuningConfiguration& tuning) const {
 
   const auto& stencils = stencilInstantiation->getStencils();
   const auto& globalsMap = stencilInstantiation->getIIR()->getGlobalVariableMap();
@@ -168,9 +418,43 @@ void CXXOptCodeGen::generateStencilClasses(
         makeRange(stencilFields, [](std::pair<int, iir::Stencil::FieldInfo> const& p) {
           return !p.second.IsTemporary;
         });
+
+    // independent multistages are spawned as tasks, ordered by the fields they access
+    std::vector<TaskAccesses> multiStageTasks;
+    for(const auto& multiStagePtr : stencil.getChildren())
+      multiStageTasks.push_back(getMultiStageAccesses(*multiStagePtr));
+    const bool spawnMultiStageTasks = useTasks && !isSerialized(multiStageTasks);
+    const auto multiStageTokens = makeDependencyTokens(multiStageTasks);
+
+    // a forward multistage followed by a backward one without horizontal dependencies is
+    // generated as a vertical solver (except if the multistages are spawned as separate tasks)
+    std::set<const iir::MultiStage*> solverForwards;
+    if(solverBatchSize_ > 0 && !spawnMultiStageTasks) {
+      const auto& multiStages = stencil.getChildren();
+      for(auto it = multiStages.begin();
+          it != multiStages.end() && std::next(it) != multiStages.end(); ++it) {
+        if(isVerticalSolver(**it, **std::next(it))) {
+          DAWN_LOG(INFO) << stencilInstantiation->getName() << ": multistages " << (*it)->getID()
+                         << " and " << (*std::next(it))->getID() << " of stencil "
+                         << stencil.getStencilID() << " form a vertical solver";
+          solverForwards.insert((it++)->get());
+        }
+      }
+    }
+
+    // temporaries kept in the column buffers of a vertical solver get no 3D storage
+    std::set<int> columnBuffered;
+    for(const iir::MultiStage* forward : solverForwards) {
+      const auto& multiStages = stencil.getChildren();
+      auto it = std::find_if(multiStages.begin(), multiStages.end(),
+                             [&](const auto& multiStage) { return multiStage.get() == forward; });
+      for(const auto& bufferedPair : getColumnBufferedTemporaries(stencil, **it, **std::next(it)))
+        columnBuffered.insert(bufferedPair.first);
+    }
+
     auto tempFields =
-        makeRange(stencilFields, [](std::pair<int, iir::Stencil::FieldInfo> const& p) {
-          return p.second.IsTemporary;
+        makeRange(stencilFields, [&](std::pair<int, iir::Stencil::FieldInfo> const& p) {
+          return p.second.IsTemporary && !columnBuffered.count(p.first);
         });
 
     Structure stencilClass = stencilWrapperClass.addStruct(stencilName);
@@ -250,133 +534,361 @@ void CXXOptCodeGen::generateStencilClasses(
     // accumulated extents of API fields
     generateFieldExtentsInfo(stencilClass, nonTempFields, ast::GridType::Cartesian);
 
+    // taskloops run on the threads of the enclosing parallel region
+    const std::string parallelClauses =
+        tuning.NumThreads > 0 && !useTasks ? " num_threads(" + std::to_string(tuning.NumThreads) + ")"
+                                           : "";
+
     //
     // Run-Method
     //
-    MemberFunction stencilRunMethod = stencilClass.addMemberFunction("void", "run", "");
-    for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
-      std::string type = stencilProperties->paramNameToType_.at((*it).second.Name);
-      stencilRunMethod.addArg(type + "& " + (*it).second.Name + "_");
-    }
-
-    stencilRunMethod.startBody();
-    // Compute the loop bounds for readability
-    stencilRunMethod.addStatement("int iMin = m_dom.iminus()");
-    stencilRunMethod.addStatement("int iMax = m_dom.isize() - m_dom.iplus() - 1");
-    stencilRunMethod.addStatement("int jMin = m_dom.jminus()");
-    stencilRunMethod.addStatement("int jMax = m_dom.jsize() - m_dom.jplus() - 1");
-    stencilRunMethod.addStatement("int kMin = m_dom.kminus()");
-    stencilRunMethod.addStatement("int kMax = m_dom.ksize() - m_dom.kplus() - 1");
-
-    for(const auto& fieldPair : nonTempFields) {
-      stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
-    }
-    for(const auto& multiStagePtr : stencil.getChildren()) {
-
-      stencilRunMethod.ss() << "{";
+    // The raw pointer interface needs a second run method operating on `raw_field`s
+    for(bool rawFields : getRunMethodVariants()) {
+      MemberFunction stencilRunMethod = stencilClass.addMemberFunction("void", "run", "");
+      for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
+        if(rawFields) {
+          stencilRunMethod.addArg("raw_field<::dawn::float_type> " + (*it).second.Name);
+        } else {
+          std::string type = stencilProperties->paramNameToType_.at((*it).second.Name);
+          stencilRunMethod.addArg(type + "& " + (*it).second.Name + "_");
+        }
+      }
 
-      const iir::MultiStage& multiStage = *multiStagePtr;
+      stencilRunMethod.startBody();
+      // Compute the loop bounds for readability
+      generateLoopBounds(stencilRunMethod);
 
-      // create all the data views
-      for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
-        const auto fieldName = (*it).second.Name;
-        std::string type = stencilProperties->paramNameToType_.at(fieldName);
-        stencilRunMethod.addStatement(c_gt + "data_view<" + type + "> " + fieldName + "= " +
-                                      c_gt + "make_host_view(" + fieldName + "_)");
-        stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+      for(const auto& fieldPair : nonTempFields) {
+        if(!rawFields)
+          stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
+      }
+      if(spawnMultiStageTasks) {
+        stencilRunMethod.addPreprocessorDirective("pragma omp taskgroup");
+        stencilRunMethod.ss() << "{";
+        stencilRunMethod.addStatement("char taskDeps[" + std::to_string(multiStageTokens.size()) +
+                                      "]");
       }
-      for(const auto& fieldPair : tempFields) {
-        const auto fieldName = fieldPair.second.Name;
-        stencilRunMethod.addStatement(c_gt + "data_view<tmp_storage_t> " + fieldName + "= " +
-                                      c_gt + "make_host_view(m_" + fieldName + ")");
-        stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+      // k-loops of a multistage, the loops of `makeLoops` are nested around each stage
+      auto generateKLoops = [&](const iir::MultiStage& multiStage, bool isKParallel,
+                                const std::function<std::vector<std::string>(
+                                    const iir::CartesianExtent&)>& makeLoops) {
+        auto intervals_set = multiStage.getIntervals();
+        std::vector<iir::Interval> intervals_v;
+        std::copy(intervals_set.begin(), intervals_set.end(), std::back_inserter(intervals_v));
+
+        // compute the partition of the intervals
+        auto partitionIntervals = iir::Interval::computePartition(intervals_v);
+        if((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward))
+          std::reverse(partitionIntervals.begin(), partitionIntervals.end());
+
+        for(auto interval : partitionIntervals) {
+
+          // for each interval, we generate naive nested loops
+          stencilRunMethod.addBlockStatement(
+              makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval,
+                        isKParallel, useTasks, parallelClauses),
+              [&]() {
+                for(const auto& stagePtr : multiStage.getChildren()) {
+                  iir::Stage& stage = *stagePtr;
+
+                  auto const& extents = iir::extent_cast<iir::CartesianExtent const&>(
+                      stage.getExtents().horizontalExtent());
+
+                  // Check if we need to execute this statement:
+                  bool hasOverlappingInterval = false;
+                  for(const auto& doMethodPtr : stage.getChildren()) {
+                    hasOverlappingInterval |= (doMethodPtr->getInterval().overlaps(interval));
+                  }
+
+                  if(hasOverlappingInterval) {
+                    auto doMethodGenerator = [&]() {
+                      // Generate Do-Method
+                      for(const auto& doMethodPtr : stage.getChildren()) {
+                        const iir::DoMethod& doMethod = *doMethodPtr;
+                        if(!doMethod.getInterval().overlaps(interval))
+                          continue;
+                        for(const auto& stmt : doMethod.getAST().getStatements()) {
+                          stmt->accept(stencilBodyCXXVisitor);
+                          stencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
+                        }
+                      }
+                    };
+
+                    auto stageGenerator = [&]() {
+                      const auto& iterationSpace = stage.getIterationSpace();
+                      if(std::any_of(iterationSpace.cbegin(), iterationSpace.cend(),
+                                     [](const auto& p) -> bool { return p.has_value(); })) {
+                        const std::string stageID = std::to_string(stage.getStageID());
+                        std::string conditional = "if(";
+                        if(iterationSpace[0]) {
+                          conditional += "checkOffset(stage" + stageID +
+                                         "GlobalIIndices[0], stage" + stageID +
+                                         "GlobalIIndices[1], globalOffsets[0] + i)";
+                        }
+                        if(iterationSpace[1]) {
+                          if(iterationSpace[0]) {
+                            conditional += " && ";
+                          }
+                          conditional += "checkOffset(stage" + stageID +
+                                         "GlobalJIndices[0], stage" + stageID +
+                                         "GlobalJIndices[1], globalOffsets[1] + j)";
+                        }
+                        conditional += ")";
+                        stencilRunMethod.addBlockStatement(conditional, doMethodGenerator);
+                      } else {
+                        doMethodGenerator();
+                      }
+                    };
+
+                    // nest the horizontal loops around the stage
+                    const auto loops = makeLoops(extents);
+                    std::function<void(std::size_t)> generateLoops = [&](std::size_t level) {
+                      if(level == loops.size())
+                        stageGenerator();
+                      else
+                        stencilRunMethod.addBlockStatement(loops[level],
+                                                           [&]() { generateLoops(level + 1); });
+                    };
+                    generateLoops(0);
+                  }
+                }
+              });
+        }
+      };
+
+      // Vertical solvers compute both sweeps for a batch of adjacent columns before moving on to
+      // the next batch. The statements of a stage are vectorized over the columns of the batch,
+      // temporaries only used by the solver are kept in buffers of the batch instead of 3D
+      // storages.
+      auto generateVerticalSolver = [&](const iir::MultiStage& forward,
+                                        const iir::MultiStage& backward) {
+        const std::string batchSize = std::to_string(solverBatchSize_);
+        const auto buffered = getColumnBufferedTemporaries(stencil, forward, backward);
+        auto levels = [](const ColumnBufferHalo& halo) {
+          return "(kMax - kMin + " + std::to_string(1 + halo.Below + halo.Above) + ")";
+        };
+
+        stencilRunMethod.ss() << makeParallelPragma(useTasks, parallelClauses);
+        stencilRunMethod.addBlockStatement("for(int j = jMin+0; j <= jMax+0; ++j)", [&]() {
+          // the buffers are allocated once per thread (also for taskloops) instead of per row,
+          // resizing them to the same size is a no-op
+          for(const auto& [accessID, halo] : buffered) {
+            const std::string buffer = stencil.getFields().at(accessID).Name + "_buffer";
+            stencilRunMethod.addStatement("thread_local std::vector<::dawn::float_type> " + buffer);
+            stencilRunMethod.addStatement(buffer + ".resize(" + batchSize + " * " + levels(halo) +
+                                          ")");
+          }
+          stencilRunMethod.addBlockStatement(
+              "for(int iBatch = iMin+0; iBatch <= iMax+0; iBatch += " + batchSize + ")", [&]() {
+                const std::string last = "iBatch+" + std::to_string(solverBatchSize_ - 1);
+                stencilRunMethod.addStatement("const int iEnd = (" + last + " < iMax+0 ? " + last +
+                                              " : iMax+0)");
+                // the buffers are accessed like the storages they replace
+                for(const auto& [accessID, halo] : buffered) {
+                  const std::string& name = stencil.getFields().at(accessID).Name;
+                  stencilRunMethod.addStatement(
+                      "auto " + name +
+                      " = [&](int i, int, int k) -> ::dawn::float_type& { return " + name +
+                      "_buffer[(k - kMin + " + std::to_string(halo.Below) + ") * " + batchSize +
+                      " + i - iBatch]; }");
+                }
+                auto makeBatchLoop = [](const iir::CartesianExtent&) {
+                  return std::vector<std::string>{
+                      "#pragma omp simd\nfor(int i = iBatch; i <= iEnd; ++i)"};
+                };
+                generateKLoops(forward, false, makeBatchLoop);
+                generateKLoops(backward, false, makeBatchLoop);
+              });
+        });
+      };
+
+      std::size_t multiStageIdx = 0;
+      const iir::MultiStage* solverForward = nullptr;
+      for(const auto& multiStagePtr : stencil.getChildren()) {
+        // the forward sweep of a vertical solver is generated with the backward sweep
+        if(solverForwards.count(multiStagePtr.get())) {
+          solverForward = multiStagePtr.get();
+          ++multiStageIdx;
+          continue;
+        }
+
+        if(spawnMultiStageTasks)
+          stencilRunMethod.ss() << "\n#pragma omp task default(shared)"
+                                << makeDependClauses(multiStageTasks[multiStageIdx],
+                                                     multiStageTokens, "taskDeps")
+                                << "\n";
+        stencilRunMethod.ss() << "{";
+
+        const iir::MultiStage& multiStage = *multiStagePtr;
+        ++multiStageIdx;
+
+        // create all the data views, raw fields are accessed directly
+        for(auto it = nonTempFields.begin(); it != nonTempFields.end(); ++it) {
+          const auto fieldName = (*it).second.Name;
+          if(!rawFields) {
+            std::string type = stencilProperties->paramNameToType_.at(fieldName);
+            stencilRunMethod.addStatement(c_gt + "data_view<" + type + "> " + fieldName + "= " +
+                                          c_gt + "make_host_view(" + fieldName + "_)");
+          }
+          stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+        }
+        for(const auto& fieldPair : tempFields) {
+          const auto fieldName = fieldPair.second.Name;
+          stencilRunMethod.addStatement(c_gt + "data_view<tmp_storage_t> " + fieldName + "= " +
+                                        c_gt + "make_host_view(m_" + fieldName + ")");
+          stencilRunMethod.addStatement("std::array<int,3> " + fieldName + "_offsets{0,0,0}");
+        }
+
+        if(solverForward) {
+          generateVerticalSolver(*solverForward, multiStage);
+          solverForward = nullptr;
+        } else {
+          // parallel multistages are parallelized in k if requested, everything else over the
+          // horizontal loops if k is iterated sequentially
+          const bool isKParallel =
+              multiStage.getLoopOrder() == iir::LoopOrderKind::Parallel && tuning.KParallel;
+          const bool isHorizontalParallel = !tuning.KParallel;
+          generateKLoops(multiStage, isKParallel, [&](const iir::CartesianExtent& extents) {
+            return makeHorizontalLoops(extents, tuning, isHorizontalParallel, useTasks,
+                                       parallelClauses);
+          });
+        }
+        stencilRunMethod.ss() << "}";
       }
+      if(spawnMultiStageTasks)
+        stencilRunMethod.ss() << "}";
+      for(const auto& fieldPair : nonTempFields) {
+        if(!rawFields)
+          stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
+      }
+      stencilRunMethod.commit();
+    }
+  }
+}
 
-      auto intervals_set = multiStage.getIntervals();
-      std::vector<iir::Interval> intervals_v;
-      std::copy(intervals_set.begin(), intervals_set.end(), std::back_inserter(intervals_v));
+bool CXXOptCodeGen::useTaskParallelism(
+    const iir::StencilInstantiation& stencilInstantiation) const {
+  if(!taskParallel_)
+    return false;
+
+  const auto& metadata = stencilInstantiation.getMetaData();
+  const auto& statements =
+      stencilInstantiation.getIIR()->getControlFlowDescriptor().getStatements();
+
+  std::vector<TaskAccesses> stencilCallTasks;
+  for(const auto& statement : statements) {
+    auto stencilCall = std::dynamic_pointer_cast<ast::StencilCallDeclStmt>(statement);
+    if(!stencilCall) {
+      DAWN_DIAG(INFO, metadata.getFileName(), metadata.getStencilLocation())
+          << stencilInstantiation.getName()
+          << ": task parallel execution requires a sequence of stencil calls, falling back to "
+             "serial execution";
+      return false;
+    }
+    stencilCallTasks.push_back(getStencilCallAccesses(stencilInstantiation, stencilCall));
+  }
 
-      // compute the partition of the intervals
-      auto partitionIntervals = iir::Interval::computePartition(intervals_v);
-      if((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward))
-        std::reverse(partitionIntervals.begin(), partitionIntervals.end());
+  bool hasIndependentTasks = false;
+  if(stencilCallTasks.size() > 1) {
+    if(isSerialized(stencilCallTasks))
+      DAWN_DIAG(INFO, metadata.getFileName(), metadata.getStencilLocation())
+          << stencilInstantiation.getName() << ": stencil calls serialized by data dependencies";
+    else
+      hasIndependentTasks = true;
+  }
+  for(const auto& stencil : stencilInstantiation.getStencils()) {
+    if(stencil->getChildren().size() < 2)
+      continue;
+    std::vector<TaskAccesses> multiStageTasks;
+    for(const auto& multiStagePtr : stencil->getChildren())
+      multiStageTasks.push_back(getMultiStageAccesses(*multiStagePtr));
+    if(isSerialized(multiStageTasks))
+      DAWN_DIAG(INFO, metadata.getFileName(), metadata.getStencilLocation())
+          << stencilInstantiation.getName() << ": multistages of stencil "
+          << stencil->getStencilID() << " serialized by data dependencies";
+    else
+      hasIndependentTasks = true;
+  }
 
-      for(auto interval : partitionIntervals) {
+  if(!hasIndependentTasks)
+    DAWN_DIAG(INFO, metadata.getFileName(), metadata.getStencilLocation())
+        << stencilInstantiation.getName()
+        << ": no independent stencils or multistages, falling back to serial execution";
+  return hasIndependentTasks;
+}
 
-        // for each interval, we generate naive nested loops
-        stencilRunMethod.addBlockStatement(
-            makeKLoop((multiStage.getLoopOrder() == iir::LoopOrderKind::Backward), interval,
-                      (multiStage.getLoopOrder() == iir::LoopOrderKind::Parallel)),
-            [&]() {
-              for(const auto& stagePtr : multiStage.getChildren()) {
-                iir::Stage& stage = *stagePtr;
+TuningConfiguration
+CXXOptCodeGen::getTuningConfiguration(const iir::StencilInstantiation& stencilInstantiation) const {
+  const auto* record = tuningDatabase_.lookup(tuningBackendName, stencilInstantiation.getName(),
+                                              codeGenOptions_.domainSize);
+  if(!record)
+    return tuning_;
+
+  const TuningConfiguration& config = record->Configuration;
+  DAWN_LOG(INFO) << stencilInstantiation.getName() << ": tuned for domain size "
+                 << record->DomainSize << ", tiles [" << config.TileSize[0] << ","
+                 << config.TileSize[1] << "], loop order " << config.LoopOrder
+                 << (config.KParallel ? ", k-parallel" : ", k-sequential") << ", "
+                 << config.NumThreads << " threads";
+  return config;
+}
 
-                auto const& extents = iir::extent_cast<iir::CartesianExtent const&>(
-                    stage.getExtents().horizontalExtent());
+void CXXOptCodeGen::generateStencilWrapperRun(
+    Class& stencilWrapperClass,
+    const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
+    const CodeGenProperties& codeGenProperties, bool useTasks,
+    const TuningConfiguration& tuning) const {
+  if(!useTasks) {
+    CXXNaiveCodeGen::generateStencilWrapperRun(stencilWrapperClass, stencilInstantiation,
+                                               codeGenProperties);
+    return;
+  }
 
-                // Check if we need to execute this statement:
-                bool hasOverlappingInterval = false;
-                for(const auto& doMethodPtr : stage.getChildren()) {
-                  hasOverlappingInterval |= (doMethodPtr->getInterval().overlaps(interval));
-                }
+  const auto& metadata = stencilInstantiation->getMetaData();
+  const auto& statements =
+      stencilInstantiation->getIIR()->getControlFlowDescriptor().getStatements();
+
+  // useTaskParallelism guarantees the control flow to be a sequence of stencil calls
+  std::vector<TaskAccesses> stencilCallTasks;
+  for(const auto& statement : statements)
+    stencilCallTasks.push_back(getStencilCallAccesses(
+        *stencilInstantiation, std::static_pointer_cast<ast::StencilCallDeclStmt>(statement)));
+  const auto tokens = makeDependencyTokens(stencilCallTasks);
+
+  for(bool rawFields : getRunMethodVariants()) {
+    MemberFunction runMethod = stencilWrapperClass.addMemberFunction("void", "run", "");
+
+    for(const auto& fieldID : metadata.getAPIFields()) {
+      std::string name = metadata.getFieldNameFromAccessID(fieldID);
+      runMethod.addArg((rawFields ? "raw_field<::dawn::float_type>"
+                                  : codeGenProperties.getParamType(stencilInstantiation, name)) +
+                       " " + name);
+    }
 
-                if(hasOverlappingInterval) {
-                  auto doMethodGenerator = [&]() {
-                    // Generate Do-Method
-                    for(const auto& doMethodPtr : stage.getChildren()) {
-                      const iir::DoMethod& doMethod = *doMethodPtr;
-                      if(!doMethod.getInterval().overlaps(interval))
-                        continue;
-                      for(const auto& stmt : doMethod.getAST().getStatements()) {
-                        stmt->accept(stencilBodyCXXVisitor);
-                        stencilRunMethod << stencilBodyCXXVisitor.getCodeAndResetStream();
-                      }
-                    }
-                  };
-
-                  stencilRunMethod.addBlockStatement(
-                      makeIJLoop(extents.iMinus(), extents.iPlus(), "m_dom", "i"), [&]() {
-                        stencilRunMethod.addBlockStatement(
-                            makeIJLoop(extents.jMinus(), extents.jPlus(), "m_dom", "j", true),
-                            [&] {
-                              if(std::any_of(stage.getIterationSpace().cbegin(),
-                                             stage.getIterationSpace().cend(),
-                                             [](const auto& p) -> bool { return p.has_value(); })) {
-                                std::string conditional = "if(";
-                                if(stage.getIterationSpace()[0]) {
-                                  conditional += "checkOffset(stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalIIndices[0], stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalIIndices[1], globalOffsets[0] + i)";
-                                }
-                                if(stage.getIterationSpace()[1]) {
-                                  if(stage.getIterationSpace()[0]) {
-                                    conditional += " && ";
-                                  }
-                                  conditional += "checkOffset(stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalJIndices[0], stage" +
-                                                 std::to_string(stage.getStageID()) +
-                                                 "GlobalJIndices[1], globalOffsets[1] + j)";
-                                }
-                                conditional += ")";
-                                stencilRunMethod.addBlockStatement(conditional, doMethodGenerator);
-                              } else {
-                                doMethodGenerator();
-                              }
-                            });
-                      });
-                }
-              }
-            });
+    runMethod.finishArgs();
+
+    // every stencil call is a task, the stencils spawn the tasks of their multistages
+    ASTStencilDesc stencilDescCGVisitor(stencilInstantiation, codeGenProperties, rawFields);
+    stencilDescCGVisitor.setIndent(runMethod.getIndent());
+    runMethod.addPreprocessorDirective(
+        "pragma omp parallel" +
+        (tuning.NumThreads > 0 ? " num_threads(" + std::to_string(tuning.NumThreads) + ")" : ""));
+    runMethod.addPreprocessorDirective("pragma omp single");
+    runMethod.addBlockStatement("", [&]() {
+      runMethod.addStatement("char taskDeps[" + std::to_string(tokens.size()) + "]");
+      for(std::size_t i = 0; i < statements.size(); ++i) {
+        statements[i]->accept(stencilDescCGVisitor);
+        auto str = stencilDescCGVisitor.getCodeAndResetStream();
+        if(str.back() == ';')
+          str.pop_back();
+        runMethod.addPreprocessorDirective("pragma omp task default(shared)" +
+                                           makeDependClauses(stencilCallTasks[i], tokens,
+                                                             "taskDeps"));
+        runMethod.addStatement(str);
       }
-      stencilRunMethod.ss() << "}";
-    }
-    for(const auto& fieldPair : nonTempFields) {
-      stencilRunMethod.addStatement(fieldPair.second.Name + "_" + ".sync()");
-    }
-    stencilRunMethod.commit();
+    });
+
+    runMethod.commit();
   }
 }
 
@@ -392,6 +904,8 @@ std::unique_ptr<TranslationUnit> CXXOptCodeGen::generateCode() {
     stencils.emplace(nameStencilCtxPair.first, std::move(code));
   }
 
+  writeRawInterfaceFiles();
+
   std::string globals = generateGlobals(context_, "dawn_generated", "cxxopt");
 
   std::vector<std::string> ppDefines;
@@ -407,6 +921,8 @@ std::unique_ptr<TranslationUnit> CXXOptCodeGen::generateCode() {
   ppDefines.push_back("#include <driver-includes/gridtools_includes.hpp>");
   ppDefines.push_back("using namespace gridtools::dawn;");
   ppDefines.push_back("#include <omp.h>");
+  if(hasFixedDomainSize())
+    ppDefines.push_back("#include <stdexcept>");
   DAWN_LOG(INFO) << "Done generating code";
 
   std::string filename = generateFileName(context_);
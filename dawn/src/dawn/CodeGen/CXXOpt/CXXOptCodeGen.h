@@ -20,6 +20,7 @@
 #include "dawn/CodeGen/CXXNaive/CXXNaiveCodeGen.h"
 #include "dawn/IIR/Interval.h"
 #include "dawn/Support/IndexRange.h"
+#include "dawn/Support/TuningDatabase.h"
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -45,7 +46,12 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 class CXXOptCodeGen : public CXXNaiveCodeGen {
 public:
   ///@brief constructor
-  CXXOptCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint);
+  CXXOptCodeGen(const StencilInstantiationContext& ctx, int maxHaloPoint,
+                const Array3i& domainSize = {0, 0, 0},
+                std::optional<std::string> outputCHeader = std::nullopt,
+                std::optional<std::string> outputFortranInterface = std::nullopt,
+                bool taskParallel = false, const TuningConfiguration& tuning = {},
+                TuningDatabase tuningDatabase = {}, int solverBatchSize = 0);
   virtual ~CXXOptCodeGen();
   virtual std::unique_ptr<TranslationUnit> generateCode() override;
 
@@ -55,7 +61,31 @@ private:
 
   void generateStencilClasses(const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
                               Class& stencilWrapperClass,
-                              const CodeGenProperties& codeGenProperties) const;
+                              const CodeGenProperties& codeGenProperties, bool useTasks,
+                              const TuningConfiguration& tuning) const;
+
+  /// @brief Generate the wrapper run methods, spawning one OpenMP task per stencil call if
+  /// `useTasks` is set
+  void
+  generateStencilWrapperRun(Class& stencilWrapperClass,
+                            const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
+                            const CodeGenProperties& codeGenProperties, bool useTasks,
+                            const TuningConfiguration& tuning) const;
+
+  /// @brief Tile sizes, loop order, k-parallelism and thread count of the instantiation, taken
+  /// from the tuning database if the stencil was tuned and from the options otherwise
+  TuningConfiguration
+  getTuningConfiguration(const iir::StencilInstantiation& stencilInstantiation) const;
+
+  /// @brief Check whether the stencils and multistages of the instantiation are executed as a
+  /// graph of OpenMP tasks. Reports (as info diagnostics) where the execution is serialized.
+  bool useTaskParallelism(const iir::StencilInstantiation& stencilInstantiation) const;
+
+  bool taskParallel_;
+  TuningConfiguration tuning_;
+  TuningDatabase tuningDatabase_;
+  /// Number of columns computed together by vertical solvers (0 disables the solver schedule)
+  int solverBatchSize_;
 };
 } // namespace cxxopt
 } // namespace codegen
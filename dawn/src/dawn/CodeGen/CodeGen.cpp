@@ -15,7 +15,10 @@
 #include "dawn/CodeGen/CodeGen.h"
 #include "dawn/CodeGen/StencilFunctionAsBCGenerator.h"
 #include "dawn/IIR/Extents.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include <algorithm>
 #include <optional>
+#include <set>
 
 namespace dawn {
 namespace codegen {
@@ -521,5 +524,92 @@ void CodeGen::generateFieldExtentsInfo(
   }
 }
 
+void CodeGen::generateFieldAccessCounts(
+    Class& stencilWrapperClass, const iir::StencilInstantiation& stencilInstantiation) const {
+  int numFieldsRead = 0;
+  int numFieldsWritten = 0;
+  for(const auto& stencil : stencilInstantiation.getStencils()) {
+    for(const auto& [accessID, fieldInfo] : stencil->getFields()) {
+      if(fieldInfo.IsTemporary)
+        continue;
+      const auto intend = fieldInfo.field.getIntend();
+      if(intend != iir::Field::IntendKind::Output)
+        ++numFieldsRead;
+      if(intend != iir::Field::IntendKind::Input)
+        ++numFieldsWritten;
+    }
+  }
+  stencilWrapperClass.addMember("static constexpr int s_fields_read =",
+                                std::to_string(numFieldsRead));
+  stencilWrapperClass.addMember("static constexpr int s_fields_written =",
+                                std::to_string(numFieldsWritten));
+}
+
+CodeGen::HaloExchange CodeGen::computeHaloExchange(const iir::Stencil& stencil) {
+  HaloExchange exchange;
+  std::vector<const iir::Stage*> stages;
+  for(const auto& stage : iterateIIROver<iir::Stage>(stencil))
+    stages.push_back(stage.get());
+
+  auto isWrittenBy = [](const iir::Stage* stage, int accessID) {
+    return stage->getFields().count(accessID) &&
+           stage->getFields().at(accessID).getIntend() != iir::Field::IntendKind::Input;
+  };
+
+  std::set<int> writtenFields;
+  for(std::size_t stageIdx = 0; stageIdx < stages.size(); ++stageIdx) {
+    const iir::Stage* stage = stages[stageIdx];
+    const bool isExtended = !stage->getExtents().isHorizontalPointwise();
+
+    for(const auto& [accessID, field] : stage->getFields()) {
+      const bool isRead = field.getIntend() != iir::Field::IntendKind::Output;
+      const bool isReadOffCenter =
+          isRead && field.getReadExtents() && !field.getReadExtents()->isHorizontalPointwise();
+
+      // Points computed by the interior and a boundary strip, or read by a strip from the
+      // interior, need to see the same values, i.e. the fields read there may not be updated by
+      // this or a later stage and the fields written there may not be updated by other stages
+      if(isRead && (isExtended || isReadOffCenter))
+        for(std::size_t idx = stageIdx; idx < stages.size(); ++idx)
+          exchange.CanOverlap &= !isWrittenBy(stages[idx], accessID);
+      if(isExtended && field.getIntend() != iir::Field::IntendKind::Input)
+        for(std::size_t idx = 0; idx < stages.size(); ++idx)
+          exchange.CanOverlap &= idx == stageIdx || !isWrittenBy(stages[idx], accessID);
+
+      const auto& fieldInfo = stencil.getFields().at(accessID);
+      const auto& readExtents = fieldInfo.field.getReadExtentsRB();
+      if(!isRead || fieldInfo.IsTemporary || writtenFields.count(accessID) || !readExtents ||
+         readExtents->isHorizontalPointwise() ||
+         std::any_of(exchange.Fields.begin(), exchange.Fields.end(),
+                     [&](const auto& pair) { return pair.first == accessID; }))
+        continue;
+
+      // Fields without horizontal dimensions are the same on all subdomains
+      const auto& dimensions = fieldInfo.field.getFieldDimensions();
+      if(dimensions.isVertical())
+        continue;
+      const auto& horizontal = ast::dimension_cast<const ast::CartesianFieldDimension&>(
+          dimensions.getHorizontalFieldDimension());
+      const auto& hExtents =
+          iir::extent_cast<iir::CartesianExtent const&>(readExtents->horizontalExtent());
+      const std::array<int, 4> width{
+          horizontal.I() ? std::max(0, -hExtents.iMinus()) : 0,
+          horizontal.I() ? std::max(0, hExtents.iPlus()) : 0,
+          horizontal.J() ? std::max(0, -hExtents.jMinus()) : 0,
+          horizontal.J() ? std::max(0, hExtents.jPlus()) : 0};
+      if(width == std::array<int, 4>{0, 0, 0, 0})
+        continue;
+      exchange.Fields.emplace_back(accessID, width);
+      for(int dim = 0; dim < 4; ++dim)
+        exchange.Width[dim] = std::max(exchange.Width[dim], width[dim]);
+    }
+
+    for(const auto& [accessID, field] : stage->getFields())
+      if(field.getIntend() != iir::Field::IntendKind::Input)
+        writtenFields.insert(accessID);
+  }
+  return exchange;
+}
+
 } // namespace codegen
 } // namespace dawn
@@ -69,6 +69,27 @@ protected:
                            IndexRange<const std::map<int, iir::Stencil::FieldInfo>>& nonTempFields,
                            ast::GridType const& gridType) const;
 
+  /// @brief Declares the number of non-temporary fields read and written by all stencils of the
+  /// instantiation (per grid point), used to compute the effective memory bandwidth of a run
+  void generateFieldAccessCounts(Class& stencilWrapperClass,
+                                 const iir::StencilInstantiation& stencilInstantiation) const;
+
+  /// @brief Halo exchanges of a stencil running on a domain decomposed grid
+  struct HaloExchange {
+    /// Non-temporary fields whose halos are read before the stencil writes them, with the halo
+    /// widths {iminus, iplus, jminus, jplus} given by their read extents (including the extents
+    /// of the reading stages)
+    std::vector<std::pair<int, std::array<int, 4>>> Fields;
+    /// Maximal widths over all fields, the compute domain shrunk by them does not depend on halos
+    std::array<int, 4> Width{0, 0, 0, 0};
+    /// Whether the stencil can be run on the interior and the boundary strips one after the
+    /// other, i.e. the points computed by both (due to stage extents) get the same values
+    bool CanOverlap = true;
+  };
+
+  /// @brief Derive the halo exchanges of a cartesian stencil from its field extents
+  static HaloExchange computeHaloExchange(const iir::Stencil& stencil);
+
   const std::string tmpStorageTypename_ = "tmp_storage_t";
   const std::string tmpMetadataTypename_ = "tmp_meta_data_t";
   const std::string tmpMetadataName_ = "m_tmp_meta_data";
@@ -696,6 +696,8 @@ void CudaCodeGen::addTmpStorageInit(
 std::unique_ptr<TranslationUnit> CudaCodeGen::generateCode() {
   DAWN_LOG(INFO) << "Starting code generation for GTClang ...";
 
+  MSCodeGen::clearGlobalNames();
+
   // Generate code for StencilInstantiations
   std::map<std::string, std::string> stencils;
   for(const auto& nameStencilCtxPair : context_) {
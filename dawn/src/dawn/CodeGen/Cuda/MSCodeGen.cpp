@@ -28,7 +28,7 @@ namespace dawn {
 namespace codegen {
 namespace cuda {
 
-std::unordered_set<std::string> MSCodeGen::globalNames_;
+thread_local std::unordered_set<std::string> MSCodeGen::globalNames_;
 
 MSCodeGen::MSCodeGen(std::stringstream& ss, const std::unique_ptr<iir::MultiStage>& ms,
                      const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
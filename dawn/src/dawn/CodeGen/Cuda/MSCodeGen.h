@@ -58,7 +58,9 @@ private:
   const bool solveKLoopInParallel_;
   CudaCodeGen::CudaCodeGenOptions options_;
   bool iterationSpaceSet_;
-  static std::unordered_set<std::string> globalNames_;
+  // names of the global declarations already emitted into the current translation unit, kept per
+  // thread such that concurrent code generations do not interfere
+  static thread_local std::unordered_set<std::string> globalNames_;
 
 public:
   MSCodeGen(std::stringstream& ss, const std::unique_ptr<iir::MultiStage>& ms,
@@ -68,6 +70,9 @@ public:
 
   void generateCudaKernelCode();
 
+  /// @brief Forget the global declarations emitted so far (called for every new translation unit)
+  static void clearGlobalNames() { globalNames_.clear(); }
+
 private:
   std::vector<std::string> generateStrideArguments(
       const IndexRange<const std::unordered_map<int, iir::Field>>& nonTempFields,
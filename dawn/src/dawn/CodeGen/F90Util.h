@@ -133,12 +133,14 @@ protected:
 
   virtual void streamArgsDecls(IndentedStringStream& ss) const = 0;
 
-  void streamAPI(IndentedStringStream& ss) const {
+  void streamAPI(IndentedStringStream& ss, bool useOpenACC = true) const {
     streamAPISignature(ss);
 
     ss.increaseIndent();
     ss << "use, intrinsic :: iso_c_binding" << endline;
-    ss << "use openacc" << endline;
+    if(useOpenACC) {
+      ss << "use openacc" << endline;
+    }
     streamArgsDecls(ss);
   }
 
@@ -230,8 +232,10 @@ protected:
 
 class FortranInterfaceModuleGen {
 public:
-  FortranInterfaceModuleGen(IndentedStringStream& ss, std::string moduleName)
-      : moduleName_(moduleName), ss_(ss) {}
+  /// `useOpenACC` controls whether the APIs import the openacc module (not needed for CPU code)
+  FortranInterfaceModuleGen(IndentedStringStream& ss, std::string moduleName,
+                            bool useOpenACC = true)
+      : moduleName_(moduleName), ss_(ss), useOpenACC_(useOpenACC) {}
 
   void addInterfaceAPI(const FortranInterfaceAPI& api) { interfaces_.push_back(api); }
   void addInterfaceAPI(FortranInterfaceAPI&& api) { interfaces_.push_back(std::move(api)); }
@@ -248,7 +252,7 @@ public:
     ss_.increaseIndent();
 
     for(auto& interface : interfaces_) {
-      interface.streamAPI(ss_);
+      interface.streamAPI(ss_, useOpenACC_);
       interface.streamFooter(ss_);
     }
 
@@ -258,7 +262,7 @@ public:
       ss_ << "contains" << endline;
       ss_.increaseIndent();
       for(auto& wrapper : wrappers_) {
-        wrapper.streamAPI(ss_);
+        wrapper.streamAPI(ss_, useOpenACC_);
         wrapper.streamStatements(ss_);
         wrapper.streamFooter(ss_);
       }
@@ -272,6 +276,7 @@ public:
 protected:
   std::string moduleName_;
   IndentedStringStream& ss_;
+  bool useOpenACC_;
   std::vector<FortranInterfaceAPI> interfaces_;
   std::vector<FortranWrapperAPI> wrappers_;
 };
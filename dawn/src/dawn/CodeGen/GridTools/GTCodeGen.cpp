@@ -480,6 +480,7 @@ void GTCodeGen::generateStencilWrapperMembers(
 
   stencilWrapperClass.addMember("static constexpr const char* s_name =",
                                 "\"" + stencilWrapperClass.getName() + "\"");
+  generateFieldAccessCounts(stencilWrapperClass, *stencilInstantiation);
 
   // globals member
   if(!globalsMap.empty()) {
@@ -262,4 +262,19 @@ int ICOChainSize(const ast::NeighborChain& chain) {
     return previous_locations.size();
   }
 }
+
+int ICOChainSize(const ast::NeighborChain& chain, bool includeCenter) {
+  return ICOChainSize(chain) + (includeCenter ? 1 : 0);
+}
+
+int ICOValuesPerElement(const ast::FieldDimensions& dimensions) {
+  if(dimensions.isVertical() || !ast::dimension_isa<ast::UnstructuredFieldDimension>(
+                                    dimensions.getHorizontalFieldDimension()))
+    return 1;
+  const auto& dimension = ast::dimension_cast<const ast::UnstructuredFieldDimension&>(
+      dimensions.getHorizontalFieldDimension());
+  return dimension.isSparse()
+             ? ICOChainSize(dimension.getNeighborChain(), dimension.getIncludeCenter())
+             : 1;
+}
 } // namespace dawn
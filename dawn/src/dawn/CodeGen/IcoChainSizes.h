@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "dawn/AST/FieldDimension.h"
 #include "dawn/AST/LocationType.h"
 #include <map>
 
@@ -21,4 +22,12 @@ namespace dawn {
 
 int ICOChainSize(const ast::NeighborChain& chain);
 
+/// @brief Number of distinct neighbors of a chain on an icosahedral mesh, plus one for the center
+/// if it is included
+int ICOChainSize(const ast::NeighborChain& chain, bool includeCenter);
+
+/// @brief Number of values of a field per horizontal element and level on an icosahedral mesh
+/// (the size of the sparse dimension for sparse fields, 1 otherwise)
+int ICOValuesPerElement(const ast::FieldDimensions& dimensions);
+
 } // namespace dawn
\ No newline at end of file
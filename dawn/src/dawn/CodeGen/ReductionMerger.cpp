@@ -0,0 +1,162 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/CodeGen/ReductionMerger.h"
+#include "dawn/AST/ASTVisitor.h"
+#include "dawn/IIR/AST.h"
+#include "dawn/IIR/ASTExpr.h"
+#include "dawn/IIR/ASTStmt.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+
+#include <optional>
+#include <set>
+
+namespace dawn {
+namespace codegen {
+
+namespace {
+
+/// Collects the outermost reductions of a statement (without descending into their operands)
+class FindTopLevelReductions : public ast::ASTVisitorForwardingNonConst {
+  ReductionMergeGroup reductions_;
+
+public:
+  void visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) override {
+    reductions_.push_back(expr);
+  }
+  const ReductionMergeGroup& getReductions() const { return reductions_; }
+};
+
+/// Collects the AccessIDs of all fields and variables read by an expression
+class FindReadSet : public ast::ASTVisitorForwardingNonConst {
+  std::set<int> readSet_;
+
+public:
+  void visit(const std::shared_ptr<ast::FieldAccessExpr>& expr) override {
+    readSet_.insert(iir::getAccessID(expr));
+    for(auto& s : expr->getChildren()) {
+      s->accept(*this);
+    }
+  }
+  void visit(const std::shared_ptr<ast::VarAccessExpr>& expr) override {
+    readSet_.insert(iir::getAccessID(expr));
+    ast::ASTVisitorForwardingNonConst::visit(expr);
+  }
+  const std::set<int>& getReadSet() const { return readSet_; }
+};
+
+std::set<int> getReadSet(const std::shared_ptr<ast::Expr>& expr) {
+  FindReadSet readSetFinder;
+  expr->accept(readSetFinder);
+  return readSetFinder.getReadSet();
+}
+
+/// AccessID written by the statement, or nothing if the statement is not an assignment to a field
+/// or variable (or a variable declaration)
+std::optional<int> getWriteID(const std::shared_ptr<ast::Stmt>& stmt) {
+  if(const auto varDeclStmt = std::dynamic_pointer_cast<ast::VarDeclStmt>(stmt))
+    return iir::getAccessID(varDeclStmt);
+
+  const auto exprStmt = std::dynamic_pointer_cast<ast::ExprStmt>(stmt);
+  if(!exprStmt)
+    return std::nullopt;
+  const auto assignmentExpr = std::dynamic_pointer_cast<ast::AssignmentExpr>(exprStmt->getExpr());
+  if(!assignmentExpr)
+    return std::nullopt;
+  const auto& lhs = assignmentExpr->getLeft();
+  if(lhs->getKind() != ast::Expr::Kind::FieldAccessExpr &&
+     lhs->getKind() != ast::Expr::Kind::VarAccessExpr)
+    return std::nullopt;
+  return iir::getAccessID(lhs);
+}
+
+bool isDisjoint(const std::set<int>& set1, const std::set<int>& set2) {
+  for(int id : set1)
+    if(set2.count(id))
+      return false;
+  return true;
+}
+
+class FindMergeGroupsVisitor : public ast::ASTVisitorForwardingNonConst {
+  MergeGroupMap blockMergeGroups_;
+
+public:
+  void visit(const std::shared_ptr<ast::BlockStmt>& stmt) override {
+    blockMergeGroups_[stmt->getID()] =
+        ReductionMergeGroupsComputer::ComputeReductionMergeGroups(stmt->getStatements());
+    ast::ASTVisitorForwardingNonConst::visit(stmt);
+  }
+
+  MergeGroupMap getMergeGroupsByBlock() { return blockMergeGroups_; }
+};
+
+} // namespace
+
+std::vector<ReductionMergeGroup> ReductionMergeGroupsComputer::ComputeReductionMergeGroups(
+    const std::vector<std::shared_ptr<ast::Stmt>>& statements) {
+  std::vector<ReductionMergeGroup> mergeGroups;
+  ReductionMergeGroup mergeGroup;
+  // fields and variables written by the statements spanned by the current group
+  std::set<int> writeSet;
+
+  auto closeGroup = [&]() {
+    if(!mergeGroup.empty())
+      mergeGroups.push_back(std::move(mergeGroup));
+    mergeGroup.clear();
+    writeSet.clear();
+  };
+
+  for(const auto& stmt : statements) {
+    const auto writeID = getWriteID(stmt);
+    if(!writeID) {
+      // any other statement (if, loop, ...) ends the current group
+      closeGroup();
+      continue;
+    }
+
+    FindTopLevelReductions reductionFinder;
+    stmt->accept(reductionFinder);
+    if(reductionFinder.getReductions().empty()) {
+      closeGroup();
+      continue;
+    }
+
+    for(const auto& reduction : reductionFinder.getReductions()) {
+      // the reduction is hoisted in front of all statements spanned by the group, hence it must
+      // not depend on any of their results
+      bool compatible = !mergeGroup.empty() &&
+                        mergeGroup.front()->getIterSpace() == reduction->getIterSpace() &&
+                        isDisjoint(writeSet, getReadSet(reduction));
+      if(!compatible)
+        closeGroup();
+      mergeGroup.push_back(reduction);
+    }
+    writeSet.insert(*writeID);
+  }
+  closeGroup();
+
+  return mergeGroups;
+}
+
+MergeGroupMap ReductionMergeGroupsComputer::ComputeReductionMergeGroups(
+    const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation) {
+  FindMergeGroupsVisitor mergeGroupVtor;
+  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*(stencilInstantiation->getIIR()))) {
+    doMethod->getASTPtr()->accept(mergeGroupVtor);
+  }
+  return mergeGroupVtor.getMergeGroupsByBlock();
+}
+
+} // namespace codegen
+} // namespace dawn
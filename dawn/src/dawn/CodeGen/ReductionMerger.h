@@ -0,0 +1,59 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/AST/ASTExpr.h"
+#include "dawn/AST/ASTStmt.h"
+#include "dawn/IIR/StencilInstantiation.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace dawn {
+namespace codegen {
+
+/// @brief Reductions which can be evaluated in a single loop over their (common) neighbor chain
+using ReductionMergeGroup = std::vector<std::shared_ptr<ast::ReductionOverNeighborExpr>>;
+
+/// @brief Merge groups of each block statement, indexed by the ID of the block statement
+using MergeGroupMap = std::map<int, std::vector<ReductionMergeGroup>>;
+
+/// @brief Groups the reductions of consecutive statements which share the same iteration space
+///
+/// A reduction is added to the group of the preceding reduction if
+///   - both reductions are found in consecutive assignments or variable declarations of the same
+///     block statement,
+///   - both reductions iterate over the same neighbor chain (and agree on including the center),
+///   - the reduction does not read a field or variable written by a statement of the group.
+///
+/// The reductions of a group can then be hoisted in front of the statement of the first reduction
+/// and computed in a single neighbor loop. Only the outermost reductions of a statement are
+/// considered, nested reductions are left to the loop body of their parent.
+///
+/// @ingroup codegen
+class ReductionMergeGroupsComputer {
+public:
+  /// @brief Compute the merge groups of a sequence of statements
+  static std::vector<ReductionMergeGroup>
+  ComputeReductionMergeGroups(const std::vector<std::shared_ptr<ast::Stmt>>& statements);
+
+  /// @brief Compute the merge groups of all block statements of the do-methods of the IIR
+  static MergeGroupMap ComputeReductionMergeGroups(
+      const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation);
+};
+
+} // namespace codegen
+} // namespace dawn
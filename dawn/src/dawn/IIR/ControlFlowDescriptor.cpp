@@ -24,26 +24,45 @@ ControlFlowDescriptor ControlFlowDescriptor::clone() const {
   }
   return copy;
 }
-void ControlFlowDescriptor::removeStencilCalls(const std::set<int>& stencilIDs,
-                                               iir::StencilMetaInformation& metadata) {
-  std::vector<StmtConstIterator> stmtsToRemove;
-  for(StmtConstIterator it = getStatements().begin(); it != getStatements().end(); ++it) {
-    const std::shared_ptr<ast::Stmt>& stmt = *it;
-    if(isa<ast::StencilCallDeclStmt>(stmt.get())) {
-      auto callDecl = std::static_pointer_cast<ast::StencilCallDeclStmt>(stmt);
-      bool remove = false;
-      for(int id : stencilIDs) {
-        if(metadata.getStencilIDFromStencilCallStmt(callDecl) == id) {
-          remove = true;
-        }
-      }
-      if(remove) {
-        stmtsToRemove.push_back(it);
+namespace {
+bool isCallOf(const std::shared_ptr<ast::Stmt>& stmt, const std::set<int>& stencilIDs,
+              const iir::StencilMetaInformation& metadata) {
+  if(!isa<ast::StencilCallDeclStmt>(stmt.get()))
+    return false;
+  auto callDecl = std::static_pointer_cast<ast::StencilCallDeclStmt>(stmt);
+  return stencilIDs.count(metadata.getStencilIDFromStencilCallStmt(callDecl));
+}
+
+/// Remove the calls nested in the blocks and branches of `stmt`
+void removeNestedStencilCalls(const std::shared_ptr<ast::Stmt>& stmt,
+                              const std::set<int>& stencilIDs,
+                              const iir::StencilMetaInformation& metadata) {
+  if(auto block = std::dynamic_pointer_cast<ast::BlockStmt>(stmt)) {
+    for(auto it = block->getStatements().begin(); it != block->getStatements().end();) {
+      if(isCallOf(*it, stencilIDs, metadata)) {
+        it = block->erase(it);
+      } else {
+        removeNestedStencilCalls(*it, stencilIDs, metadata);
+        ++it;
       }
     }
+  } else if(auto ifStmt = std::dynamic_pointer_cast<ast::IfStmt>(stmt)) {
+    removeNestedStencilCalls(ifStmt->getThenStmt(), stencilIDs, metadata);
+    if(ifStmt->hasElse())
+      removeNestedStencilCalls(ifStmt->getElseStmt(), stencilIDs, metadata);
   }
-  for(StmtConstIterator it : stmtsToRemove) {
-    eraseStmt(it);
+}
+} // namespace
+
+void ControlFlowDescriptor::removeStencilCalls(const std::set<int>& stencilIDs,
+                                               iir::StencilMetaInformation& metadata) {
+  for(auto it = controlFlowStatements_.begin(); it != controlFlowStatements_.end();) {
+    if(isCallOf(*it, stencilIDs, metadata)) {
+      it = controlFlowStatements_.erase(it);
+    } else {
+      removeNestedStencilCalls(*it, stencilIDs, metadata);
+      ++it;
+    }
   }
   for(auto stencilID : stencilIDs) {
     metadata.eraseStencilID(stencilID);
@@ -24,6 +24,8 @@
 #include <vector>
 
 namespace dawn {
+class IIRSerializer;
+
 namespace iir {
 
 class Stage;
@@ -34,6 +36,8 @@ class StencilMetaInformation;
 ///
 /// @ingroup optimizer
 class DoMethod : public IIRNode<Stage, DoMethod, void> {
+  friend IIRSerializer;
+
   Interval interval_;
   long unsigned int id_;
 
@@ -27,6 +27,8 @@
 #include <vector>
 
 namespace dawn {
+class IIRSerializer;
+
 namespace iir {
 
 class Stencil;
@@ -45,6 +47,8 @@ using StdList = std::list<T, std::allocator<T>>;
 ///
 /// @ingroup optimizer
 class MultiStage : public IIRNode<Stencil, MultiStage, Stage, impl::StdList> {
+  friend IIRSerializer;
+
   StencilMetaInformation& metadata_;
 
   LoopOrderKind loopOrder_;
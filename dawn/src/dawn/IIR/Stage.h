@@ -28,6 +28,8 @@
 #include <vector>
 
 namespace dawn {
+class IIRSerializer;
+
 namespace iir {
 
 class DependencyGraphAccesses;
@@ -41,6 +43,7 @@ class MultiStage;
 ///
 /// @ingroup optimizer
 class Stage : public IIRNode<MultiStage, Stage, DoMethod> {
+  friend IIRSerializer;
 
   const StencilMetaInformation& metaData_;
 
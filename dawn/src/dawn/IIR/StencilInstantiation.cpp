@@ -28,6 +28,7 @@
 #include "dawn/Support/RemoveIf.hpp"
 #include <fstream>
 #include <functional>
+#include <iomanip>
 #include <string>
 
 namespace dawn {
@@ -212,7 +213,8 @@ void StencilInstantiation::jsonDump(std::string filename) const {
   json::json node;
   node["MetaInformation"] = metadata_.jsonDump();
   node["IIR"] = IIR_->jsonDump();
-  fs << node.dump(2) << std::endl;
+  // Stream the dump instead of building the string first, the logs of large IIRs are huge
+  fs << std::setw(2) << node << std::endl;
   fs.close();
 }
 
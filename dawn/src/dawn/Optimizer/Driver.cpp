@@ -17,11 +17,14 @@
 #include "dawn/CodeGen/TranslationUnit.h"
 #include "dawn/Optimizer/Lowering.h"
 #include "dawn/Optimizer/PassManager.h"
+#include "dawn/Optimizer/PerformanceModel.h"
 #include "dawn/SIR/SIR.h"
 #include "dawn/Support/Exception.h"
+#include "dawn/Support/FileSystem.h"
 #include "dawn/Support/Logger.h"
 #include "dawn/Support/StringSwitch.h"
 
+#include "dawn/Optimizer/PassConstantFolding.h"
 #include "dawn/Optimizer/PassDataLocalityMetric.h"
 #include "dawn/Optimizer/PassFieldVersioning.h"
 #include "dawn/Optimizer/PassFixVersionedInputFields.h"
@@ -45,11 +48,13 @@
 #include "dawn/Optimizer/PassStageReordering.h"
 #include "dawn/Optimizer/PassStageSplitAllStatements.h"
 #include "dawn/Optimizer/PassStageSplitter.h"
+#include "dawn/Optimizer/PassStencilMerger.h"
 #include "dawn/Optimizer/PassTemporaryMerger.h"
 #include "dawn/Optimizer/PassTemporaryToStencilFunction.h"
 #include "dawn/Optimizer/PassTemporaryType.h"
 #include "dawn/Optimizer/PassValidation.h"
 
+#include <fstream>
 #include <stdexcept>
 #include <string>
 
@@ -92,7 +97,9 @@ run(const std::shared_ptr<SIR>& stencilIR, const std::list<PassGroup>& groups,
   // validation checks after parallelisation
   passManager.pushBackPass<PassValidation>();
 
-  dawn::log::error.clear();
+  dawn::log::error.clearThisThread();
+  // only errors of this thread count, other threads may compile concurrently
+  const auto numErrors = dawn::log::error.numEnqueuedByThisThread();
   for(auto& stencil : stencilInstantiationMap) {
     // Run optimization passes
     auto& instantiation = stencil.second;
@@ -105,7 +112,7 @@ run(const std::shared_ptr<SIR>& stencilIR, const std::list<PassGroup>& groups,
     DAWN_LOG(INFO) << "Done with parallelization passes for `" << instantiation->getName() << "`";
   }
 
-  if(dawn::log::error.size() > 0) {
+  if(dawn::log::error.numEnqueuedByThisThread() > numErrors) {
     throw CompileError("An error occured in lowering");
   }
 
@@ -155,22 +162,42 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
       // validation check
       passManager.pushBackPass<PassValidation>();
       break;
-    case PassGroup::StageReordering:
+    case PassGroup::ConstantFolding:
+      // running the actual pass (recomputes the stage graphs)
+      passManager.pushBackPass<PassConstantFolding>();
+      // stages may have been removed
+      passManager.pushBackPass<PassSetSyncStage>();
+      // validation check
+      passManager.pushBackPass<PassValidation>();
+      break;
+    case PassGroup::StencilMerger:
       if(stencilInstantiationMap.begin()->second->getIIR()->getGridType() !=
          ast::GridType::Unstructured) {
-        passManager.pushBackPass<PassSetStageGraph>();
-        passManager.pushBackPass<PassSetDependencyGraph>();
-        passManager.pushBackPass<PassStageReordering>(reorderStrategy);
-        // moved stages around ...
+        // running the actual pass (recomputes the stage graphs of the merged stencils)
+        passManager.pushBackPass<PassStencilMerger>();
+        // inter-stencil temporaries may have become local to a stencil ...
+        passManager.pushBackPass<PassTemporaryType>();
+        // modify stage dependencies
         passManager.pushBackPass<PassSetSyncStage>();
-        // if we want this info around, we should probably run this also
-        // passManager.pushBackPass<PassSetStageName>();
         // validation check
         passManager.pushBackPass<PassValidation>();
       } else {
-        DAWN_LOG(WARNING) << "PassStageReordering currently disabled for unstructured meshes!";
+        DAWN_LOG(WARNING) << "PassStencilMerger currently disabled for unstructured meshes!";
       }
       break;
+    case PassGroup::StageReordering:
+      // on unstructured meshes the reordering groups stages of the same location type, which are
+      // then fused by the stage merger
+      passManager.pushBackPass<PassSetStageGraph>();
+      passManager.pushBackPass<PassSetDependencyGraph>();
+      passManager.pushBackPass<PassStageReordering>(reorderStrategy);
+      // moved stages around ...
+      passManager.pushBackPass<PassSetSyncStage>();
+      // if we want this info around, we should probably run this also
+      // passManager.pushBackPass<PassSetStageName>();
+      // validation check
+      passManager.pushBackPass<PassValidation>();
+      break;
     case PassGroup::StageMerger:
       // merging requires the stage graph
       passManager.pushBackPass<PassSetStageGraph>();
@@ -187,6 +214,8 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
       passManager.pushBackPass<PassValidation>();
       break;
     case PassGroup::TemporaryMerger:
+      // the unstructured pipeline splits the statements without setting the dependency graphs
+      passManager.pushBackPass<PassSetDependencyGraph>();
       passManager.pushBackPass<PassTemporaryMerger>();
       // this should not affect the temporaries but since we're touching them it would probably be
       // a safe idea
@@ -271,7 +300,10 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
 
   //===-----------------------------------------------------------------------------------------
 
-  dawn::log::error.clear();
+  const MachineModel machine = MachineModel::fromOptions(options);
+
+  dawn::log::error.clearThisThread();
+  const auto numErrors = dawn::log::error.numEnqueuedByThisThread();
   for(auto& stencil : stencilInstantiationMap) {
     // Run optimization passes
     auto& instantiation = stencil.second;
@@ -288,7 +320,17 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
       const IIRSerializer::Format serializationKind =
           options.SerializeIIR ? IIRSerializer::parseFormatString(options.IIRFormat)
                                : IIRSerializer::Format::Json;
-      IIRSerializer::serialize(instantiation->getName() + ".iir", instantiation, serializationKind);
+      IIRSerializer::serialize(instantiation->getName() + ".iir", instantiation, serializationKind,
+                               options.SerializeIIRDerivedInfo);
+    }
+
+    if(!options.PerfModelDir.empty()) {
+      const fs::path file =
+          fs::path(options.PerfModelDir) / (instantiation->getName() + ".perf.json");
+      std::ofstream ofs(file);
+      if(!ofs)
+        throw std::runtime_error("cannot write performance model '" + file.string() + "'");
+      ofs << PerformanceModel(*instantiation, machine).jsonDump().dump(2) << "\n";
     }
 
     if(options.DumpStencilInstantiation) {
@@ -296,7 +338,7 @@ run(const std::map<std::string, std::shared_ptr<iir::StencilInstantiation>>&
     }
   }
 
-  if(dawn::log::error.size() > 0) {
+  if(dawn::log::error.numEnqueuedByThisThread() > numErrors) {
     throw CompileError("An error occured in optimization");
   }
 
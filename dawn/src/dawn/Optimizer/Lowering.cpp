@@ -401,7 +401,8 @@ public:
     DoMethod& doMethod = stage->getSingleDoMethod();
     // TODO move iterators of IIRNode to const getChildren, when we pass here begin, end instead
 
-    dawn::log::error.clear();
+    dawn::log::error.clearThisThread();
+    const auto numErrors = dawn::log::error.numEnqueuedByThisThread();
     StatementMapper statementMapper(instantiation_.get(), scope_.top()->StackTrace, doMethod,
                                     doMethod.getInterval(),
                                     scope_.top()->LocalFieldnameToAccessIDMap, nullptr);
@@ -409,7 +410,7 @@ public:
     DAWN_LOG(INFO) << "Inserted " << doMethod.getAST().getStatements().size() << " statements";
 
     // Exit if there were any errors in the statement mapper.
-    if(dawn::log::error.size() > 0)
+    if(dawn::log::error.numEnqueuedByThisThread() > numErrors)
       return;
 
     // Here we compute the *actual* access of each statement and associate access to the AccessIDs
@@ -27,6 +27,8 @@ enum class PassGroup {
   StageReordering,
   StageMerger,
   MultiStageMerger,
+  ConstantFolding,
+  StencilMerger,
   TemporaryMerger,
   Inlining,
   IntervalPartitioning,
@@ -0,0 +1,320 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PassConstantFolding.h"
+#include "dawn/IIR/ASTExpr.h"
+#include "dawn/IIR/ASTStmt.h"
+#include "dawn/IIR/AccessComputation.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Optimizer/PassSetStageGraph.h"
+#include "dawn/Support/Logger.h"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <set>
+#include <sstream>
+
+namespace dawn {
+namespace {
+
+/// Value and type of a literal
+struct Constant {
+  double value;
+  BuiltinTypeID type;
+
+  bool isFloatingPoint() const {
+    return type == BuiltinTypeID::Float || type == BuiltinTypeID::Double;
+  }
+};
+
+std::optional<Constant> getConstant(const std::shared_ptr<ast::Expr>& expr) {
+  const auto literal = std::dynamic_pointer_cast<ast::LiteralAccessExpr>(expr);
+  if(!literal)
+    return std::nullopt;
+
+  const std::string& value = literal->getValue();
+  try {
+    switch(literal->getBuiltinType()) {
+    case BuiltinTypeID::Boolean:
+      if(value == "true" || value == "1")
+        return Constant{1, BuiltinTypeID::Boolean};
+      if(value == "false" || value == "0")
+        return Constant{0, BuiltinTypeID::Boolean};
+      return std::nullopt;
+    case BuiltinTypeID::Integer:
+      return Constant{double(std::stoi(value)), BuiltinTypeID::Integer};
+    case BuiltinTypeID::Float:
+    case BuiltinTypeID::Double:
+      return Constant{std::stod(value), literal->getBuiltinType()};
+    default:
+      return std::nullopt;
+    }
+  } catch(std::logic_error&) {
+    return std::nullopt;
+  }
+}
+
+/// Folds unary, binary and ternary operators whose operands are literals (post-order, i.e.
+/// nested expressions are folded first)
+class ConstantFolder : public ast::ASTVisitorPostOrder {
+  iir::StencilInstantiation& instantiation_;
+  int numFolded_ = 0;
+
+  std::shared_ptr<ast::Expr> makeLiteral(const std::shared_ptr<ast::Expr>& expr, double value,
+                                         BuiltinTypeID type) {
+    std::string valueStr;
+    if(type == BuiltinTypeID::Boolean) {
+      valueStr = value != 0 ? "true" : "false";
+    } else if(type == BuiltinTypeID::Integer) {
+      if(value > std::numeric_limits<int>::max() || value < std::numeric_limits<int>::min())
+        return expr;
+      valueStr = std::to_string(int(value));
+    } else {
+      if(!std::isfinite(value))
+        return expr;
+      std::ostringstream ss;
+      ss << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+      valueStr = ss.str();
+      // keep it a floating point literal in the generated code
+      if(valueStr.find_first_of(".e") == std::string::npos)
+        valueStr += ".0";
+    }
+
+    auto literal =
+        std::make_shared<ast::LiteralAccessExpr>(valueStr, type, expr->getSourceLocation());
+    // literals have negative access ids
+    const int accessID = -instantiation_.nextUID();
+    instantiation_.getMetaData().insertAccessOfType(iir::FieldAccessType::Literal, accessID,
+                                                    valueStr);
+    literal->getData<iir::IIRAccessExprData>().AccessID = std::make_optional(accessID);
+    ++numFolded_;
+    return literal;
+  }
+
+public:
+  ConstantFolder(iir::StencilInstantiation& instantiation) : instantiation_(instantiation) {}
+
+  int getNumFolded() const { return numFolded_; }
+
+  std::shared_ptr<ast::Expr>
+  postVisitNode(std::shared_ptr<ast::UnaryOperator> const& expr) override {
+    const auto operand = getConstant(expr->getOperand());
+    if(!operand)
+      return expr;
+
+    const std::string& op = expr->getOp();
+    if(op == "!")
+      return makeLiteral(expr, !operand->value, BuiltinTypeID::Boolean);
+    if(operand->type == BuiltinTypeID::Boolean)
+      return expr;
+    if(op == "-")
+      return makeLiteral(expr, -operand->value, operand->type);
+    if(op == "+")
+      return makeLiteral(expr, operand->value, operand->type);
+    return expr;
+  }
+
+  std::shared_ptr<ast::Expr>
+  postVisitNode(std::shared_ptr<ast::BinaryOperator> const& expr) override {
+    const auto lhs = getConstant(expr->getLeft());
+    const auto rhs = getConstant(expr->getRight());
+    if(!lhs || !rhs)
+      return expr;
+
+    const double a = lhs->value;
+    const double b = rhs->value;
+    const std::string& op = expr->getOp();
+
+    if(op == "&&")
+      return makeLiteral(expr, a != 0 && b != 0, BuiltinTypeID::Boolean);
+    if(op == "||")
+      return makeLiteral(expr, a != 0 || b != 0, BuiltinTypeID::Boolean);
+    if(op == "==")
+      return makeLiteral(expr, a == b, BuiltinTypeID::Boolean);
+    if(op == "!=")
+      return makeLiteral(expr, a != b, BuiltinTypeID::Boolean);
+    if(op == "<")
+      return makeLiteral(expr, a < b, BuiltinTypeID::Boolean);
+    if(op == ">")
+      return makeLiteral(expr, a > b, BuiltinTypeID::Boolean);
+    if(op == "<=")
+      return makeLiteral(expr, a <= b, BuiltinTypeID::Boolean);
+    if(op == ">=")
+      return makeLiteral(expr, a >= b, BuiltinTypeID::Boolean);
+
+    // arithmetic, promoted to the widest operand type
+    if(lhs->type == BuiltinTypeID::Boolean || rhs->type == BuiltinTypeID::Boolean)
+      return expr;
+    BuiltinTypeID type = BuiltinTypeID::Integer;
+    if(lhs->type == BuiltinTypeID::Double || rhs->type == BuiltinTypeID::Double)
+      type = BuiltinTypeID::Double;
+    else if(lhs->isFloatingPoint() || rhs->isFloatingPoint())
+      type = BuiltinTypeID::Float;
+
+    if(op == "+")
+      return makeLiteral(expr, a + b, type);
+    if(op == "-")
+      return makeLiteral(expr, a - b, type);
+    if(op == "*")
+      return makeLiteral(expr, a * b, type);
+    if(op == "/" && type != BuiltinTypeID::Integer)
+      return makeLiteral(expr, a / b, type);
+    return expr;
+  }
+
+  std::shared_ptr<ast::Expr>
+  postVisitNode(std::shared_ptr<ast::TernaryOperator> const& expr) override {
+    const auto cond = getConstant(expr->getCondition());
+    if(!cond)
+      return expr;
+    ++numFolded_;
+    return cond->value != 0 ? expr->getLeft() : expr->getRight();
+  }
+};
+
+bool declaresVariables(const ast::BlockStmt& block) {
+  for(const auto& stmt : block.getStatements())
+    if(stmt->getKind() == ast::Stmt::Kind::VarDeclStmt)
+      return true;
+  return false;
+}
+
+/// Replace the `if` statements with constant conditions by the statements of the taken branch
+///
+/// @returns the number of removed `if` statements
+int removeDeadBranches(ast::BlockStmt& block) {
+  int numRemoved = 0;
+  for(auto it = block.getStatements().begin(); it != block.getStatements().end();) {
+    const auto ifStmt = std::dynamic_pointer_cast<ast::IfStmt>(*it);
+    if(!ifStmt) {
+      ++it;
+      continue;
+    }
+
+    for(const auto& branch : {ifStmt->getThenStmt(), ifStmt->getElseStmt()})
+      if(branch)
+        numRemoved += removeDeadBranches(*std::static_pointer_cast<ast::BlockStmt>(branch));
+
+    const auto cond = getConstant(ifStmt->getCondExpr());
+    if(!cond) {
+      ++it;
+      continue;
+    }
+
+    ++numRemoved;
+    const auto branch =
+        std::static_pointer_cast<ast::BlockStmt>(cond->value != 0 ? ifStmt->getThenStmt()
+                                                                  : ifStmt->getElseStmt());
+    it = block.erase(it);
+    if(!branch)
+      continue;
+
+    if(declaresVariables(*branch)) {
+      // keep the scope of the local variables of the branch
+      it = block.insert(it, &branch, &branch + 1) + 1;
+    } else {
+      const auto& statements = branch->getStatements();
+      it = block.insert(it, statements.begin(), statements.end()) + statements.size();
+    }
+  }
+  return numRemoved;
+}
+
+/// Remove the do-methods, stages and multi-stages which have become empty
+void removeEmptyNodes(iir::Stencil& stencil) {
+  for(auto msIt = stencil.childrenBegin(); msIt != stencil.childrenEnd();) {
+    iir::MultiStage& multiStage = **msIt;
+    for(auto stageIt = multiStage.childrenBegin(); stageIt != multiStage.childrenEnd();) {
+      iir::Stage& stage = **stageIt;
+      for(auto doMethodIt = stage.childrenBegin(); doMethodIt != stage.childrenEnd();) {
+        if((*doMethodIt)->isEmptyOrNullStmt())
+          doMethodIt = stage.childrenErase(doMethodIt);
+        else
+          ++doMethodIt;
+      }
+
+      if(stage.childrenEmpty()) {
+        stageIt = multiStage.childrenErase(stageIt);
+      } else {
+        stage.update(iir::NodeUpdateType::level);
+        ++stageIt;
+      }
+    }
+
+    if(multiStage.childrenEmpty()) {
+      msIt = stencil.childrenErase(msIt);
+    } else {
+      multiStage.update(iir::NodeUpdateType::level);
+      ++msIt;
+    }
+  }
+  stencil.update(iir::NodeUpdateType::level);
+}
+
+} // namespace
+
+bool PassConstantFolding::run(
+    const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+    const Options& options) {
+  int numFolded = 0;
+  int numRemovedBranches = 0;
+
+  for(const auto& doMethod : iterateIIROver<iir::DoMethod>(*stencilInstantiation->getIIR())) {
+    ConstantFolder folder(*stencilInstantiation);
+    doMethod->getASTPtr()->acceptAndReplace(folder);
+    const int numRemoved = removeDeadBranches(doMethod->getAST());
+    if(folder.getNumFolded() == 0 && numRemoved == 0)
+      continue;
+
+    numFolded += folder.getNumFolded();
+    numRemovedBranches += numRemoved;
+
+    // accesses of the removed branches and folded expressions are gone
+    computeAccesses(stencilInstantiation->getMetaData(), doMethod->getAST().getStatements());
+    doMethod->update(iir::NodeUpdateType::level);
+  }
+
+  if(numFolded == 0 && numRemovedBranches == 0)
+    return true;
+
+  for(const auto& stencil : stencilInstantiation->getStencils())
+    removeEmptyNodes(*stencil);
+
+  // Stencils folded away entirely are removed together with their calls
+  std::set<int> emptyStencilIDs;
+  auto& iir = stencilInstantiation->getIIR();
+  for(auto it = iir->childrenBegin(); it != iir->childrenEnd();) {
+    if((*it)->isEmpty()) {
+      emptyStencilIDs.insert((*it)->getStencilID());
+      it = iir->childrenErase(it);
+    } else
+      ++it;
+  }
+  iir->getControlFlowDescriptor().removeStencilCalls(emptyStencilIDs,
+                                                     stencilInstantiation->getMetaData());
+
+  // Recompute the stage graphs as stages may have been removed
+  PassSetStageGraph pass;
+  pass.run(stencilInstantiation);
+
+  DAWN_LOG(INFO) << stencilInstantiation->getName() << ": folded " << numFolded
+                 << " expressions, removed " << numRemovedBranches << " branches";
+
+  return true;
+}
+
+} // namespace dawn
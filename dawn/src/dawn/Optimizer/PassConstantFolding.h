@@ -0,0 +1,47 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Specialize the stencils for the values of constant globals
+///
+/// Accesses to globals with a constant value (e.g. set in the config file of gtclang) are replaced
+/// by literals during lowering. This pass folds the expressions of the do-methods which only
+/// depend on literals and removes the `if` branches whose condition folds to `false` (or the
+/// `else` branches of conditions folding to `true`). Do-methods, stages and multi-stages which
+/// become empty are removed, as are the accesses to fields only read or written in dead branches.
+///
+/// Expressions are folded with the semantics of C++: comparisons and logical operators yield
+/// booleans, arithmetic on integers is only folded for `+`, `-` and `*` (integer division is left
+/// to the compiler) and any floating point operand yields a floating point literal.
+///
+/// @note This pass renders the stage graphs invalid and recomputes them.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassConstantFolding : public Pass {
+public:
+  PassConstantFolding() : Pass("PassConstantFolding") {}
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+           const Options& options = {}) override;
+};
+
+} // namespace dawn
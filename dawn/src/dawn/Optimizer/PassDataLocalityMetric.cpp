@@ -19,6 +19,7 @@
 #include "dawn/IIR/IIRNodeIterator.h"
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/Optimizer/Options.h"
+#include "dawn/Optimizer/PerformanceModel.h"
 #include "dawn/Support/Format.h"
 #include "dawn/Support/Logger.h"
 #include <deque>
@@ -303,6 +304,25 @@ computeReadWriteAccessesMetric(const std::shared_ptr<iir::StencilInstantiation>&
   return std::make_pair(readWriteCounter.getNumReads(), readWriteCounter.getNumWrites());
 }
 
+int computeInterStencilTraffic(const iir::StencilInstantiation& instantiation) {
+  int numFields = 0;
+  std::unordered_set<int> writtenFields;
+  for(const auto& stencilPtr : instantiation.getStencils()) {
+    for(const auto& fieldPair : stencilPtr->getFields()) {
+      const auto& fieldInfo = fieldPair.second;
+      if(!fieldInfo.IsTemporary && fieldInfo.field.getIntend() != iir::Field::IntendKind::Output &&
+         writtenFields.count(fieldPair.first))
+        numFields++;
+    }
+    for(const auto& fieldPair : stencilPtr->getFields()) {
+      const auto& fieldInfo = fieldPair.second;
+      if(!fieldInfo.IsTemporary && fieldInfo.field.getIntend() != iir::Field::IntendKind::Input)
+        writtenFields.insert(fieldPair.first);
+    }
+  }
+  return numFields;
+}
+
 bool PassDataLocalityMetric::run(
     const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
     const Options& options) {
@@ -314,6 +334,7 @@ bool PassDataLocalityMetric::run(
      << "\n";
 
   std::size_t perStencilNumReads = 0, perStencilNumWrites = 0;
+  const PerformanceModel model(*stencilInstantiation, MachineModel::fromOptions(options));
 
   int stencilIdx = 0;
   for(const auto& stencilPtr : stencilInstantiation->getStencils()) {
@@ -334,6 +355,14 @@ bool PassDataLocalityMetric::run(
       ss << format("    %-20s %15i\n", "Reads", numReads);
       ss << format("    %-20s %15i\n", "Writes", numWrites);
 
+      const PerformanceEstimate estimate = model.estimate(multiStage);
+      ss << format("    %-20s %15.3e\n", "FLOPs", estimate.Flops);
+      ss << format("    %-20s %15.3e\n", "Bytes", estimate.Bytes);
+      ss << format("    %-20s %15.3f\n", "FLOPs/Byte", estimate.arithmeticIntensity());
+      const bool isMemoryBound = estimate.isMemoryBound(model.getMachine());
+      ss << format("    %-20s %15.3e %s\n", "Runtime [s]", estimate.Runtime,
+                   isMemoryBound ? "(memory bound)" : "(compute bound)");
+
       DAWN_LOG(INFO) << ss.str();
 
       perStencilNumReads += numReads;
@@ -345,6 +374,11 @@ bool PassDataLocalityMetric::run(
   }
 
   DAWN_LOG(INFO) << "Reads: " << perStencilNumReads << ", Writes: " << perStencilNumWrites;
+  for(const auto& stencilPtr : stencilInstantiation->getStencils())
+    DAWN_LOG(INFO) << "Predicted runtime of stencil " << stencilPtr->getStencilID() << ": "
+                   << model.estimate(*stencilPtr).Runtime << " s";
+  DAWN_LOG(INFO) << "Fields exchanged between stencils: "
+                 << computeInterStencilTraffic(*stencilInstantiation);
 
   return true;
 }
@@ -46,6 +46,10 @@ std::pair<int, int>
 computeReadWriteAccessesMetric(const std::shared_ptr<iir::StencilInstantiation>& instantiation,
                                const iir::MultiStage& multiStage);
 
+/// @brief Approximate the traffic at the stencil boundaries, i.e. the number of fields written by a
+/// stencil and read by a later one (each of them is stored and reloaded in full)
+int computeInterStencilTraffic(const iir::StencilInstantiation& instantiation);
+
 std::unordered_map<int, ReadWriteAccumulator> computeReadWriteAccessesMetricPerAccessID(
     const std::shared_ptr<iir::StencilInstantiation>& instantiation, const Options& options,
     const iir::MultiStage& multiStage);
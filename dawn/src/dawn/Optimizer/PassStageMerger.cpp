@@ -15,12 +15,33 @@
 #include "dawn/Optimizer/PassStageMerger.h"
 #include "dawn/IIR/DependencyGraphAccesses.h"
 #include "dawn/IIR/DependencyGraphStage.h"
+#include "dawn/IIR/IIR.h"
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/Optimizer/ReadBeforeWriteConflict.h"
 #include "dawn/Support/FileSystem.h"
 
 namespace dawn {
 
+/// @brief Check if one of the Do-Methods reads a field on neighbors which the other one writes
+///
+/// Unstructured stages are not computed on an extended domain, hence a neighbor may already have
+/// been (or not yet been) updated within the same loop, regardless of the order of the statements.
+static bool hasNeighborAccessConflict(const iir::DoMethod& first, const iir::DoMethod& second) {
+  auto readsNeighborsOfWrite = [](const iir::DoMethod& reader, const iir::DoMethod& writer) {
+    for(const auto& [accessID, field] : reader.getFields()) {
+      const auto& readExtents = field.getReadExtents();
+      if(!readExtents || readExtents->isHorizontalPointwise())
+        continue;
+      auto writtenField = writer.getFields().find(accessID);
+      if(writtenField != writer.getFields().end() &&
+         writtenField->second.getIntend() != iir::Field::IntendKind::Input)
+        return true;
+    }
+    return false;
+  };
+  return readsNeighborsOfWrite(first, second) || readsNeighborsOfWrite(second, first);
+}
+
 bool PassStageMerger::run(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
                           const Options& options) {
   // Do we need to run this Pass?
@@ -39,6 +60,9 @@ bool PassStageMerger::run(const std::shared_ptr<iir::StencilInstantiation>& sten
   if(options.WriteStencilInstantiation)
     stencilInstantiation->jsonDump(filenameWE + "_before_stage_merger.json");
 
+  const bool isUnstructured =
+      stencilInstantiation->getIIR()->getGridType() == ast::GridType::Unstructured;
+
   for(const auto& stencil : stencilInstantiation->getStencils()) {
     if(stencil->isEmpty()) {
       continue;
@@ -127,7 +151,8 @@ bool PassStageMerger::run(const std::shared_ptr<iir::StencilInstantiation>& sten
                 auto newDepGraph = iir::DependencyGraphAccesses(stencilInstantiation->getMetaData(),
                                                                 *candidateDepGraph, *curDepGraph);
 
-                if(newDepGraph.isDAG() && !hasHorizontalReadBeforeWriteConflict(newDepGraph)) {
+                if(newDepGraph.isDAG() && !hasHorizontalReadBeforeWriteConflict(newDepGraph) &&
+                   !(isUnstructured && hasNeighborAccessConflict(candidateDoMethod, curDoMethod))) {
                   candidateStage.appendDoMethod(*curDoMethodIt, *candidateDoMethodIt,
                                                 std::move(newDepGraph));
                   for(auto& doMethod : candidateStage.getChildren()) {
@@ -0,0 +1,176 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PassStencilMerger.h"
+#include "dawn/IIR/AST.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Optimizer/PassDataLocalityMetric.h"
+#include "dawn/Optimizer/PassSetStageGraph.h"
+#include "dawn/Optimizer/TemporaryHandling.h"
+#include "dawn/Support/Logger.h"
+
+#include <unordered_map>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Check if the extents of the stages or the API fields of the stencil exceed the maximum
+/// number of halo points (same criterion as the `MultiStageChecker`)
+bool exceedsMaxHaloPoints(const iir::Stencil& stencil, int maxHaloPoints) {
+  iir::Extents maxExtents{ast::cartesian};
+  for(const auto& fieldPair : stencil.getFields())
+    if(!fieldPair.second.IsTemporary)
+      maxExtents.merge(fieldPair.second.field.getExtentsRB());
+  for(const auto& stage : iterateIIROver<iir::Stage>(stencil))
+    maxExtents.merge(stage->getExtents());
+
+  const auto& horizExtent =
+      iir::extent_cast<iir::CartesianExtent const&>(maxExtents.horizontalExtent());
+  const auto& vertExtent = maxExtents.verticalExtent();
+  return horizExtent.iPlus() > maxHaloPoints || horizExtent.iMinus() < -maxHaloPoints ||
+         horizExtent.jPlus() > maxHaloPoints || horizExtent.jMinus() < -maxHaloPoints ||
+         vertExtent.plus() > maxHaloPoints || vertExtent.minus() < -maxHaloPoints;
+}
+
+bool writesNonTemporaryField(const iir::StencilMetaInformation& metadata, const iir::Stage& stage) {
+  for(const auto& fieldPair : stage.getFields()) {
+    if(fieldPair.second.getIntend() != iir::Field::IntendKind::Input &&
+       !metadata.isAccessType(iir::FieldAccessType::StencilTemporary, fieldPair.first) &&
+       !metadata.isAccessType(iir::FieldAccessType::InterStencilTemporary, fieldPair.first))
+      return true;
+  }
+  return false;
+}
+
+const std::unique_ptr<iir::Stencil>& getStencilPtr(const iir::StencilInstantiation& instantiation,
+                                                   int stencilID) {
+  const auto& stencils = instantiation.getStencils();
+  auto it = std::find_if(stencils.begin(), stencils.end(), [&](const auto& stencil) {
+    return stencil->getStencilID() == stencilID;
+  });
+  DAWN_ASSERT(it != stencils.end());
+  return *it;
+}
+
+/// @brief Append the multi-stages of `second` to `first`
+///
+/// @returns false (leaving the IIR unchanged) if the merged stencil exceeds the halo or if the
+/// merge introduces redundant computations on API fields in the halo of `first`
+bool tryMerge(iir::StencilInstantiation& instantiation, const std::unique_ptr<iir::Stencil>& first,
+              const iir::Stencil& second, int maxHaloPoints) {
+  const auto& metadata = instantiation.getMetaData();
+
+  std::unordered_map<int, iir::Extents> stageExtents;
+  for(const auto& stage : iterateIIROver<iir::Stage>(*first))
+    stageExtents.emplace(stage->getStageID(), stage->getExtents());
+
+  std::unique_ptr<iir::Stencil> merged = first->clone();
+  for(const auto& multiStage : second.getChildren())
+    merged->insertChild(multiStage->clone());
+
+  // From here on `first` refers to the merged stencil while `merged` holds the original one
+  instantiation.getIIR()->replace(first, merged, instantiation.getIIR());
+  instantiation.computeDerivedInfo();
+
+  bool isLegal = !exceedsMaxHaloPoints(*first, maxHaloPoints);
+  for(const auto& stage : iterateIIROver<iir::Stage>(*first)) {
+    auto it = stageExtents.find(stage->getStageID());
+    if(it != stageExtents.end() && it->second != stage->getExtents() &&
+       writesNonTemporaryField(metadata, *stage))
+      isLegal = false;
+  }
+
+  if(!isLegal) {
+    instantiation.getIIR()->replace(first, merged, instantiation.getIIR());
+    instantiation.computeDerivedInfo();
+  }
+  return isLegal;
+}
+
+} // namespace
+
+bool PassStencilMerger::run(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+                            const Options& options) {
+  auto& metadata = stencilInstantiation->getMetaData();
+  auto& statements = stencilInstantiation->getIIR()->getControlFlowDescriptor().getStatements();
+
+  // Stencils called several times (or not at all) can't be merged with their neighbors
+  std::unordered_map<int, int> numCalls;
+  for(const auto& stencilCallPair : metadata.getStencilCallToStencilIDMap())
+    numCalls[stencilCallPair.second]++;
+
+  const int trafficBefore = computeInterStencilTraffic(*stencilInstantiation);
+  int numMerged = 0;
+
+  for(std::size_t i = 0; i + 1 < statements.size();) {
+    auto firstCall = std::dynamic_pointer_cast<ast::StencilCallDeclStmt>(statements[i]);
+    auto secondCall = std::dynamic_pointer_cast<ast::StencilCallDeclStmt>(statements[i + 1]);
+    if(!firstCall || !secondCall) {
+      ++i;
+      continue;
+    }
+
+    const int firstID = metadata.getStencilIDFromStencilCallStmt(firstCall);
+    const int secondID = metadata.getStencilIDFromStencilCallStmt(secondCall);
+    const auto& first = getStencilPtr(*stencilInstantiation, firstID);
+    const auto& second = getStencilPtr(*stencilInstantiation, secondID);
+
+    if(firstID == secondID || numCalls[firstID] != 1 || numCalls[secondID] != 1 ||
+       first->isEmpty() || second->isEmpty() ||
+       !(first->getStencilAttributes() == second->getStencilAttributes()) ||
+       !tryMerge(*stencilInstantiation, first, *second, options.MaxHaloPoints)) {
+      ++i;
+      continue;
+    }
+
+    DAWN_LOG(INFO) << stencilInstantiation->getName() << ": merged stencil " << secondID
+                   << " into stencil " << firstID;
+    ++numMerged;
+
+    // Remove the second stencil and its call, the merged stencil is tried with the next call again
+    auto& stencils = stencilInstantiation->getIIR()->getChildren();
+    stencilInstantiation->getIIR()->childrenErase(
+        std::find_if(stencils.begin(), stencils.end(),
+                     [&](const auto& stencil) { return stencil->getStencilID() == secondID; }));
+    metadata.eraseStencilCallStmt(secondCall);
+    statements.erase(statements.begin() + i + 1);
+  }
+
+  if(numMerged == 0)
+    return true;
+
+  // Inter-stencil temporaries which are now local to a single stencil become stencil temporaries
+  std::vector<int> interStencilTemporaries;
+  for(int accessID : metadata.getAccessesOfType<iir::FieldAccessType::InterStencilTemporary>())
+    if(!stencilInstantiation->isIDAccessedMultipleStencils(accessID))
+      interStencilTemporaries.push_back(accessID);
+  for(int accessID : interStencilTemporaries)
+    demoteAllocatedFieldToTemporaryField(stencilInstantiation.get(), accessID);
+
+  for(const auto& stencil : stencilInstantiation->getStencils())
+    stencil->update(iir::NodeUpdateType::level);
+
+  // Recompute the stage graph of the merged stencils
+  PassSetStageGraph pass;
+  pass.run(stencilInstantiation);
+
+  DAWN_LOG(INFO) << stencilInstantiation->getName() << ": fields exchanged between stencils: "
+                 << trafficBefore << " -> " << computeInterStencilTraffic(*stencilInstantiation);
+
+  return true;
+}
+
+} // namespace dawn
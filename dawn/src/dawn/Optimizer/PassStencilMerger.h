@@ -0,0 +1,50 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/Optimizer/Pass.h"
+
+namespace dawn {
+
+/// @brief Merge consecutive stencil calls of the control flow into a single stencil
+///
+/// The multi-stages of the second stencil are appended to the first one. Fields produced by the
+/// first stencil and consumed by the second one are no longer written to memory at the stencil
+/// boundary by construction, inter-stencil temporaries which are only accessed by the merged
+/// stencil become stencil temporaries and the subsequent passes (stage reordering and merging,
+/// multi-stage merging, caching) can operate across the former stencil boundary.
+///
+/// Two stencils are merged if
+///   - their calls are adjacent in the control flow and each stencil is called exactly once,
+///   - they have the same stencil attributes,
+///   - the extents of the merged stencil do not exceed `MaxHaloPoints` and
+///   - the redundant computations the merge introduces in the halo of the first stencil only write
+///     temporaries (writing API fields in the halo would change their values visible to the user).
+///
+/// @note This pass renders the stage graphs invalid and recomputes them.
+///
+/// @ingroup optimizer
+///
+/// This pass is not necessary to create legal code and is hence not in the debug-group
+class PassStencilMerger : public Pass {
+public:
+  PassStencilMerger() : Pass("PassStencilMerger") {}
+
+  /// @brief Pass implementation
+  bool run(const std::shared_ptr<iir::StencilInstantiation>& stencilInstantiation,
+           const Options& options = {}) override;
+};
+
+} // namespace dawn
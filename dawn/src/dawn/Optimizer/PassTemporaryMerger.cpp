@@ -13,6 +13,7 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn/Optimizer/PassTemporaryMerger.h"
+#include "dawn/CodeGen/IcoChainSizes.h"
 #include "dawn/IIR/DependencyGraph.h"
 #include "dawn/IIR/DependencyGraphAccesses.h"
 #include "dawn/IIR/StencilInstantiation.h"
@@ -122,6 +123,35 @@ bool PassTemporaryMerger::run(
         if(FromLifetime.overlaps(ToLifetime)) {
           TemporaryDAG.insertEdge(FromAccessID, ToAccessID, iir::Extents{});
         }
+
+        // Temporaries can only share their storage if they have the same dimensions, i.e. the
+        // same location type and neighbor chain on unstructured grids (dense and sparse
+        // temporaries are never merged)
+        if(!(metadata.getFieldDimensions(FromAccessID) ==
+             metadata.getFieldDimensions(ToAccessID))) {
+          TemporaryDAG.insertEdge(FromAccessID, ToAccessID, iir::Extents{});
+        }
+      }
+    }
+
+    // Temporaries read with a vertical offset in a multi-stage with a vertical loop order carry
+    // their values from one level to the next and live as long as the whole multi-stage
+    for(const auto& multiStagePtr : stencil.getChildren()) {
+      if(multiStagePtr->getLoopOrder() == iir::LoopOrderKind::Parallel)
+        continue;
+
+      const auto& fields = multiStagePtr->getFields();
+      for(const auto& [FromAccessID, field] : fields) {
+        if(!temporaries.count(FromAccessID) || !field.getReadExtents() ||
+           field.getReadExtents()->isVerticalPointwise())
+          continue;
+        for(const auto& ToAccessIDFieldPair : fields) {
+          const int ToAccessID = ToAccessIDFieldPair.first;
+          if(ToAccessID != FromAccessID && temporaries.count(ToAccessID)) {
+            TemporaryDAG.insertEdge(FromAccessID, ToAccessID, iir::Extents{});
+            TemporaryDAG.insertEdge(ToAccessID, FromAccessID, iir::Extents{});
+          }
+        }
       }
     }
 
@@ -145,6 +175,22 @@ bool PassTemporaryMerger::run(
         colorToAccessIDOfRenameCandidatesMap[color].push_back(AccessID);
     }
 
+    // Report the saved storage, all temporaries of a color have the same dimensions
+    int numValues = 0;
+    int numMergedValues = 0;
+    for(const auto& colorRenameCandidatesPair : colorToAccessIDOfRenameCandidatesMap) {
+      const std::vector<int>& AccessIDOfRenameCandidates = colorRenameCandidatesPair.second;
+      const int values =
+          ICOValuesPerElement(metadata.getFieldDimensions(AccessIDOfRenameCandidates.front()));
+      numValues += values * AccessIDOfRenameCandidates.size();
+      numMergedValues += values;
+    }
+    DAWN_LOG(INFO) << stencilInstantiation->getName() << ": stencil " << stencil.getStencilID()
+                   << ": " << coloring.size() << " temporaries stored in "
+                   << colorToAccessIDOfRenameCandidatesMap.size() << " fields, saving "
+                   << (numValues - numMergedValues) << " of " << numValues
+                   << " values per horizontal element and level";
+
     for(const auto& colorRenameCandidatesPair : colorToAccessIDOfRenameCandidatesMap) {
       const std::vector<int>& AccessIDOfRenameCandidates = colorRenameCandidatesPair.second;
 
@@ -168,6 +214,8 @@ bool PassTemporaryMerger::run(
         if(oldAccessID != newAccessID) {
           merged = true;
           renameAccessIDInStencil(stencilPtr.get(), oldAccessID, newAccessID);
+          // The merged temporary is no longer accessed and must not be allocated by the backends
+          stencilInstantiation->getMetaData().removeAccessID(oldAccessID);
         }
       }
     }
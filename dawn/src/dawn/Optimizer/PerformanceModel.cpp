@@ -0,0 +1,250 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Optimizer/PerformanceModel.h"
+#include "dawn/AST/ASTVisitor.h"
+#include "dawn/CodeGen/IcoChainSizes.h"
+#include "dawn/IIR/AST.h"
+#include "dawn/IIR/ASTExpr.h"
+#include "dawn/IIR/StencilFunctionInstantiation.h"
+#include <algorithm>
+#include <fstream>
+#include <stack>
+#include <stdexcept>
+
+namespace dawn {
+
+namespace {
+
+/// @brief Counts the floating point operations of the statements per grid point
+class FlopCounter : public ast::ASTVisitorForwardingNonConst {
+  const iir::StencilMetaInformation& metadata_;
+  std::stack<std::shared_ptr<iir::StencilFunctionInstantiation>> stencilFunCalls_;
+  double flops_ = 0;
+  /// Number of evaluations of the current expression (neighbors of enclosing reductions)
+  double multiplicity_ = 1;
+
+public:
+  FlopCounter(const iir::StencilMetaInformation& metadata) : metadata_(metadata) {}
+
+  double getFlops() const { return flops_; }
+
+  void visit(const std::shared_ptr<ast::UnaryOperator>& expr) override {
+    if(expr->getOp() == "-")
+      flops_ += multiplicity_;
+    ast::ASTVisitorForwardingNonConst::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<ast::BinaryOperator>& expr) override {
+    const std::string& op = expr->getOp();
+    if(op == "+" || op == "-" || op == "*" || op == "/")
+      flops_ += multiplicity_;
+    ast::ASTVisitorForwardingNonConst::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<ast::AssignmentExpr>& expr) override {
+    const std::string& op = expr->getOp();
+    if(op == "+=" || op == "-=" || op == "*=" || op == "/=")
+      flops_ += multiplicity_;
+    ast::ASTVisitorForwardingNonConst::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<ast::FunCallExpr>& expr) override {
+    // math functions (sqrt, exp, min, ...) count as one operation
+    flops_ += multiplicity_;
+    ast::ASTVisitorForwardingNonConst::visit(expr);
+  }
+
+  void visit(const std::shared_ptr<ast::ReductionOverNeighborExpr>& expr) override {
+    const double neighbors = ICOChainSize(expr->getNbhChain(), expr->getIncludeCenter());
+    expr->getInit()->accept(*this);
+    const double multiplicity = multiplicity_;
+    multiplicity_ *= neighbors;
+    // the reduction operation and the multiplication by the weight
+    flops_ += multiplicity_ * (expr->getWeights() ? 2 : 1);
+    expr->getRhs()->accept(*this);
+    if(expr->getWeights())
+      for(const auto& weight : *expr->getWeights())
+        weight->accept(*this);
+    multiplicity_ = multiplicity;
+  }
+
+  void visit(const std::shared_ptr<ast::StencilFunCallExpr>& expr) override {
+    stencilFunCalls_.push(stencilFunCalls_.empty()
+                              ? metadata_.getStencilFunctionInstantiation(expr)
+                              : stencilFunCalls_.top()->getStencilFunctionInstantiation(expr));
+    stencilFunCalls_.top()->getAST()->accept(*this);
+    stencilFunCalls_.pop();
+    ast::ASTVisitorForwardingNonConst::visit(expr);
+  }
+};
+
+/// @brief Number of levels of `interval` in a domain of `numLevels` levels
+double levels(const iir::Interval& interval, int numLevels) {
+  auto bound = [&](int level, int offset) {
+    return (level == ast::Interval::End ? numLevels - 1 : level) + offset;
+  };
+  const int lower = std::max(bound(interval.lowerLevel(), interval.lowerOffset()), 0);
+  const int upper =
+      std::min(bound(interval.upperLevel(), interval.upperOffset()), numLevels - 1);
+  return std::max(upper - lower + 1, 0);
+}
+
+/// @brief Values loaded and stored per horizontal point of a level
+double valuesPerLevel(const iir::StencilMetaInformation& metadata,
+                      const std::unordered_map<int, iir::Field>& fields) {
+  double values = 0;
+  for(const auto& [accessID, field] : fields) {
+    const int accesses = field.getIntend() == iir::Field::IntendKind::InputOutput ? 2 : 1;
+    values += accesses * ICOValuesPerElement(metadata.getFieldDimensions(accessID));
+  }
+  return values;
+}
+
+double runtime(const MachineModel& machine, double flops, double bytes) {
+  return std::max(flops / machine.PeakFlops, bytes / machine.MemoryBandwidth);
+}
+
+} // namespace
+
+MachineModel MachineModel::load(const std::string& file) {
+  std::ifstream ifs(file);
+  if(!ifs)
+    throw std::runtime_error("cannot open machine model '" + file + "'");
+
+  MachineModel machine;
+  try {
+    json::json node;
+    ifs >> node;
+    machine.MemoryBandwidth = node.value("memory_bandwidth", machine.MemoryBandwidth);
+    machine.PeakFlops = node.value("peak_flops", machine.PeakFlops);
+    machine.CacheSize = node.value("cache_size", machine.CacheSize);
+    machine.BytesPerValue = node.value("bytes_per_value", machine.BytesPerValue);
+    machine.DomainSize = node.value("domain_size", machine.DomainSize);
+  } catch(const std::exception& e) {
+    throw std::runtime_error("malformed machine model '" + file + "': " + e.what());
+  }
+  if(machine.MemoryBandwidth <= 0 || machine.PeakFlops <= 0 || machine.BytesPerValue <= 0 ||
+     machine.DomainSize[0] <= 0 || machine.DomainSize[1] <= 0 || machine.DomainSize[2] <= 0)
+    throw std::runtime_error("machine model '" + file +
+                             "' needs a positive bandwidth, peak performance and domain size");
+  return machine;
+}
+
+MachineModel MachineModel::fromOptions(const Options& options) {
+  return options.PerfModelConfig.empty() ? MachineModel() : load(options.PerfModelConfig);
+}
+
+json::json MachineModel::jsonDump() const {
+  json::json node;
+  node["memory_bandwidth"] = MemoryBandwidth;
+  node["peak_flops"] = PeakFlops;
+  node["cache_size"] = CacheSize;
+  node["bytes_per_value"] = BytesPerValue;
+  node["domain_size"] = DomainSize;
+  return node;
+}
+
+json::json PerformanceEstimate::jsonDump(const MachineModel& machine) const {
+  json::json node;
+  node["flops"] = Flops;
+  node["bytes"] = Bytes;
+  node["arithmetic_intensity"] = arithmeticIntensity();
+  node["runtime"] = Runtime;
+  node["memory_bound"] = isMemoryBound(machine);
+  return node;
+}
+
+PerformanceEstimate PerformanceModel::estimate(const iir::Stage& stage) const {
+  const auto& metadata = instantiation_.getMetaData();
+  const double pointsPerLevel = double(machine_.DomainSize[0]) * machine_.DomainSize[1];
+
+  PerformanceEstimate estimate;
+  for(const auto& doMethod : stage.getChildren()) {
+    FlopCounter counter(metadata);
+    for(const auto& stmt : doMethod->getAST().getStatements())
+      stmt->accept(counter);
+    estimate.Flops += counter.getFlops() * pointsPerLevel *
+                      levels(doMethod->getInterval(), machine_.DomainSize[2]);
+  }
+  estimate.Bytes = valuesPerLevel(metadata, stage.getFields()) * machine_.BytesPerValue *
+                   pointsPerLevel * levels(stage.getEnclosingInterval(), machine_.DomainSize[2]);
+  estimate.Runtime = runtime(machine_, estimate.Flops, estimate.Bytes);
+  return estimate;
+}
+
+PerformanceEstimate PerformanceModel::estimate(const iir::MultiStage& multiStage) const {
+  const auto& metadata = instantiation_.getMetaData();
+  const double pointsPerLevel = double(machine_.DomainSize[0]) * machine_.DomainSize[1];
+
+  PerformanceEstimate estimate;
+  for(const auto& stage : multiStage.getChildren()) {
+    const PerformanceEstimate stageEstimate = this->estimate(*stage);
+    estimate.Flops += stageEstimate.Flops;
+    estimate.Bytes += stageEstimate.Bytes;
+  }
+
+  // Reuse between the stages if the levels of all fields fit into the cache
+  const double bytesPerLevel =
+      valuesPerLevel(metadata, multiStage.getFields()) * machine_.BytesPerValue * pointsPerLevel;
+  if(bytesPerLevel <= machine_.CacheSize)
+    estimate.Bytes =
+        std::min(estimate.Bytes, bytesPerLevel * levels(multiStage.getEnclosingInterval(),
+                                                        machine_.DomainSize[2]));
+  estimate.Runtime = runtime(machine_, estimate.Flops, estimate.Bytes);
+  return estimate;
+}
+
+PerformanceEstimate PerformanceModel::estimate(const iir::Stencil& stencil) const {
+  PerformanceEstimate estimate;
+  for(const auto& multiStage : stencil.getChildren()) {
+    const PerformanceEstimate multiStageEstimate = this->estimate(*multiStage);
+    estimate.Flops += multiStageEstimate.Flops;
+    estimate.Bytes += multiStageEstimate.Bytes;
+    estimate.Runtime += multiStageEstimate.Runtime;
+  }
+  return estimate;
+}
+
+json::json PerformanceModel::jsonDump() const {
+  json::json node;
+  node["name"] = instantiation_.getName();
+  node["machine"] = machine_.jsonDump();
+
+  PerformanceEstimate total;
+  for(const auto& stencil : instantiation_.getStencils()) {
+    json::json stencilNode = estimate(*stencil).jsonDump(machine_);
+    stencilNode["id"] = stencil->getStencilID();
+    for(const auto& multiStage : stencil->getChildren()) {
+      json::json multiStageNode = estimate(*multiStage).jsonDump(machine_);
+      multiStageNode["id"] = multiStage->getID();
+      multiStageNode["loop_order"] = iir::loopOrderToString(multiStage->getLoopOrder());
+      for(const auto& stage : multiStage->getChildren()) {
+        json::json stageNode = estimate(*stage).jsonDump(machine_);
+        stageNode["id"] = stage->getStageID();
+        multiStageNode["stages"].push_back(stageNode);
+      }
+      stencilNode["multistages"].push_back(multiStageNode);
+    }
+    const PerformanceEstimate stencilEstimate = estimate(*stencil);
+    total.Flops += stencilEstimate.Flops;
+    total.Bytes += stencilEstimate.Bytes;
+    total.Runtime += stencilEstimate.Runtime;
+    node["stencils"].push_back(stencilNode);
+  }
+  node["total"] = total.jsonDump(machine_);
+  return node;
+}
+
+} // namespace dawn
@@ -0,0 +1,107 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Optimizer/Options.h"
+#include "dawn/Support/Array.h"
+#include "dawn/Support/Json.h"
+#include <string>
+
+namespace dawn {
+
+/// @brief Parameters of the target machine and the domain size the performance model predicts
+/// @ingroup optimizer
+///
+/// The parameters are read from a JSON file (see the `perf-model-config` option), all keys are
+/// optional:
+///
+/// @code
+///   {"memory_bandwidth": 1.0e11, "peak_flops": 1.0e12, "cache_size": 33554432,
+///    "bytes_per_value": 8, "domain_size": [128, 128, 80]}
+/// @endcode
+struct MachineModel {
+  /// Sustained main memory bandwidth [bytes/s]
+  double MemoryBandwidth = 1.0e11;
+  /// Peak floating point performance [FLOP/s]
+  double PeakFlops = 1.0e12;
+  /// Size of the last level cache [bytes]
+  double CacheSize = 32.0 * 1024 * 1024;
+  /// Size of a field value [bytes]
+  int BytesPerValue = 8;
+  /// Compute domain of the predictions, unstructured domains are given as {#elements, 1, #levels}
+  Array3i DomainSize = {128, 128, 80};
+
+  /// @brief Read the parameters from `file`
+  /// @throws std::runtime_error if the file can't be read or is malformed
+  static MachineModel load(const std::string& file);
+
+  /// @brief Machine of the `perf-model-config` option (the defaults if not set)
+  static MachineModel fromOptions(const Options& options);
+
+  json::json jsonDump() const;
+};
+
+/// @brief Roofline estimate of a stage, multistage or stencil on the compute domain
+/// @ingroup optimizer
+struct PerformanceEstimate {
+  /// Floating point operations
+  double Flops = 0;
+  /// Bytes moved between main memory and the last level cache
+  double Bytes = 0;
+  /// Predicted run time [s], the maximum of compute and memory time of each multistage
+  double Runtime = 0;
+
+  /// @brief FLOPs per byte (0 if no memory is moved)
+  double arithmeticIntensity() const { return Bytes > 0 ? Flops / Bytes : 0; }
+  /// @brief Whether the run time is limited by the memory bandwidth
+  bool isMemoryBound(const MachineModel& machine) const {
+    return Bytes / machine.MemoryBandwidth >= Flops / machine.PeakFlops;
+  }
+
+  json::json jsonDump(const MachineModel& machine) const;
+};
+
+/// @brief Roofline-style performance model of the stencils of an instantiation
+/// @ingroup optimizer
+///
+/// FLOPs are counted per grid point from the statements (arithmetic operators and math function
+/// calls count one FLOP, both branches of conditionals are counted). The moved bytes of a stage are
+/// given by the fields it accesses, each of them is loaded or stored once per level (input-output
+/// fields twice). Fields accessed by several stages of a multistage are moved once if a level of
+/// all fields of the multistage fits into the cache, otherwise each stage moves its fields. The
+/// software caches of the GPU backends are ignored. Multistages are executed after each other, the
+/// run time of a stencil is the sum of the roofline run times of its multistages.
+///
+/// The model does not modify the IIR and can be queried by any pass.
+class PerformanceModel {
+  const iir::StencilInstantiation& instantiation_;
+  MachineModel machine_;
+
+public:
+  PerformanceModel(const iir::StencilInstantiation& instantiation, const MachineModel& machine)
+      : instantiation_(instantiation), machine_(machine) {}
+
+  PerformanceEstimate estimate(const iir::Stage& stage) const;
+  PerformanceEstimate estimate(const iir::MultiStage& multiStage) const;
+  PerformanceEstimate estimate(const iir::Stencil& stencil) const;
+
+  /// @brief Model of all stages, multistages and stencils of the instantiation
+  json::json jsonDump() const;
+
+  const MachineModel& getMachine() const { return machine_; }
+};
+
+} // namespace dawn
@@ -15,13 +15,81 @@
 #include "dawn/Optimizer/ReorderStrategyGreedy.h"
 #include "dawn/IIR/DependencyGraphAccesses.h"
 #include "dawn/IIR/DependencyGraphStage.h"
+#include "dawn/IIR/IIR.h"
 #include "dawn/IIR/MultiStage.h"
 #include "dawn/IIR/Stencil.h"
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/Support/Iterator.h"
+#include <algorithm>
+#include <vector>
 
 namespace dawn {
 
+namespace {
+
+using StageList = std::vector<std::unique_ptr<iir::Stage>>;
+
+/// @brief Check if the two stages loop over the same elements, i.e. they can be fused by the stage
+/// merger
+bool isSameHorizontalLoop(const iir::Stage& stage, const iir::Stage& other) {
+  return stage.getLocationType() == other.getLocationType() &&
+         stage.getIterationSpace() == other.getIterationSpace();
+}
+
+/// @brief Move each stage of an unstructured multi-stage next to a stage with the same location
+/// type and iteration space, if the dependencies permit
+///
+/// Every statement of an unstructured stencil lives in its own stage, i.e. its own loop over one
+/// location type. The stages are first moved upwards behind the last stage looping over the same
+/// elements (without passing a stage they depend on) and then, in the same way, downwards in front
+/// of the next such stage. A stage without such a neighbor keeps its position.
+StageList groupByHorizontalLoop(StageList stages, const iir::DependencyGraphStage& stageDAG) {
+  auto dependent = [&](const iir::Stage& stage, const iir::Stage& other) {
+    return stageDAG.depends(stage.getStageID(), other.getStageID()) ||
+           stageDAG.depends(other.getStageID(), stage.getStageID());
+  };
+
+  // upwards sweep (top -> bottom), stages are inserted behind the matching stage
+  StageList upwards;
+  for(auto& stage : stages) {
+    int lastDependency = upwards.size() - 1;
+    for(; lastDependency >= 0; --lastDependency)
+      if(dependent(*stage, *upwards[lastDependency]))
+        break;
+
+    auto pos = upwards.end();
+    for(int idx = upwards.size() - 1; idx >= std::max(lastDependency, 0); --idx)
+      if(isSameHorizontalLoop(*stage, *upwards[idx])) {
+        pos = upwards.begin() + idx + 1;
+        break;
+      }
+    upwards.insert(pos, std::move(stage));
+  }
+
+  // downwards sweep (bottom -> top), stages are inserted in front of the matching stage
+  StageList downwards;
+  for(auto stageIt = upwards.rbegin(); stageIt != upwards.rend(); ++stageIt) {
+    auto& stage = *stageIt;
+    const int numStages = downwards.size();
+    int firstDependency = 0;
+    for(; firstDependency < numStages; ++firstDependency)
+      if(dependent(*stage, *downwards[firstDependency]))
+        break;
+
+    auto pos = downwards.begin();
+    for(int idx = 0; idx <= std::min(firstDependency, numStages - 1); ++idx)
+      if(isSameHorizontalLoop(*stage, *downwards[idx])) {
+        pos = downwards.begin() + idx;
+        break;
+      }
+    downwards.insert(pos, std::move(stage));
+  }
+
+  return downwards;
+}
+
+} // anonymous namespace
+
 std::unique_ptr<iir::Stencil>
 ReorderStrategyGreedy::reorder(iir::StencilInstantiation* stencilInstantiation,
                                const std::unique_ptr<iir::Stencil>& stencil,
@@ -33,6 +101,22 @@ ReorderStrategyGreedy::reorder(iir::StencilInstantiation* stencilInstantiation,
   auto const& stageDAG = *stencil->getStageDependencyGraph();
   newStencil->setStageDependencyGraph(iir::DependencyGraphStage(stageDAG));
 
+  if(stencilInstantiation->getIIR()->getGridType() == ast::GridType::Unstructured) {
+    for(auto [msIdx, multiStage] : enumerate(stencil->getChildren())) {
+      newStencil->insertChild(
+          std::make_unique<iir::MultiStage>(metadata, multiStage->getLoopOrder()));
+
+      StageList stages;
+      for(auto& stage : multiStage->getChildren())
+        stages.push_back(std::move(stage));
+
+      int stageIdx = -1;
+      for(auto& stage : groupByHorizontalLoop(std::move(stages), stageDAG))
+        newStencil->insertStage(iir::Stencil::StagePosition(msIdx, stageIdx++), std::move(stage));
+    }
+    return newStencil;
+  }
+
   int totalNewStages = 0;
   for(auto [msIdx, multiStage] : enumerate(stencil->getChildren())) {
     iir::LoopOrderKind stageLoopOrder = multiStage->getLoopOrder();
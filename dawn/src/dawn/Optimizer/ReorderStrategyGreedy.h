@@ -23,6 +23,9 @@ class StencilInstantiation;
 }
 /// @brief Reordering strategy which tries to move each stage upwards as far as possible under the
 /// sole constraint that the extent of any field does not exeed the maximum halo points
+///
+/// On unstructured meshes the stages are instead grouped by location type and iteration space, such
+/// that the stage merger can fuse them into one loop.
 /// @ingroup optimizer
 class ReorderStrategyGreedy : public ReorderStrategy {
 public:
@@ -121,6 +121,14 @@ void promoteTemporaryFieldToAllocatedField(iir::StencilInstantiation* instantiat
                                                      AccessID);
 }
 
+void demoteAllocatedFieldToTemporaryField(iir::StencilInstantiation* instantiation, int AccessID) {
+  DAWN_ASSERT(instantiation->getMetaData().isAccessType(
+      iir::FieldAccessType::InterStencilTemporary, AccessID));
+  DAWN_ASSERT(!instantiation->isIDAccessedMultipleStencils(AccessID));
+  instantiation->getMetaData().moveRegisteredFieldTo(iir::FieldAccessType::StencilTemporary,
+                                                     AccessID);
+}
+
 void demoteTemporaryFieldToLocalVariable(iir::StencilInstantiation* instantiation,
                                          iir::Stencil* stencil, int AccessID,
                                          const iir::Stencil::Lifetime& lifetime) {
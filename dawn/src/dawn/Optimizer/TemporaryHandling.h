@@ -29,6 +29,10 @@ void promoteLocalVariableToTemporaryField(iir::StencilInstantiation* instantiati
 /// allocated by the stencil
 void promoteTemporaryFieldToAllocatedField(iir::StencilInstantiation* instantiation, int AccessID);
 
+/// @brief Demote the allocated field, given by `AccessID`, to a temporary field of the (single)
+/// stencil accessing it
+void demoteAllocatedFieldToTemporaryField(iir::StencilInstantiation* instantiation, int AccessID);
+
 // @brief Demote the temporary field, given by `AccessID`, to a local variable
 ///
 /// This will take care of registering the new variable (and removing the field) as well as
@@ -21,11 +21,17 @@
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/SIR/SIR.h"
 #include "dawn/Serialization/ASTSerializer.h"
+#include "dawn/Serialization/ProtobufIO.h"
 #include "dawn/Support/Assert.h"
+#include "dawn/Support/ContainerUtils.h"
 #include "dawn/Support/UIDGenerator.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
-#include <google/protobuf/util/json_util.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -174,6 +180,93 @@ static iir::Cache makeCache(const proto::iir::Cache* protoCache) {
   return iir::Cache(cacheType, cachePolicy, ID, interval, enclosingInverval, cacheWindow);
 }
 
+static void
+setDerivedFields(google::protobuf::RepeatedPtrField<proto::iir::DerivedField>* protoFields,
+                 const std::unordered_map<int, iir::Field>& fields) {
+  for(const auto& [accessID, field] : support::orderMap(fields)) {
+    auto protoField = protoFields->Add();
+    protoField->set_accessid(accessID);
+    switch(field.getIntend()) {
+    case iir::Field::IntendKind::Output:
+      protoField->set_intend(proto::iir::DerivedField_IntendKind_Output);
+      break;
+    case iir::Field::IntendKind::InputOutput:
+      protoField->set_intend(proto::iir::DerivedField_IntendKind_InputOutput);
+      break;
+    case iir::Field::IntendKind::Input:
+      protoField->set_intend(proto::iir::DerivedField_IntendKind_Input);
+      break;
+    }
+    if(field.getReadExtents())
+      *protoField->mutable_readextents() = makeProtoExtents(*field.getReadExtents());
+    if(field.getWriteExtents())
+      *protoField->mutable_writeextents() = makeProtoExtents(*field.getWriteExtents());
+    if(field.getReadExtentsRB() && field.getReadExtentsRB() != field.getReadExtents())
+      *protoField->mutable_readextentsrb() = makeProtoExtents(*field.getReadExtentsRB());
+    if(field.getWriteExtentsRB() && field.getWriteExtentsRB() != field.getWriteExtents())
+      *protoField->mutable_writeextentsrb() = makeProtoExtents(*field.getWriteExtentsRB());
+    dawn::ast::Interval interval = field.getInterval().asASTInterval();
+    setInterval(protoField->mutable_interval(), &interval);
+  }
+}
+
+static std::unordered_map<int, iir::Field>
+makeDerivedFields(const google::protobuf::RepeatedPtrField<proto::iir::DerivedField>& protoFields,
+                  const iir::StencilMetaInformation& metadata) {
+  auto makeOptionalExtents = [](bool isSet, const proto::ast::Extents& protoExtents) {
+    return isSet ? std::make_optional(makeExtents(&protoExtents)) : std::optional<iir::Extents>();
+  };
+
+  std::unordered_map<int, iir::Field> fields;
+  for(const auto& protoField : protoFields) {
+    iir::Field::IntendKind intend;
+    switch(protoField.intend()) {
+    case proto::iir::DerivedField_IntendKind_Output:
+      intend = iir::Field::IntendKind::Output;
+      break;
+    case proto::iir::DerivedField_IntendKind_InputOutput:
+      intend = iir::Field::IntendKind::InputOutput;
+      break;
+    case proto::iir::DerivedField_IntendKind_Input:
+      intend = iir::Field::IntendKind::Input;
+      break;
+    default:
+      throw std::out_of_range("unknown field intend");
+    }
+
+    iir::Field field(protoField.accessid(), intend,
+                     makeOptionalExtents(protoField.has_readextents(), protoField.readextents()),
+                     makeOptionalExtents(protoField.has_writeextents(), protoField.writeextents()),
+                     *makeInterval(protoField.interval()),
+                     metadata.getFieldDimensions(protoField.accessid()));
+    field.setReadExtentsRB(
+        makeOptionalExtents(protoField.has_readextentsrb(), protoField.readextentsrb()));
+    field.setWriteExtentsRB(
+        makeOptionalExtents(protoField.has_writeextentsrb(), protoField.writeextentsrb()));
+    fields.emplace(protoField.accessid(), std::move(field));
+  }
+  return fields;
+}
+
+/// @brief 64-bit FNV-1a hash of the (deterministically) serialized IIR and Metadata
+static std::uint64_t computeChecksum(const proto::iir::StencilInstantiation& protoInstantiation) {
+  std::string bytes;
+  {
+    google::protobuf::io::StringOutputStream stream(&bytes);
+    google::protobuf::io::CodedOutputStream codedStream(&stream);
+    codedStream.SetSerializationDeterministic(true);
+    protoInstantiation.metadata().SerializeToCodedStream(&codedStream);
+    protoInstantiation.internalir().SerializeToCodedStream(&codedStream);
+  }
+
+  std::uint64_t hash = 14695981039346656037ull;
+  for(unsigned char byte : bytes) {
+    hash ^= byte;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
 void IIRSerializer::serializeMetaData(proto::iir::StencilInstantiation& target,
                                       iir::StencilMetaInformation& metaData) {
   auto protoMetaData = target.mutable_metadata();
@@ -427,9 +520,46 @@ void IIRSerializer::serializeIIR(proto::iir::StencilInstantiation& target,
   }
 }
 
-std::string
-IIRSerializer::serializeImpl(const std::shared_ptr<iir::StencilInstantiation>& instantiation,
-                             Format kind) {
+void IIRSerializer::serializeDerivedInfo(proto::iir::StencilInstantiation& target,
+                                         const std::unique_ptr<iir::IIR>& iir) {
+  auto protoDerivedInfo = target.mutable_derivedinfo();
+
+  for(const auto& stencil : iir->getChildren()) {
+    auto protoStencil = protoDerivedInfo->add_stencils();
+    for(const auto& multiStage : stencil->getChildren()) {
+      auto protoMSS = protoStencil->add_multistages();
+      for(const auto& stage : multiStage->getChildren()) {
+        auto protoStage = protoMSS->add_stages();
+        for(const auto& doMethod : stage->getChildren()) {
+          setDerivedFields(protoStage->add_domethods()->mutable_fields(), doMethod->getFields());
+        }
+
+        auto setIDs = [](google::protobuf::RepeatedField<int>* protoIDs,
+                         const std::unordered_set<int>& IDs) {
+          for(int ID : IDs)
+            protoIDs->Add(ID);
+          std::sort(protoIDs->begin(), protoIDs->end());
+        };
+        setIDs(protoStage->mutable_globalvariables(), stage->getGlobalVariables());
+        setIDs(protoStage->mutable_globalvariablesfromstencilfunctioncalls(),
+               stage->getGlobalVariablesFromStencilFunctionCalls());
+
+        *protoStage->mutable_extents() = makeProtoExtents(stage->getExtents());
+        protoStage->set_requiressync(stage->getRequiresSync());
+      }
+    }
+  }
+
+  auto& protoStageIDToName = *protoDerivedInfo->mutable_stageidtoname();
+  for(const auto& [stageID, name] : iir->getStageIDToNameMap())
+    protoStageIDToName.insert({stageID, name});
+
+  protoDerivedInfo->set_checksum(computeChecksum(target));
+}
+
+void IIRSerializer::serializeImpl(
+    const std::shared_ptr<iir::StencilInstantiation>& instantiation,
+    proto::iir::StencilInstantiation& protoStencilInstantiation, bool withDerivedInfo) {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
   /////////////////////////////// WITTODO //////////////////////////////////////////////////////////
   //==------------------------------------------------------------------------------------------==//
@@ -459,7 +589,6 @@ IIRSerializer::serializeImpl(const std::shared_ptr<iir::StencilInstantiation>& i
   //==------------------------------------------------------------------------------------------==//
 
   using namespace dawn::proto::iir;
-  proto::iir::StencilInstantiation protoStencilInstantiation;
   serializeMetaData(protoStencilInstantiation, instantiation->getMetaData());
   auto& fieldNameToBCMap = instantiation->getMetaData().getFieldNameToBCMap();
   std::set<std::string> usedBC;
@@ -470,29 +599,8 @@ IIRSerializer::serializeImpl(const std::shared_ptr<iir::StencilInstantiation>& i
       });
   serializeIIR(protoStencilInstantiation, instantiation->getIIR(), usedBC);
   protoStencilInstantiation.set_filename(instantiation->getMetaData().fileName_);
-
-  // Encode the message
-  std::string str;
-  switch(kind) {
-  case Format::Json: {
-    google::protobuf::util::JsonPrintOptions options;
-    options.add_whitespace = true;
-    options.always_print_primitive_fields = true;
-    options.preserve_proto_field_names = true;
-    auto status =
-        google::protobuf::util::MessageToJsonString(protoStencilInstantiation, &str, options);
-    if(!status.ok())
-      throw std::runtime_error(dawn::format("cannot serialize IIR: %s", status.ToString()));
-    break;
-  }
-  case Format::Byte: {
-    if(!protoStencilInstantiation.SerializeToString(&str))
-      throw std::runtime_error(dawn::format("cannot serialize IIR:"));
-    break;
-  }
-  }
-
-  return str;
+  if(withDerivedInfo)
+    serializeDerivedInfo(protoStencilInstantiation, instantiation->getIIR());
 }
 
 void IIRSerializer::deserializeMetaData(std::shared_ptr<iir::StencilInstantiation>& target,
@@ -760,26 +868,101 @@ void IIRSerializer::deserializeIIR(std::shared_ptr<iir::StencilInstantiation>& t
   }
 }
 
-std::shared_ptr<iir::StencilInstantiation>
-IIRSerializer::deserializeImpl(const std::string& str, IIRSerializer::Format kind) {
-  GOOGLE_PROTOBUF_VERIFY_VERSION;
-  // Decode the string
-  proto::iir::StencilInstantiation protoStencilInstantiation;
+bool IIRSerializer::deserializeDerivedInfo(
+    std::shared_ptr<iir::StencilInstantiation>& target,
+    const proto::iir::StencilInstantiation& protoStencilInstantiation) {
+  const auto& protoDerivedInfo = protoStencilInstantiation.derivedinfo();
+  if(protoDerivedInfo.checksum() != computeChecksum(protoStencilInstantiation))
+    return false;
+
+  // Make sure the shape of the derived information matches the IIR tree before modifying it
+  const auto& protoStencils = protoStencilInstantiation.internalir().stencils();
+  if(protoDerivedInfo.stencils_size() != protoStencils.size())
+    return false;
+  for(int stencilIdx = 0; stencilIdx < protoStencils.size(); ++stencilIdx) {
+    const auto& protoMSSs = protoStencils[stencilIdx].multistages();
+    const auto& derivedMSSs = protoDerivedInfo.stencils(stencilIdx).multistages();
+    if(derivedMSSs.size() != protoMSSs.size())
+      return false;
+    for(int mssIdx = 0; mssIdx < protoMSSs.size(); ++mssIdx) {
+      const auto& protoStages = protoMSSs[mssIdx].stages();
+      const auto& derivedStages = derivedMSSs[mssIdx].stages();
+      if(derivedStages.size() != protoStages.size())
+        return false;
+      for(int stageIdx = 0; stageIdx < protoStages.size(); ++stageIdx) {
+        if(derivedStages[stageIdx].domethods_size() != protoStages[stageIdx].domethods_size())
+          return false;
+      }
+    }
+  }
+
+  const auto& metadata = target->getMetaData();
+  int stencilIdx = 0;
+  for(const auto& stencil : target->getIIR()->getChildren()) {
+    const auto& protoStencil = protoDerivedInfo.stencils(stencilIdx++);
+    int mssIdx = 0;
+    for(const auto& multiStage : stencil->getChildren()) {
+      const auto& protoMSS = protoStencil.multistages(mssIdx++);
+      int stageIdx = 0;
+      for(const auto& stage : multiStage->getChildren()) {
+        const auto& protoStage = protoMSS.stages(stageIdx++);
+        // Same as `Stage::updateFromChildren` without traversing the ASTs for the global variables
+        auto& stageInfo = stage->derivedInfo_;
+        stageInfo.clear();
+        int doMethodIdx = 0;
+        for(const auto& doMethod : stage->getChildren()) {
+          doMethod->derivedInfo_.fields_ =
+              makeDerivedFields(protoStage.domethods(doMethodIdx++).fields(), metadata);
+          iir::mergeFields(doMethod->getFields(), stageInfo.fields_);
+        }
+
+        stageInfo.globalVariables_.insert(protoStage.globalvariables().begin(),
+                                          protoStage.globalvariables().end());
+        stageInfo.globalVariablesFromStencilFunctionCalls_.insert(
+            protoStage.globalvariablesfromstencilfunctioncalls().begin(),
+            protoStage.globalvariablesfromstencilfunctioncalls().end());
+        stageInfo.allGlobalVariables_.insert(stageInfo.globalVariables_.begin(),
+                                             stageInfo.globalVariables_.end());
+        stageInfo.allGlobalVariables_.insert(
+            stageInfo.globalVariablesFromStencilFunctionCalls_.begin(),
+            stageInfo.globalVariablesFromStencilFunctionCalls_.end());
+
+        stage->setExtents(makeExtents(&protoStage.extents()));
+        stage->setRequiresSync(protoStage.requiressync());
+      }
+      multiStage->clearDerivedInfo();
+      multiStage->updateFromChildren();
+    }
+    stencil->updateFromChildren();
+  }
+  target->getIIR()->updateFromChildren();
+
+  for(const auto& [stageID, name] : protoDerivedInfo.stageidtoname())
+    target->getIIR()->getStageIDToNameMap().emplace(stageID, name);
+
+  return true;
+}
+
+/// @brief Decode `protoStencilInstantiation` from `size` bytes at `data`
+static void parse(const char* data, std::size_t size, IIRSerializer::Format kind,
+                  proto::iir::StencilInstantiation& protoStencilInstantiation) {
   switch(kind) {
   case dawn::IIRSerializer::Format::Json: {
-    auto status = google::protobuf::util::JsonStringToMessage(str, &protoStencilInstantiation);
-    if(!status.ok())
-      throw std::runtime_error(
-          dawn::format("cannot deserialize StencilInstantiation: %s", status.ToString()));
+    auto error = parseProtoFromJson(data, size, protoStencilInstantiation);
+    if(!error.empty())
+      throw std::runtime_error(dawn::format("cannot deserialize StencilInstantiation: %s", error));
     break;
   }
   case dawn::IIRSerializer::Format::Byte: {
-    if(!protoStencilInstantiation.ParseFromString(str))
+    if(!parseProtoFromBytes(data, size, protoStencilInstantiation))
       throw std::runtime_error("cannot deserialize StencilInstantiation");
     break;
   }
   }
+}
 
+std::shared_ptr<iir::StencilInstantiation>
+IIRSerializer::deserializeImpl(const proto::iir::StencilInstantiation& protoStencilInstantiation) {
   std::shared_ptr<iir::StencilInstantiation> target;
 
   switch(protoStencilInstantiation.internalir().gridtype()) {
@@ -798,43 +981,94 @@ IIRSerializer::deserializeImpl(const std::string& str, IIRSerializer::Format kin
   deserializeMetaData(target, (protoStencilInstantiation.metadata()), maxID);
   target->getMetaData().fileName_ = protoStencilInstantiation.filename();
   UIDGenerator::getInstance()->set(maxID + 1);
-  target->computeDerivedInfo();
+  if(!protoStencilInstantiation.has_derivedinfo() ||
+     !deserializeDerivedInfo(target, protoStencilInstantiation))
+    target->computeDerivedInfo();
 
   return target;
 }
 
 std::shared_ptr<iir::StencilInstantiation> IIRSerializer::deserialize(const std::string& file,
                                                                       IIRSerializer::Format kind) {
-  std::ifstream ifs(file);
-  if(!ifs.is_open()) {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+  MappedFile input(file);
+  if(!input.isOpen()) {
     throw std::runtime_error(
         dawn::format("cannot deserialize IIR: failed to open file \"%s\"", file));
   }
-  std::string str((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
 
-  return deserializeImpl(str, kind);
+  google::protobuf::Arena arena;
+  auto protoStencilInstantiation =
+      google::protobuf::Arena::CreateMessage<proto::iir::StencilInstantiation>(&arena);
+  parse(input.data(), input.size(), kind, *protoStencilInstantiation);
+  return deserializeImpl(*protoStencilInstantiation);
 }
 
 std::shared_ptr<iir::StencilInstantiation>
 IIRSerializer::deserializeFromString(const std::string& str, IIRSerializer::Format kind) {
-  return deserializeImpl(str, kind);
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+  google::protobuf::Arena arena;
+  auto protoStencilInstantiation =
+      google::protobuf::Arena::CreateMessage<proto::iir::StencilInstantiation>(&arena);
+  parse(str.data(), str.size(), kind, *protoStencilInstantiation);
+  return deserializeImpl(*protoStencilInstantiation);
 }
 
 void IIRSerializer::serialize(const std::string& file,
                               const std::shared_ptr<iir::StencilInstantiation> instantiation,
-                              dawn::IIRSerializer::Format kind) {
-  std::ofstream ofs(file);
+                              dawn::IIRSerializer::Format kind, bool withDerivedInfo) {
+  std::ofstream ofs(file, std::ios::binary);
   if(!ofs.is_open()) {
     throw std::runtime_error(format("cannot serialize IIR: failed to open file \"%s\"", file));
   }
-  auto str = serializeImpl(instantiation, kind);
-  std::copy(str.begin(), str.end(), std::ostreambuf_iterator<char>(ofs));
+
+  google::protobuf::Arena arena;
+  auto protoStencilInstantiation =
+      google::protobuf::Arena::CreateMessage<proto::iir::StencilInstantiation>(&arena);
+  serializeImpl(instantiation, *protoStencilInstantiation, withDerivedInfo);
+
+  // Encode the message directly into the file
+  switch(kind) {
+  case Format::Json: {
+    auto error = writeProtoAsJson(*protoStencilInstantiation, ofs);
+    if(!error.empty())
+      throw std::runtime_error(dawn::format("cannot serialize IIR: %s", error));
+    break;
+  }
+  case Format::Byte: {
+    if(!writeProtoAsBytes(*protoStencilInstantiation, ofs))
+      throw std::runtime_error(dawn::format("cannot serialize IIR:"));
+    break;
+  }
+  }
+  if(!ofs.flush())
+    throw std::runtime_error(format("cannot serialize IIR: failed to write file \"%s\"", file));
 }
 
 std::string
 IIRSerializer::serializeToString(const std::shared_ptr<iir::StencilInstantiation> instantiation,
-                                 dawn::IIRSerializer::Format kind) {
-  return serializeImpl(instantiation, kind);
+                                 dawn::IIRSerializer::Format kind, bool withDerivedInfo) {
+  google::protobuf::Arena arena;
+  auto protoStencilInstantiation =
+      google::protobuf::Arena::CreateMessage<proto::iir::StencilInstantiation>(&arena);
+  serializeImpl(instantiation, *protoStencilInstantiation, withDerivedInfo);
+
+  // Encode the message
+  std::string str;
+  switch(kind) {
+  case Format::Json: {
+    auto error = writeProtoAsJson(*protoStencilInstantiation, str);
+    if(!error.empty())
+      throw std::runtime_error(dawn::format("cannot serialize IIR: %s", error));
+    break;
+  }
+  case Format::Byte: {
+    if(!protoStencilInstantiation->SerializeToString(&str))
+      throw std::runtime_error(dawn::format("cannot serialize IIR:"));
+    break;
+  }
+  }
+  return str;
 }
 
 } // namespace dawn
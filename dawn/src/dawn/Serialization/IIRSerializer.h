@@ -43,6 +43,8 @@ public:
 
   /// @brief Deserialize the StencilInstantiation from `file`
   ///
+  /// The file is memory mapped and decoded from the mapping, without reading it into a string.
+  ///
   /// @param file    Path the file
   /// @param kind    The kind of serialization used in `file` (Json or Byte)
   /// @throws std::exception    Failed to deserialize
@@ -61,32 +63,37 @@ public:
 
   /// @brief Serialize the StencilInstantiation as a Json or Byte formatted string to `file`
   ///
+  /// The encoding is streamed to `file` instead of being built in memory first.
+  ///
   /// @param file          Path the file
   /// @param instantiation StencilInstantiation to serialize
   /// @param kind          The kind of serialization to use to write to `file` (Json or Byte)
+  /// @param withDerivedInfo  Also store the derived information (fields, extents, stage names) of
+  ///                         the IIR such that it is not recomputed on deserialization
   /// @throws std::exception    Failed to open `file`
   static void serialize(const std::string& file,
                         const std::shared_ptr<iir::StencilInstantiation> instantiation,
-                        dawn::IIRSerializer::Format kind = Format::Json);
+                        dawn::IIRSerializer::Format kind = Format::Json,
+                        bool withDerivedInfo = false);
 
   /// @brief Serialize the StencilInstantiation as a Json or Byte formatted string
   ///
   /// @param instantiation StencilInstantiation to serialize
   /// @param kind         The kind of serialization to use when writing to the string (Json or Byte)
+  /// @param withDerivedInfo  Also store the derived information of the IIR (see `serialize`)
   /// @returns JSON formatted string of `StencilInstantiation`
   static std::string
   serializeToString(const std::shared_ptr<iir::StencilInstantiation> instantiation,
-                    Format kind = Format::Json);
+                    Format kind = Format::Json, bool withDerivedInfo = false);
 
 private:
   /// @brief The implementation of deserialization used for string and file. This delegates to the
   /// separate implementations of deserializing the IIR and the Metadata
   ///
-  /// @param str    the sting to deserialize
-  /// @param kind   The kind of serialization used in `str` (Json or Byte)
-  /// @param target The newly created StencilInstantiation
-  static std::shared_ptr<iir::StencilInstantiation> deserializeImpl(const std::string& str,
-                                                                    IIRSerializer::Format kind);
+  /// @param protoStencilInstantiation  the decoded protobuf version of the StencilInstantiation
+  /// @returns The newly created StencilInstantiation
+  static std::shared_ptr<iir::StencilInstantiation>
+  deserializeImpl(const proto::iir::StencilInstantiation& protoStencilInstantiation);
 
   /// @brief deserializeIIR does deserialization of the IIR tree
   /// @param target     the StencilInstantiation to insert the IIR into
@@ -104,14 +111,25 @@ private:
   static void deserializeMetaData(std::shared_ptr<iir::StencilInstantiation>& target,
                                   const proto::iir::StencilMetaInfo& protoMetaData, int& maxID);
 
+  /// @brief deserializeDerivedInfo restores the derived information of the IIR tree instead of
+  /// recomputing it
+  /// @param target                     the StencilInstantiation with deserialized IIR and metadata
+  /// @param protoStencilInstantiation  the serialized protobuf version of the StencilInstantiation
+  /// @returns `false` if the derived information does not match the IIR (in which case `target` is
+  ///          left untouched)
+  static bool
+  deserializeDerivedInfo(std::shared_ptr<iir::StencilInstantiation>& target,
+                         const proto::iir::StencilInstantiation& protoStencilInstantiation);
+
   /// @brief The implementation of serialization used for string and file. This delegates to the
   /// separate implementations of serializing the IIR and the Metadata
   ///
-  /// @param instantiation  The StencilInstantiation to fill
-  /// @param kind           The kind of serialization used in the return value (Json or Byte)
-  /// @return               The serialized string
-  static std::string serializeImpl(const std::shared_ptr<iir::StencilInstantiation>& instantiation,
-                                   dawn::IIRSerializer::Format kind);
+  /// @param instantiation  The StencilInstantiation to serialize
+  /// @param target         The protobuf version of the StencilInstantiation to fill, which is
+  ///                       then encoded to a string or directly to a file
+  /// @param withDerivedInfo  Also serialize the derived information of the IIR
+  static void serializeImpl(const std::shared_ptr<iir::StencilInstantiation>& instantiation,
+                            proto::iir::StencilInstantiation& target, bool withDerivedInfo);
   /// @brief serializeIIR serializes the IIR tree
   /// @param target     The protobuf version of the StencilInstantiation to serialize the IIR into
   /// @param iir        The IIR to serialize
@@ -123,6 +141,12 @@ private:
   /// @param metaData  The Metadata to serialize
   static void serializeMetaData(proto::iir::StencilInstantiation& target,
                                 iir::StencilMetaInformation& metaData);
+  /// @brief serializeDerivedInfo serializes the derived information of the IIR tree together with
+  /// the checksum of the already serialized IIR and Metadata
+  /// @param target    The protobuf version of the StencilInstantiation to serialize the info to
+  /// @param iir       The IIR to serialize the derived information of
+  static void serializeDerivedInfo(proto::iir::StencilInstantiation& target,
+                                   const std::unique_ptr<iir::IIR>& iir);
 };
 
 } // namespace dawn
@@ -0,0 +1,297 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Serialization/ProtobufIO.h"
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/util/json_util.h>
+#include <google/protobuf/util/type_resolver.h>
+#include <google/protobuf/util/type_resolver_util.h>
+#include <iterator>
+#include <memory>
+#include <streambuf>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DAWN_SERIALIZATION_HAS_MMAP
+#endif
+
+namespace dawn {
+
+MappedFile::MappedFile(const std::string& file) {
+#ifdef DAWN_SERIALIZATION_HAS_MMAP
+  const int fd = ::open(file.c_str(), O_RDONLY);
+  if(fd < 0)
+    return;
+  isOpen_ = true;
+
+  struct stat status;
+  if(::fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0) {
+    void* addr = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(addr != MAP_FAILED) {
+      // The parsers read the file front to back
+      ::madvise(addr, status.st_size, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(addr);
+      size_ = status.st_size;
+      isMapped_ = true;
+    }
+  }
+
+  if(!isMapped_) {
+    // Pipes, empty files or mapping failures: read everything
+    char chunk[1 << 16];
+    ssize_t numRead;
+    while((numRead = ::read(fd, chunk, sizeof(chunk))) > 0)
+      buffer_.append(chunk, numRead);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+  ::close(fd);
+#else
+  std::ifstream ifs(file, std::ios::binary);
+  if(!ifs.is_open())
+    return;
+  isOpen_ = true;
+  buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef DAWN_SERIALIZATION_HAS_MMAP
+  if(isMapped_)
+    ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+namespace {
+
+/// @brief Type resolver of the generated messages, as used by `MessageToJsonString`
+google::protobuf::util::TypeResolver* getTypeResolver() {
+  static std::unique_ptr<google::protobuf::util::TypeResolver> resolver(
+      google::protobuf::util::NewTypeResolverForDescriptorPool(
+          "type.googleapis.com", google::protobuf::DescriptorPool::generated_pool()));
+  return resolver.get();
+}
+
+std::string getTypeUrl(const google::protobuf::Message& message) {
+  return "type.googleapis.com/" + message.GetDescriptor()->full_name();
+}
+
+google::protobuf::util::JsonPrintOptions getJsonPrintOptions() {
+  google::protobuf::util::JsonPrintOptions options;
+  options.add_whitespace = true;
+  options.always_print_primitive_fields = true;
+  options.preserve_proto_field_names = true;
+  return options;
+}
+
+/// @brief Convert the byte encoding of `message` to JSON (with a trailing newline) in `str`
+std::string printJson(const google::protobuf::Message& message, std::string& str) {
+  const std::string bytes = message.SerializeAsString();
+  google::protobuf::io::ArrayInputStream input(bytes.data(), bytes.size());
+  google::protobuf::io::StringOutputStream output(&str);
+  auto status = google::protobuf::util::BinaryToJsonStream(
+      getTypeResolver(), getTypeUrl(message), &input, &output, getJsonPrintOptions());
+  return status.ok() ? std::string() : status.ToString();
+}
+
+/// @brief Write [begin, end) to `os`, indenting all but the first line by `indent` more spaces
+void writeIndented(std::ostream& os, const char* begin, const char* end, int indent) {
+  const std::string newLine = "\n" + std::string(indent, ' ');
+  for(const char* line = begin; line != end;) {
+    const char* lineEnd = std::find(line, end, '\n');
+    os.write(line, lineEnd - line);
+    if(lineEnd == end)
+      break;
+    os << newLine;
+    line = lineEnd + 1;
+  }
+}
+
+/// @brief Write the JSON encoding of `message`, whose lines are indented by `indent` spaces
+///
+/// The printer of protobuf needs to build a tree of the whole message to print the fields with
+/// default values, which takes hundreds of times the size of the byte encoding. Messages larger
+/// than `chunkSize` are thus printed as a skeleton, where their message fields are replaced by
+/// empty placeholders, into which the fields are printed separately (recursively).
+std::string writeJson(google::protobuf::Message& message, std::ostream& os, int indent,
+                      std::size_t chunkSize) {
+  using google::protobuf::FieldDescriptor;
+  const google::protobuf::Descriptor* descriptor = message.GetDescriptor();
+  const google::protobuf::Reflection* reflection = message.GetReflection();
+
+  std::vector<const FieldDescriptor*> fields;
+  if(message.ByteSizeLong() > chunkSize) {
+    for(int i = 0; i < descriptor->field_count(); ++i) {
+      const FieldDescriptor* field = descriptor->field(i);
+      // Well known types (e.g. wrappers) have a special JSON representation
+      if(field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE || field->is_map() ||
+         field->message_type()->file()->package() == "google.protobuf")
+        continue;
+      if(field->is_repeated() ? reflection->FieldSize(message, field) > 0
+                              : reflection->HasField(message, field))
+        fields.push_back(field);
+    }
+  }
+
+  std::string skeleton;
+  if(fields.empty()) {
+    auto error = printJson(message, skeleton);
+    if(error.empty())
+      writeIndented(os, skeleton.data(), skeleton.data() + skeleton.size() - 1, indent);
+    return error;
+  }
+
+  // Move the fields into `holder` (on the same arena, such that only pointers are swapped) and
+  // print the remaining message with empty placeholders
+  google::protobuf::Message* holder = message.New(message.GetArena());
+  std::unique_ptr<google::protobuf::Message> holderOwner(message.GetArena() ? nullptr : holder);
+  reflection->SwapFields(&message, holder, fields);
+  for(const FieldDescriptor* field : fields)
+    if(!field->is_repeated())
+      reflection->MutableMessage(&message, field);
+  auto error = printJson(message, skeleton);
+  reflection->SwapFields(&message, holder, fields);
+  if(!error.empty())
+    return error;
+
+  // The placeholders are the values of the top level keys of the fields in the skeleton: `[]` for
+  // repeated fields and the empty message, printed with its default values, otherwise
+  struct Placeholder {
+    std::size_t begin, end;
+    const FieldDescriptor* field;
+    bool operator<(const Placeholder& other) const { return begin < other.begin; }
+  };
+  std::vector<Placeholder> placeholders;
+  for(const FieldDescriptor* field : fields) {
+    const std::string key = "\n \"" + field->name() + "\": ";
+    const std::size_t begin = skeleton.find(key);
+    if(begin == std::string::npos)
+      return "missing placeholder of " + field->full_name();
+    Placeholder placeholder{begin + key.size(), begin + key.size() + 2, field};
+    if(skeleton.compare(placeholder.begin, 2, field->is_repeated() ? "[]" : "{}") != 0) {
+      const std::size_t end = skeleton.find("\n }", placeholder.begin);
+      if(field->is_repeated() || end == std::string::npos)
+        return "missing placeholder of " + field->full_name();
+      placeholder.end = end + 3;
+    }
+    placeholders.push_back(placeholder);
+  }
+  std::sort(placeholders.begin(), placeholders.end());
+
+  const std::string elementIndent(indent + 2, ' ');
+  std::size_t pos = 0;
+  for(const Placeholder& placeholder : placeholders) {
+    const FieldDescriptor* field = placeholder.field;
+    writeIndented(os, skeleton.data() + pos, skeleton.data() + placeholder.begin, indent);
+    pos = placeholder.end;
+
+    if(field->is_repeated()) {
+      os << "[";
+      const int size = reflection->FieldSize(message, field);
+      for(int i = 0; i < size; ++i) {
+        os << "\n" << elementIndent;
+        error = writeJson(*reflection->MutableRepeatedMessage(&message, field, i), os,
+                          indent + 2, chunkSize);
+        if(!error.empty())
+          return error;
+        os << (i + 1 < size ? "," : "");
+      }
+      os << "\n" << std::string(indent + 1, ' ') << "]";
+    } else {
+      error = writeJson(*reflection->MutableMessage(&message, field), os, indent + 1, chunkSize);
+      if(!error.empty())
+        return error;
+    }
+  }
+  writeIndented(os, skeleton.data() + pos, skeleton.data() + skeleton.size() - 1, indent);
+  return std::string();
+}
+
+/// @brief Stream buffer appending to a string
+class StringBuffer : public std::streambuf {
+public:
+  explicit StringBuffer(std::string& str) : str_(str) {}
+
+protected:
+  int_type overflow(int_type c) override {
+    if(!traits_type::eq_int_type(c, traits_type::eof()))
+      str_.push_back(traits_type::to_char_type(c));
+    return c;
+  }
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    str_.append(s, n);
+    return n;
+  }
+
+private:
+  std::string& str_;
+};
+
+} // namespace
+
+bool parseProtoFromBytes(const char* data, std::size_t size, google::protobuf::Message& message) {
+  if(size > INT_MAX)
+    return false;
+  return message.ParseFromArray(data, static_cast<int>(size));
+}
+
+std::string parseProtoFromJson(const char* data, std::size_t size,
+                               google::protobuf::Message& message) {
+  if(size > INT_MAX)
+    return "input exceeds 2GB";
+  // The JSON parser emits the byte encoding, which is then parsed into `message`
+  google::protobuf::io::ArrayInputStream input(data, static_cast<int>(size));
+  std::string bytes;
+  google::protobuf::io::StringOutputStream output(&bytes);
+  auto status = google::protobuf::util::JsonToBinaryStream(
+      getTypeResolver(), getTypeUrl(message), &input, &output,
+      google::protobuf::util::JsonParseOptions());
+  if(!status.ok())
+    return status.ToString();
+  if(!message.ParseFromString(bytes))
+    return "invalid " + message.GetDescriptor()->full_name();
+  return std::string();
+}
+
+std::string writeProtoAsJson(google::protobuf::Message& message, std::ostream& os,
+                             std::size_t chunkSize) {
+  auto error = writeJson(message, os, 0, chunkSize);
+  os << "\n";
+  return error;
+}
+
+std::string writeProtoAsJson(google::protobuf::Message& message, std::string& str,
+                             std::size_t chunkSize) {
+  StringBuffer buffer(str);
+  std::ostream os(&buffer);
+  return writeProtoAsJson(message, os, chunkSize);
+}
+
+bool writeProtoAsBytes(const google::protobuf::Message& message, std::ostream& os) {
+  return message.SerializeToOstream(&os);
+}
+
+} // namespace dawn
@@ -0,0 +1,81 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/Support/NonCopyable.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace google {
+namespace protobuf {
+class Message;
+} // namespace protobuf
+} // namespace google
+
+namespace dawn {
+
+/// @brief Read-only view of the contents of a file
+///
+/// The file is memory mapped where supported, such that messages can be parsed from it without
+/// copying it into a string first. Otherwise (or if mapping fails, e.g. for pipes) the file is read
+/// into an internal buffer.
+class MappedFile : NonCopyable {
+public:
+  /// @brief Map `file`, check `isOpen` for success
+  explicit MappedFile(const std::string& file);
+  ~MappedFile();
+
+  bool isOpen() const { return isOpen_; }
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+  bool isOpen_ = false;
+  bool isMapped_ = false;
+  std::string buffer_;
+};
+
+/// @brief Parse `message` from the protobuf byte encoded `data`
+/// @returns `false` if `data` is not a valid encoding of `message`
+bool parseProtoFromBytes(const char* data, std::size_t size, google::protobuf::Message& message);
+
+/// @brief Parse `message` from the JSON encoded `data` without copying `data`
+/// @returns the error message of the parser, empty on success
+std::string parseProtoFromJson(const char* data, std::size_t size,
+                               google::protobuf::Message& message);
+
+/// @brief Write the JSON encoding of `message` (with whitespace, default values and the proto
+/// field names, as written by the serializers) to `os`
+///
+/// Message fields of messages whose byte encoding is larger than `chunkSize` are printed one by
+/// one, which bounds the memory needed by the printer of protobuf. For this, they are temporarily
+/// moved out of `message`, which is unchanged on return.
+/// @returns the error message of the printer, empty on success
+std::string writeProtoAsJson(google::protobuf::Message& message, std::ostream& os,
+                             std::size_t chunkSize = 64 * 1024);
+
+/// @brief Write the JSON encoding of `message` (see above) to `str`
+/// @returns the error message of the printer, empty on success
+std::string writeProtoAsJson(google::protobuf::Message& message, std::string& str,
+                             std::size_t chunkSize = 64 * 1024);
+
+/// @brief Write the protobuf byte encoding of `message` to `os`
+/// @returns `false` if the message could not be written
+bool writeProtoAsBytes(const google::protobuf::Message& message, std::ostream& os);
+
+} // namespace dawn
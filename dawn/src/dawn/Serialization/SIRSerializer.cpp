@@ -18,11 +18,13 @@
 #include "dawn/SIR/SIR/SIR.pb.h"
 #include "dawn/AST/AST/statements.pb.h"
 #include "dawn/Serialization/ASTSerializer.h"
+#include "dawn/Serialization/ProtobufIO.h"
 #include "dawn/Support/Exception.h"
 #include "dawn/Support/Format.h"
 #include "dawn/Support/Logger.h"
 #include "dawn/Support/Unreachable.h"
-#include <google/protobuf/util/json_util.h>
+#include <fstream>
+#include <google/protobuf/arena.h>
 #include <list>
 #include <memory>
 #include <stdexcept>
@@ -108,13 +110,11 @@ SIRSerializer::Format SIRSerializer::parseFormatString(const std::string& format
 //     Serialization
 //===------------------------------------------------------------------------------------------===//
 
-static std::string serializeImpl(const SIR* sir, SIRSerializer::Format kind) {
+static void serializeImpl(const SIR* sir, proto::sir::SIR& sirProto) {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
   ProtobufLogger::init();
 
   // Convert SIR to protobuf SIR
-  proto::sir::SIR sirProto;
-
   // SIR.GridType
   switch(sir->GridType) {
   case ast::GridType::Cartesian:
@@ -215,42 +215,59 @@ static std::string serializeImpl(const SIR* sir, SIRSerializer::Format kind) {
 
     mapProto->insert({name, valueProto});
   }
+}
 
-  // Encode the message
-  std::string str;
+void SIRSerializer::serialize(const std::string& file, const SIR* sir, SIRSerializer::Format kind) {
+  std::ofstream ofs(file, std::ios::binary);
+  if(!ofs.is_open())
+    throw std::runtime_error(format("cannot serialize SIR: failed to open file \"%s\"", file));
+
+  google::protobuf::Arena arena;
+  auto sirProto = google::protobuf::Arena::CreateMessage<proto::sir::SIR>(&arena);
+  serializeImpl(sir, *sirProto);
+
+  // Encode the message directly into the file
   switch(kind) {
   case dawn::SIRSerializer::Format::Json: {
-    google::protobuf::util::JsonPrintOptions options;
-    options.add_whitespace = true;
-    options.always_print_primitive_fields = true;
-    options.preserve_proto_field_names = true;
-    auto status = google::protobuf::util::MessageToJsonString(sirProto, &str, options);
-    if(!status.ok())
-      throw std::runtime_error(format("cannot serialize SIR: %s", status.ToString()));
+    auto error = writeProtoAsJson(*sirProto, ofs);
+    if(!error.empty())
+      throw std::runtime_error(format("cannot serialize SIR: %s", error));
     break;
   }
   case dawn::SIRSerializer::Format::Byte: {
-    if(!sirProto.SerializeToString(&str))
+    if(!writeProtoAsBytes(*sirProto, ofs))
       throw std::runtime_error(dawn::format(
-          "cannot deserialize SIR: %s", ProtobufLogger::getInstance().getErrorMessagesAndReset()));
+          "cannot serialize SIR: %s", ProtobufLogger::getInstance().getErrorMessagesAndReset()));
     break;
   }
   }
-
-  return str;
+  if(!ofs.flush())
+    throw std::runtime_error(format("cannot serialize SIR: failed to write file \"%s\"", file));
 }
 
-void SIRSerializer::serialize(const std::string& file, const SIR* sir, SIRSerializer::Format kind) {
-  std::ofstream ofs(file);
-  if(!ofs.is_open())
-    throw std::runtime_error(format("cannot serialize SIR: failed to open file \"%s\"", file));
+std::string SIRSerializer::serializeToString(const SIR* sir, SIRSerializer::Format kind) {
+  google::protobuf::Arena arena;
+  auto sirProto = google::protobuf::Arena::CreateMessage<proto::sir::SIR>(&arena);
+  serializeImpl(sir, *sirProto);
 
-  auto str = serializeImpl(sir, kind);
-  std::copy(str.begin(), str.end(), std::ostreambuf_iterator<char>(ofs));
-}
+  // Encode the message
+  std::string str;
+  switch(kind) {
+  case dawn::SIRSerializer::Format::Json: {
+    auto error = writeProtoAsJson(*sirProto, str);
+    if(!error.empty())
+      throw std::runtime_error(format("cannot serialize SIR: %s", error));
+    break;
+  }
+  case dawn::SIRSerializer::Format::Byte: {
+    if(!sirProto->SerializeToString(&str))
+      throw std::runtime_error(dawn::format(
+          "cannot serialize SIR: %s", ProtobufLogger::getInstance().getErrorMessagesAndReset()));
+    break;
+  }
+  }
 
-std::string SIRSerializer::serializeToString(const SIR* sir, SIRSerializer::Format kind) {
-  return serializeImpl(sir, kind);
+  return str;
 }
 
 //===------------------------------------------------------------------------------------------===//
@@ -651,22 +668,24 @@ static std::shared_ptr<ast::AST> makeAST(const dawn::proto::ast::AST& astProto)
   return ast;
 }
 
-static std::shared_ptr<SIR> deserializeImpl(const std::string& str, SIRSerializer::Format kind) {
+static std::shared_ptr<SIR> deserializeImpl(const char* data, std::size_t size,
+                                            SIRSerializer::Format kind) {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
   using namespace sir;
   ProtobufLogger::init();
 
   // Decode the string
-  proto::sir::SIR sirProto;
+  google::protobuf::Arena arena;
+  proto::sir::SIR& sirProto = *google::protobuf::Arena::CreateMessage<proto::sir::SIR>(&arena);
   switch(kind) {
   case dawn::SIRSerializer::Format::Json: {
-    auto status = google::protobuf::util::JsonStringToMessage(str, &sirProto);
-    if(!status.ok())
-      throw std::runtime_error(dawn::format("cannot deserialize SIR: %s", status.ToString()));
+    auto error = parseProtoFromJson(data, size, sirProto);
+    if(!error.empty())
+      throw std::runtime_error(dawn::format("cannot deserialize SIR: %s", error));
     break;
   }
   case dawn::SIRSerializer::Format::Byte: {
-    if(!sirProto.ParseFromString(str))
+    if(!parseProtoFromBytes(data, size, sirProto))
       throw std::runtime_error(dawn::format(
           "cannot deserialize SIR: %s", ProtobufLogger::getInstance().getErrorMessagesAndReset()));
     break;
@@ -797,18 +816,17 @@ static std::shared_ptr<SIR> deserializeImpl(const std::string& str, SIRSerialize
 
 std::shared_ptr<SIR> SIRSerializer::deserialize(const std::string& file,
                                                 SIRSerializer::Format kind) {
-  std::ifstream ifs(file);
-  if(!ifs.is_open())
+  MappedFile input(file);
+  if(!input.isOpen())
     throw std::runtime_error(
         dawn::format("cannot deserialize SIR: failed to open file \"%s\"", file));
 
-  std::string str((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-  return deserializeImpl(str, kind);
+  return deserializeImpl(input.data(), input.size(), kind);
 }
 
 std::shared_ptr<SIR> SIRSerializer::deserializeFromString(const std::string& str,
                                                           SIRSerializer::Format kind) {
-  return deserializeImpl(str, kind);
+  return deserializeImpl(str.data(), str.size(), kind);
 }
 
 } // namespace dawn
@@ -16,7 +16,6 @@
 
 #include "dawn/Support/Assert.h"
 #include <limits>
-#include <memory>
 
 namespace dawn {
 
@@ -25,19 +24,16 @@ private:
   IndexGenerator(const IndexGenerator&) = delete;
   IndexGenerator& operator=(const IndexGenerator&) = delete;
 
-  static std::unique_ptr<IndexGenerator> instance;
-
   long unsigned int idx_ = 0;
 
 private:
   IndexGenerator() = default;
 
 public:
+  /// @brief One generator per thread, concurrent compilations do not share their indices
   static IndexGenerator& Instance() {
-    if(!instance)
-      instance.reset(new IndexGenerator);
-
-    return *(instance.get());
+    thread_local IndexGenerator instance;
+    return instance;
   }
 
   long unsigned int getIndex() {
@@ -15,10 +15,27 @@
 #include "dawn/Support/Logger.h"
 #include "dawn/Support/Format.h"
 
+#include <atomic>
 #include <sstream>
+#include <unordered_map>
 
 namespace dawn {
 
+namespace {
+/// @brief Serial number of the calling thread, unlike `std::thread::id` never reused
+std::uint64_t thisThreadSerial() {
+  static std::atomic<std::uint64_t> nextSerial(0);
+  thread_local const std::uint64_t serial = nextSerial++;
+  return serial;
+}
+
+/// @brief Number of messages enqueued by the calling thread per logger
+std::unordered_map<const Logger*, Logger::Container::size_type>& numEnqueuedByThisThreadMap() {
+  thread_local std::unordered_map<const Logger*, Logger::Container::size_type> numEnqueued;
+  return numEnqueued;
+}
+} // namespace
+
 Logger::MessageFormatter makeMessageFormatter(const std::string type) {
   return [type](const std::string& msg, const std::string& file, int line) {
     std::stringstream ss;
@@ -81,7 +98,10 @@ DiagnosticProxy Logger::operator()(const std::string& file, int line, const std:
 }
 
 void Logger::doEnqueue(const std::string& message) {
+  ++numEnqueuedByThisThreadMap()[this];
+  std::lock_guard<std::mutex> lock(mutex_);
   data_.push_back(message);
+  threads_.push_back(thisThreadSerial());
   if(show_) {
     *os_ << data_.back();
     if(data_.back().back() != '\n')
@@ -107,7 +127,26 @@ void Logger::messageFormatter(const MessageFormatter& msgFmt) { msgFmt_ = msgFmt
 Logger::DiagnosticFormatter Logger::diagnosticFormatter() const { return diagFmt_; }
 void Logger::diagnosticFormatter(const DiagnosticFormatter& diagFmt) { diagFmt_ = diagFmt; }
 
-void Logger::clear() { data_.clear(); }
+void Logger::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  data_.clear();
+  threads_.clear();
+}
+
+void Logger::clearThisThread() {
+  const std::uint64_t thisThread = thisThreadSerial();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto message = data_.begin();
+  for(auto thread = threads_.begin(); thread != threads_.end();) {
+    if(*thread == thisThread) {
+      message = data_.erase(message);
+      thread = threads_.erase(thread);
+    } else {
+      ++message;
+      ++thread;
+    }
+  }
+}
 
 void Logger::show() { show_ = true; }
 void Logger::hide() { show_ = false; }
@@ -119,6 +158,12 @@ Logger::const_iterator Logger::begin() const { return std::begin(data_); }
 Logger::const_iterator Logger::end() const { return std::end(data_); }
 Logger::Container::size_type Logger::size() const { return std::size(data_); }
 
+Logger::Container::size_type Logger::numEnqueuedByThisThread() const {
+  const auto& numEnqueued = numEnqueuedByThisThreadMap();
+  auto it = numEnqueued.find(this);
+  return it != numEnqueued.end() ? it->second : 0;
+}
+
 std::string createDiagnosticStackTrace(const std::string& prefix,
                                        const DiagnosticStack& inputStack) {
   auto stack = inputStack;
@@ -15,9 +15,11 @@
 #pragma once
 
 #include "dawn/Support/SourceLocation.h"
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <sstream>
 #include <stack>
 #include <string>
@@ -117,6 +119,10 @@ public:
   /// @brief Reset storage
   void clear();
 
+  /// @brief Remove the messages enqueued by the calling thread, the ones of other threads (e.g.
+  /// concurrent compilations) are kept
+  void clearThisThread();
+
   /// @brief Show or hide output from ostream -- still accessible in the container
   /// {
   void show();
@@ -134,6 +140,13 @@ public:
 
   Container::size_type size() const;
 
+  /// @brief Number of messages enqueued by the calling thread since the construction
+  ///
+  /// Unlike `size`, this is not affected by `clear` or by other threads, such that concurrent
+  /// compilations can check for their own errors. The count is kept in thread-local storage and
+  /// thus released when the thread exits.
+  Container::size_type numEnqueuedByThisThread() const;
+
 private:
   void doEnqueue(const std::string& message);
 
@@ -141,7 +154,12 @@ private:
   DiagnosticFormatter diagFmt_;
   std::ostream* os_;
   Container data_;
+  // thread which enqueued the message of the same position in `data_` (identified by a serial
+  // number, as the ids of finished threads are reused)
+  std::list<std::uint64_t> threads_;
   bool show_;
+  // messages may be enqueued concurrently (e.g. by the compilations of a gtclang batch)
+  mutable std::mutex mutex_;
 };
 
 /// @brief create a basic (default) message formatter
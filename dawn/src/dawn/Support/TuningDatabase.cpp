@@ -0,0 +1,91 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/TuningDatabase.h"
+#include "dawn/Support/Json.h"
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace dawn {
+
+namespace {
+
+TuningRecord parseRecord(const json::json& node) {
+  TuningRecord record;
+  record.Backend = node.at("backend").get<std::string>();
+  record.Stencil = node.at("stencil").get<std::string>();
+  record.DomainSize = node.at("domain_size").get<Array3i>();
+  record.Time = node.value("time", 0.0);
+
+  TuningConfiguration& config = record.Configuration;
+  config.TileSize = node.value("tile_size", config.TileSize);
+  config.LoopOrder = node.value("loop_order", config.LoopOrder);
+  config.KParallel = node.value("k_parallel", config.KParallel);
+  config.NumThreads = node.value("num_threads", config.NumThreads);
+  if(config.LoopOrder != "ij" && config.LoopOrder != "ji")
+    throw std::runtime_error("invalid loop order '" + config.LoopOrder + "' of stencil " +
+                             record.Stencil);
+  if(config.TileSize[0] < 0 || config.TileSize[1] < 0 || config.NumThreads < 0)
+    throw std::runtime_error("negative tile size or thread count of stencil " + record.Stencil);
+  return record;
+}
+
+double numPoints(const Array3i& domainSize) {
+  return double(domainSize[0]) * domainSize[1] * domainSize[2];
+}
+
+} // namespace
+
+TuningDatabase TuningDatabase::load(const std::string& file) {
+  std::ifstream ifs(file);
+  if(!ifs)
+    throw std::runtime_error("cannot open tuning database '" + file + "'");
+
+  std::vector<TuningRecord> records;
+  try {
+    json::json database;
+    ifs >> database;
+    for(const auto& node : database.at("records"))
+      records.push_back(parseRecord(node));
+  } catch(const std::exception& e) {
+    throw std::runtime_error("malformed tuning database '" + file + "': " + e.what());
+  }
+  return TuningDatabase(std::move(records));
+}
+
+const TuningRecord* TuningDatabase::lookup(const std::string& backend, const std::string& stencil,
+                                           const Array3i& domainSize) const {
+  const bool knownDomain = domainSize[0] > 0 && domainSize[1] > 0 && domainSize[2] > 0;
+
+  const TuningRecord* best = nullptr;
+  double bestDistance = 0;
+  for(const auto& record : records_) {
+    if(record.Backend != backend || record.Stencil != stencil)
+      continue;
+    if(record.DomainSize == domainSize)
+      return &record;
+    // distance of the domains on a logarithmic scale, the largest domain wins if unknown
+    const double distance = knownDomain ? std::abs(std::log(numPoints(record.DomainSize) /
+                                                            numPoints(domainSize)))
+                                        : -numPoints(record.DomainSize);
+    if(!best || distance < bestDistance) {
+      best = &record;
+      bestDistance = distance;
+    }
+  }
+  return best;
+}
+
+} // namespace dawn
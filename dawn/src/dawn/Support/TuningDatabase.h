@@ -0,0 +1,81 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "dawn/Support/Array.h"
+#include <string>
+#include <vector>
+
+namespace dawn {
+
+/// @brief Code generation parameters of a stencil found by auto-tuning
+/// @ingroup support
+struct TuningConfiguration {
+  /// Horizontal tile size in i and j, 0 leaves the dimension untiled
+  Array2i TileSize = {0, 0};
+  /// Nesting of the horizontal loops, "ij" (i outermost) or "ji"
+  std::string LoopOrder = "ij";
+  /// Parallelize the k-loop of parallel multistages, otherwise the horizontal loops
+  bool KParallel = true;
+  /// Number of OpenMP threads, 0 uses the OpenMP default
+  int NumThreads = 0;
+};
+
+/// @brief Best configuration measured for a stencil on a domain size
+/// @ingroup support
+struct TuningRecord {
+  std::string Backend;
+  std::string Stencil;
+  /// Domain size including the halos (as the `domain-size-*` options)
+  Array3i DomainSize;
+  TuningConfiguration Configuration;
+  /// Run time of the stencil in seconds
+  double Time;
+};
+
+/// @brief Database of auto-tuned code generation parameters
+///
+/// The database is a JSON file written by `dawn4py.autotune`, holding the best configuration per
+/// backend, stencil and domain size:
+///
+/// @code
+///   {"records": [{"backend": "c++-opt", "stencil": "hori_diff", "domain_size": [128, 128, 80],
+///                 "tile_size": [32, 8], "loop_order": "ij", "k_parallel": false,
+///                 "num_threads": 8, "time": 1.2e-3}]}
+/// @endcode
+/// @ingroup support
+class TuningDatabase {
+  std::vector<TuningRecord> records_;
+
+public:
+  TuningDatabase() = default;
+  explicit TuningDatabase(std::vector<TuningRecord> records) : records_(std::move(records)) {}
+
+  /// @brief Read the database from `file`
+  /// @throws std::runtime_error if the file can't be read or is malformed
+  static TuningDatabase load(const std::string& file);
+
+  /// @brief Configuration of `stencil` tuned for the domain size closest to `domainSize`
+  ///
+  /// Records of the exact domain size are preferred, otherwise the one with the closest number of
+  /// grid points is chosen. A domain size which is not known at compile time (any dimension 0)
+  /// picks the largest tuned domain. Returns `nullptr` if the stencil was never tuned.
+  const TuningRecord* lookup(const std::string& backend, const std::string& stencil,
+                             const Array3i& domainSize) const;
+
+  const std::vector<TuningRecord>& getRecords() const { return records_; }
+};
+
+} // namespace dawn
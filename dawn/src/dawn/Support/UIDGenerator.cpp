@@ -13,18 +13,32 @@
 //===------------------------------------------------------------------------------------------===//
 
 #include "dawn/Support/UIDGenerator.h"
+#include <atomic>
 
 namespace dawn {
 
-/* Null, because instance will be initialized on demand. */
-UIDGenerator* UIDGenerator::instance_ = 0;
+namespace {
+// Next identifier after all the ones generated within a sync guard
+std::atomic<int> publishedCounter(1);
+} // namespace
 
 UIDGenerator* UIDGenerator::getInstance() {
-  if(instance_ == 0) {
-    instance_ = new UIDGenerator();
-  }
+  thread_local UIDGenerator instance;
+  return &instance;
+}
+
+UIDGeneratorSyncGuard::UIDGeneratorSyncGuard() {
+  UIDGenerator* generator = UIDGenerator::getInstance();
+  const int published = publishedCounter.load();
+  if(generator->peek() < published)
+    generator->set(published);
+}
 
-  return instance_;
+UIDGeneratorSyncGuard::~UIDGeneratorSyncGuard() {
+  const int counter = UIDGenerator::getInstance()->peek();
+  int published = publishedCounter.load();
+  while(published < counter && !publishedCounter.compare_exchange_weak(published, counter))
+    ;
 }
 
 } // namespace dawn
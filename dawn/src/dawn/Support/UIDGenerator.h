@@ -19,10 +19,12 @@
 namespace dawn {
 
 /// @brief Unique identifier generator (starting from @b 1)
+///
+/// Every thread has its own generator, such that concurrent compilations (e.g. the invocations of
+/// a gtclang batch) do not interfere.
 /// @ingroup support
 class UIDGenerator : NonCopyable {
   int counter_;
-  static UIDGenerator* instance_;
 
   UIDGenerator() : counter_(1) {}
 
@@ -32,10 +34,25 @@ public:
   /// @brief Get a unique *strictly* positive identifer
   int get() { return (counter_++); }
 
+  /// @brief Identifier returned by the next call to `get`
+  int peek() const { return counter_; }
+
   void reset() { set(1); }
 
   /// @brief We need a way to modify the generator after deserialization
   void set(int id) { counter_ = id; }
 };
 
+/// @brief Synchronizes the generator of the calling thread with the ones of other threads
+///
+/// IR created on one thread may later be modified on another one, e.g. by the dawn4py handles used
+/// from a pool of Python threads. Within the scope of a guard the generator continues after the
+/// highest identifier published by any guard so far, and publishes its own on destruction.
+/// @ingroup support
+class UIDGeneratorSyncGuard : NonCopyable {
+public:
+  UIDGeneratorSyncGuard();
+  ~UIDGeneratorSyncGuard();
+};
+
 } // namespace dawn
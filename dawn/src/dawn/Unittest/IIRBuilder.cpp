@@ -60,19 +60,28 @@ Array3i asArray(FieldType ft) {
 
 std::shared_ptr<iir::StencilInstantiation>
 IIRBuilder::build(std::string const& name, std::unique_ptr<iir::Stencil> stencilIIR) {
+  std::vector<std::unique_ptr<iir::Stencil>> stencils;
+  stencils.push_back(std::move(stencilIIR));
+  return build(name, std::move(stencils));
+}
+
+std::shared_ptr<iir::StencilInstantiation>
+IIRBuilder::build(std::string const& name, std::vector<std::unique_ptr<iir::Stencil>> stencils) {
   DAWN_ASSERT(si_);
   // setup the whole stencil instantiation
-  auto stencil_id = stencilIIR->getStencilID();
   si_->getMetaData().setStencilName(name);
-  si_->getIIR()->insertChild(std::move(stencilIIR), si_->getIIR());
+  for(auto& stencilIIR : stencils) {
+    auto stencil_id = stencilIIR->getStencilID();
+    si_->getIIR()->insertChild(std::move(stencilIIR), si_->getIIR());
 
-  auto placeholderStencil = std::make_shared<ast::StencilCall>(
-      iir::InstantiationHelper::makeStencilCallCodeGenName(stencil_id));
-  auto stencilCallDeclStmt = iir::makeStencilCallDeclStmt(placeholderStencil);
-  // Register the call and set it as a replacement for the next vertical region
-  si_->getMetaData().addStencilCallStmt(stencilCallDeclStmt, stencil_id);
+    auto placeholderStencil = std::make_shared<ast::StencilCall>(
+        iir::InstantiationHelper::makeStencilCallCodeGenName(stencil_id));
+    auto stencilCallDeclStmt = iir::makeStencilCallDeclStmt(placeholderStencil);
+    // Register the call and set it as a replacement for the next vertical region
+    si_->getMetaData().addStencilCallStmt(stencilCallDeclStmt, stencil_id);
 
-  si_->getIIR()->getControlFlowDescriptor().insertStmt(stencilCallDeclStmt);
+    si_->getIIR()->getControlFlowDescriptor().insertStmt(stencilCallDeclStmt);
+  }
 
   // update everything
   for(const auto& MS : iterateIIROver<iir::MultiStage>(*(si_->getIIR()))) {
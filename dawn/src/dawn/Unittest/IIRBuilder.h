@@ -336,6 +336,10 @@ public:
   std::shared_ptr<iir::StencilInstantiation> build(std::string const& name,
                                                    std::unique_ptr<iir::Stencil> stencil);
 
+  // generates the final instantiation context, the stencils are called in the given order
+  std::shared_ptr<iir::StencilInstantiation>
+  build(std::string const& name, std::vector<std::unique_ptr<iir::Stencil>> stencils);
+
 protected:
   std::shared_ptr<iir::StencilInstantiation> si_;
 };
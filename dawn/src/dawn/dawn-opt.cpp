@@ -43,6 +43,10 @@ dawn::PassGroup parsePassGroup(const std::string& passGroup) {
     return dawn::PassGroup::PrintStencilGraph;
   else if(passGroup == "SetStageName" || passGroup == "set-stage-name")
     return dawn::PassGroup::SetStageName;
+  else if(passGroup == "ConstantFolding" || passGroup == "constant-folding")
+    return dawn::PassGroup::ConstantFolding;
+  else if(passGroup == "StencilMerger" || passGroup == "stencil-merger")
+    return dawn::PassGroup::StencilMerger;
   else if(passGroup == "StageReordering" || passGroup == "stage-reordering")
     return dawn::PassGroup::StageReordering;
   else if(passGroup == "StageMerger" || passGroup == "stage-merger")
@@ -241,9 +245,11 @@ int main(int argc, char* argv[]) {
                                                 ? dawn::IIRSerializer::Format::Byte
                                                 : dawn::IIRSerializer::Format::Json;
     if(result.count("out"))
-      dawn::IIRSerializer::serialize(result["out"].as<std::string>(), instantiation, iirFormat);
+      dawn::IIRSerializer::serialize(result["out"].as<std::string>(), instantiation, iirFormat,
+                                     optimizerOptions.SerializeIIRDerivedInfo);
     else if(!optimizerOptions.DumpStencilInstantiation) {
-      std::cout << dawn::IIRSerializer::serializeToString(instantiation, iirFormat);
+      std::cout << dawn::IIRSerializer::serializeToString(instantiation, iirFormat,
+                                                          optimizerOptions.SerializeIIRDerivedInfo);
     } else {
       DAWN_LOG(INFO) << "dump-si present. Skipping serialization.";
     }
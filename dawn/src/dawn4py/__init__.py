@@ -18,8 +18,10 @@
 Python bindings for the C++ Dawn compiler project.
 """
 
-from typing import Any, Dict, Optional, Union
+from typing import Any, Dict, Iterable, List, Optional, Union
+import concurrent.futures
 import inspect
+import threading
 
 from . import _dawn4py
 from . import serialization
@@ -28,6 +30,7 @@ from ._dawn4py import OptimizerOptions, CodeGenOptions
 from ._dawn4py import PassGroup, CodeGenBackend
 from ._dawn4py import LogLevel
 from ._dawn4py import default_pass_groups, set_verbosity
+from ._dawn4py import SIR, StencilInstantiation
 
 try:
     import os
@@ -79,6 +82,47 @@ def _serialize_instantiations(stencil_instantiation_map: dict):
     )
 
 
+def _is_handle_map(stencil_instantiation_map: dict):
+    return len(stencil_instantiation_map) > 0 and all(
+        isinstance(si, StencilInstantiation) for si in stencil_instantiation_map.values()
+    )
+
+
+def load_sir(sir: Union[serialization.SIR.SIR, str, bytes]) -> SIR:
+    """Deserialize SIR into a handle to the C++ SIR.
+    The handle can be passed to :func:`compile` and :func:`lower_and_optimize` any number of
+    times (also concurrently) without serializing the SIR again.
+    Parameters
+    ----------
+    sir:
+        SIR of the stencil (in any valid serialized or non serialized form).
+    Returns
+    -------
+    sir : `SIR`
+        Handle to the deserialized SIR.
+    """
+    sir, sir_format = _serialize_sir(sir)
+    return SIR.from_string(sir, sir_format)
+
+
+def load_stencil_instantiations(instantiation_map: dict) -> Dict[str, StencilInstantiation]:
+    """Deserialize stencil instantiations into handles to the C++ stencil instantiations.
+    Parameters
+    ----------
+    instantiation_map:
+        Stencil instantiation map (values in any valid serialized or non serialized form).
+    Returns
+    -------
+    instantiation_map : `dict`
+        Handles to the deserialized stencil instantiations.
+    """
+    instantiation_map, iir_format = _serialize_instantiations(instantiation_map)
+    return {
+        name: StencilInstantiation.from_string(si, iir_format)
+        for name, si in instantiation_map.items()
+    }
+
+
 _OPTIMIZER_OPTIONS = tuple(
     name for name, value in inspect.getmembers(OptimizerOptions) if not name.startswith("__")
 )
@@ -89,7 +133,7 @@ _CODEGEN_OPTIONS = tuple(
 
 
 def compile(
-    sir: Union[serialization.SIR.SIR, str, bytes],
+    sir: Union[SIR, serialization.SIR.SIR, str, bytes],
     *,
     groups: list = default_pass_groups(),
     backend: CodeGenBackend = CodeGenBackend.GridTools,
@@ -101,7 +145,8 @@ def compile(
     Parameters
     ----------
     sir:
-        SIR of the stencil (in any valid serialized or non serialized form).
+        SIR of the stencil (a :class:`SIR` handle or in any valid serialized or non serialized
+        form).
     groups:
         Optimizer pass groups [defaults to :func:`default_pass_groups()`]
     backend:
@@ -117,6 +162,15 @@ def compile(
     optimizer_options = {k: v for k, v in kwargs.items() if k in _OPTIMIZER_OPTIONS}
     codegen_options = {k: v for k, v in kwargs.items() if k in _CODEGEN_OPTIONS}
 
+    if isinstance(sir, SIR):
+        return _dawn4py.compile_sir(
+            sir,
+            groups,
+            OptimizerOptions(**optimizer_options),
+            backend,
+            CodeGenOptions(**codegen_options),
+        )
+
     sir, sir_format = _serialize_sir(sir)
     return _dawn4py.compile_sir(
         sir,
@@ -128,8 +182,72 @@ def compile(
     )
 
 
+_executor = None
+_executor_lock = threading.Lock()
+
+
+def _default_executor():
+    global _executor
+    with _executor_lock:
+        if _executor is None:
+            _executor = concurrent.futures.ThreadPoolExecutor(thread_name_prefix="dawn4py")
+        return _executor
+
+
+def compile_async(
+    sir: Union[SIR, serialization.SIR.SIR, str, bytes],
+    *,
+    executor: Optional[concurrent.futures.Executor] = None,
+    **kwargs,
+) -> concurrent.futures.Future:
+    """Compile SIR to source code in the background.
+    Dawn releases the GIL while compiling, such that several stencils submitted to a thread pool
+    are compiled concurrently.
+    Parameters
+    ----------
+    sir:
+        SIR of the stencil (see :func:`compile`).
+    executor:
+        Executor running the compilation [defaults to a shared thread pool].
+    **kwargs
+        Optional keyword arguments of :func:`compile`.
+    Returns
+    -------
+    future : `concurrent.futures.Future`
+        Future of the generated code.
+    """
+    if executor is None:
+        executor = _default_executor()
+    return executor.submit(compile, sir, **kwargs)
+
+
+def compile_batch(
+    sirs: Iterable[Union[SIR, serialization.SIR.SIR, str, bytes]],
+    *,
+    max_workers: Optional[int] = None,
+    **kwargs,
+) -> List[str]:
+    """Compile several SIRs to source code concurrently.
+    Parameters
+    ----------
+    sirs:
+        SIRs of the stencils (see :func:`compile`).
+    max_workers:
+        Maximum number of concurrent compilations [defaults to the thread pool default].
+    **kwargs
+        Optional keyword arguments of :func:`compile`, used for all SIRs.
+    Returns
+    -------
+    codes : `list`
+        The generated codes, in the order of `sirs`.
+    """
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max_workers) as executor:
+        futures = [compile_async(sir, executor=executor, **kwargs) for sir in sirs]
+        return [future.result() for future in futures]
+
+
 def lower_and_optimize(
-    sir: Union[serialization.SIR.SIR, str, bytes], groups: list, **kwargs,
+    sir: Union[SIR, serialization.SIR.SIR, str, bytes], groups: list, **kwargs,
 ):
     """Compile SIR to source code.
     This is a convenience function which instantiates a temporary :class:`Compiler`
@@ -137,7 +255,8 @@ def lower_and_optimize(
     Parameters
     ----------
     sir:
-        SIR of the stencil (in any valid serialized or non serialized form).
+        SIR of the stencil (a :class:`SIR` handle or in any valid serialized or non serialized
+        form).
     groups:
         Optimizer pass groups [defaults to :func:`default_pass_groups()`]
     **kwargs
@@ -145,10 +264,14 @@ def lower_and_optimize(
     Returns
     -------
     instantiation_map : `dict`
-        Optimized stencil instantiations.
+        Optimized stencil instantiations (:class:`StencilInstantiation` handles for a
+        :class:`SIR` handle).
     """
     optimizer_options = {k: v for k, v in kwargs.items() if k in _OPTIMIZER_OPTIONS}
 
+    if isinstance(sir, SIR):
+        return _dawn4py.run_optimizer_sir(sir, groups, OptimizerOptions(**optimizer_options))
+
     sir, sir_format = _serialize_sir(sir)
     iir_map = _dawn4py.run_optimizer_sir(
         sir, sir_format, groups, OptimizerOptions(**optimizer_options)
@@ -168,7 +291,8 @@ def optimize(
     Parameters
     ----------
     instantiation_map:
-        Stencil instantiation map (values in any valid serialized or non serialized form).
+        Stencil instantiation map (values in any valid serialized or non serialized form, or
+        :class:`StencilInstantiation` handles, which are optimized in place).
     groups:
         Optimizer pass groups [defaults to :func:`default_pass_groups()`]
     **kwargs
@@ -176,10 +300,15 @@ def optimize(
     Returns
     -------
     instantiation_map : `dict`
-        Optimized stencil instantiations.
+        Optimized stencil instantiations (handles for handles).
     """
     optimizer_options = {k: v for k, v in kwargs.items() if k in _OPTIMIZER_OPTIONS}
 
+    if _is_handle_map(instantiation_map):
+        return _dawn4py.run_optimizer_iir(
+            instantiation_map, groups, OptimizerOptions(**optimizer_options)
+        )
+
     instantiation_map, iir_format = _serialize_instantiations(instantiation_map)
     optimized_instantiations = _dawn4py.run_optimizer_iir(
         instantiation_map, iir_format, groups, OptimizerOptions(**optimizer_options)
@@ -199,7 +328,8 @@ def codegen(
     Parameters
     ----------
     instantiation_map:
-        Stencil instantiation map (values in any valid serialized or non serialized form).
+        Stencil instantiation map (values in any valid serialized or non serialized form, or
+        :class:`StencilInstantiation` handles).
     backend:
         Code generation backend [defaults to GridTools].
     **kwargs
@@ -211,6 +341,11 @@ def codegen(
     """
     codegen_options = {k: v for k, v in kwargs.items() if k in _CODEGEN_OPTIONS}
 
+    if _is_handle_map(instantiation_map):
+        return _dawn4py.run_codegen(
+            instantiation_map, backend, CodeGenOptions(**codegen_options)
+        )
+
     instantiation_map, iir_format = _serialize_instantiations(instantiation_map)
     return _dawn4py.run_codegen(
         instantiation_map, iir_format, backend, CodeGenOptions(**codegen_options)
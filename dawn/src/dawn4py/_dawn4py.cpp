@@ -9,9 +9,12 @@
 
 #include "dawn/Support/Exception.h"
 #include "dawn/Support/Logger.h"
+#include "dawn/Support/UIDGenerator.h"
 
 #include <list>
 #include <map>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 #include <pybind11/pybind11.h>
@@ -19,6 +22,23 @@
 
 namespace py = ::pybind11;
 
+namespace {
+
+using StencilInstantiationMap =
+    std::map<std::string, std::shared_ptr<dawn::iir::StencilInstantiation>>;
+
+// Release the GIL while dawn runs, such that stencils can be compiled concurrently from several
+// Python threads. The handles may be passed between threads (see `dawn::UIDGeneratorSyncGuard`).
+using CompileGuard = py::call_guard<py::gil_scoped_release, dawn::UIDGeneratorSyncGuard>;
+
+void checkHandles(const StencilInstantiationMap& stencilInstantiationMap) {
+  for(const auto& [name, instantiation] : stencilInstantiationMap)
+    if(!instantiation)
+      throw std::invalid_argument("stencil instantiation '" + name + "' is None");
+}
+
+} // namespace
+
 PYBIND11_MODULE(_dawn4py, m) {
   m.doc() = "Dawn DSL toolchain"; // optional module docstring
 
@@ -47,6 +67,8 @@ PYBIND11_MODULE(_dawn4py, m) {
       .value("StageReordering", dawn::PassGroup::StageReordering)
       .value("StageMerger", dawn::PassGroup::StageMerger)
       .value("MultiStageMerger", dawn::PassGroup::MultiStageMerger)
+      .value("ConstantFolding", dawn::PassGroup::ConstantFolding)
+      .value("StencilMerger", dawn::PassGroup::StencilMerger)
       .value("TemporaryMerger", dawn::PassGroup::TemporaryMerger)
       .value("Inlining", dawn::PassGroup::Inlining)
       .value("IntervalPartitioning", dawn::PassGroup::IntervalPartitioning)
@@ -81,10 +103,13 @@ PYBIND11_MODULE(_dawn4py, m) {
                       int MaxFieldsPerStencil, bool MaxCutMSS, int BlockSizeI, int BlockSizeJ,
                       int BlockSizeK, int SMemMaxFields, int TexCacheMaxFields, bool SplitStencils,
                       bool MergeStages, bool MergeDoMethods, bool DisableKCaches, bool KeepVarnames,
-                      bool ReportAccesses, bool SerializeIIR, const std::string& IIRFormat,
+                      bool ReportAccesses, const std::string& PerfModelConfig,
+                      const std::string& PerfModelDir, bool SerializeIIR,
+                      const std::string& IIRFormat, bool SerializeIIRDerivedInfo,
                       bool DumpSplitGraphs, bool DumpStageGraph, bool DumpTemporaryGraphs,
-                      bool DumpRaceConditionGraph, bool DumpStencilInstantiation,
-                      bool WriteStencilInstantiation, bool DumpStencilGraph) {
+                      bool DumpRaceConditionGraph,
+                      bool DumpStencilInstantiation, bool WriteStencilInstantiation,
+                      bool DumpStencilGraph) {
             return dawn::Options{MaxHaloPoints,
                                  ReorderStrategy,
                                  MaxFieldsPerStencil,
@@ -100,8 +125,11 @@ PYBIND11_MODULE(_dawn4py, m) {
                                  DisableKCaches,
                                  KeepVarnames,
                                  ReportAccesses,
+                                 PerfModelConfig,
+                                 PerfModelDir,
                                  SerializeIIR,
                                  IIRFormat,
+                                 SerializeIIRDerivedInfo,
                                  DumpSplitGraphs,
                                  DumpStageGraph,
                                  DumpTemporaryGraphs,
@@ -117,9 +145,11 @@ PYBIND11_MODULE(_dawn4py, m) {
           py::arg("split_stencils") = false, py::arg("merge_stages") = false,
           py::arg("merge_do_methods") = true, py::arg("disable_k_caches") = false,
           py::arg("keep_varnames") = false, py::arg("report_accesses") = false,
+          py::arg("perf_model_config") = "", py::arg("perf_model_dir") = "",
           py::arg("serialize_iir") = false, py::arg("iir_format") = "json",
-          py::arg("dump_split_graphs") = false, py::arg("dump_stage_graph") = false,
-          py::arg("dump_temporary_graphs") = false, py::arg("dump_race_condition_graph") = false,
+          py::arg("serialize_iir_derived_info") = false, py::arg("dump_split_graphs") = false,
+          py::arg("dump_stage_graph") = false, py::arg("dump_temporary_graphs") = false,
+          py::arg("dump_race_condition_graph") = false,
           py::arg("dump_stencil_instantiation") = false,
           py::arg("write_stencil_instantiation") = false, py::arg("dump_stencil_graph") = false)
       .def_readwrite("max_halo_points", &dawn::Options::MaxHaloPoints)
@@ -137,8 +167,11 @@ PYBIND11_MODULE(_dawn4py, m) {
       .def_readwrite("disable_k_caches", &dawn::Options::DisableKCaches)
       .def_readwrite("keep_varnames", &dawn::Options::KeepVarnames)
       .def_readwrite("report_accesses", &dawn::Options::ReportAccesses)
+      .def_readwrite("perf_model_config", &dawn::Options::PerfModelConfig)
+      .def_readwrite("perf_model_dir", &dawn::Options::PerfModelDir)
       .def_readwrite("serialize_iir", &dawn::Options::SerializeIIR)
       .def_readwrite("iir_format", &dawn::Options::IIRFormat)
+      .def_readwrite("serialize_iir_derived_info", &dawn::Options::SerializeIIRDerivedInfo)
       .def_readwrite("dump_split_graphs", &dawn::Options::DumpSplitGraphs)
       .def_readwrite("dump_stage_graph", &dawn::Options::DumpStageGraph)
       .def_readwrite("dump_temporary_graphs", &dawn::Options::DumpTemporaryGraphs)
@@ -165,10 +198,17 @@ PYBIND11_MODULE(_dawn4py, m) {
            << "disable_k_caches=" << self.DisableKCaches << ",\n    "
            << "keep_varnames=" << self.KeepVarnames << ",\n    "
            << "report_accesses=" << self.ReportAccesses << ",\n    "
+           << "perf_model_config="
+           << "\"" << self.PerfModelConfig << "\""
+           << ",\n    "
+           << "perf_model_dir="
+           << "\"" << self.PerfModelDir << "\""
+           << ",\n    "
            << "serialize_iir=" << self.SerializeIIR << ",\n    "
            << "iir_format="
            << "\"" << self.IIRFormat << "\""
            << ",\n    "
+           << "serialize_iir_derived_info=" << self.SerializeIIRDerivedInfo << ",\n    "
            << "dump_split_graphs=" << self.DumpSplitGraphs << ",\n    "
            << "dump_stage_graph=" << self.DumpStageGraph << ",\n    "
            << "dump_temporary_graphs=" << self.DumpTemporaryGraphs << ",\n    "
@@ -183,7 +223,11 @@ PYBIND11_MODULE(_dawn4py, m) {
       .def(py::init([](int MaxHaloSize, bool UseParallelEP, bool RunWithSync, int MaxBlocksPerSM,
                        int nsms, int DomainSizeI, int DomainSizeJ, int DomainSizeK,
                        const std::string& OutputCHeader, const std::string& OutputFortranInterface,
-                       bool AtlasCompatible, int BlockSize, int LevelsPerThread) {
+                       bool AtlasCompatible, int BlockSize, int LevelsPerThread,
+                       bool TaskParallel, bool FlatNeighborTables, bool HaloExchange,
+                       int TileSizeI, int TileSizeJ, const std::string& LoopOrder, bool KParallel,
+                       int NumThreads, const std::string& TuningDatabaseFile,
+                       int SolverBatchSize) {
              return dawn::codegen::Options{MaxHaloSize,
                                            UseParallelEP,
                                            RunWithSync,
@@ -196,14 +240,28 @@ PYBIND11_MODULE(_dawn4py, m) {
                                            OutputFortranInterface,
                                            AtlasCompatible,
                                            BlockSize,
-                                           LevelsPerThread};
+                                           LevelsPerThread,
+                                           TaskParallel,
+                                           FlatNeighborTables,
+                                           HaloExchange,
+                                           TileSizeI,
+                                           TileSizeJ,
+                                           LoopOrder,
+                                           KParallel,
+                                           NumThreads,
+                                           TuningDatabaseFile,
+                                           SolverBatchSize};
            }),
            py::arg("max_halo_size") = 3, py::arg("use_parallel_ep") = false,
            py::arg("run_with_sync") = true, py::arg("max_blocks_per_sm") = 0, py::arg("nsms") = 0,
            py::arg("domain_size_i") = 0, py::arg("domain_size_j") = 0, py::arg("domain_size_k") = 0,
            py::arg("output_c_header") = "", py::arg("output_fortran_interface") = "",
            py::arg("atlas_compatible") = false, py::arg("block_size") = 128,
-           py::arg("levels_per_thread") = 1)
+           py::arg("levels_per_thread") = 1, py::arg("task_parallel") = false,
+           py::arg("flat_neighbor_tables") = false, py::arg("halo_exchange") = false,
+           py::arg("tile_size_i") = 0, py::arg("tile_size_j") = 0, py::arg("loop_order") = "ij",
+           py::arg("k_parallel") = true, py::arg("num_threads") = 0,
+           py::arg("tuning_database_file") = "", py::arg("solver_batch_size") = 0)
       .def_readwrite("max_halo_size", &dawn::codegen::Options::MaxHaloSize)
       .def_readwrite("use_parallel_ep", &dawn::codegen::Options::UseParallelEP)
       .def_readwrite("run_with_sync", &dawn::codegen::Options::RunWithSync)
@@ -217,6 +275,16 @@ PYBIND11_MODULE(_dawn4py, m) {
       .def_readwrite("atlas_compatible", &dawn::codegen::Options::AtlasCompatible)
       .def_readwrite("block_size", &dawn::codegen::Options::BlockSize)
       .def_readwrite("levels_per_thread", &dawn::codegen::Options::LevelsPerThread)
+      .def_readwrite("task_parallel", &dawn::codegen::Options::TaskParallel)
+      .def_readwrite("flat_neighbor_tables", &dawn::codegen::Options::FlatNeighborTables)
+      .def_readwrite("halo_exchange", &dawn::codegen::Options::HaloExchange)
+      .def_readwrite("tile_size_i", &dawn::codegen::Options::TileSizeI)
+      .def_readwrite("tile_size_j", &dawn::codegen::Options::TileSizeJ)
+      .def_readwrite("loop_order", &dawn::codegen::Options::LoopOrder)
+      .def_readwrite("k_parallel", &dawn::codegen::Options::KParallel)
+      .def_readwrite("num_threads", &dawn::codegen::Options::NumThreads)
+      .def_readwrite("tuning_database_file", &dawn::codegen::Options::TuningDatabaseFile)
+      .def_readwrite("solver_batch_size", &dawn::codegen::Options::SolverBatchSize)
       .def("__repr__", [](const dawn::codegen::Options& self) {
         std::ostringstream ss;
         ss << "max_halo_size=" << self.MaxHaloSize << ",\n    "
@@ -235,10 +303,77 @@ PYBIND11_MODULE(_dawn4py, m) {
            << ",\n    "
            << "atlas_compatible=" << self.AtlasCompatible << ",\n    "
            << "block_size=" << self.BlockSize << ",\n    "
-           << "levels_per_thread=" << self.LevelsPerThread;
+           << "levels_per_thread=" << self.LevelsPerThread << ",\n    "
+           << "task_parallel=" << self.TaskParallel << ",\n    "
+           << "flat_neighbor_tables=" << self.FlatNeighborTables << ",\n    "
+           << "halo_exchange=" << self.HaloExchange << ",\n    "
+           << "tile_size_i=" << self.TileSizeI << ",\n    "
+           << "tile_size_j=" << self.TileSizeJ << ",\n    "
+           << "loop_order="
+           << "\"" << self.LoopOrder << "\""
+           << ",\n    "
+           << "k_parallel=" << self.KParallel << ",\n    "
+           << "num_threads=" << self.NumThreads << ",\n    "
+           << "tuning_database_file="
+           << "\"" << self.TuningDatabaseFile << "\""
+           << ",\n    "
+           << "solver_batch_size=" << self.SolverBatchSize;
         return "CodeGenOptions(\n    " + ss.str() + "\n)";
       });
 
+  // Handles to the C++ IRs, passed to the functions below without serialization
+  py::class_<dawn::SIR, std::shared_ptr<dawn::SIR>>(m, "SIR", "Handle to a stencil IR")
+      .def_static(
+          "from_string",
+          [](const std::string& sir, dawn::SIRSerializer::Format format) {
+            return dawn::SIRSerializer::deserializeFromString(sir, format);
+          },
+          "Deserialize the stencil IR.", py::arg("sir"),
+          py::arg("format") = dawn::SIRSerializer::Format::Byte, CompileGuard())
+      .def(
+          "to_string",
+          [](const dawn::SIR& self, dawn::SIRSerializer::Format format) {
+            std::string sir;
+            {
+              py::gil_scoped_release release;
+              sir = dawn::SIRSerializer::serializeToString(&self, format);
+            }
+            return format == dawn::SIRSerializer::Format::Json ? py::object(py::str(sir))
+                                                                : py::object(py::bytes(sir));
+          },
+          "Serialize the stencil IR (JSON as str, Byte as bytes).",
+          py::arg("format") = dawn::SIRSerializer::Format::Byte)
+      .def_property_readonly("filename", [](const dawn::SIR& self) { return self.Filename; });
+
+  py::class_<dawn::iir::StencilInstantiation, std::shared_ptr<dawn::iir::StencilInstantiation>>(
+      m, "StencilInstantiation", "Handle to a stencil instantiation (IIR)")
+      .def_static(
+          "from_string",
+          [](const std::string& iir, dawn::IIRSerializer::Format format) {
+            return dawn::IIRSerializer::deserializeFromString(iir, format);
+          },
+          "Deserialize the stencil instantiation.", py::arg("iir"),
+          py::arg("format") = dawn::IIRSerializer::Format::Byte, CompileGuard())
+      .def(
+          "to_string",
+          [](const std::shared_ptr<dawn::iir::StencilInstantiation>& self,
+             dawn::IIRSerializer::Format format, bool withDerivedInfo) {
+            std::string iir;
+            {
+              py::gil_scoped_release release;
+              iir = dawn::IIRSerializer::serializeToString(self, format, withDerivedInfo);
+            }
+            return format == dawn::IIRSerializer::Format::Json ? py::object(py::str(iir))
+                                                                : py::object(py::bytes(iir));
+          },
+          "Serialize the stencil instantiation (JSON as str, Byte as bytes).",
+          py::arg("format") = dawn::IIRSerializer::Format::Byte,
+          py::arg("with_derived_info") = false)
+      .def("clone", &dawn::iir::StencilInstantiation::clone,
+           "Deep copy of the stencil instantiation, e.g. to keep it unchanged by the optimizer.",
+           CompileGuard())
+      .def_property_readonly("name", &dawn::iir::StencilInstantiation::getName);
+
   m.def("default_pass_groups", &dawn::defaultPassGroups,
         "Return a list of default optimizer pass groups");
 
@@ -255,7 +390,17 @@ PYBIND11_MODULE(_dawn4py, m) {
       "passes.",
       "A list of default optimization passes is returned from default_pass_groups().",
       py::arg("sir"), py::arg("format") = dawn::SIRSerializer::Format::Byte,
-      py::arg("groups") = std::list<dawn::PassGroup>(), py::arg("options") = dawn::Options());
+      py::arg("groups") = std::list<dawn::PassGroup>(), py::arg("options") = dawn::Options(),
+      CompileGuard());
+
+  m.def(
+      "run_optimizer_sir",
+      [](const std::shared_ptr<dawn::SIR>& sir, const std::list<dawn::PassGroup>& groups,
+         const dawn::Options& options) { return dawn::run(sir, groups, options); },
+      "Lower the stencil IR handle to a map of stencil instantiation handles and (optionally) run "
+      "optimization passes.",
+      py::arg("sir").none(false), py::arg("groups") = std::list<dawn::PassGroup>(),
+      py::arg("options") = dawn::Options(), CompileGuard());
 
   m.def(
       "run_optimizer_iir",
@@ -267,7 +412,19 @@ PYBIND11_MODULE(_dawn4py, m) {
       "Optimize the stencil instantiation map.",
       "A list of default optimization passes is returned from default_pass_groups().",
       py::arg("stencil_instantiation_map"), py::arg("format") = dawn::IIRSerializer::Format::Byte,
-      py::arg("groups") = std::list<dawn::PassGroup>(), py::arg("options") = dawn::Options());
+      py::arg("groups") = std::list<dawn::PassGroup>(), py::arg("options") = dawn::Options(),
+      CompileGuard());
+
+  m.def(
+      "run_optimizer_iir",
+      [](const StencilInstantiationMap& stencilInstantiationMap,
+         const std::list<dawn::PassGroup>& groups, const dawn::Options& options) {
+        checkHandles(stencilInstantiationMap);
+        return dawn::run(stencilInstantiationMap, groups, options);
+      },
+      "Optimize the stencil instantiation handles in place and return them.",
+      py::arg("stencil_instantiation_map"), py::arg("groups") = std::list<dawn::PassGroup>(),
+      py::arg("options") = dawn::Options(), CompileGuard());
 
   m.def(
       "run_codegen",
@@ -279,7 +436,19 @@ PYBIND11_MODULE(_dawn4py, m) {
       "Generate code from the stencil instantiation map.", py::arg("stencil_instantiation_map"),
       py::arg("format") = dawn::IIRSerializer::Format::Byte,
       py::arg("backend") = dawn::codegen::Backend::GridTools,
-      py::arg("options") = dawn::codegen::Options());
+      py::arg("options") = dawn::codegen::Options(), CompileGuard());
+
+  m.def(
+      "run_codegen",
+      [](const StencilInstantiationMap& stencilInstantiationMap, dawn::codegen::Backend backend,
+         const dawn::codegen::Options& options) {
+        checkHandles(stencilInstantiationMap);
+        return dawn::codegen::generate(
+            dawn::codegen::run(stencilInstantiationMap, backend, options));
+      },
+      "Generate code from the stencil instantiation handles.",
+      py::arg("stencil_instantiation_map"), py::arg("backend") = dawn::codegen::Backend::GridTools,
+      py::arg("options") = dawn::codegen::Options(), CompileGuard());
 
   m.def(
       "compile_sir",
@@ -293,5 +462,20 @@ PYBIND11_MODULE(_dawn4py, m) {
       py::arg("format") = dawn::SIRSerializer::Format::Byte,
       py::arg("groups") = dawn::defaultPassGroups(), py::arg("optimizer_options") = dawn::Options(),
       py::arg("backend") = dawn::codegen::Backend::GridTools,
-      py::arg("codegen_options") = dawn::codegen::Options());
+      py::arg("codegen_options") = dawn::codegen::Options(), CompileGuard());
+
+  m.def(
+      "compile_sir",
+      [](const std::shared_ptr<dawn::SIR>& sir, const std::list<dawn::PassGroup>& groups,
+         const dawn::Options& optimizerOptions, dawn::codegen::Backend backend,
+         const dawn::codegen::Options& codegenOptions) {
+        return dawn::codegen::generate(
+            dawn::compile(sir, groups, optimizerOptions, backend, codegenOptions));
+      },
+      "Compile the stencil IR handle: lower, optimize, and generate code.",
+      "Runs the default_pass_groups() unless the 'groups' argument is passed.",
+      py::arg("sir").none(false), py::arg("groups") = dawn::defaultPassGroups(),
+      py::arg("optimizer_options") = dawn::Options(),
+      py::arg("backend") = dawn::codegen::Backend::GridTools,
+      py::arg("codegen_options") = dawn::codegen::Options(), CompileGuard());
 }
@@ -0,0 +1,263 @@
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##                          _
+##                         | |
+##                       __| | __ ___      ___ ___
+##                      / _` |/ _` \ \ /\ / / '_  |
+##                     | (_| | (_| |\ V  V /| | | |
+##                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+##
+##
+##  This file is distributed under the MIT License (MIT).
+##  See LICENSE.txt for details.
+##
+##===------------------------------------------------------------------------------------------===##
+
+
+"""Auto-tuning of the code generation parameters of the CXXOpt backend.
+
+:func:`tune` generates a variant of a stencil for every configuration of a parameter space (tile
+sizes, nesting of the horizontal loops, k-parallel or k-sequential execution and thread count),
+compiles them with :mod:`dawn4py.jit`, times them on the given fields and records the fastest
+configuration per stencil and domain size in a :class:`TuningDatabase`. Later compilations pick up
+the tuned configurations with the `tuning_database_file` option (`-tuning-db` in gtclang).
+
+Example::
+
+    database = dawn4py.autotune.TuningDatabase("tuning.json")
+    dawn4py.autotune.tune(sir, database=database, halo=(3, 3, 0), in_field=a, out_field=b)
+    database.save()
+
+    code = dawn4py.compile(sir, backend=dawn4py.CodeGenBackend.CXXOpt,
+                           tuning_database_file="tuning.json")
+"""
+
+import dataclasses
+import itertools
+import json
+import os
+import tempfile
+import time
+import warnings
+from typing import Any, Dict, Iterable, List, Optional, Sequence, Tuple
+
+from . import jit
+from ._dawn4py import CodeGenBackend
+
+__all__ = ["Configuration", "Record", "TuningDatabase", "default_space", "tune"]
+
+#: Name of the backend in the tuning database
+BACKEND_NAME = "c++-opt"
+
+
+@dataclasses.dataclass(frozen=True)
+class Configuration:
+    """Tunable code generation parameters (see the CodeGen options of the same names)."""
+
+    tile_size: Tuple[int, int] = (0, 0)
+    loop_order: str = "ij"
+    k_parallel: bool = True
+    num_threads: int = 0
+
+    def codegen_options(self) -> Dict[str, Any]:
+        """Keyword arguments of :func:`dawn4py.compile` generating this variant."""
+        return {
+            "tile_size_i": self.tile_size[0],
+            "tile_size_j": self.tile_size[1],
+            "loop_order": self.loop_order,
+            "k_parallel": self.k_parallel,
+            "num_threads": self.num_threads,
+        }
+
+
+@dataclasses.dataclass
+class Record:
+    """Fastest configuration of a stencil on a domain size (including the halos)."""
+
+    stencil: str
+    domain_size: Tuple[int, int, int]
+    configuration: Configuration
+    time: float
+    backend: str = BACKEND_NAME
+
+    def to_json(self) -> Dict[str, Any]:
+        return {
+            "backend": self.backend,
+            "stencil": self.stencil,
+            "domain_size": list(self.domain_size),
+            "tile_size": list(self.configuration.tile_size),
+            "loop_order": self.configuration.loop_order,
+            "k_parallel": self.configuration.k_parallel,
+            "num_threads": self.configuration.num_threads,
+            "time": self.time,
+        }
+
+    @classmethod
+    def from_json(cls, node: Dict[str, Any]) -> "Record":
+        configuration = Configuration(
+            tile_size=tuple(node.get("tile_size", (0, 0))),
+            loop_order=node.get("loop_order", "ij"),
+            k_parallel=node.get("k_parallel", True),
+            num_threads=node.get("num_threads", 0),
+        )
+        return cls(
+            stencil=node["stencil"],
+            domain_size=tuple(node["domain_size"]),
+            configuration=configuration,
+            time=node.get("time", 0.0),
+            backend=node["backend"],
+        )
+
+
+class TuningDatabase:
+    """Best configurations per backend, stencil and domain size, stored as JSON file.
+
+    The file is read by the code generation (`dawn::TuningDatabase`) if passed as
+    `tuning_database_file`.
+    """
+
+    def __init__(self, path: Optional[str] = None):
+        self.path = path
+        self.records: Dict[Tuple[str, str, Tuple[int, int, int]], Record] = {}
+        if path is not None and os.path.exists(path):
+            with open(path, mode="r") as f:
+                for node in json.load(f)["records"]:
+                    self.add(Record.from_json(node))
+
+    def add(self, record: Record) -> bool:
+        """Keep `record` if it is faster than the one of its stencil and domain size."""
+        key = (record.backend, record.stencil, tuple(record.domain_size))
+        if key in self.records and self.records[key].time <= record.time:
+            return False
+        self.records[key] = record
+        return True
+
+    def lookup(
+        self, stencil: str, domain_size: Sequence[int], backend: str = BACKEND_NAME
+    ) -> Optional[Record]:
+        """Record of the exact domain size (the code generation also falls back to the closest)."""
+        return self.records.get((backend, stencil, tuple(domain_size)))
+
+    def save(self, path: Optional[str] = None):
+        """Write the database (to the file it was read from by default)."""
+        path = path or self.path
+        if path is None:
+            raise ValueError("No file to save the tuning database to")
+        records = [self.records[key].to_json() for key in sorted(self.records)]
+        directory = os.path.dirname(os.path.abspath(path))
+        # replace the file atomically, concurrent tuning runs must not leave a partial database
+        with tempfile.NamedTemporaryFile("w", dir=directory, suffix=".json", delete=False) as f:
+            json.dump({"records": records}, f, indent=2)
+        os.replace(f.name, path)
+
+
+def default_space(max_threads: Optional[int] = None) -> List[Configuration]:
+    """Untiled and tiled variants in both loop orders, k-parallel and k-sequential, with powers of
+    two threads up to `max_threads` [defaults to the number of CPUs]."""
+    max_threads = max_threads or os.cpu_count() or 1
+    threads = sorted({2 ** n for n in range(max_threads.bit_length()) if 2 ** n <= max_threads})
+    threads = sorted(set(threads) | {max_threads})
+    tile_sizes = [(0, 0), (8, 8), (16, 16), (32, 8), (64, 4)]
+    return [
+        Configuration(tile_size, loop_order, k_parallel, num_threads)
+        for tile_size, loop_order, k_parallel, num_threads in itertools.product(
+            tile_sizes, ("ij", "ji"), (True, False), threads
+        )
+    ]
+
+
+def _domain_size(fields: Dict[str, Any]) -> Tuple[int, int, int]:
+    domain = [1, 1, 1]
+    for name, field in fields.items():
+        shape = memoryview(field).shape
+        if len(shape) != 3:
+            raise ValueError(f"Field '{name}' is not 3-dimensional")
+        domain = [max(size, extent) for size, extent in zip(domain, shape)]
+    return tuple(domain)
+
+
+def _time(stencil: jit.Stencil, repetitions: int, kwargs: Dict[str, Any]) -> float:
+    stencil.run(**kwargs)  # warm up
+    times = []
+    for _ in range(repetitions):
+        start = time.perf_counter()
+        stencil.run(**kwargs)
+        times.append(time.perf_counter() - start)
+    return min(times)
+
+
+def tune(
+    sir,
+    *,
+    stencil: Optional[str] = None,
+    database: Optional[TuningDatabase] = None,
+    space: Optional[Iterable[Configuration]] = None,
+    repetitions: int = 5,
+    halo: Optional[Sequence[int]] = None,
+    build_args: Optional[Dict[str, Any]] = None,
+    **kwargs,
+) -> Record:
+    """Find the fastest configuration of a stencil on the given fields.
+
+    Every configuration is compiled with :func:`dawn4py.jit.build` (once, the shared objects are
+    cached) and timed by the minimum of `repetitions` runs after a warm up run. The fields are
+    updated in place by every run. Configurations which fail to compile are skipped with a warning.
+
+    Parameters
+    ----------
+    sir:
+        SIR of the stencil (a :class:`SIR` handle or in any valid serialized or non serialized
+        form).
+    stencil:
+        Name of the stencil to time [defaults to the only stencil of the SIR].
+    database:
+        Database the best configuration is added to (not saved).
+    space:
+        Configurations to try [defaults to :func:`default_space`].
+    repetitions:
+        Number of timed runs per configuration.
+    halo:
+        Halo of the fields (see :meth:`dawn4py.jit.CartesianStencil.run`).
+    build_args:
+        Keyword arguments of :func:`dawn4py.jit.build` (e.g. `include_dirs`) and of
+        :func:`dawn4py.compile` (e.g. `domain_size_i` to tune the specialized code).
+    **kwargs
+        Fields (3-dimensional buffers of the domain including the halos) and globals of the
+        stencil.
+    Returns
+    -------
+    record : `Record`
+        The fastest configuration.
+    """
+    build_args = dict(build_args or {})
+    space = list(space) if space is not None else default_space()
+    if not space:
+        raise ValueError("Empty tuning space")
+    best: Optional[Record] = None
+    for configuration in space:
+        try:
+            module = jit.build(
+                sir,
+                backend=CodeGenBackend.CXXOpt,
+                **build_args,
+                **configuration.codegen_options(),
+            )
+        except jit.JITError as error:
+            warnings.warn(f"Skipping {configuration}: {error}")
+            continue
+        if stencil is None:
+            if len(module.stencils) != 1:
+                raise TypeError(f"Several stencils {sorted(module.stencils)}, choose one")
+            stencil = next(iter(module.stencils))
+        domain_size = _domain_size(
+            {name: kwargs[name] for name in module.stencils[stencil].fields if name in kwargs}
+        )
+        elapsed = _time(module.stencils[stencil], repetitions, dict(kwargs, halo=halo))
+        if best is None or elapsed < best.time:
+            best = Record(stencil, domain_size, configuration, elapsed)
+
+    if best is None:
+        raise jit.JITError("No configuration of the tuning space could be compiled")
+    if database is not None:
+        database.add(best)
+    return best
@@ -0,0 +1,612 @@
+# -*- coding: utf-8 -*-
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##                          _
+##                         | |
+##                       __| | __ ___      ___ ___
+##                      / _` |/ _` \ \ /\ / / '_  |
+##                     | (_| | (_| |\ V  V /| | | |
+##                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+##
+##
+##  This file is distributed under the MIT License (MIT).
+##  See LICENSE.txt for details.
+##
+##===------------------------------------------------------------------------------------------===##
+
+
+"""Just-in-time compilation of the generated C++ code.
+
+The code of the CPU backends (CXXNaive, CXXOpt and CXXNaiveIco) is compiled with the host
+compiler into a shared object, which is cached by a hash of the source and the build flags. The
+stencils are called through their raw pointer interface (see the `output_c_header` option), the
+fields are passed as buffers (e.g. NumPy arrays) and updated in place, no data is copied.
+
+Example::
+
+    module = dawn4py.jit.build(sir, backend=dawn4py.CodeGenBackend.CXXNaive,
+                               include_dirs=[gridtools_include_dir, boost_include_dir])
+    module.run(in_field=a, out_field=b)
+
+The Cartesian backends need the headers of GridTools (and Boost), the unstructured backend runs
+on a :class:`Mesh` given by flat neighbor tables.
+"""
+
+import ctypes
+import enum
+import hashlib
+import os
+import re
+import shlex
+import subprocess
+import tempfile
+import threading
+from typing import Any, Dict, Iterable, List, Mapping, Optional, Sequence, Tuple
+
+from . import compile as _compile
+from ._dawn4py import CodeGenBackend
+
+__all__ = ["JITError", "Location", "Subdomain", "Mesh", "Module", "build", "build_code"]
+
+
+class JITError(RuntimeError):
+    """The generated code could not be compiled or loaded."""
+
+
+class Location(enum.IntEnum):
+    """Location types (values of `dawn::LocationType`)."""
+
+    Cells = 0
+    Edges = 1
+    Vertices = 2
+
+
+class Subdomain(enum.IntEnum):
+    """Horizontal subdomains (values of `dawn::UnstructuredSubdomain`)."""
+
+    LateralBoundary = 0
+    Nudging = 1000
+    Interior = 2000
+    Halo = 3000
+    End = 4000
+
+
+_SUPPORTED_BACKENDS = (CodeGenBackend.CXXNaive, CodeGenBackend.CXXOpt, CodeGenBackend.CXXNaiveIco)
+
+_CTYPES = {
+    "int": ctypes.c_int,
+    "double": ctypes.c_double,
+    "float": ctypes.c_float,
+    "bool": ctypes.c_bool,
+}
+
+_FLOAT_TYPE = "::dawn::float_type*"
+_MESH_TYPE = "::dawn::GlobalCpuTriMesh*"
+
+# ---------------------------------------------------------------------------------------------- #
+# buffers
+# ---------------------------------------------------------------------------------------------- #
+
+
+def _pointer(obj: Any, view: memoryview) -> int:
+    interface = getattr(obj, "__array_interface__", None)
+    if interface is not None:
+        return interface["data"][0]
+    # Plain buffers (e.g. arrays of ctypes) are contiguous
+    return ctypes.addressof(ctypes.c_char.from_buffer(view))
+
+
+def _buffer(name: str, field: Any) -> Tuple[int, Tuple[int, ...], Tuple[int, ...]]:
+    """Pointer, shape and strides (in elements) of a writeable buffer of doubles."""
+    try:
+        view = memoryview(field)
+    except TypeError:
+        raise TypeError(f"Field '{name}' does not support the buffer protocol") from None
+    if view.format.lstrip("@=<") != "d" or view.itemsize != ctypes.sizeof(ctypes.c_double):
+        raise TypeError(f"Field '{name}' is not a buffer of doubles (format '{view.format}')")
+    if view.readonly:
+        raise ValueError(f"Field '{name}' is read-only, stencils update their fields in place")
+    if any(stride % view.itemsize for stride in view.strides):
+        raise ValueError(f"Strides of field '{name}' are not multiples of the element size")
+    strides = tuple(stride // view.itemsize for stride in view.strides)
+    return _pointer(field, view), tuple(view.shape), strides
+
+
+# ---------------------------------------------------------------------------------------------- #
+# C interface
+# ---------------------------------------------------------------------------------------------- #
+
+_DECLARATION = re.compile(r"void\s+(setup|run|free)_(\w+)\s*\(([^)]*)\)\s*;")
+
+
+def _parse_c_header(c_header: str) -> Dict[str, Dict[str, List[Tuple[str, str]]]]:
+    """Signatures of the raw pointer interface: {stencil: {function: [(type, name), ...]}}."""
+    interface: Dict[str, Dict[str, List[Tuple[str, str]]]] = {}
+    for function, stencil, args in _DECLARATION.findall(c_header):
+        params = []
+        for arg in filter(None, (arg.strip() for arg in args.split(","))):
+            arg_type, name = arg.replace("*", "* ").rsplit(None, 1)
+            params.append((arg_type.replace(" ", ""), name))
+        interface.setdefault(stencil, {})[function] = params
+    return interface
+
+
+def _argtype(arg_type: str):
+    if arg_type in (_FLOAT_TYPE, _MESH_TYPE):
+        return ctypes.c_void_p
+    if arg_type not in _CTYPES:
+        raise JITError(f"Unsupported argument type '{arg_type}' in the C interface")
+    return _CTYPES[arg_type]
+
+
+class _Function:
+    def __init__(self, library: ctypes.CDLL, name: str, params: List[Tuple[str, str]]):
+        self.params = params
+        self.function = getattr(library, name)
+        self.function.argtypes = [_argtype(arg_type) for arg_type, _ in params]
+        self.function.restype = None
+
+    def __call__(self, *args):
+        self.function(*args)
+
+
+class Stencil:
+    """Stencil of a compiled module, `run` updates the fields in place."""
+
+    def __init__(self, module: "Module", name: str, functions: Dict[str, _Function]):
+        self.module = module
+        self.name = name
+        self._functions = functions
+
+        # Fields are passed as pointer followed by their strides, the unstructured stencils start
+        # with the mesh and the vertical size
+        self.fields: List[str] = []
+        self.globals: List[str] = []
+        params = functions["run"].params
+        if params and params[0][0] == _MESH_TYPE:
+            params = params[2:]
+        for arg_type, arg_name in params:
+            if arg_type == _FLOAT_TYPE:
+                self.fields.append(arg_name)
+            elif not (self.fields and arg_name.startswith(self.fields[-1] + "_stride")):
+                self.globals.append(arg_name)
+
+    def _arguments(self, kwargs: Dict[str, Any]) -> Tuple[Dict[str, Any], Dict[str, Tuple]]:
+        """Globals and buffers of the fields passed to `run`."""
+        missing = [name for name in self.globals + self.fields if name not in kwargs]
+        if missing:
+            raise TypeError(f"{self.name}.run() is missing the arguments {missing}")
+        global_args = {name: kwargs.pop(name) for name in self.globals}
+        buffers = {name: _buffer(name, kwargs.pop(name)) for name in self.fields}
+        if kwargs:
+            raise TypeError(f"{self.name}.run() got unexpected arguments {sorted(kwargs)}")
+        return global_args, buffers
+
+
+class CartesianStencil(Stencil):
+    """Stencil of the Cartesian backends.
+
+    Fields are 3-dimensional buffers of the full domain including the halos (indexed i, j, k),
+    dimensions of extent 1 are masked (e.g. `a[:, :, np.newaxis]` for a 2D field).
+    """
+
+    def __init__(self, module: "Module", name: str, functions: Dict[str, _Function]):
+        super().__init__(module, name, functions)
+        self._setup = None
+
+    def run(self, *, halo: Optional[Sequence[int]] = None, **kwargs):
+        """Run the stencil on the given fields (and globals) in place.
+
+        The domain is given by the largest extent of the fields in each dimension, `halo` is
+        either (i, j, k) or (iminus, iplus, jminus, jplus, kminus, kplus) [defaults to the
+        `max_halo_size` of the code generation in i and j].
+        """
+        global_args, buffers = self._arguments(kwargs)
+
+        domain = [1, 1, 1]
+        for name, (_, shape, _) in buffers.items():
+            if len(shape) != 3:
+                raise ValueError(f"Field '{name}' of {self.name} is not 3-dimensional")
+            domain = [max(size, extent) for size, extent in zip(domain, shape)]
+
+        if halo is None:
+            halo = (self.module.max_halo_size, self.module.max_halo_size, 0)
+        halo = tuple(halo)
+        if len(halo) == 3:
+            halo = (halo[0], halo[0], halo[1], halo[1], halo[2], halo[2])
+        if len(halo) != 6:
+            raise ValueError("halo needs to have 3 or 6 entries")
+
+        # The stencil instance of the shared object is only set up again if the domain changes
+        setup = (tuple(domain), halo)
+        if self._setup != setup:
+            self._functions["setup"](*domain, *halo)
+            self._setup = setup
+
+        args = [global_args[name] for name in self.globals]
+        for name in self.fields:
+            pointer, shape, strides = buffers[name]
+            args.append(pointer)
+            args.extend(stride if extent > 1 else 0 for extent, stride in zip(shape, strides))
+        self._functions["run"](*args)
+
+    def free(self):
+        """Free the stencil instance of the shared object (`run` sets it up again)."""
+        if self._setup is not None:
+            self._functions["free"]()
+            self._setup = None
+
+    def __del__(self):
+        try:
+            self.free()
+        except Exception:
+            pass
+
+
+class Mesh:
+    """Mesh given by flat neighbor tables, as expected by the unstructured backends.
+
+    Neighbor `n` of element `idx` of a chain starting at location `loc` is stored at
+    `table[n, idx]`, i.e. at `table[idx + n * stride(loc)]` of the flat table, where missing
+    neighbors are -1. The tables are C-contiguous 2-dimensional int32 buffers, which are referenced
+    (not copied) by the mesh. Element strides default to the number of elements.
+
+    Example::
+
+        mesh = Mesh(num_edges=ne, num_cells=nc,
+                    neighbor_tables={((Location.Edges, Location.Cells), False): ec_table})
+    """
+
+    def __init__(
+        self,
+        *,
+        num_edges: int = 0,
+        num_cells: int = 0,
+        num_vertices: int = 0,
+        neighbor_tables: Optional[Mapping[Tuple[Sequence[Location], bool], Any]] = None,
+        splitter_indices: Optional[Mapping[Tuple[Location, Subdomain, int], int]] = None,
+        edge_stride: Optional[int] = None,
+        cell_stride: Optional[int] = None,
+        vertex_stride: Optional[int] = None,
+    ):
+        self.sizes = {
+            Location.Edges: num_edges,
+            Location.Cells: num_cells,
+            Location.Vertices: num_vertices,
+        }
+        self.strides = {
+            Location.Edges: num_edges if edge_stride is None else edge_stride,
+            Location.Cells: num_cells if cell_stride is None else cell_stride,
+            Location.Vertices: num_vertices if vertex_stride is None else vertex_stride,
+        }
+
+        self.neighbor_tables = {}
+        for (chain, include_center), table in (neighbor_tables or {}).items():
+            chain = tuple(Location(location) for location in chain)
+            view = memoryview(table)
+            if view.format.lstrip("@=<") not in ("i", "l") or view.itemsize != 4:
+                raise TypeError(f"Neighbor table of {chain} is not a buffer of int32")
+            if view.ndim != 2 or not view.c_contiguous:
+                raise ValueError(f"Neighbor table of {chain} is not a contiguous 2D buffer")
+            if view.shape[1] != self.strides[chain[0]]:
+                raise ValueError(f"Neighbor table of {chain} does not match the element stride")
+            self.neighbor_tables[(chain, bool(include_center))] = (table, _pointer(table, view))
+
+        self.splitter_indices = {
+            (Location(loc), Subdomain(subdomain), int(offset)): int(index)
+            for (loc, subdomain, offset), index in (splitter_indices or {}).items()
+        }
+
+
+class UnstructuredStencil(Stencil):
+    """Stencil of the unstructured backend.
+
+    Dense fields are buffers indexed (k, idx), sparse fields (k, neighbor, idx) and vertical
+    fields (k), where the horizontal index needs to be contiguous. Fields without a vertical
+    dimension drop the leading k.
+    """
+
+    def __init__(self, module: "Module", name: str, functions: Dict[str, _Function]):
+        super().__init__(module, name, functions)
+        self._mesh = None
+        self._c_mesh = None
+        # vertical fields are passed without stride
+        params = [arg_name for _, arg_name in functions["run"].params]
+        self._vertical_fields = {
+            name for pos, name in enumerate(params[:-1]) if name in self.fields
+            and params[pos + 1] != name + "_stride"
+        }
+        if params and params[-1] in self.fields:
+            self._vertical_fields.add(params[-1])
+
+    def _set_mesh(self, mesh: Mesh):
+        """Create the C mesh of `mesh`, which is reused as long as the same mesh is passed"""
+        if self._mesh is mesh:
+            return
+        self._free_mesh()
+        library = self.module.library
+        locations = (Location.Edges, Location.Cells, Location.Vertices)
+        c_mesh = library.create_cpu_mesh(
+            *(mesh.sizes[loc] for loc in locations), *(mesh.strides[loc] for loc in locations)
+        )
+        for (chain, include_center), (_, pointer) in mesh.neighbor_tables.items():
+            c_chain = (ctypes.c_int * len(chain))(*chain)
+            library.set_cpu_mesh_neighbor_table(
+                c_mesh, c_chain, len(chain), int(include_center), pointer
+            )
+        for (loc, subdomain, offset), index in mesh.splitter_indices.items():
+            library.set_cpu_mesh_splitter_index(c_mesh, loc, subdomain, offset, index)
+        self._mesh, self._c_mesh = mesh, c_mesh
+
+    def _free_mesh(self):
+        if self._c_mesh is not None:
+            self.module.library.free_cpu_mesh(self._c_mesh)
+            self._mesh = self._c_mesh = None
+
+    def run(self, *, mesh: Mesh, k_size: Optional[int] = None, **kwargs):
+        """Run the stencil on the given mesh and fields (and globals) in place.
+
+        `k_size` defaults to the vertical extent of the fields (pass it if all fields are
+        horizontal).
+        """
+        global_args, buffers = self._arguments(kwargs)
+
+        if k_size is None:
+            vertical_extents = [
+                shape[0]
+                for name, (_, shape, _) in buffers.items()
+                if name in self._vertical_fields or len(shape) == 3
+            ]
+            k_size = max(vertical_extents or [shape[0] for _, shape, _ in buffers.values()])
+        self._set_mesh(mesh)
+
+        args = [self._c_mesh, k_size] + [global_args[name] for name in self.globals]
+        for name in self.fields:
+            pointer, shape, strides = buffers[name]
+            args.append(pointer)
+            if name in self._vertical_fields:
+                if strides[0] != 1:
+                    raise ValueError(f"Vertical field '{name}' is not contiguous")
+            elif len(shape) == 1:
+                args.append(0)
+            else:
+                if strides[-1] != 1 or (len(shape) == 3 and strides[0] != shape[1] * strides[1]):
+                    raise ValueError(f"Field '{name}' is not in the layout of the mesh fields")
+                args.append(strides[-2])
+        self._functions["run"](*args)
+
+    def __del__(self):
+        try:
+            self._free_mesh()
+        except Exception:
+            pass
+
+
+class Module:
+    """Compiled shared object of the generated code.
+
+    The stencils are accessible by name (`module.stencils[name]` or `module.<name>`), `run` runs
+    the only stencil of the module.
+    """
+
+    def __init__(self, library_path: str, c_header: str, backend, max_halo_size: int = 3):
+        self.library_path = library_path
+        self.library = ctypes.CDLL(library_path)
+        self.backend = backend
+        self.max_halo_size = max_halo_size
+
+        if backend == CodeGenBackend.CXXNaiveIco:
+            self.library.create_cpu_mesh.argtypes = [ctypes.c_int] * 6
+            self.library.create_cpu_mesh.restype = ctypes.c_void_p
+            self.library.set_cpu_mesh_neighbor_table.argtypes = [
+                ctypes.c_void_p,
+                ctypes.POINTER(ctypes.c_int),
+                ctypes.c_int,
+                ctypes.c_int,
+                ctypes.c_void_p,
+            ]
+            self.library.set_cpu_mesh_splitter_index.argtypes = [ctypes.c_void_p] + [
+                ctypes.c_int
+            ] * 4
+            self.library.free_cpu_mesh.argtypes = [ctypes.c_void_p]
+            stencil_class = UnstructuredStencil
+        else:
+            stencil_class = CartesianStencil
+
+        self.stencils: Dict[str, Stencil] = {}
+        for name, signatures in _parse_c_header(c_header).items():
+            functions = {
+                function: _Function(self.library, f"{function}_{name}", params)
+                for function, params in signatures.items()
+            }
+            self.stencils[name] = stencil_class(self, name, functions)
+        if not self.stencils:
+            raise JITError("No stencils found in the C interface")
+
+    def __getattr__(self, name: str) -> Stencil:
+        stencils = self.__dict__.get("stencils", {})
+        if name in stencils:
+            return stencils[name]
+        raise AttributeError(name)
+
+    def run(self, **kwargs):
+        """Run the only stencil of the module (see :meth:`CartesianStencil.run` and
+        :meth:`UnstructuredStencil.run`)."""
+        if len(self.stencils) != 1:
+            raise TypeError(f"Module has several stencils {sorted(self.stencils)}, choose one")
+        next(iter(self.stencils.values())).run(**kwargs)
+
+
+# ---------------------------------------------------------------------------------------------- #
+# build
+# ---------------------------------------------------------------------------------------------- #
+
+_modules: Dict[str, Module] = {}
+_modules_lock = threading.Lock()
+
+
+def default_include_dirs() -> List[str]:
+    """Directories of `DAWN4PY_JIT_INCLUDE_DIRS` (e.g. of GridTools and Boost) and the directory
+    containing the `driver-includes` of the generated code."""
+    include_dirs = os.environ.get("DAWN4PY_JIT_INCLUDE_DIRS", "").split(os.pathsep)
+    include_dirs = [include_dir for include_dir in include_dirs if include_dir]
+    package_dir = os.path.dirname(os.path.abspath(__file__))
+    candidates = [os.path.join(package_dir, "_external_src"), os.path.dirname(package_dir)]
+    return include_dirs + [
+        d for d in candidates if os.path.isdir(os.path.join(d, "driver-includes"))
+    ][:1]
+
+
+def default_cache_dir() -> str:
+    """Cache of the compiled shared objects (`DAWN4PY_CACHE_DIR` or `~/.cache/dawn4py`)."""
+    cache_dir = os.environ.get("DAWN4PY_CACHE_DIR")
+    if not cache_dir:
+        cache_root = os.environ.get("XDG_CACHE_HOME", os.path.join("~", ".cache"))
+        cache_dir = os.path.join(cache_root, "dawn4py")
+    return os.path.join(os.path.expanduser(cache_dir), "jit")
+
+
+def _compile_command(
+    compiler: str,
+    backend,
+    include_dirs: Iterable[str],
+    extra_compile_args: Iterable[str],
+    source: str,
+    target: str,
+) -> List[str]:
+    command = shlex.split(compiler) + ["-std=c++17", "-O3", "-shared", "-fPIC"]
+    if backend == CodeGenBackend.CXXOpt:
+        command.append("-fopenmp")
+    command += [f"-I{include_dir}" for include_dir in include_dirs]
+    command += list(extra_compile_args)
+    return command + [source, "-o", target]
+
+
+def build_code(
+    code: str,
+    c_header: str,
+    *,
+    backend=CodeGenBackend.CXXNaive,
+    name: str = "stencil",
+    cache_dir: Optional[str] = None,
+    compiler: Optional[str] = None,
+    include_dirs: Iterable[str] = (),
+    extra_compile_args: Iterable[str] = (),
+    max_halo_size: int = 3,
+) -> Module:
+    """Compile generated code with its raw pointer interface into a shared object and load it.
+
+    Parameters
+    ----------
+    code:
+        Generated code, containing the raw pointer interface.
+    c_header:
+        C header of the raw pointer interface (as written to `output_c_header`).
+    backend:
+        Code generation backend of the code.
+    name:
+        Name of the shared object in the cache (the hash of the build is appended).
+    cache_dir:
+        Cache of the compiled shared objects [defaults to :func:`default_cache_dir`].
+    compiler:
+        Host C++ compiler [defaults to `$CXX` or `c++`].
+    include_dirs:
+        Additional include directories (e.g. of GridTools and Boost for the Cartesian backends).
+    extra_compile_args:
+        Additional compiler flags.
+    max_halo_size:
+        Default halo of the Cartesian stencils in i and j.
+    Returns
+    -------
+    module : `Module`
+        The loaded shared object.
+    """
+    if backend not in _SUPPORTED_BACKENDS:
+        raise ValueError(f"JIT compilation is not supported for backend {backend}")
+    if compiler is None:
+        compiler = os.environ.get("CXX", "c++")
+    include_dirs = list(include_dirs) + default_include_dirs()
+    extra_compile_args = list(extra_compile_args)
+
+    if backend == CodeGenBackend.CXXNaiveIco:
+        # the C interface of the mesh
+        code += '\n#include "driver-includes/cpu_mesh.cpp"\n'
+
+    cache_dir = cache_dir or default_cache_dir()
+    key = hashlib.sha256()
+    for item in [code, c_header, compiler, str(backend)] + include_dirs + extra_compile_args:
+        key.update(item.encode())
+        key.update(b"\0")
+    library_path = os.path.join(cache_dir, f"{name}_{key.hexdigest()[:24]}.so")
+
+    with _modules_lock:
+        if library_path in _modules:
+            return _modules[library_path]
+
+        if not os.path.exists(library_path):
+            os.makedirs(cache_dir, exist_ok=True)
+            with tempfile.TemporaryDirectory(dir=cache_dir) as build_dir:
+                source = os.path.join(build_dir, f"{name}.cpp")
+                target = os.path.join(build_dir, f"{name}.so")
+                with open(source, mode="w") as f:
+                    f.write(code)
+                command = _compile_command(
+                    compiler, backend, include_dirs, extra_compile_args, source, target
+                )
+                result = subprocess.run(
+                    command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True
+                )
+                if result.returncode != 0:
+                    raise JITError(
+                        f"Compilation of the generated code failed:\n{' '.join(command)}\n"
+                        + result.stdout
+                    )
+                # concurrent builds of the same code (e.g. from several processes) are identical
+                os.replace(target, library_path)
+                os.replace(source, library_path[: -len(".so")] + ".cpp")
+
+        module = Module(library_path, c_header, backend, max_halo_size)
+        _modules[library_path] = module
+        return module
+
+
+def build(sir, *, backend=CodeGenBackend.CXXNaive, **kwargs) -> Module:
+    """Compile SIR to a shared object with the host compiler and load it.
+
+    Parameters
+    ----------
+    sir:
+        SIR of the stencil (a :class:`SIR` handle or in any valid serialized or non serialized
+        form).
+    backend:
+        CPU code generation backend (CXXNaive, CXXOpt or CXXNaiveIco).
+    **kwargs
+        Optional keyword arguments of :func:`build_code` and of :func:`dawn4py.compile`.
+    Returns
+    -------
+    module : `Module`
+        The loaded shared object.
+    """
+    build_args = {
+        key: kwargs.pop(key)
+        for key in (
+            "name",
+            "cache_dir",
+            "compiler",
+            "include_dirs",
+            "extra_compile_args",
+        )
+        if key in kwargs
+    }
+    if backend == CodeGenBackend.CXXNaiveIco:
+        kwargs["flat_neighbor_tables"] = True
+    max_halo_size = kwargs.get("max_halo_size", 3)
+
+    with tempfile.TemporaryDirectory() as header_dir:
+        header = os.path.join(header_dir, "interface.h")
+        code = _compile(sir, backend=backend, output_c_header=header, **kwargs)
+        with open(header, mode="r") as f:
+            c_header = f.read()
+
+    return build_code(
+        code, c_header, backend=backend, max_halo_size=max_halo_size, **build_args
+    )
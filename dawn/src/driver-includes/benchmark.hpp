@@ -0,0 +1,119 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gridtools {
+namespace dawn {
+
+/**
+ * @brief Timings of the repeated runs of a stencil
+ *
+ * Throughput figures are derived from the compute domain and from the compulsory memory traffic
+ * of the stencil, i.e. every non-temporary field read or written by the stencil is assumed to be
+ * transferred exactly once per grid point and run.
+ *
+ * @ingroup gridtools_dawn
+ */
+struct benchmark_result {
+  std::string name;
+  std::array<unsigned int, 3> compute_domain;
+  int warmup = 0;
+  int repetitions = 0;
+
+  /// Run times [s]
+  double min_time = 0;
+  double median_time = 0;
+  double mean_time = 0;
+
+  /// Bytes transferred from and to memory by a single run
+  double bytes_per_run = 0;
+
+  double points() const {
+    return double(compute_domain[0]) * compute_domain[1] * compute_domain[2];
+  }
+
+  /// Grid points updated per second (based on the median run time)
+  double points_per_second() const { return median_time > 0 ? points() / median_time : 0; }
+
+  /// Effective memory bandwidth [GB/s] (based on the median run time)
+  double bandwidth() const { return median_time > 0 ? bytes_per_run / median_time * 1e-9 : 0; }
+
+  /**
+   * @brief Write the result as a single-line JSON object
+   *
+   * @param extra   Additional (already quoted) key/value pairs, e.g. the backend name
+   */
+  void to_json(std::ostream& out,
+               const std::vector<std::pair<std::string, std::string>>& extra = {}) const {
+    out << "{\"name\": \"" << name << "\", ";
+    for(const auto& keyValue : extra)
+      out << "\"" << keyValue.first << "\": " << keyValue.second << ", ";
+    out << "\"domain\": [" << compute_domain[0] << ", " << compute_domain[1] << ", "
+        << compute_domain[2] << "], \"warmup\": " << warmup
+        << ", \"repetitions\": " << repetitions << ", \"min_time\": " << min_time
+        << ", \"median_time\": " << median_time << ", \"mean_time\": " << mean_time
+        << ", \"bytes_per_run\": " << bytes_per_run
+        << ", \"points_per_second\": " << points_per_second()
+        << ", \"bandwidth_gbs\": " << bandwidth() << "}";
+  }
+};
+
+/**
+ * @brief Call `run` `warmup` times untimed and `repetitions` times timed
+ *
+ * @return the run times [s] of the timed calls
+ */
+template <typename RunFunctor>
+std::vector<double> time_repeated(RunFunctor&& run, int warmup, int repetitions) {
+  for(int i = 0; i < warmup; ++i)
+    run();
+
+  std::vector<double> times;
+  times.reserve(repetitions);
+  for(int i = 0; i < repetitions; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto stop = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(stop - start).count());
+  }
+  return times;
+}
+
+/**
+ * @brief Fill the time statistics of `result` from the run times
+ */
+inline void set_time_statistics(benchmark_result& result, std::vector<double> times) {
+  const std::size_t n = times.size();
+  result.repetitions = n;
+  if(n == 0)
+    return;
+  std::sort(times.begin(), times.end());
+  result.min_time = times.front();
+  result.median_time = n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+  result.mean_time = std::accumulate(times.begin(), times.end(), 0.0) / n;
+}
+
+} // namespace dawn
+} // namespace gridtools
@@ -0,0 +1,33 @@
+#include "cpu_mesh.hpp"
+
+#include <vector>
+
+extern "C" {
+dawn::GlobalCpuTriMesh* create_cpu_mesh(int numEdges, int numCells, int numVertices,
+                                        int edgeStride, int cellStride, int vertexStride) {
+  auto* mesh = new dawn::GlobalCpuTriMesh;
+  mesh->NumEdges = numEdges;
+  mesh->NumCells = numCells;
+  mesh->NumVertices = numVertices;
+  mesh->EdgeStride = edgeStride;
+  mesh->CellStride = cellStride;
+  mesh->VertexStride = vertexStride;
+  return mesh;
+}
+
+void set_cpu_mesh_neighbor_table(dawn::GlobalCpuTriMesh* mesh, const int* chain,
+                                 int chainLength, int includeCenter, int* table) {
+  std::vector<dawn::LocationType> locations;
+  for(int i = 0; i < chainLength; ++i)
+    locations.push_back(dawn::LocationType(chain[i]));
+  mesh->NeighborTables[dawn::UnstructuredIterationSpace{locations, includeCenter != 0}] = table;
+}
+
+void set_cpu_mesh_splitter_index(dawn::GlobalCpuTriMesh* mesh, int loc, int space, int offset,
+                                 int index) {
+  mesh->set_splitter_index(dawn::LocationType(loc), dawn::UnstructuredSubdomain(space), offset,
+                           index);
+}
+
+void free_cpu_mesh(dawn::GlobalCpuTriMesh* mesh) { delete mesh; }
+}
@@ -0,0 +1,323 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "defs.hpp"
+
+#include "unstructured_domain.hpp"
+#include "unstructured_interface.hpp"
+
+#include <cassert>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#ifndef DEVICE_MISSING_VALUE
+#define DEVICE_MISSING_VALUE -1
+#endif
+
+namespace dawn {
+
+/**
+ * @brief Host mesh given by flat, padded neighbor tables (e.g. the connectivity arrays of ICON)
+ *
+ * Same layout as `GlobalGpuTriMesh`: neighbor `nbh` of element `idx` along a chain is stored at
+ * `NeighborTables.at(chain)[idx + nbh * <Location>Stride]`, where `<Location>` is the start of the
+ * chain. Neighborhoods smaller than the table width are padded with `DEVICE_MISSING_VALUE`. The
+ * tables are not owned by the mesh.
+ *
+ * @ingroup gridtools_dawn
+ */
+struct GlobalCpuTriMesh {
+  dawn::unstructured_domain HorizontalDomain;
+  int NumEdges = 0;
+  int NumCells = 0;
+  int NumVertices = 0;
+  int EdgeStride = 0;
+  int CellStride = 0;
+  int VertexStride = 0;
+  std::map<dawn::UnstructuredIterationSpace, int*> NeighborTables;
+  void set_splitter_index(dawn::LocationType loc, dawn::UnstructuredSubdomain space, int offset,
+                          int index) {
+    HorizontalDomain.set_splitter_index({loc, space, offset}, index);
+  }
+
+  int stride(dawn::LocationType loc) const {
+    switch(loc) {
+    case dawn::LocationType::Cells:
+      return CellStride;
+    case dawn::LocationType::Edges:
+      return EdgeStride;
+    case dawn::LocationType::Vertices:
+      return VertexStride;
+    }
+    return 0;
+  }
+};
+
+//===------------------------------------------------------------------------------------------===//
+// C interface to set up the mesh, e.g. for the raw pointer interface of the generated stencils
+// (defined in cpu_mesh.cpp). Locations and subdomains are passed as the values of the enums.
+//===------------------------------------------------------------------------------------------===//
+
+extern "C" {
+GlobalCpuTriMesh* create_cpu_mesh(int numEdges, int numCells, int numVertices, int edgeStride,
+                                  int cellStride, int vertexStride);
+/// The table is not copied and must outlive the mesh
+void set_cpu_mesh_neighbor_table(GlobalCpuTriMesh* mesh, const int* chain, int chainLength,
+                                 int includeCenter, int* table);
+void set_cpu_mesh_splitter_index(GlobalCpuTriMesh* mesh, int loc, int space, int offset,
+                                 int index);
+void free_cpu_mesh(GlobalCpuTriMesh* mesh);
+}
+
+//===------------------------------------------------------------------------------------------===//
+// fields, views on raw pointers in the layout of the ICON arrays (or owning allocated storage)
+//===------------------------------------------------------------------------------------------===//
+
+/// Dense field, element `idx` of level `k` is stored at `data[k * stride + idx]`
+template <typename T>
+class cpu_dense_field {
+public:
+  cpu_dense_field() = default;
+  cpu_dense_field(T* data, int stride) : data_(data), stride_(stride) {}
+
+  T& operator()(int idx, int k) const { return data_[k * stride_ + idx]; }
+  // horizontal field accesses
+  T& operator()(int idx) const { return data_[idx]; }
+
+  T* data() const { return data_; }
+  int stride() const { return stride_; }
+
+private:
+  template <typename U>
+  friend cpu_dense_field<U> allocate_cpu_dense_field(int, int);
+
+  std::shared_ptr<std::vector<T>> storage_;
+  T* data_ = nullptr;
+  int stride_ = 0;
+};
+
+/// Sparse field, neighbor `nbh` of element `idx` on level `k` is stored at
+/// `data[(k * sparseSize + nbh) * stride + idx]`
+template <typename T>
+class cpu_sparse_field {
+public:
+  cpu_sparse_field() = default;
+  cpu_sparse_field(T* data, int stride, int sparseSize)
+      : data_(data), stride_(stride), sparseSize_(sparseSize) {}
+
+  T& operator()(int idx, int nbh, int k) const {
+    assert(nbh < sparseSize_);
+    return data_[(k * sparseSize_ + nbh) * stride_ + idx];
+  }
+  // horizontal field accesses
+  T& operator()(int idx, int nbh) const {
+    assert(nbh < sparseSize_);
+    return data_[nbh * stride_ + idx];
+  }
+
+  T* data() const { return data_; }
+  int stride() const { return stride_; }
+  int sparseSize() const { return sparseSize_; }
+
+private:
+  template <typename U>
+  friend cpu_sparse_field<U> allocate_cpu_sparse_field(int, int, int);
+
+  std::shared_ptr<std::vector<T>> storage_;
+  T* data_ = nullptr;
+  int stride_ = 0;
+  int sparseSize_ = 0;
+};
+
+/// Vertical field
+template <typename T>
+class cpu_vertical_field {
+public:
+  cpu_vertical_field() = default;
+  cpu_vertical_field(T* data) : data_(data) {}
+
+  T& operator()(int k) const { return data_[k]; }
+
+  T* data() const { return data_; }
+
+private:
+  template <typename U>
+  friend cpu_vertical_field<U> allocate_cpu_vertical_field(int);
+
+  std::shared_ptr<std::vector<T>> storage_;
+  T* data_ = nullptr;
+};
+
+template <typename T>
+cpu_dense_field<T> allocate_cpu_dense_field(int numElements, int kSize) {
+  cpu_dense_field<T> field;
+  field.storage_ = std::make_shared<std::vector<T>>(numElements * kSize);
+  field.data_ = field.storage_->data();
+  field.stride_ = numElements;
+  return field;
+}
+template <typename T>
+cpu_sparse_field<T> allocate_cpu_sparse_field(int numElements, int kSize, int sparseSize) {
+  cpu_sparse_field<T> field;
+  field.storage_ = std::make_shared<std::vector<T>>(numElements * kSize * sparseSize);
+  field.data_ = field.storage_->data();
+  field.stride_ = numElements;
+  field.sparseSize_ = sparseSize;
+  return field;
+}
+template <typename T>
+cpu_vertical_field<T> allocate_cpu_vertical_field(int kSize) {
+  cpu_vertical_field<T> field;
+  field.storage_ = std::make_shared<std::vector<T>>(kSize);
+  field.data_ = field.storage_->data();
+  return field;
+}
+
+//===------------------------------------------------------------------------------------------===//
+// library interface
+//===------------------------------------------------------------------------------------------===//
+
+// Tag for the host mesh given by flat neighbor tables, the host counterpart of NoLibTag
+struct NoLibCpuTag {};
+dawn::GlobalCpuTriMesh meshType(NoLibCpuTag);
+int indexType(NoLibCpuTag);
+template <typename T>
+cpu_dense_field<T> cellFieldType(NoLibCpuTag);
+template <typename T>
+cpu_dense_field<T> edgeFieldType(NoLibCpuTag);
+template <typename T>
+cpu_dense_field<T> vertexFieldType(NoLibCpuTag);
+template <typename T>
+cpu_sparse_field<T> sparseCellFieldType(NoLibCpuTag);
+template <typename T>
+cpu_sparse_field<T> sparseEdgeFieldType(NoLibCpuTag);
+template <typename T>
+cpu_sparse_field<T> sparseVertexFieldType(NoLibCpuTag);
+template <typename T>
+cpu_vertical_field<T> verticalFieldType(NoLibCpuTag);
+
+/// Range of element indices [begin, end)
+class index_range {
+public:
+  class iterator {
+  public:
+    iterator(int idx) : idx_(idx) {}
+    int operator*() const { return idx_; }
+    iterator& operator++() {
+      ++idx_;
+      return *this;
+    }
+    bool operator==(const iterator& other) const { return idx_ == other.idx_; }
+    bool operator!=(const iterator& other) const { return idx_ != other.idx_; }
+
+  private:
+    int idx_;
+  };
+
+  index_range(int begin, int end) : begin_(begin), end_(end) {}
+  iterator begin() const { return iterator(begin_); }
+  iterator end() const { return iterator(end_); }
+
+private:
+  int begin_;
+  int end_;
+};
+
+inline index_range getCells(NoLibCpuTag, GlobalCpuTriMesh const& mesh) {
+  return index_range(0, mesh.NumCells);
+}
+inline index_range getEdges(NoLibCpuTag, GlobalCpuTriMesh const& mesh) {
+  return index_range(0, mesh.NumEdges);
+}
+inline index_range getVertices(NoLibCpuTag, GlobalCpuTriMesh const& mesh) {
+  return index_range(0, mesh.NumVertices);
+}
+inline index_range getCells(NoLibCpuTag, GlobalCpuTriMesh const&, int lo, int hi) {
+  return index_range(lo, hi);
+}
+inline index_range getEdges(NoLibCpuTag, GlobalCpuTriMesh const&, int lo, int hi) {
+  return index_range(lo, hi);
+}
+inline index_range getVertices(NoLibCpuTag, GlobalCpuTriMesh const&, int lo, int hi) {
+  return index_range(lo, hi);
+}
+
+inline int numCells(NoLibCpuTag, GlobalCpuTriMesh const& mesh) { return mesh.NumCells; }
+inline int numEdges(NoLibCpuTag, GlobalCpuTriMesh const& mesh) { return mesh.NumEdges; }
+inline int numVertices(NoLibCpuTag, GlobalCpuTriMesh const& mesh) { return mesh.NumVertices; }
+
+inline cpu_vertical_field<::dawn::float_type> allocateField(NoLibCpuTag, int kSize) {
+  return allocate_cpu_vertical_field<::dawn::float_type>(kSize);
+}
+inline cpu_dense_field<::dawn::float_type> allocateField(NoLibCpuTag, int numElements, int kSize) {
+  return allocate_cpu_dense_field<::dawn::float_type>(numElements, kSize);
+}
+inline cpu_sparse_field<::dawn::float_type> allocateField(NoLibCpuTag, int numElements, int kSize,
+                                                          int sparseSize) {
+  return allocate_cpu_sparse_field<::dawn::float_type>(numElements, kSize, sparseSize);
+}
+
+/// Neighbors of element `idx` listed in the table of the chain, missing neighbors are skipped. The
+/// table width needs to be passed since the mesh does not know it.
+inline std::vector<int> getNeighbors(GlobalCpuTriMesh const& mesh,
+                                     std::vector<dawn::LocationType> const& chain, int idx,
+                                     bool includeCenter, int numNbhPerElement) {
+  const int* table = mesh.NeighborTables.at(dawn::UnstructuredIterationSpace{chain, includeCenter});
+  const int stride = mesh.stride(chain.front());
+  std::vector<int> neighbors;
+  for(int nbh = 0; nbh < numNbhPerElement; ++nbh) {
+    const int nbhIdx = table[idx + nbh * stride];
+    if(nbhIdx != DEVICE_MISSING_VALUE)
+      neighbors.push_back(nbhIdx);
+  }
+  return neighbors;
+}
+
+/// Build the flat neighbor table of a chain from the neighbor discovery of another library
+template <typename LibTag>
+std::vector<int> generateNbhTable(dawn::mesh_t<LibTag> const& mesh,
+                                  std::vector<dawn::LocationType> chain, int numElements,
+                                  int numNbhPerElement, bool includeCenter = false) {
+  std::vector<int> table(numElements * numNbhPerElement, DEVICE_MISSING_VALUE);
+  auto fill = [&](int elem, int pos) {
+    auto neighbors = getNeighbors(LibTag{}, mesh, chain, elem, includeCenter);
+    assert(neighbors.size() <= size_t(numNbhPerElement));
+    for(size_t nbh = 0; nbh < neighbors.size(); ++nbh)
+      table[pos + nbh * numElements] = neighbors[nbh];
+  };
+
+  int pos = 0;
+  switch(chain.front()) {
+  case dawn::LocationType::Cells:
+    for(auto cell : getCells(LibTag{}, mesh))
+      fill(cell, pos++);
+    break;
+  case dawn::LocationType::Edges:
+    for(auto edge : getEdges(LibTag{}, mesh))
+      fill(edge, pos++);
+    break;
+  case dawn::LocationType::Vertices:
+    for(auto vertex : getVertices(LibTag{}, mesh))
+      fill(vertex, pos++);
+    break;
+  }
+  assert(pos == numElements);
+  return table;
+}
+
+} // namespace dawn
@@ -0,0 +1,62 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "field_comparison.hpp"
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace dawn {
+
+/**
+ * @brief Host counterpart of `verify_field` in cuda_verify.hpp, comparing `num_el` values of the
+ * dsl field to the reference (`actual`) with the tolerance of `numpy.isclose`
+ *
+ * Reports the error statistics of `compare_fields` and, if the verification fails, the value
+ * ranges of both fields.
+ *
+ * @ingroup gridtools_dawn
+ */
+inline bool verify_field(const int num_el, const double* dsl, const double* actual,
+                         std::string name, const double rel_tol, const double abs_tol) {
+  const field_comparison result =
+      compare_fields(num_el, 1, 0, actual, 0, dsl, is_close{rel_tol, abs_tol});
+  result.report(std::cout, "[DSL] " + name);
+
+  if(!result.verified()) {
+    auto printRange = [&](const double* field, const std::string& fieldName) {
+      double min = std::numeric_limits<double>::infinity();
+      double max = -std::numeric_limits<double>::infinity();
+      double sum = 0.;
+#pragma omp parallel for simd reduction(min : min) reduction(max : max) reduction(+ : sum)
+      for(int idx = 0; idx < num_el; ++idx) {
+        min = field[idx] < min ? field[idx] : min;
+        max = field[idx] > max ? field[idx] : max;
+        sum += field[idx];
+      }
+      std::cout << "[DSL] " << fieldName << " max: " << max << "\n" << std::flush;
+      std::cout << "[DSL] " << fieldName << " min: " << min << "\n" << std::flush;
+      std::cout << "[DSL] " << fieldName << " avg: " << sum / num_el << "\n" << std::flush;
+    };
+    printRange(actual, name);
+    printRange(dsl, name + "_dsl");
+  }
+
+  return result.verified();
+}
+
+} // namespace dawn
@@ -0,0 +1,298 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dawn {
+
+//===------------------------------------------------------------------------------------------===//
+// distance in units in the last place
+//===------------------------------------------------------------------------------------------===//
+
+/// Map the bits of a floating point value to an integer that is ordered like the value (-0 and +0
+/// map to the same integer), consecutive floating point values map to consecutive integers
+inline std::int64_t ordered_bits(double value) {
+  std::int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits < 0 ? std::numeric_limits<std::int64_t>::min() - bits : bits;
+}
+inline std::int64_t ordered_bits(float value) {
+  std::int32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits < 0 ? std::int64_t(std::numeric_limits<std::int32_t>::min()) - bits : bits;
+}
+
+/// Number of representable values between `a` and `b` (undefined for NaNs)
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, std::uint64_t>::type
+ulp_distance(T a, T b) {
+  const std::int64_t ia = ordered_bits(a);
+  const std::int64_t ib = ordered_bits(b);
+  return ia > ib ? std::uint64_t(ia) - std::uint64_t(ib) : std::uint64_t(ib) - std::uint64_t(ia);
+}
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, std::uint64_t>::type
+ulp_distance(T a, T b) {
+  return a > b ? std::uint64_t(a - b) : std::uint64_t(b - a);
+}
+
+//===------------------------------------------------------------------------------------------===//
+// comparison of a field to a reference
+//===------------------------------------------------------------------------------------------===//
+
+/// Point of a field, element `idx` on level `k`
+struct field_location {
+  int idx;
+  int k;
+  bool operator<(const field_location& other) const {
+    return k < other.k || (k == other.k && idx < other.idx);
+  }
+};
+
+/**
+ * @brief Error statistics of a field compared to a reference, see `compare_fields`
+ *
+ * Points where either value is NaN are counted as failures but do not enter the error
+ * statistics. The relative error is taken with respect to the reference (expected) value.
+ *
+ * @ingroup gridtools_dawn
+ */
+struct field_comparison {
+  std::size_t num_points = 0;
+  /// Points outside the tolerance (including NaNs)
+  std::size_t num_failures = 0;
+  std::size_t num_nans = 0;
+  double max_abs_error = 0.;
+  double min_abs_error = std::numeric_limits<double>::infinity();
+  double sum_abs_error = 0.;
+  double max_rel_error = 0.;
+  double min_rel_error = std::numeric_limits<double>::infinity();
+  double sum_rel_error = 0.;
+  std::uint64_t max_ulp_distance = 0;
+  /// Histograms of the failures
+  std::vector<std::size_t> failures_per_level;
+  std::vector<std::size_t> failures_per_subdomain;
+  /// The first failing points in storage order (level by level)
+  std::vector<field_location> failures;
+
+  bool verified() const { return num_failures == 0; }
+  double mean_abs_error() const {
+    return num_points > num_nans ? sum_abs_error / (num_points - num_nans) : 0.;
+  }
+  double mean_rel_error() const {
+    return num_points > num_nans ? sum_rel_error / (num_points - num_nans) : 0.;
+  }
+
+  /// Accumulate the statistics of another part of the same field, keeping at most `max_failures`
+  /// failing points
+  void merge(const field_comparison& other, std::size_t max_failures) {
+    num_points += other.num_points;
+    num_failures += other.num_failures;
+    num_nans += other.num_nans;
+    max_abs_error = std::max(max_abs_error, other.max_abs_error);
+    min_abs_error = std::min(min_abs_error, other.min_abs_error);
+    sum_abs_error += other.sum_abs_error;
+    max_rel_error = std::max(max_rel_error, other.max_rel_error);
+    min_rel_error = std::min(min_rel_error, other.min_rel_error);
+    sum_rel_error += other.sum_rel_error;
+    max_ulp_distance = std::max(max_ulp_distance, other.max_ulp_distance);
+    for(std::size_t k = 0; k < other.failures_per_level.size(); ++k)
+      failures_per_level[k] += other.failures_per_level[k];
+    for(std::size_t sub = 0; sub < other.failures_per_subdomain.size(); ++sub)
+      failures_per_subdomain[sub] += other.failures_per_subdomain[sub];
+    failures.insert(failures.end(), other.failures.begin(), other.failures.end());
+    std::sort(failures.begin(), failures.end());
+    if(failures.size() > max_failures)
+      failures.resize(max_failures);
+  }
+
+  /// Print the statistics, every line starts with `prefix`. The histograms only list the levels
+  /// and subdomains with failures.
+  void report(std::ostream& os, const std::string& prefix) const {
+    const auto flags = os.flags();
+    os << std::scientific;
+    os << prefix << " maximum relative error: " << max_rel_error << "\n";
+    os << prefix << " minimum relative error: " << (num_points > num_nans ? min_rel_error : 0.)
+       << "\n";
+    os << prefix << " mean relative error: " << mean_rel_error() << "\n";
+    os << prefix << " maximum absolute error: " << max_abs_error << "\n";
+    os << prefix << " minimum absolute error: " << (num_points > num_nans ? min_abs_error : 0.)
+       << "\n";
+    os << prefix << " mean absolute error: " << mean_abs_error() << "\n";
+    os.flags(flags);
+    os << prefix << " maximum ULP distance: " << max_ulp_distance << "\n";
+    os << prefix << " points outside tolerance: " << num_failures << " of " << num_points << " ("
+       << num_nans << " NaN)\n";
+    auto printHistogram = [&](const std::vector<std::size_t>& histogram, const char* what) {
+      if(num_failures == 0 || histogram.size() < 2)
+        return;
+      os << prefix << " points outside tolerance per " << what << ":";
+      for(std::size_t bin = 0; bin < histogram.size(); ++bin)
+        if(histogram[bin] != 0)
+          os << " " << bin << ": " << histogram[bin];
+      os << "\n";
+    };
+    printHistogram(failures_per_level, "level");
+    printHistogram(failures_per_subdomain, "subdomain");
+    os << std::flush;
+  }
+};
+
+/**
+ * @brief Compare a field to a reference in a single pass
+ *
+ * The field has `num_elements` horizontal elements on each of `num_levels` levels and is accessed
+ * through `expected(idx, k)` and `actual(idx, k)`. `within_tolerance(expected, actual)` decides
+ * whether a point passes. The elements can be partitioned into subdomains by passing the first
+ * element of every subdomain but the first (ascending), failures are then counted per subdomain.
+ *
+ * The levels are split into chunks which are compared in parallel if OpenMP is enabled, the loop
+ * over a chunk is a SIMD reduction. Only chunks with failures are scanned a second time to record
+ * the first `max_failures` failing points.
+ *
+ * @ingroup gridtools_dawn
+ */
+template <typename Expected, typename Actual, typename WithinTolerance>
+field_comparison compare_fields(int num_elements, int num_levels, Expected expected, Actual actual,
+                                WithinTolerance within_tolerance,
+                                std::vector<int> subdomain_starts = std::vector<int>(),
+                                std::size_t max_failures = 10) {
+  const int chunk_size = 4096;
+
+  field_comparison result;
+  result.failures_per_level.resize(std::max(num_levels, 0), 0);
+  result.failures_per_subdomain.resize(subdomain_starts.size() + 1, 0);
+
+  // tasks (level, subdomain, first element, end of elements) not crossing subdomain boundaries
+  std::vector<int> bounds{0};
+  for(int start : subdomain_starts)
+    bounds.push_back(std::min(std::max(start, bounds.back()), num_elements));
+  bounds.push_back(std::max(num_elements, 0));
+  struct task {
+    int k;
+    int sub;
+    int begin;
+    int end;
+  };
+  std::vector<task> tasks;
+  for(int k = 0; k < num_levels; ++k)
+    for(std::size_t sub = 0; sub + 1 < bounds.size(); ++sub)
+      for(int begin = bounds[sub]; begin < bounds[sub + 1]; begin += chunk_size)
+        tasks.push_back(task{k, int(sub), begin, std::min(begin + chunk_size, bounds[sub + 1])});
+  const long num_tasks = long(tasks.size());
+
+#pragma omp parallel
+  {
+    field_comparison local;
+    local.failures_per_level.resize(result.failures_per_level.size(), 0);
+    local.failures_per_subdomain.resize(result.failures_per_subdomain.size(), 0);
+
+#pragma omp for schedule(static)
+    for(long t = 0; t < num_tasks; ++t) {
+      const task chunk = tasks[t];
+      const int k = chunk.k;
+      const double inf = std::numeric_limits<double>::infinity();
+      std::size_t failures = 0, nans = 0;
+      double max_abs = 0., min_abs = inf, sum_abs = 0.;
+      double max_rel = 0., min_rel = inf, sum_rel = 0.;
+      std::uint64_t max_ulp = 0;
+
+#pragma omp simd reduction(+ : failures, nans, sum_abs, sum_rel)                                  \
+    reduction(max : max_abs, max_rel, max_ulp) reduction(min : min_abs, min_rel)
+      for(int idx = chunk.begin; idx < chunk.end; ++idx) {
+        const auto e = expected(idx, k);
+        const auto a = actual(idx, k);
+        const bool nan = std::isnan(double(e)) || std::isnan(double(a));
+        const bool equal = e == a;
+        const double abs_err = (nan || equal) ? 0. : std::fabs(double(e) - double(a));
+        const double rel_err = (nan || equal) ? 0. : abs_err / std::fabs(double(e));
+        const std::uint64_t ulp = nan ? 0 : ulp_distance(e, a);
+        failures += (nan || !within_tolerance(e, a)) ? 1 : 0;
+        nans += nan ? 1 : 0;
+        sum_abs += abs_err;
+        sum_rel += rel_err;
+        max_abs = abs_err > max_abs ? abs_err : max_abs;
+        max_rel = rel_err > max_rel ? rel_err : max_rel;
+        max_ulp = ulp > max_ulp ? ulp : max_ulp;
+        min_abs = (!nan && abs_err < min_abs) ? abs_err : min_abs;
+        min_rel = (!nan && rel_err < min_rel) ? rel_err : min_rel;
+      }
+
+      local.num_points += chunk.end - chunk.begin;
+      local.num_failures += failures;
+      local.num_nans += nans;
+      local.sum_abs_error += sum_abs;
+      local.sum_rel_error += sum_rel;
+      local.max_abs_error = std::max(local.max_abs_error, max_abs);
+      local.min_abs_error = std::min(local.min_abs_error, min_abs);
+      local.max_rel_error = std::max(local.max_rel_error, max_rel);
+      local.min_rel_error = std::min(local.min_rel_error, min_rel);
+      local.max_ulp_distance = std::max(local.max_ulp_distance, max_ulp);
+      local.failures_per_level[k] += failures;
+      local.failures_per_subdomain[chunk.sub] += failures;
+
+      for(int idx = chunk.begin; failures != 0 && local.failures.size() < max_failures &&
+                                 idx < chunk.end;
+          ++idx) {
+        const auto e = expected(idx, k);
+        const auto a = actual(idx, k);
+        if(std::isnan(double(e)) || std::isnan(double(a)) || !within_tolerance(e, a))
+          local.failures.push_back(field_location{idx, k});
+      }
+    }
+
+#pragma omp critical(dawn_compare_fields)
+    result.merge(local, max_failures);
+  }
+
+  return result;
+}
+
+/// Compare fields stored level by level, element `idx` of level `k` is at `k * stride + idx`
+template <typename T, typename WithinTolerance>
+field_comparison compare_fields(int num_elements, int num_levels, int stride_expected,
+                                const T* expected, int stride_actual, const T* actual,
+                                WithinTolerance within_tolerance,
+                                std::vector<int> subdomain_starts = std::vector<int>(),
+                                std::size_t max_failures = 10) {
+  return compare_fields(
+      num_elements, num_levels,
+      [=](int idx, int k) { return expected[std::size_t(k) * stride_expected + idx]; },
+      [=](int idx, int k) { return actual[std::size_t(k) * stride_actual + idx]; },
+      within_tolerance, std::move(subdomain_starts), max_failures);
+}
+
+/// Tolerance of `numpy.isclose`: |actual - expected| <= abs_tol + rel_tol * |expected|
+struct is_close {
+  double rel_tol;
+  double abs_tol;
+  template <typename T>
+  bool operator()(T expected, T actual) const {
+    return std::fabs(double(actual) - double(expected)) <=
+           abs_tol + rel_tol * std::fabs(double(expected));
+  }
+};
+
+} // namespace dawn
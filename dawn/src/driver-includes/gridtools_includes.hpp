@@ -22,6 +22,8 @@
 #include "domain.hpp"
 #include "extent.hpp"
 #include "halo.hpp"
+#include "halo_exchange.hpp"
 #include "math.hpp"
 #include "param_wrapper.hpp"
+#include "raw_field.hpp"
 #include "storage.hpp"
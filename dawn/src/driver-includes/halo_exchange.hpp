@@ -0,0 +1,228 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include "defs.hpp"
+#include "domain.hpp"
+#include "raw_field.hpp"
+
+#include <array>
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace gridtools {
+namespace dawn {
+
+/**
+ * @brief Communication layer updating the halos of the fields of a domain decomposed grid
+ *
+ * Stencils generated with `-halo-exchange` call `start` for every field whose halo they read
+ * before writing it, compute the grid points which do not depend on the halos, call `finish` and
+ * compute the remaining boundary strips. The compute domains of the fields passed to `start` are
+ * not modified before `finish` returns, the received halos have to be written by `finish` at the
+ * latest. Halos at the boundary of the global domain are left to the boundary conditions.
+ *
+ * Halo widths are given as {iminus, iplus, jminus, jplus} and do not exceed the halos of `dom`.
+ *
+ * @ingroup gridtools_dawn
+ */
+class halo_exchange {
+public:
+  virtual ~halo_exchange() {}
+
+  /// @brief Start updating the halo of `field` allocated on `dom`
+  virtual void start(const raw_field<::dawn::float_type>& field, const domain& dom,
+                     const std::array<int, 4>& width) = 0;
+
+  /// @brief Wait until the halos of all fields passed to `start` (since the last call) are updated
+  virtual void finish() = 0;
+};
+
+/**
+ * @brief Shared memory stand-in for a distributed memory communicator, each rank is a thread
+ *
+ * The global domain is decomposed into `xcols` x `ycols` subdomains, rank `r` owns the one in
+ * column `r % xcols` and row `r / xcols` (see `computeGlobalOffsets` of the generated stencils).
+ * Like a nonblocking point-to-point implementation, `start` packs the boundary strips sent to the
+ * (up to eight, the diagonal ones fill the corners) neighbors into messages, `finish` waits for the
+ * messages of the neighbors and unpacks them into the halos. The messages are passed through a
+ * mailbox shared by all ranks.
+ *
+ * @ingroup gridtools_dawn
+ */
+class thread_halo_exchange_world {
+  using message_key = std::tuple<int, int, int, int>; // receiver, sender, sequence, direction
+
+  class rank_communicator : public halo_exchange {
+    struct receive {
+      raw_field<::dawn::float_type> field;
+      std::array<int, 6> range; // first and last i, j and k
+      int sender;
+      int sequence;
+      int direction;
+    };
+
+    thread_halo_exchange_world& m_world;
+    int m_rank;
+    int m_sequence = 0;
+    std::vector<receive> m_receives;
+
+  public:
+    rank_communicator(thread_halo_exchange_world& world, int rank)
+        : m_world(world), m_rank(rank) {}
+
+    void start(const raw_field<::dawn::float_type>& field, const domain& dom,
+               const std::array<int, 4>& width) override {
+      assert(width[0] <= int(dom.iminus()) && width[1] <= int(dom.iplus()));
+      assert(width[2] <= int(dom.jminus()) && width[3] <= int(dom.jplus()));
+      const int iMin = dom.iminus(), iMax = dom.isize() - dom.iplus() - 1;
+      const int jMin = dom.jminus(), jMax = dom.jsize() - dom.jplus() - 1;
+      const int sequence = m_sequence++;
+
+      for(int di = -1; di <= 1; ++di)
+        for(int dj = -1; dj <= 1; ++dj) {
+          const int neighbor = m_world.neighbor(m_rank, di, dj);
+          if((di == 0 && dj == 0) || neighbor < 0)
+            continue;
+          // The neighbor in direction (di, dj) receives our boundary strip into its halo on the
+          // opposite side and sends us the one adjacent to our halo on this side
+          const std::array<int, 6> sendRange{di > 0 ? iMax - width[0] + 1 : iMin,
+                                             di < 0 ? iMin + width[1] - 1 : iMax,
+                                             dj > 0 ? jMax - width[2] + 1 : jMin,
+                                             dj < 0 ? jMin + width[3] - 1 : jMax,
+                                             0,
+                                             int(dom.ksize()) - 1};
+          const std::array<int, 6> receiveRange{di > 0 ? iMax + 1 : di < 0 ? iMin - width[0] : iMin,
+                                                di > 0 ? iMax + width[1] : di < 0 ? iMin - 1 : iMax,
+                                                dj > 0 ? jMax + 1 : dj < 0 ? jMin - width[2] : jMin,
+                                                dj > 0 ? jMax + width[3] : dj < 0 ? jMin - 1 : jMax,
+                                                0,
+                                                int(dom.ksize()) - 1};
+
+          if(!is_empty(sendRange)) {
+            std::vector<::dawn::float_type> message;
+            for_each(sendRange, [&](int i, int j, int k) { message.push_back(field(i, j, k)); });
+            m_world.post(message_key{neighbor, m_rank, sequence, direction(di, dj)},
+                         std::move(message));
+          }
+          if(!is_empty(receiveRange))
+            m_receives.push_back(
+                receive{field, receiveRange, neighbor, sequence, direction(-di, -dj)});
+        }
+    }
+
+    void finish() override {
+      for(const receive& r : m_receives) {
+        const std::vector<::dawn::float_type> message =
+            m_world.take(message_key{m_rank, r.sender, r.sequence, r.direction});
+        std::size_t pos = 0;
+        for_each(r.range, [&](int i, int j, int k) { r.field(i, j, k) = message[pos++]; });
+        assert(pos == message.size());
+      }
+      m_receives.clear();
+    }
+
+  private:
+    static int direction(int di, int dj) { return 3 * (di + 1) + dj + 1; }
+
+    static bool is_empty(const std::array<int, 6>& range) {
+      return range[0] > range[1] || range[2] > range[3] || range[4] > range[5];
+    }
+
+    template <typename F>
+    static void for_each(const std::array<int, 6>& range, F&& f) {
+      for(int i = range[0]; i <= range[1]; ++i)
+        for(int j = range[2]; j <= range[3]; ++j)
+          for(int k = range[4]; k <= range[5]; ++k)
+            f(i, j, k);
+    }
+  };
+
+  int m_xcols;
+  int m_ycols;
+  bool m_periodic;
+  std::vector<std::unique_ptr<rank_communicator>> m_ranks;
+  std::map<message_key, std::vector<::dawn::float_type>> m_mailbox;
+  std::mutex m_mutex;
+  std::condition_variable m_posted;
+
+public:
+  /**
+   * @param xcols     Number of subdomains along i
+   * @param ycols     Number of subdomains along j
+   * @param periodic  Whether the global domain is periodic in i and j
+   */
+  thread_halo_exchange_world(int xcols, int ycols, bool periodic = false)
+      : m_xcols(xcols), m_ycols(ycols), m_periodic(periodic) {
+    for(int rank = 0; rank < size(); ++rank)
+      m_ranks.emplace_back(new rank_communicator(*this, rank));
+  }
+
+  thread_halo_exchange_world(const thread_halo_exchange_world&) = delete;
+  thread_halo_exchange_world& operator=(const thread_halo_exchange_world&) = delete;
+
+  int size() const { return m_xcols * m_ycols; }
+
+  /// @brief Communicator of `rank`, to be used by a single thread
+  halo_exchange& communicator(int rank) { return *m_ranks.at(rank); }
+
+  /// @brief Neighbor of `rank` in direction (`di`, `dj`), -1 at the boundary of the global domain
+  int neighbor(int rank, int di, int dj) const {
+    int col = rank % m_xcols + di, row = rank / m_xcols + dj;
+    if(m_periodic) {
+      col = (col + m_xcols) % m_xcols;
+      row = (row + m_ycols) % m_ycols;
+    }
+    if(col < 0 || col >= m_xcols || row < 0 || row >= m_ycols)
+      return -1;
+    return row * m_xcols + col;
+  }
+
+  /// @brief Run `f(rank, communicator(rank))` on one thread per rank and wait for all of them
+  void run(const std::function<void(int, halo_exchange&)>& f) {
+    std::vector<std::thread> threads;
+    for(int rank = 0; rank < size(); ++rank)
+      threads.emplace_back([this, &f, rank]() { f(rank, communicator(rank)); });
+    for(std::thread& thread : threads)
+      thread.join();
+  }
+
+private:
+  void post(const message_key& key, std::vector<::dawn::float_type> message) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_mailbox[key] = std::move(message);
+    }
+    m_posted.notify_all();
+  }
+
+  std::vector<::dawn::float_type> take(const message_key& key) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_posted.wait(lock, [&]() { return m_mailbox.count(key) > 0; });
+    std::vector<::dawn::float_type> message = std::move(m_mailbox[key]);
+    m_mailbox.erase(key);
+    return message;
+  }
+};
+
+} // namespace dawn
+} // namespace gridtools
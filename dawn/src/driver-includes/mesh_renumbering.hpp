@@ -0,0 +1,202 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "unstructured_domain.hpp"
+
+// Renumbering of the elements of an unstructured mesh to improve the locality of neighbor accesses.
+//
+// A renumbering is described by a permutation `new_index`, element `i` of the original numbering
+// becomes element `new_index[i]`. The connectivity tables and all fields defined on the mesh have to
+// be permuted with the same permutation. Elements are only ever permuted within a block of
+// consecutive indices, the blocks are delimited by the splitter indices of the mesh's
+// `unstructured_domain`. Hence lateral boundary, nudging, interior and halo elements keep their
+// position relative to each other and the splitter indices stay valid after the renumbering.
+
+namespace dawn {
+
+namespace detail {
+// [begin, end) ranges of the blocks delimited by the boundaries
+inline std::vector<std::pair<int, int>> renumbering_blocks(int num_elements,
+                                                           std::vector<int> boundaries) {
+  boundaries.push_back(0);
+  boundaries.push_back(num_elements);
+  boundaries.erase(std::remove_if(boundaries.begin(), boundaries.end(),
+                                  [&](int idx) { return idx < 0 || idx > num_elements; }),
+                   boundaries.end());
+  std::sort(boundaries.begin(), boundaries.end());
+  boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+  std::vector<std::pair<int, int>> blocks;
+  for(std::size_t i = 0; i + 1 < boundaries.size(); ++i)
+    blocks.emplace_back(boundaries[i], boundaries[i + 1]);
+  return blocks;
+}
+
+// index of the point (x, y) on the Hilbert curve filling a n x n square (n being a power of 2)
+inline std::uint64_t hilbert_index(std::uint32_t n, std::uint32_t x, std::uint32_t y) {
+  std::uint64_t d = 0;
+  for(std::uint32_t s = n / 2; s > 0; s /= 2) {
+    const std::uint32_t rx = (x & s) > 0;
+    const std::uint32_t ry = (y & s) > 0;
+    d += std::uint64_t(s) * s * ((3 * rx) ^ ry);
+    // rotate the quadrant such that the curve is continuous
+    if(ry == 0) {
+      if(rx == 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+} // namespace detail
+
+/// @brief Reverse Cuthill-McKee ordering of the graph given by `adjacency`
+///
+/// Every block is renumbered separately. Within a block a breadth first search is started from a
+/// minimum degree element (of every connected component), neighbors are visited in order of
+/// increasing degree and the resulting order is reversed. Edges leaving a block are ignored. The
+/// boundaries of the blocks are typically `domain.splitter_indices(loc)`.
+///
+/// @return the new index of every element
+inline std::vector<int> reverse_cuthill_mckee(std::vector<std::vector<int>> const& adjacency,
+                                              std::vector<int> const& boundaries = {}) {
+  const int num_elements = adjacency.size();
+  std::vector<int> new_index(num_elements, -1);
+  std::vector<bool> visited(num_elements, false);
+
+  for(auto [begin, end] : detail::renumbering_blocks(num_elements, boundaries)) {
+    auto in_block = [begin = begin, end = end](int idx) { return idx >= begin && idx < end; };
+
+    std::vector<int> degree(num_elements, 0);
+    for(int idx = begin; idx < end; ++idx)
+      degree[idx] = std::count_if(adjacency[idx].begin(), adjacency[idx].end(), in_block);
+    auto by_degree = [&](int a, int b) {
+      return degree[a] != degree[b] ? degree[a] < degree[b] : a < b;
+    };
+
+    std::vector<int> candidates;
+    for(int idx = begin; idx < end; ++idx)
+      candidates.push_back(idx);
+    std::sort(candidates.begin(), candidates.end(), by_degree);
+
+    std::vector<int> order;
+    order.reserve(end - begin);
+    std::vector<int> neighbors;
+    for(int start : candidates) {
+      if(visited[start])
+        continue;
+      std::queue<int> queue;
+      queue.push(start);
+      visited[start] = true;
+      while(!queue.empty()) {
+        const int idx = queue.front();
+        queue.pop();
+        order.push_back(idx);
+
+        neighbors.clear();
+        for(int neighbor : adjacency[idx])
+          if(in_block(neighbor) && !visited[neighbor]) {
+            visited[neighbor] = true;
+            neighbors.push_back(neighbor);
+          }
+        std::sort(neighbors.begin(), neighbors.end(), by_degree);
+        for(int neighbor : neighbors)
+          queue.push(neighbor);
+      }
+    }
+
+    std::reverse(order.begin(), order.end());
+    for(std::size_t pos = 0; pos < order.size(); ++pos)
+      new_index[order[pos]] = begin + pos;
+  }
+  return new_index;
+}
+
+/// @brief Ordering of points along a Hilbert space filling curve
+///
+/// Every block is renumbered separately. The points are mapped to a 2^16 x 2^16 grid spanning their
+/// bounding box, points of the same grid cell keep their relative order.
+///
+/// @return the new index of every point
+inline std::vector<int> hilbert_order(std::vector<double> const& x, std::vector<double> const& y,
+                                      std::vector<int> const& boundaries = {}) {
+  assert(x.size() == y.size());
+  const int num_elements = x.size();
+  std::vector<int> new_index(num_elements, -1);
+  if(num_elements == 0)
+    return new_index;
+
+  const auto [xMin, xMax] = std::minmax_element(x.begin(), x.end());
+  const auto [yMin, yMax] = std::minmax_element(y.begin(), y.end());
+  const std::uint32_t n = 1 << 16;
+  auto quantize = [n](double value, double min, double max) -> std::uint32_t {
+    if(max <= min)
+      return 0;
+    return std::min<std::uint32_t>(n - 1, (value - min) / (max - min) * n);
+  };
+
+  std::vector<std::uint64_t> key(num_elements);
+  for(int idx = 0; idx < num_elements; ++idx)
+    key[idx] = detail::hilbert_index(n, quantize(x[idx], *xMin, *xMax),
+                                     quantize(y[idx], *yMin, *yMax));
+
+  for(auto [begin, end] : detail::renumbering_blocks(num_elements, boundaries)) {
+    std::vector<int> order;
+    for(int idx = begin; idx < end; ++idx)
+      order.push_back(idx);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return key[a] < key[b]; });
+    for(std::size_t pos = 0; pos < order.size(); ++pos)
+      new_index[order[pos]] = begin + pos;
+  }
+  return new_index;
+}
+
+/// @brief Permute a per-element array, `values[i]` is moved to position `new_index[i]`
+template <typename T>
+std::vector<T> apply_renumbering(std::vector<T> const& values, std::vector<int> const& new_index) {
+  assert(values.size() == new_index.size());
+  std::vector<T> result(values.size());
+  for(std::size_t idx = 0; idx < values.size(); ++idx)
+    result[new_index[idx]] = values[idx];
+  return result;
+}
+
+/// @brief Average distance between the indices of neighboring elements
+///
+/// The smaller the distance, the more likely neighbors of an element share a cache line or page with
+/// the element. Useful as a cheap, machine-independent proxy for the cache misses of a numbering.
+inline double mean_neighbor_distance(std::vector<std::vector<int>> const& adjacency) {
+  double distance = 0;
+  std::size_t count = 0;
+  for(std::size_t idx = 0; idx < adjacency.size(); ++idx)
+    for(int neighbor : adjacency[idx]) {
+      distance += std::abs(neighbor - int(idx));
+      ++count;
+    }
+  return count > 0 ? distance / count : 0;
+}
+
+} // namespace dawn
@@ -0,0 +1,64 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#pragma once
+
+namespace gridtools {
+namespace dawn {
+
+/**
+ * @brief Non-owning view on memory allocated by the caller (e.g. a Fortran model)
+ *
+ * The raw pointer entry points (`run_<stencil>`) of the C++ backends wrap the caller's arrays
+ * into `raw_field`s, the stencils then operate in place. Strides are given in number of
+ * elements, a stride of 0 masks the dimension (e.g. the k-stride of a 2D field). The pointer
+ * refers to the element (0, 0, 0) of the allocated domain, i.e. including the halos, which
+ * matches the indexing of gridtools data views.
+ *
+ * @ingroup gridtools_dawn
+ */
+template <typename T>
+class raw_field {
+  T* m_ptr;
+  int m_stride_i;
+  int m_stride_j;
+  int m_stride_k;
+
+public:
+  raw_field(T* ptr, int stride_i, int stride_j, int stride_k)
+      : m_ptr(ptr), m_stride_i(stride_i), m_stride_j(stride_j), m_stride_k(stride_k) {}
+
+  T& operator()(int i, int j, int k) const {
+    return m_ptr[i * m_stride_i + j * m_stride_j + k * m_stride_k];
+  }
+
+  T* data() const { return m_ptr; }
+};
+
+/**
+ * @brief Wrap the host memory of a gridtools data store into a `raw_field`
+ *
+ * Used to pass storages owned by the generated code (e.g. inter-stencil temporaries) to the
+ * `raw_field` overloads of the stencil run methods.
+ */
+template <typename Storage>
+raw_field<typename Storage::data_t> make_raw_field(Storage& storage) {
+  auto view = make_host_view(storage);
+  const auto& info = *storage.get_storage_info_ptr();
+  return raw_field<typename Storage::data_t>(&view(0, 0, 0), info.template stride<0>(),
+                                             info.template stride<1>(), info.template stride<2>());
+}
+
+} // namespace dawn
+} // namespace gridtools
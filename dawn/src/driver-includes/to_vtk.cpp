@@ -3,88 +3,325 @@
 #include "cuda_utils.hpp"
 
 #include <algorithm>
-#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 MeshInfoVtk mesh_info_vtk;
 
 static const std::string fname_pre = "dsl_fields_";
 
-class StencilFieldsVtkOutput {
-  std::fstream fs;
-  std::stringstream cells_ss, points_ss;
-  bool wroteCellData = false, wrotePointData = false;
+namespace {
 
-  int num_k_;
+//===------------------------------------------------------------------------------------------===//
+// background writer
+//===------------------------------------------------------------------------------------------===//
+
+// upper bound for the field data held by queued output, the serialize_* calls block beyond it
+constexpr std::size_t maxPendingOutputBytes = std::size_t(1) << 30;
+
+// Writes the output on a background thread in the order it was queued. Every task declares the
+// number of bytes it keeps alive, queueing blocks as long as the pending tasks exceed the limit (a
+// single task larger than the limit is accepted once the queue has drained). The thread is started
+// on the first task and joined after all queued tasks have been written.
+class BackgroundWriter {
+  std::mutex mutex_;
+  std::condition_variable taskQueued_;
+  std::condition_variable taskDone_;
+  std::deque<std::pair<std::function<void()>, std::size_t>> tasks_;
+  std::size_t pendingBytes_ = 0;
+  const std::size_t maxPendingBytes_;
+  bool done_ = false;
+  std::thread thread_;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true) {
+      taskQueued_.wait(lock, [&] { return done_ || !tasks_.empty(); });
+      if(tasks_.empty())
+        return;
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      try {
+        task.first();
+      } catch(const std::exception& e) {
+        std::cerr << "vtk output failed: " << e.what() << std::endl;
+      }
+      // release the data captured by the task before its bytes are freed for new tasks
+      task.first = nullptr;
+      lock.lock();
+      pendingBytes_ -= task.second;
+      taskDone_.notify_all();
+    }
+  }
 
 public:
-  StencilFieldsVtkOutput(int num_k, std::string stencil_name, int iteration) : num_k_(num_k) {
+  explicit BackgroundWriter(std::size_t maxPendingBytes) : maxPendingBytes_(maxPendingBytes) {}
 
-    if(!mesh_info_vtk.isInitialized()) {
-      throw std::runtime_error("Uninitialized vtk mesh data.");
+  ~BackgroundWriter() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
     }
+    taskQueued_.notify_one();
+    if(thread_.joinable())
+      thread_.join();
+  }
 
-    const int num_cells = mesh_info_vtk.mesh_num_cells;
-    const int num_verts = mesh_info_vtk.mesh_num_verts;
+  BackgroundWriter(const BackgroundWriter&) = delete;
+  BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+
+  void push(std::function<void()> task, std::size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if(!thread_.joinable())
+      thread_ = std::thread([this] { run(); });
+    taskDone_.wait(lock, [&] {
+      return pendingBytes_ == 0 || pendingBytes_ + bytes <= maxPendingBytes_;
+    });
+    tasks_.emplace_back(std::move(task), bytes);
+    pendingBytes_ += bytes;
+    taskQueued_.notify_one();
+  }
+};
 
-    const int* cells_vertex_idx = mesh_info_vtk.mesh_cells_vertex_idx;
+// defined after `mesh_info_vtk` and before the outputs below such that pending output is queued
+// and written before the mesh is destroyed at exit
+BackgroundWriter background_writer(maxPendingOutputBytes);
 
-    const double* vlat = mesh_info_vtk.mesh_vlat;
-    const double* vlon = mesh_info_vtk.mesh_vlon;
+using HostField = std::shared_ptr<const std::vector<double>>;
 
-    const double lat_range =
-        *std::max_element(vlat, vlat + num_verts) - *std::min_element(vlat, vlat + num_verts);
-    const double lon_range =
-        *std::max_element(vlon, vlon + num_verts) - *std::min_element(vlon, vlon + num_verts);
-    const double range = std::max(lat_range, lon_range);
+//===------------------------------------------------------------------------------------------===//
+// binary vtu (xml unstructured grid) output
+//===------------------------------------------------------------------------------------------===//
 
-    fs.open(fname_pre + stencil_name + "_rank" + std::to_string(mesh_info_vtk.rank_id) + "_" +
-                std::to_string(iteration) + ".vtk",
-            std::fstream::out);
+// Geometry of the mesh, the horizontal triangles are extruded to `num_k` levels. The horizontal
+// data is taken from `mesh_info_vtk` and the vertical spacing computed once, the levels are
+// generated one at a time while writing.
+struct VtuGeometry {
+  int num_cells;
+  int num_verts;
+  double range;
 
-    fs << "# vtk DataFile Version 3.0\n2D scalar data\nASCII\nDATASET "
-          "UNSTRUCTURED_GRID\n";
+  static const VtuGeometry& get() {
+    static const VtuGeometry geometry = [] {
+      if(!mesh_info_vtk.isInitialized()) {
+        throw std::runtime_error("Uninitialized vtk mesh data.");
+      }
+      const int num_verts = mesh_info_vtk.mesh_num_verts;
+      const double* vlat = mesh_info_vtk.mesh_vlat;
+      const double* vlon = mesh_info_vtk.mesh_vlon;
+      const double lat_range =
+          *std::max_element(vlat, vlat + num_verts) - *std::min_element(vlat, vlat + num_verts);
+      const double lon_range =
+          *std::max_element(vlon, vlon + num_verts) - *std::min_element(vlon, vlon + num_verts);
+      return VtuGeometry{mesh_info_vtk.mesh_num_cells, num_verts, std::max(lat_range, lon_range)};
+    }();
+    return geometry;
+  }
+};
+
+struct VtuDataArray {
+  std::string name;
+  std::vector<double> values;
+};
+
+// Writes a VTK XML unstructured grid with all arrays appended as raw binary data. Blocks are
+// prefixed by their size in bytes (header_type UInt64) and written in the byte order of the host.
+class VtuWriter {
+  std::FILE* file_;
+  std::vector<char> buffer_;
+
+  void write(const void* data, std::size_t bytes) {
+    if(std::fwrite(data, 1, bytes, file_) != bytes)
+      throw std::runtime_error("Failed to write vtu output.");
+  }
+  template <typename T>
+  void writeBlock(const std::vector<T>& values) {
+    write(values.data(), sizeof(T) * values.size());
+  }
+  void writeBlockHeader(std::uint64_t bytes) { write(&bytes, sizeof(bytes)); }
+
+  static bool isLittleEndian() {
+    const std::uint16_t one = 1;
+    return *reinterpret_cast<const unsigned char*>(&one) == 1;
+  }
 
-    fs << "POINTS " << num_verts * num_k << " double\n";
+public:
+  explicit VtuWriter(const std::string& filename)
+      : file_(std::fopen(filename.c_str(), "wb")), buffer_(1 << 22) {
+    if(!file_)
+      throw std::runtime_error("Failed to open vtu output " + filename + ".");
+    std::setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+  }
+  ~VtuWriter() { std::fclose(file_); }
+
+  VtuWriter(const VtuWriter&) = delete;
+  VtuWriter& operator=(const VtuWriter&) = delete;
+
+  void writeGrid(const VtuGeometry& geometry, int num_k, const std::vector<VtuDataArray>& cell_data,
+                 const std::vector<VtuDataArray>& point_data) {
+    const std::uint64_t num_cells = std::uint64_t(geometry.num_cells) * num_k;
+    const std::uint64_t num_points = std::uint64_t(geometry.num_verts) * num_k;
+
+    std::uint64_t offset = 0;
+    auto dataArray = [&](const char* type, const std::string& name, int num_components,
+                         std::uint64_t bytes) {
+      std::stringstream ss;
+      ss << "<DataArray type=\"" << type << "\"";
+      if(!name.empty())
+        ss << " Name=\"" << name << "\"";
+      if(num_components != 1)
+        ss << " NumberOfComponents=\"" << num_components << "\"";
+      ss << " format=\"appended\" offset=\"" << offset << "\"/>\n";
+      offset += sizeof(std::uint64_t) + bytes;
+      return ss.str();
+    };
+
+    std::stringstream header;
+    header << "<?xml version=\"1.0\"?>\n"
+           << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+           << (isLittleEndian() ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\">\n"
+           << "<UnstructuredGrid>\n"
+           << "<Piece NumberOfPoints=\"" << num_points << "\" NumberOfCells=\"" << num_cells
+           << "\">\n";
+    // one statement per array, the offsets depend on the order of the calls
+    header << "<Points>\n";
+    header << dataArray("Float64", "", 3, 3 * sizeof(double) * num_points);
+    header << "</Points>\n";
+    header << "<Cells>\n";
+    header << dataArray("Int64", "connectivity", 1, 3 * sizeof(std::int64_t) * num_cells);
+    header << dataArray("Int64", "offsets", 1, sizeof(std::int64_t) * num_cells);
+    header << dataArray("UInt8", "types", 1, sizeof(std::uint8_t) * num_cells);
+    header << "</Cells>\n";
+    header << "<CellData>\n";
+    for(const auto& array : cell_data)
+      header << dataArray("Float64", array.name, 1, sizeof(double) * array.values.size());
+    header << "</CellData>\n";
+    header << "<PointData>\n";
+    for(const auto& array : point_data)
+      header << dataArray("Float64", array.name, 1, sizeof(double) * array.values.size());
+    header << "</PointData>\n";
+    header << "</Piece>\n</UnstructuredGrid>\n<AppendedData encoding=\"raw\">\n_";
+    const std::string header_str = header.str();
+    write(header_str.data(), header_str.size());
 
-    fs << std::setprecision(std::numeric_limits<double>::max_digits10);
+    const int* cells_vertex_idx = mesh_info_vtk.mesh_cells_vertex_idx;
+    const double* vlat = mesh_info_vtk.mesh_vlat;
+    const double* vlon = mesh_info_vtk.mesh_vlon;
+    const int num_level_cells = geometry.num_cells;
+    const int num_level_verts = geometry.num_verts;
 
+    writeBlockHeader(3 * sizeof(double) * num_points);
+    std::vector<double> points(3 * num_level_verts);
     for(int k = 0; k < num_k; k++) {
-      for(int nodeIter = 0; nodeIter < num_verts; nodeIter++) {
-        double x = vlat[nodeIter];
-        double y = vlon[nodeIter];
-        double z = k / ((double)num_k) * range;
-        fs << x << " " << y << " " << z << "\n";
+      const double z = k / ((double)num_k) * geometry.range;
+      for(int nodeIter = 0; nodeIter < num_level_verts; nodeIter++) {
+        points[3 * nodeIter + 0] = vlat[nodeIter];
+        points[3 * nodeIter + 1] = vlon[nodeIter];
+        points[3 * nodeIter + 2] = z;
       }
+      writeBlock(points);
     }
 
-    fs << "CELLS " << num_cells * num_k << " " << 4 * num_cells * num_k << "\n";
-
+    writeBlockHeader(3 * sizeof(std::int64_t) * num_cells);
+    std::vector<std::int64_t> connectivity(3 * num_level_cells);
     for(int k = 0; k < num_k; k++) {
-      for(int cellIter = 0; cellIter < num_cells; cellIter++) {
-        fs << "3 " << cells_vertex_idx[0 * num_cells + cellIter] + k * num_verts << " "
-           << cells_vertex_idx[1 * num_cells + cellIter] + k * num_verts << " "
-           << cells_vertex_idx[2 * num_cells + cellIter] + k * num_verts << '\n';
+      const std::int64_t level_offset = std::int64_t(k) * num_level_verts;
+      for(int cellIter = 0; cellIter < num_level_cells; cellIter++) {
+        for(int vertex = 0; vertex < 3; vertex++) {
+          connectivity[3 * cellIter + vertex] =
+              cells_vertex_idx[vertex * num_level_cells + cellIter] + level_offset;
+        }
       }
+      writeBlock(connectivity);
     }
 
-    fs << "CELL_TYPES " << num_cells * num_k << '\n';
+    writeBlockHeader(sizeof(std::int64_t) * num_cells);
+    std::vector<std::int64_t> offsets(num_level_cells);
     for(int k = 0; k < num_k; k++) {
-      for(int cellIter = 0; cellIter < num_cells; cellIter++) {
-        fs << "5\n";
+      for(int cellIter = 0; cellIter < num_level_cells; cellIter++) {
+        offsets[cellIter] = 3 * (std::int64_t(k) * num_level_cells + cellIter + 1);
       }
+      writeBlock(offsets);
+    }
+
+    // VTK_TRIANGLE
+    writeBlockHeader(sizeof(std::uint8_t) * num_cells);
+    const std::vector<std::uint8_t> types(num_level_cells, 5);
+    for(int k = 0; k < num_k; k++) {
+      writeBlock(types);
+    }
+
+    for(const auto& array : cell_data) {
+      writeBlockHeader(sizeof(double) * array.values.size());
+      writeBlock(array.values);
+    }
+    for(const auto& array : point_data) {
+      writeBlockHeader(sizeof(double) * array.values.size());
+      writeBlock(array.values);
     }
+
+    const std::string footer = "\n</AppendedData>\n</VTKFile>\n";
+    write(footer.data(), footer.size());
+    if(std::fflush(file_) != 0)
+      throw std::runtime_error("Failed to write vtu output.");
+  }
+};
+
+// Field data of one (stencil, iteration), written to a vtu file by the background writer when the
+// output is flushed or destroyed at exit
+class StencilFieldsVtkOutput {
+  struct Data {
+    std::string filename;
+    int num_k;
+    std::vector<VtuDataArray> cell_data;
+    std::vector<VtuDataArray> point_data;
+  };
+  std::unique_ptr<Data> data_;
+
+public:
+  StencilFieldsVtkOutput(int num_k, std::string stencil_name, int iteration)
+      : data_(new Data{fname_pre + stencil_name + "_rank" + std::to_string(mesh_info_vtk.rank_id) +
+                           "_" + std::to_string(iteration) + ".vtu",
+                       num_k,
+                       {},
+                       {}}) {
+    // fail early, not on the background thread
+    VtuGeometry::get();
   }
 
   ~StencilFieldsVtkOutput() {
-    fs << cells_ss.str();
-    fs << points_ss.str();
-    fs.close();
+    if(!data_)
+      return;
+    std::size_t bytes = 0;
+    for(const auto& array : data_->cell_data)
+      bytes += sizeof(double) * array.values.size();
+    for(const auto& array : data_->point_data)
+      bytes += sizeof(double) * array.values.size();
+
+    std::shared_ptr<Data> data(std::move(data_));
+    background_writer.push(
+        [data]() {
+          VtuWriter writer(data->filename);
+          writer.writeGrid(VtuGeometry::get(), data->num_k, data->cell_data, data->point_data);
+        },
+        bytes);
   }
 
   StencilFieldsVtkOutput(const StencilFieldsVtkOutput&) = delete;
@@ -92,43 +329,19 @@ public:
   StencilFieldsVtkOutput& operator=(const StencilFieldsVtkOutput&) = delete;
   StencilFieldsVtkOutput& operator=(StencilFieldsVtkOutput&&) = default;
 
-  std::stringstream& cellData() {
-    if(!wroteCellData) {
-      cells_ss << "CELL_DATA " << mesh_info_vtk.mesh_num_cells * num_k_ << '\n';
-    }
-    wroteCellData = true;
-    return cells_ss;
+  std::vector<double>& cellData(std::string field_name) {
+    data_->cell_data.push_back(VtuDataArray{std::move(field_name), {}});
+    return data_->cell_data.back().values;
   }
-  std::stringstream& pointData() {
-    if(!wrotePointData) {
-      points_ss << "POINT_DATA " << mesh_info_vtk.mesh_num_verts * num_k_ << '\n';
-    }
-    wrotePointData = true;
-    return points_ss;
+  std::vector<double>& pointData(std::string field_name) {
+    data_->point_data.push_back(VtuDataArray{std::move(field_name), {}});
+    return data_->point_data.back().values;
   }
 };
 
 // (stencil_name, iteration) -> vtk_output_handle
 std::map<std::pair<std::string, int>, StencilFieldsVtkOutput> stencil_to_output_map;
 
-// wrapper type so we can overload `std::ostream <<` and get vtk compatible formatting for NaNs
-struct formatNaNs {
-  double value;
-  formatNaNs(double value): value(value) {}
-};
-
-std::ostream& operator<<(std::ostream& os, const formatNaNs& wrapper)
-{
-  if(std::isnan(wrapper.value)) {
-    os << "nan";
-  } else {
-    os << wrapper.value;
-  }
-  return os;
-}
-
-
-namespace {
 StencilFieldsVtkOutput& getStencilFieldsVtkOutput(int num_k, std::string stencil_name, int iter) {
   if(stencil_to_output_map.count(std::make_pair(stencil_name, iter)) == 0) {
     stencil_to_output_map.emplace(std::make_pair(stencil_name, iter),
@@ -141,166 +354,142 @@ void flushAtIter(std::string stencil_name, int iter) {
   stencil_to_output_map.erase(std::make_pair(stencil_name, iter));
 }
 
-double* fieldFromGpu(const double* field_gpu, const int size) {
-  double* field_cpu = new double[size];
-  gpuErrchk(cudaMemcpy(field_cpu, field_gpu, sizeof(double) * size, cudaMemcpyDeviceToHost));
+HostField fieldFromGpu(const double* field_gpu, const int size) {
+  auto field_cpu = std::make_shared<std::vector<double>>(size);
+  gpuErrchk(cudaMemcpy(field_cpu->data(), field_gpu, sizeof(double) * size,
+                       cudaMemcpyDeviceToHost));
   return field_cpu;
 }
 
-void dense_cells_to_csv(int start_idx, int end_idx, int num_k, int dense_stride,
-                        const double* field, const char stencil_name[50], const char field_name[50],
-                        int iter) {
-  std::fstream fs;
-  fs.open(std::string(stencil_name) + "_rank" + std::to_string(mesh_info_vtk.rank_id) + "_" +
-              std::string(field_name) + "_" + std::to_string(iter) + ".csv",
-          std::fstream::out);
+//===------------------------------------------------------------------------------------------===//
+// csv output
+//===------------------------------------------------------------------------------------------===//
+
+// Queues the csv output of a field, `value(k, idx)` is evaluated on the background thread
+void to_csv(const HostField& field, const char stencil_name[50], const char field_name[50],
+            int iter, int num_k, int num_elements, std::function<double(int, int)> value) {
+  const std::string name(field_name);
+  const std::string filename = std::string(stencil_name) + "_rank" +
+                               std::to_string(mesh_info_vtk.rank_id) + "_" + name + "_" +
+                               std::to_string(iter) + ".csv";
+  background_writer.push(
+      [field, filename, name, num_k, num_elements, value]() {
+        std::fstream fs;
+        fs.open(filename, std::fstream::out);
+
+        fs << "\"";
+        fs << name;
+        fs << "\"\n";
+
+        fs << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+        for(int k = 0; k < num_k; k++) {
+          for(int idx = 0; idx < num_elements; idx++) {
+            fs << value(k, idx) << "\n";
+          }
+        }
 
-  fs << "\"";
-  fs << field_name;
-  fs << "\"\n";
+        fs.close();
+      },
+      sizeof(double) * field->size());
+}
 
-  fs << std::setprecision(std::numeric_limits<double>::max_digits10);
+double dense_value(int start_idx, int end_idx, int dense_stride, const double* field, int k,
+                   int idx) {
+  if(idx < start_idx || idx > end_idx) {
+    return 0.0;
+  }
+  return field[k * dense_stride + idx];
+}
 
-  for(int k = 0; k < num_k; k++) {
-    for(int cellIter = 0; cellIter < mesh_info_vtk.mesh_num_cells; cellIter++) {
-      if(cellIter < start_idx || cellIter > end_idx) {
-        fs << 0.0 << "\n";
-      } else {
-        fs << field[k * dense_stride + cellIter] << "\n";
-      }
+// Edges not supported by vtk, need to interpolate into cells.
+double edges_to_cell_value(int start_idx, int end_idx, int dense_stride, const double* field,
+                           int k, int cellIter) {
+  double interpol = 0.0;
+  for(int neighbor = 0; neighbor < 3; neighbor++) {
+    int idx = mesh_info_vtk.mesh_cells_edge_idx[neighbor * mesh_info_vtk.mesh_num_cells + cellIter];
+    if(idx < start_idx || idx > end_idx) {
+      interpol = 0.0;
+      break;
     }
+    interpol += field[k * dense_stride + idx];
   }
+  interpol /= double(3);
+  return interpol;
+}
 
-  fs.close();
+void dense_cells_to_csv(int start_idx, int end_idx, int num_k, int dense_stride,
+                        const HostField& field, const char stencil_name[50],
+                        const char field_name[50], int iter) {
+  const double* data = field->data();
+  to_csv(field, stencil_name, field_name, iter, num_k, mesh_info_vtk.mesh_num_cells,
+         [=](int k, int idx) {
+           return dense_value(start_idx, end_idx, dense_stride, data, k, idx);
+         });
 }
 
 void dense_cells_to_vtk(int start_idx, int end_idx, int num_k, int dense_stride,
-                        const double* field, const char stencil_name[50], const char field_name[50],
-                        int iter) {
+                        const HostField& field, const char stencil_name[50],
+                        const char field_name[50], int iter) {
 
   auto& output = getStencilFieldsVtkOutput(num_k, std::string(stencil_name), iter);
 
-  output.cellData() << "SCALARS " << std::string(field_name) << " double 1\nLOOKUP_TABLE default\n";
-
-  output.cellData() << std::setprecision(std::numeric_limits<double>::max_digits10);
-
+  auto& values = output.cellData(field_name);
+  values.reserve(std::size_t(num_k) * mesh_info_vtk.mesh_num_cells);
   for(int k = 0; k < num_k; k++) {
     for(int cellIter = 0; cellIter < mesh_info_vtk.mesh_num_cells; cellIter++) {
-      if(cellIter < start_idx || cellIter > end_idx) {
-        output.cellData() << 0.0 << "\n";
-      } else {
-        output.cellData() << formatNaNs(field[k * dense_stride + cellIter]) << "\n";
-      }
+      values.push_back(dense_value(start_idx, end_idx, dense_stride, field->data(), k, cellIter));
     }
   }
 }
 
 void dense_verts_to_csv(int start_idx, int end_idx, int num_k, int dense_stride,
-                        const double* field, const char stencil_name[50], const char field_name[50],
-                        int iter) {
-  std::fstream fs;
-  fs.open(std::string(stencil_name) + "_rank" + std::to_string(mesh_info_vtk.rank_id) + "_" +
-              std::string(field_name) + "_" + std::to_string(iter) + ".csv",
-          std::fstream::out);
-
-  fs << "\"";
-  fs << field_name;
-  fs << "\"\n";
-
-  fs << std::setprecision(std::numeric_limits<double>::max_digits10);
-
-  for(int k = 0; k < num_k; k++) {
-    for(int vertIter = 0; vertIter < mesh_info_vtk.mesh_num_verts; vertIter++) {
-      if(vertIter < start_idx || vertIter > end_idx) {
-        fs << 0.0 << "\n";
-      } else {
-        fs << field[k * dense_stride + vertIter] << "\n";
-      }
-    }
-  }
-
-  fs.close();
+                        const HostField& field, const char stencil_name[50],
+                        const char field_name[50], int iter) {
+  const double* data = field->data();
+  to_csv(field, stencil_name, field_name, iter, num_k, mesh_info_vtk.mesh_num_verts,
+         [=](int k, int idx) {
+           return dense_value(start_idx, end_idx, dense_stride, data, k, idx);
+         });
 }
 
 void dense_verts_to_vtk(int start_idx, int end_idx, int num_k, int dense_stride,
-                        const double* field, const char stencil_name[50], const char field_name[50],
-                        int iter) {
+                        const HostField& field, const char stencil_name[50],
+                        const char field_name[50], int iter) {
 
   auto& output = getStencilFieldsVtkOutput(num_k, std::string(stencil_name), iter);
 
-  output.pointData() << "SCALARS " << std::string(field_name) << " double 1\nLOOKUP_TABLE default\n";
-
-  output.pointData() << std::setprecision(std::numeric_limits<double>::max_digits10);
-
+  auto& values = output.pointData(field_name);
+  values.reserve(std::size_t(num_k) * mesh_info_vtk.mesh_num_verts);
   for(int k = 0; k < num_k; k++) {
     for(int pointIter = 0; pointIter < mesh_info_vtk.mesh_num_verts; pointIter++) {
-      if(pointIter < start_idx || pointIter > end_idx) {
-        output.pointData() << 0.0 << "\n";
-      } else {
-        output.pointData() << formatNaNs(field[k * dense_stride + pointIter]) << "\n";
-      }
+      values.push_back(dense_value(start_idx, end_idx, dense_stride, field->data(), k, pointIter));
     }
   }
 }
 
 void dense_edges_to_csv(int start_idx, int end_idx, int num_k, int dense_stride,
-                        const double* field, const char stencil_name[50], const char field_name[50],
-                        int iter) {
-  std::fstream fs;
-  fs.open(std::string(stencil_name) + "_rank" + std::to_string(mesh_info_vtk.rank_id) + "_" +
-              std::string(field_name) + "_" + std::to_string(iter) + ".csv",
-          std::fstream::out);
-
-  fs << "\"";
-  fs << field_name;
-  fs << "\"\n";
-
-  fs << std::setprecision(std::numeric_limits<double>::max_digits10);
-
-  for(int k = 0; k < num_k; k++) {
-    for(int cellIter = 0; cellIter < mesh_info_vtk.mesh_num_cells; cellIter++) {
-      double interpol = 0.0;
-      for(int neighbor = 0; neighbor < 3; neighbor++) {
-        int idx =
-            mesh_info_vtk.mesh_cells_edge_idx[neighbor * mesh_info_vtk.mesh_num_cells + cellIter];
-        if(idx < start_idx || idx > end_idx) {
-          interpol = 0.0;
-          break;
-        }
-        interpol += field[k * dense_stride + idx];
-      }
-      interpol /= double(3);
-      fs << interpol << "\n";
-    }
-  }
-
-  fs.close();
+                        const HostField& field, const char stencil_name[50],
+                        const char field_name[50], int iter) {
+  const double* data = field->data();
+  to_csv(field, stencil_name, field_name, iter, num_k, mesh_info_vtk.mesh_num_cells,
+         [=](int k, int idx) {
+           return edges_to_cell_value(start_idx, end_idx, dense_stride, data, k, idx);
+         });
 }
 
 void dense_edges_to_vtk(int start_idx, int end_idx, int num_k, int dense_stride,
-                        const double* field, const char stencil_name[50], const char field_name[50],
-                        int iter) {
+                        const HostField& field, const char stencil_name[50],
+                        const char field_name[50], int iter) {
 
   auto& output = getStencilFieldsVtkOutput(num_k, std::string(stencil_name), iter);
-  // Edges not supported by vtk, need to interpolate into cells.
-  output.cellData() << "SCALARS " << std::string(field_name) << " double 1\nLOOKUP_TABLE default\n";
-
-  output.cellData() << std::setprecision(std::numeric_limits<double>::max_digits10);
 
+  auto& values = output.cellData(field_name);
+  values.reserve(std::size_t(num_k) * mesh_info_vtk.mesh_num_cells);
   for(int k = 0; k < num_k; k++) {
     for(int cellIter = 0; cellIter < mesh_info_vtk.mesh_num_cells; cellIter++) {
-      double interpol = 0.0;
-      for(int neighbor = 0; neighbor < 3; neighbor++) {
-        int idx =
-            mesh_info_vtk.mesh_cells_edge_idx[neighbor * mesh_info_vtk.mesh_num_cells + cellIter];
-        if(idx < start_idx || idx > end_idx) {
-          interpol = 0.0;
-          break;
-        }
-        interpol += field[k * dense_stride + idx];
-      }
-      interpol /= double(3);
-      output.cellData() << formatNaNs(interpol) << "\n";
+      values.push_back(
+          edges_to_cell_value(start_idx, end_idx, dense_stride, field->data(), k, cellIter));
     }
   }
 }
@@ -312,7 +501,7 @@ extern "C" {
 void serialize_dense_cells(int start_idx, int end_idx, int num_k, int dense_stride,
                            const double* field_gpu, const char stencil_name[50],
                            const char field_name[50], int iter) {
-  const double* field = fieldFromGpu(field_gpu, dense_stride * num_k);
+  HostField field = fieldFromGpu(field_gpu, dense_stride * num_k);
 
   dense_cells_to_csv(start_idx, end_idx, num_k, dense_stride, field, stencil_name, field_name,
                      iter);
@@ -324,7 +513,7 @@ void serialize_dense_cells(int start_idx, int end_idx, int num_k, int dense_stri
 void serialize_dense_verts(int start_idx, int end_idx, int num_k, int dense_stride,
                            const double* field_gpu, const char stencil_name[50],
                            const char field_name[50], int iter) {
-  const double* field = fieldFromGpu(field_gpu, dense_stride * num_k);
+  HostField field = fieldFromGpu(field_gpu, dense_stride * num_k);
 
   dense_verts_to_csv(start_idx, end_idx, num_k, dense_stride, field, stencil_name, field_name,
                      iter);
@@ -336,7 +525,7 @@ void serialize_dense_verts(int start_idx, int end_idx, int num_k, int dense_stri
 void serialize_dense_edges(int start_idx, int end_idx, int num_k, int dense_stride,
                            const double* field_gpu, const char stencil_name[50],
                            const char field_name[50], int iter) {
-  const double* field = fieldFromGpu(field_gpu, dense_stride * num_k);
+  HostField field = fieldFromGpu(field_gpu, dense_stride * num_k);
 
   dense_edges_to_csv(start_idx, end_idx, num_k, dense_stride, field, stencil_name, field_name,
                      iter);
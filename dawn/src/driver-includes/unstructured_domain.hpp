@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <tuple>
+#include <vector>
 
 #include "unstructured_interface.hpp"
 
@@ -31,6 +34,18 @@ public:
   void set_splitter_index(KeyType&& key, int index) {     
     subdomainToIndex_[key] = index; 
   }
+  // all splitter indices, e.g. to copy them into the domain of a stencil
+  const std::map<KeyType, int>& splitter_index_map() const { return subdomainToIndex_; }
+  // sorted and unique splitter indices of all subdomains set for a location type
+  std::vector<int> splitter_indices(::dawn::LocationType loc) const {
+    std::vector<int> indices;
+    for(const auto& keyIndex : subdomainToIndex_)
+      if(std::get<0>(keyIndex.first) == loc)
+        indices.push_back(keyIndex.second);
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    return indices;
+  }
 };
 
 } // namespace dawn
\ No newline at end of file
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include "driver-includes/benchmark.hpp"
+#include "driver-includes/field_comparison.hpp"
 #include "driver-includes/gridtools_includes.hpp"
 
 #include <array>
@@ -21,6 +23,7 @@
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <vector>
 
 namespace gridtools {
 namespace dawn {
@@ -126,27 +129,40 @@ public:
       return verified;
     }
 
-    int iLower = m_domain.iminus();
-    int iUpper = std::min(m_domain.isize() - m_domain.iplus(), idim1);
-    int jLower = m_domain.jminus();
-    int jUpper = std::min(m_domain.jsize() - m_domain.jplus(), jdim1);
-    int kLower = m_domain.kminus();
-    int kUpper = std::min(m_domain.ksize() - m_domain.kplus(), kdim1);
-    for(int i = iLower; i < iUpper; ++i) {
-      for(int j = jLower; j < jUpper; ++j) {
-        for(int k = kLower; k < kUpper; ++k) {
-          typename StorageType1::data_t value1 = storage1_v(i, j, k);
-          typename StorageType2::data_t value2 = storage2_v(i, j, k);
-          if(!compare_below_threashold(value1, value2, m_precision)) {
-            if(--max_erros >= 0) {
-              std::cerr << "( " << i << ", " << j << ", " << k << " ) : "
-                        << " " << storage1.name() << " = " << value1 << " ; "
-                        << " " << storage2.name() << " = " << value2
-                        << "  error: " << std::fabs((value1 - value2) / (value1)) << std::endl;
-            }
-            verified = false;
-          }
-        }
+    const int iLower = m_domain.iminus();
+    const int iUpper = std::min(m_domain.isize() - m_domain.iplus(), idim1);
+    const int jLower = m_domain.jminus();
+    const int jUpper = std::min(m_domain.jsize() - m_domain.jplus(), jdim1);
+    const int kLower = m_domain.kminus();
+    const int kUpper = std::min(m_domain.ksize() - m_domain.kplus(), kdim1);
+    if(iUpper > iLower && jUpper > jLower && kUpper > kLower) {
+      // the horizontal points (i, j) of the compute domain are the elements of the comparison
+      const int jSize = jUpper - jLower;
+      auto value1 = [&](int idx, int k) -> typename StorageType1::data_t {
+        return storage1_v(iLower + idx / jSize, jLower + idx % jSize, kLower + k);
+      };
+      auto value2 = [&](int idx, int k) -> typename StorageType2::data_t {
+        return storage2_v(iLower + idx / jSize, jLower + idx % jSize, kLower + k);
+      };
+      const ::dawn::field_comparison result = ::dawn::compare_fields(
+          (iUpper - iLower) * jSize, kUpper - kLower, value1, value2,
+          [&](typename StorageType1::data_t expected, typename StorageType2::data_t actual) {
+            return compare_below_threashold(expected, actual, m_precision);
+          },
+          std::vector<int>(), std::max(max_erros, 0));
+
+      for(const auto& failure : result.failures) {
+        const typename StorageType1::data_t v1 = value1(failure.idx, failure.k);
+        const typename StorageType2::data_t v2 = value2(failure.idx, failure.k);
+        std::cerr << "( " << iLower + failure.idx / jSize << ", " << jLower + failure.idx % jSize
+                  << ", " << kLower + failure.k << " ) : "
+                  << " " << storage1.name() << " = " << v1 << " ; "
+                  << " " << storage2.name() << " = " << v2
+                  << "  error: " << std::fabs((v1 - v2) / (v1)) << std::endl;
+      }
+      if(!result.verified()) {
+        result.report(std::cerr, storage1.name() + " : " + storage2.name());
+        verified = false;
       }
     }
 
@@ -184,23 +200,32 @@ public:
     }
   }
 
-  template <typename GTStencil>
-  void runBenchmarks(GTStencil& computation, int niter = 100) {
-    computation.reset_meters();
-
-    for(int i = 0; i < niter; ++i) {
-      computation.run();
-    }
-
-    double time = 0;
-    auto allStencils = computation.getStencils();
-    for(auto stencil : allStencils) {
-      time += stencil->get_time();
-    }
+  /**
+   * @brief Time `computation.run(storages...)` over `repetitions` runs after `warmup` untimed runs
+   *
+   * The memory traffic is derived from the number of non-temporary fields read and written by
+   * the computation (`s_fields_read` and `s_fields_written`, emitted by the C++ backends) and the
+   * compute domain of the verifier.
+   */
+  template <typename Computation, class... StorageTypes>
+  benchmark_result runBenchmarks(Computation& computation, int warmup, int repetitions,
+                                 StorageTypes&... storages) const {
+    benchmark_result result;
+    result.name = Computation::s_name;
+    result.compute_domain = {m_domain.isize() - m_domain.iminus() - m_domain.iplus(),
+                             m_domain.jsize() - m_domain.jminus() - m_domain.jplus(),
+                             m_domain.ksize() - m_domain.kminus() - m_domain.kplus()};
+    result.warmup = warmup;
+    result.bytes_per_run = result.points() *
+                           (Computation::s_fields_read + Computation::s_fields_written) *
+                           sizeof(::dawn::float_type);
+    set_time_statistics(result, time_repeated([&]() { computation.run(storages...); }, warmup,
+                                              repetitions));
 
     std::cout << "\033[0;33m"
               << "[  output  ] "
-              << "\033[0;0m " << computation.get_name() << " " << time << std::endl;
+              << "\033[0;0m " << result.name << " " << result.median_time << std::endl;
+    return result;
   }
 
 private:
@@ -14,16 +14,31 @@
 
 #include "toylib.hpp"
 
+#include "../driver-includes/mesh_renumbering.hpp"
 #include "../interface/toylib_interface.hpp"
 
 toylib::ToylibElement::~ToylibElement() {}
 
 namespace {
+// faces wrapping around a periodic domain are not inner faces. Decided based on the coordinates
+// (rather than the ids) of the vertices such that the check survives a renumbering of the grid
 bool inner_face(toylib::Face const& f) {
-  return (f.color() == toylib::face_color::downward && f.vertex(0).id() < f.vertex(1).id() &&
-          f.vertex(0).id() < f.vertex(2).id()) ||
-         (f.color() == toylib::face_color::upward && f.vertex(1).id() > f.vertex(0).id() &&
-          f.vertex(1).id() > f.vertex(2).id());
+  return (f.color() == toylib::face_color::downward && f.vertex(0).x() < f.vertex(1).x() &&
+          f.vertex(0).y() < f.vertex(2).y()) ||
+         (f.color() == toylib::face_color::upward && f.vertex(1).y() > f.vertex(0).y() &&
+          f.vertex(1).x() > f.vertex(2).x());
+}
+
+std::vector<int> renumber_locations(std::vector<std::vector<int>> const& adjacency,
+                                    std::vector<double> const& x, std::vector<double> const& y,
+                                    toylib::renumbering_strategy strategy) {
+  switch(strategy) {
+  case toylib::renumbering_strategy::reverse_cuthill_mckee:
+    return dawn::reverse_cuthill_mckee(adjacency);
+  case toylib::renumbering_strategy::hilbert:
+    return dawn::hilbert_order(x, y);
+  }
+  return {};
 }
 } // namespace
 
@@ -154,4 +169,109 @@ std::ostream& toVtk(std::string const& name, VertexData<double> const& v_data, G
 }
 void Vertex::add_edge(Edge& e) { edges_.push_back(&e); }
 
+void Grid::renumber(GridRenumbering const& renumbering) {
+  assert(renumbering.vertices.size() == vertices_.size());
+  assert(renumbering.faces.size() == faces_.size());
+  assert(renumbering.edges.size() == edges_.size());
+
+  auto vertices = dawn::apply_renumbering(vertices_, renumbering.vertices);
+  auto faces = dawn::apply_renumbering(faces_, renumbering.faces);
+  auto edges = dawn::apply_renumbering(edges_, renumbering.edges);
+
+  // the copied elements still point into the old storage
+  auto relink = [](auto& neighbors, auto const& old_storage, auto& new_storage,
+                   std::vector<int> const& new_index) {
+    for(auto& neighbor : neighbors)
+      neighbor = &new_storage[new_index[neighbor - old_storage.data()]];
+  };
+  for(size_t i = 0; i < vertices.size(); ++i) {
+    auto& v = vertices[i];
+    v.id_ = i;
+    relink(v.edges_, edges_, edges, renumbering.edges);
+    relink(v.faces_, faces_, faces, renumbering.faces);
+  }
+  for(size_t i = 0; i < faces.size(); ++i) {
+    auto& f = faces[i];
+    f.id_ = i;
+    relink(f.edges_, edges_, edges, renumbering.edges);
+    relink(f.vertices_, vertices_, vertices, renumbering.vertices);
+  }
+  for(size_t i = 0; i < edges.size(); ++i) {
+    auto& e = edges[i];
+    if(e.id_ != -1)
+      e.id_ = i;
+    relink(e.vertices_, vertices_, vertices, renumbering.vertices);
+    relink(e.faces_, faces_, faces, renumbering.faces);
+  }
+
+  vertices_ = std::move(vertices);
+  faces_ = std::move(faces);
+  edges_ = std::move(edges);
+  valid_edges_.clear();
+  for(auto const& e : edges_) {
+    if(e.id() != -1)
+      valid_edges_.push_back(e);
+  }
+}
+
+GridRenumbering compute_renumbering(Grid const& grid, renumbering_strategy strategy) {
+  GridRenumbering renumbering;
+
+  {
+    std::vector<std::vector<int>> adjacency;
+    std::vector<double> x, y;
+    for(auto const& v : grid.vertices()) {
+      adjacency.emplace_back();
+      for(auto const* neighbor : v.vertices())
+        adjacency.back().push_back(neighbor->id());
+      x.push_back(v.x());
+      y.push_back(v.y());
+    }
+    renumbering.vertices = renumber_locations(adjacency, x, y, strategy);
+  }
+
+  {
+    std::vector<std::vector<int>> adjacency;
+    std::vector<double> x, y;
+    for(auto const& f : grid.faces()) {
+      adjacency.emplace_back();
+      for(auto const* neighbor : f.faces())
+        adjacency.back().push_back(neighbor->id());
+      x.push_back((f.vertex(0).x() + f.vertex(1).x() + f.vertex(2).x()) / 3.);
+      y.push_back((f.vertex(0).y() + f.vertex(1).y() + f.vertex(2).y()) / 3.);
+    }
+    renumbering.faces = renumber_locations(adjacency, x, y, strategy);
+  }
+
+  {
+    // only the edges inside of the domain are renumbered, numbered densely by their position in
+    // grid.edges()
+    std::vector<int> dense_index(grid.all_edges().size(), -1);
+    for(size_t i = 0; i < grid.edges().size(); ++i)
+      dense_index[grid.edges()[i].get().id()] = i;
+
+    // edges are neighbors if they share a face
+    std::vector<std::vector<int>> adjacency(grid.edges().size());
+    for(auto const& f : grid.faces())
+      for(auto const* e : f.edges())
+        for(auto const* neighbor : f.edges())
+          if(e != neighbor)
+            adjacency[dense_index[e->id()]].push_back(dense_index[neighbor->id()]);
+    std::vector<double> x, y;
+    for(Edge const& e : grid.edges()) {
+      x.push_back((e.vertex(0).x() + e.vertex(1).x()) / 2.);
+      y.push_back((e.vertex(0).y() + e.vertex(1).y()) / 2.);
+    }
+    auto new_dense_index = renumber_locations(adjacency, x, y, strategy);
+
+    renumbering.edges.resize(grid.all_edges().size());
+    int num_outside = 0;
+    for(size_t i = 0; i < grid.all_edges().size(); ++i)
+      renumbering.edges[i] = dense_index[i] != -1 ? new_dense_index[dense_index[i]]
+                                                  : grid.edges().size() + num_outside++;
+  }
+
+  return renumbering;
+}
+
 } // namespace toylib
@@ -65,6 +65,8 @@ public:
   void add_face(Face& f) { faces_.push_back(&f); }
 
 private:
+  friend class Grid;
+
   double x_;
   double y_;
 
@@ -90,6 +92,8 @@ public:
   void add_vertex(Vertex& v) { vertices_.push_back(&v); }
 
 private:
+  friend class Grid;
+
   face_color color_;
 
   std::vector<Edge*> edges_;
@@ -120,12 +124,22 @@ public:
   }
 
 private:
+  friend class Grid;
+
   edge_color color_;
 
   std::vector<Vertex*> vertices_;
   std::vector<Face*> faces_;
 };
 
+// new index of every vertex, face and edge (including the edges outside of the domain) of a grid
+struct GridRenumbering {
+  std::vector<int> vertices;
+  std::vector<int> faces;
+  std::vector<int> edges;
+};
+enum class renumbering_strategy { reverse_cuthill_mckee, hilbert };
+
 class Grid {
 public:
   // generates a grid of right triangles, vertices are in [0,1] x [0,1]
@@ -348,6 +362,10 @@ public:
   auto nx() const { return nx_; }
   auto ny() const { return ny_; }
 
+  // moves every element to its new index, the order of the neighbors of an element is kept. Fields
+  // defined on the grid need to be permuted accordingly (see Data::renumber)
+  void renumber(GridRenumbering const& renumbering);
+
 private:
   std::vector<Face> faces_;
   std::vector<Vertex> vertices_;
@@ -380,6 +398,16 @@ public:
 
   int k_size() const { return data_.size(); }
 
+  // new_index as passed to Grid::renumber for the location type of the field
+  void renumber(std::vector<int> const& new_index) {
+    for(auto& level : data_) {
+      std::vector<T> renumbered(level.size());
+      for(size_t i = 0; i < level.size(); ++i)
+        renumbered[new_index[i]] = level[i];
+      level = std::move(renumbered);
+    }
+  }
+
 private:
   std::vector<std::vector<T>> data_;
 };
@@ -432,6 +460,16 @@ public:
   }
   int k_size() const { return data_.size(); }
 
+  // new_index as passed to Grid::renumber for the dense location type of the field
+  void renumber(std::vector<int> const& new_index) {
+    for(auto& level : data_) {
+      std::vector<std::vector<T>> renumbered(level.size());
+      for(size_t i = 0; i < level.size(); ++i)
+        renumbered[new_index[i]] = std::move(level[i]);
+      level = std::move(renumbered);
+    }
+  }
+
 private:
   std::vector<std::vector<std::vector<T>>> data_;
   size_t dense_size_;
@@ -457,6 +495,10 @@ public:
       : SparseData<Edge, T>(k_size, grid.all_edges().size(), sparse_size) {}
 };
 
+// renumbering of all elements of the grid improving the locality of neighbor accesses, edges
+// outside of the domain are moved to the end
+GridRenumbering compute_renumbering(Grid const& grid, renumbering_strategy strategy);
+
 std::ostream& toVtk(Grid const& grid, int k_size, std::ostream& os = std::cout);
 std::ostream& toVtk(std::string const& name, FaceData<double> const& f_data, Grid const& grid,
                     std::ostream& os = std::cout);
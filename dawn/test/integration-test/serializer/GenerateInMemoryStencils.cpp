@@ -360,3 +360,26 @@ std::shared_ptr<dawn::iir::StencilInstantiation> createUnstructuredMixedCopies()
                                              b.stmt(b.assignExpr(b.at(out_e), b.at(in_e))))))));
   return stencilInstantiation;
 }
+
+std::shared_ptr<dawn::iir::StencilInstantiation> createStageChainIIRInMemory(int numStages,
+                                                                             int numTerms) {
+  using namespace dawn::iir;
+  CartesianIIRBuilder b;
+
+  std::vector fields{b.field("f0", FieldType::ijk)};
+  for(int i = 1; i <= numStages; ++i)
+    fields.push_back(b.field("f" + std::to_string(i), FieldType::ijk));
+
+  const std::array<std::array<int, 3>, 4> offsets{{{1, 0, 0}, {0, -1, 0}, {-1, 0, 0}, {0, 1, 0}}};
+  auto multiStage = b.multistage(LoopOrderKind::Parallel);
+  for(int i = 0; i < numStages; ++i) {
+    auto sum = b.at(fields[i], offsets[0]);
+    for(int term = 1; term < numTerms; ++term)
+      sum = b.binaryExpr(std::move(sum), b.at(fields[i], offsets[term % offsets.size()]));
+    multiStage->insertChild(
+        b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                           b.stmt(b.assignExpr(b.at(fields[i + 1], AccessType::rw),
+                                               std::move(sum))))));
+  }
+  return b.build("stage_chain", b.stencil(std::move(multiStage)));
+}
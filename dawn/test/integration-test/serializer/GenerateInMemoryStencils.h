@@ -29,4 +29,10 @@ std::shared_ptr<dawn::iir::StencilInstantiation> createUnstructuredSumEdgeToCell
 
 std::shared_ptr<dawn::iir::StencilInstantiation> createUnstructuredMixedCopies();
 
+/// @brief Synthetic stencil of `numStages` stages, each computing a field from the sum of
+/// `numTerms` neighbors of the field computed by the previous stage (used to measure serialization
+/// of large IIRs)
+std::shared_ptr<dawn::iir::StencilInstantiation> createStageChainIIRInMemory(int numStages,
+                                                                             int numTerms = 2);
+
 #endif
@@ -0,0 +1,171 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+//
+//  Measures time and peak memory of writing and reading large IIR files, once through a string
+//  holding the whole file (`serializeToString` / `deserializeFromString`) and once with the file
+//  functions of the IIRSerializer, which stream the output and memory map the input. In both cases
+//  large JSON messages are printed piecewise (see `writeProtoAsJson`).
+//
+//  Usage: DawnIIRFileIOBenchmark [num_stages=2000] [num_terms=64] [repetitions=3] [file]
+//
+//  The IIR is a synthetic stencil of `num_stages` stages, each computing a field from the sum of
+//  `num_terms` neighbors of the field computed by the previous stage. Every measurement runs in a
+//  forked process and reports the increase of its peak resident set size over its resident set
+//  size at the start.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "GenerateInMemoryStencils.h"
+
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Serialization/IIRSerializer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Measurement {
+  double time = 0.;     ///< Wall time [s]
+  long peakRSSIncr = 0; ///< Increase of the peak resident set size [kB]
+};
+
+long currentRSS() {
+#ifdef __linux__
+  long pages = 0, residentPages = 0;
+  if(FILE* statm = std::fopen("/proc/self/statm", "r")) {
+    if(std::fscanf(statm, "%ld %ld", &pages, &residentPages) != 2)
+      residentPages = 0;
+    std::fclose(statm);
+  }
+  return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+  return 0;
+#endif
+}
+
+/// @brief Run `op` in a forked process, such that its peak memory is not hidden by the ones of
+/// previous measurements
+Measurement measure(const std::function<void()>& op) {
+  int fds[2];
+  if(pipe(fds) != 0)
+    std::exit(1);
+
+  const pid_t pid = fork();
+  if(pid == 0) {
+    close(fds[0]);
+    Measurement result;
+    const long startRSS = currentRSS();
+    const auto start = std::chrono::steady_clock::now();
+    op();
+    result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.peakRSSIncr = usage.ru_maxrss - startRSS;
+    const bool success = write(fds[1], &result, sizeof(result)) == sizeof(result);
+    _exit(success ? 0 : 1);
+  }
+
+  close(fds[1]);
+  Measurement result;
+  const bool success = read(fds[0], &result, sizeof(result)) == sizeof(result);
+  close(fds[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  if(!success || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    std::printf("ERROR: measurement failed\n");
+    std::exit(1);
+  }
+  return result;
+}
+
+/// @brief Median time and maximal peak memory of `repetitions` measurements of `op`
+Measurement measure(const std::function<void()>& op, int repetitions) {
+  std::vector<Measurement> measurements;
+  for(int i = 0; i < repetitions; ++i)
+    measurements.push_back(measure(op));
+  std::sort(measurements.begin(), measurements.end(),
+            [](const Measurement& lhs, const Measurement& rhs) { return lhs.time < rhs.time; });
+  Measurement result = measurements[measurements.size() / 2];
+  for(const auto& measurement : measurements)
+    result.peakRSSIncr = std::max(result.peakRSSIncr, measurement.peakRSSIncr);
+  return result;
+}
+
+void print(const char* format, const char* operation, const Measurement& viaString,
+           const Measurement& direct) {
+  std::printf("%-6s %-6s %12.3f %12.3f %10.2fx %14ld %14ld\n", format, operation, viaString.time,
+              direct.time, viaString.time / direct.time, viaString.peakRSSIncr / 1024,
+              direct.peakRSSIncr / 1024);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const int numStages = argc > 1 ? std::atoi(argv[1]) : 2000;
+  const int numTerms = argc > 2 ? std::atoi(argv[2]) : 64;
+  const int repetitions = argc > 3 ? std::atoi(argv[3]) : 3;
+  const std::string file = argc > 4 ? argv[4] : "iir_file_io_benchmark.iir";
+
+  auto instantiation = createStageChainIIRInMemory(numStages, numTerms);
+
+  std::printf("stage chain of %d stages with %d terms, median of %d runs\n", numStages, numTerms,
+              repetitions);
+  std::printf("%-6s %-6s %12s %12s %11s %14s %14s\n", "format", "op", "string [s]", "file [s]",
+              "speedup", "string [MB]", "file [MB]");
+
+  for(auto format : {dawn::IIRSerializer::Format::Json, dawn::IIRSerializer::Format::Byte}) {
+    const char* formatName = format == dawn::IIRSerializer::Format::Json ? "json" : "byte";
+
+    auto writeViaString = measure(
+        [&]() {
+          std::ofstream ofs(file, std::ios::binary);
+          const std::string str = dawn::IIRSerializer::serializeToString(instantiation, format);
+          ofs.write(str.data(), str.size());
+        },
+        repetitions);
+    auto writeFile = measure(
+        [&]() { dawn::IIRSerializer::serialize(file, instantiation, format); }, repetitions);
+    print(formatName, "write", writeViaString, writeFile);
+
+    std::ifstream ifs(file, std::ios::binary | std::ios::ate);
+    std::printf("%-6s %-6s %ld MB\n", formatName, "size", long(ifs.tellg()) / (1024 * 1024));
+
+    auto readViaString = measure(
+        [&]() {
+          std::ifstream ifs(file, std::ios::binary);
+          const std::string str((std::istreambuf_iterator<char>(ifs)),
+                                std::istreambuf_iterator<char>());
+          dawn::IIRSerializer::deserializeFromString(str, format);
+        },
+        repetitions);
+    auto readFile = measure([&]() { dawn::IIRSerializer::deserialize(file, format); }, repetitions);
+    print(formatName, "read", readViaString, readFile);
+  }
+  std::remove(file.c_str());
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+//
+//  Measures the time to load serialized IIRs with and without the stored derived information
+//  (written with `-write-iir-derived-info`), in which case the derived information is restored
+//  instead of being recomputed.
+//
+//  Usage: DawnIIRLoadBenchmark [repetitions=20] [num_stages=200] [IIR files (JSON)...]
+//
+//  Besides the given files (by default the reference IIRs of the serializer tests) a synthetic
+//  stencil of `num_stages` stages is loaded, each stage computing a field from the neighbors of the
+//  field computed by the previous stage. The derived information restored from the file is
+//  verified to be identical to the recomputed one.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "GenerateInMemoryStencils.h"
+
+#include "dawn/IIR/IIR/IIR.pb.h"
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Serialization/IIRSerializer.h"
+#include "driver-includes/benchmark.hpp"
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+bool equalDerivedInfo(const std::shared_ptr<dawn::iir::StencilInstantiation>& lhs,
+                      const std::shared_ptr<dawn::iir::StencilInstantiation>& rhs) {
+  auto toProto = [](const std::shared_ptr<dawn::iir::StencilInstantiation>& instantiation) {
+    dawn::proto::iir::StencilInstantiation protoInstantiation;
+    protoInstantiation.ParseFromString(dawn::IIRSerializer::serializeToString(
+        instantiation, dawn::IIRSerializer::Format::Byte, true));
+    // the stage names are only restored from the derived information, never recomputed
+    protoInstantiation.mutable_derivedinfo()->clear_stageidtoname();
+    return protoInstantiation;
+  };
+  return google::protobuf::util::MessageDifferencer::Equals(toProto(lhs), toProto(rhs));
+}
+
+double medianLoadTime(const std::string& str, dawn::IIRSerializer::Format format,
+                      int repetitions) {
+  gridtools::dawn::benchmark_result timings;
+  gridtools::dawn::set_time_statistics(
+      timings, gridtools::dawn::time_repeated(
+                   [&]() { dawn::IIRSerializer::deserializeFromString(str, format); }, 1,
+                   repetitions));
+  return timings.median_time;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const int repetitions = argc > 1 ? std::atoi(argv[1]) : 20;
+  const int numStages = argc > 2 ? std::atoi(argv[2]) : 200;
+
+  std::vector<std::string> files(argv + std::min(argc, 3), argv + argc);
+  if(files.empty())
+    files = {"reference_iir/copy_stencil.iir", "reference_iir/lap_stencil.iir",
+             "reference_iir/unstructured_sum_edge_to_cells.iir",
+             "reference_iir/unstructured_mixed_copies.iir"};
+
+  std::vector<std::pair<std::string, std::shared_ptr<dawn::iir::StencilInstantiation>>>
+      instantiations;
+  for(const auto& file : files)
+    instantiations.emplace_back(file, dawn::IIRSerializer::deserialize(file));
+  instantiations.emplace_back("stage chain (" + std::to_string(numStages) + " stages)",
+                              createStageChainIIRInMemory(numStages));
+  // compute the stage extents as done by the optimizer
+  instantiations.back().second->computeDerivedInfo();
+
+  std::printf("median of %d loads\n", repetitions);
+  std::printf("%-52s %6s %16s %16s %9s\n", "IIR", "format", "recompute [s]", "restore [s]",
+              "speedup");
+
+  int status = 0;
+  for(const auto& [name, instantiation] : instantiations) {
+
+    for(auto format : {dawn::IIRSerializer::Format::Json, dawn::IIRSerializer::Format::Byte}) {
+      const std::string withoutDerivedInfo =
+          dawn::IIRSerializer::serializeToString(instantiation, format);
+      const std::string withDerivedInfo =
+          dawn::IIRSerializer::serializeToString(instantiation, format, true);
+
+      // Both ways of loading must yield the same derived information
+      auto recomputed = dawn::IIRSerializer::deserializeFromString(withoutDerivedInfo, format);
+      auto restored = dawn::IIRSerializer::deserializeFromString(withDerivedInfo, format);
+      if(!equalDerivedInfo(recomputed, restored)) {
+        std::printf("ERROR: restored derived information of %s differs from the recomputed one\n",
+                    name.c_str());
+        status = 1;
+      }
+
+      const double recomputeTime = medianLoadTime(withoutDerivedInfo, format, repetitions);
+      const double restoreTime = medianLoadTime(withDerivedInfo, format, repetitions);
+      std::printf("%-52s %6s %16.3e %16.3e %8.2fx\n", name.c_str(),
+                  format == dawn::IIRSerializer::Format::Json ? "json" : "byte", recomputeTime,
+                  restoreTime, recomputeTime / restoreTime);
+    }
+  }
+  return status;
+}
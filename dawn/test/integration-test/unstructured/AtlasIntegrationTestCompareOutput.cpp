@@ -296,6 +296,43 @@ TEST(AtlasIntegrationTestCompareOutput, Diffusion) {
 }
 } // namespace
 
+namespace {
+#include <generated_diffusionKBlocked.hpp>
+TEST(AtlasIntegrationTestCompareOutput, DiffusionKBlocked) {
+  auto mesh = generateQuadMesh(32, 32);
+  // blocks of 3 levels, the last one is incomplete
+  const int nb_levels = 7;
+
+  auto [in_ref, in_v_ref] = makeAtlasField("in_v_ref", mesh.cells().size(), nb_levels);
+  auto [in_gen, in_v_gen] = makeAtlasField("in_v_gen", mesh.cells().size(), nb_levels);
+  auto [out_ref, out_v_ref] = makeAtlasField("out_v_ref", mesh.cells().size(), nb_levels);
+  auto [out_gen, out_v_gen] = makeAtlasField("out_v_gen", mesh.cells().size(), nb_levels);
+
+  AtlasToCartesian atlasToCartesianMapper(mesh);
+
+  for(int cellIdx = 0, size = mesh.cells().size(); cellIdx < size; ++cellIdx) {
+    auto [cartX, cartY] = atlasToCartesianMapper.cellMidpoint(mesh, cellIdx);
+    for(int level = 0; level < nb_levels; ++level) {
+      in_v_ref(cellIdx, level) = cartX * (level + 1) + cartY;
+      in_v_gen(cellIdx, level) = cartX * (level + 1) + cartY;
+    }
+  }
+
+  dawn_generated::cxxnaiveico::reference_diffusion<atlasInterface::atlasTag>(mesh, nb_levels,
+                                                                             in_v_ref, out_v_ref)
+      .run();
+  dawn_generated::cxxnaiveico::diffusionKBlocked<atlasInterface::atlasTag>(mesh, nb_levels,
+                                                                           in_v_gen, out_v_gen)
+      .run();
+
+  auto out_v_ref_view = atlas::array::make_view<double, 2>(out_ref);
+  auto out_v_gen_view = atlas::array::make_view<double, 2>(out_gen);
+  UnstructuredVerifier v;
+  EXPECT_TRUE(v.compareArrayView(out_v_gen_view, out_v_ref_view))
+      << "while comparing output (on cells)";
+}
+} // namespace
+
 namespace {
 #include <generated_diamond.hpp>
 #include <reference_diamond.hpp>
@@ -533,6 +570,50 @@ TEST(AtlasIntegrationTestCompareOutput, Gradient) {
 }
 } // namespace
 
+namespace {
+#include <generated_gradientKBlocked.hpp>
+TEST(AtlasIntegrationTestCompareOutput, GradientKBlocked) {
+  // the gradient of the Gradient test, scaled differently on each level
+  const int numCell = 10;
+  auto mesh = generateQuadMesh(numCell, numCell + 1);
+
+  AtlasToCartesian atlasToCartesianMapper(mesh);
+  build_periodic_edges(mesh, numCell, numCell, atlasToCartesianMapper);
+
+  // blocks of 3 levels, the last one is incomplete
+  const int nb_levels = 7;
+
+  auto [ref_cells, ref_cells_v] = makeAtlasField("ref_cells", mesh.cells().size(), nb_levels);
+  auto [ref_edges, ref_edges_v] = makeAtlasField("ref_edges", mesh.edges().size(), nb_levels);
+  auto [gen_cells, gen_cells_v] = makeAtlasField("gen_cells", mesh.cells().size(), nb_levels);
+  auto [gen_edges, gen_edges_v] = makeAtlasField("gen_edges", mesh.edges().size(), nb_levels);
+
+  for(int cellIdx = 0, size = mesh.cells().size(); cellIdx < size; ++cellIdx) {
+    auto [cartX, cartY] = atlasToCartesianMapper.cellMidpoint(mesh, cellIdx);
+    for(int level = 0; level < nb_levels; ++level) {
+      double val = (level + 1) * sin(cartX * M_PI) * sin(cartY * M_PI);
+      ref_cells_v(cellIdx, level) = val;
+      gen_cells_v(cellIdx, level) = val;
+    }
+  }
+
+  dawn_generated::cxxnaiveico::reference_gradient<atlasInterface::atlasTag>(
+      mesh, nb_levels, ref_cells_v, ref_edges_v)
+      .run();
+  dawn_generated::cxxnaiveico::gradientKBlocked<atlasInterface::atlasTag>(
+      mesh, nb_levels, gen_cells_v, gen_edges_v)
+      .run();
+
+  {
+    auto ref_cells_v = atlas::array::make_view<double, 2>(ref_cells);
+    auto gen_cells_v = atlas::array::make_view<double, 2>(gen_cells);
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareArrayView(ref_cells_v, gen_cells_v))
+        << "while comparing output (on cells)";
+  }
+}
+} // namespace
+
 namespace {
 #include <generated_tridiagonalSolve.hpp>
 TEST(AtlasIntegrationTestCompareOutput, verticalSolver) {
@@ -1160,6 +1241,36 @@ TEST(AtlasIntegrationTestCompareOutput, sparseTempFieldAllocation) {
 }
 } // namespace
 
+namespace {
+#include <generated_mergeTempFields.hpp>
+TEST(AtlasIntegrationTestCompareOutput, mergeTempFields) {
+  auto mesh = generateEquilatMesh(10, 10);
+  size_t nb_levels = 10;
+
+  auto [in_F, in_v] = makeAtlasField("in", mesh.cells().size(), nb_levels);
+  auto [out_a_F, out_a_v] = makeAtlasField("out_a", mesh.cells().size(), nb_levels);
+  auto [out_b_F, out_b_v] = makeAtlasField("out_b", mesh.cells().size(), nb_levels);
+
+  // Initialize fields with data
+  initField(in_v, mesh.cells().size(), nb_levels, 1.0);
+  initField(out_a_v, mesh.cells().size(), nb_levels, -1.0);
+  initField(out_b_v, mesh.cells().size(), nb_levels, -1.0);
+
+  // Run the stencil
+  auto stencil = dawn_generated::cxxnaiveico::mergeTempFields<atlasInterface::atlasTag>(
+      mesh, static_cast<int>(nb_levels), in_v, out_a_v, out_b_v);
+  stencil.run();
+
+  // Check correctness of the output
+  for(int k = 0; k < nb_levels; k++) {
+    for(int cell_idx = 0; cell_idx < mesh.cells().size(); ++cell_idx) {
+      ASSERT_EQ(out_a_v(cell_idx, k), 7.);
+      ASSERT_EQ(out_b_v(cell_idx, k), 3.);
+    }
+  }
+}
+} // namespace
+
 namespace {
 #include <generated_reductionInIfConditional.hpp>
 TEST(AtlasIntegrationTestCompareOutput, reductionInConditional) {
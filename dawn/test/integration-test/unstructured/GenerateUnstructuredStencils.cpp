@@ -21,7 +21,9 @@
 #include "dawn/Optimizer/Lowering.h"
 #include "dawn/Optimizer/PassFieldVersioning.h"
 #include "dawn/Optimizer/PassFixVersionedInputFields.h"
+#include "dawn/Optimizer/PassSetDependencyGraph.h"
 #include "dawn/Optimizer/PassSetStageLocationType.h"
+#include "dawn/Optimizer/PassTemporaryMerger.h"
 #include "dawn/Support/Assert.h"
 #include "dawn/Unittest/IIRBuilder.h"
 
@@ -1130,5 +1132,234 @@ int main() {
     of << dawn::codegen::generate(tu) << std::endl;
   }
 
+  {
+    using namespace dawn::iir;
+    using LocType = dawn::ast::LocationType;
+
+    UnstructuredIIRBuilder b;
+    auto in_f = b.field("in_field", LocType::Cells);
+    auto out_a_f = b.field("out_a_field", LocType::Cells);
+    auto out_b_f = b.field("out_b_field", LocType::Cells);
+    auto tmp_s_f = b.tmpField("tmp_s", {LocType::Cells, LocType::Edges});
+    auto tmp_a_f = b.tmpField("tmp_a", LocType::Cells);
+    auto tmp_e_f = b.tmpField("tmp_e", LocType::Edges);
+    auto tmp_b_f = b.tmpField("tmp_b", LocType::Cells);
+    std::string stencilName = "mergeTempFields";
+
+    auto stencilInstantiation = b.build(
+        stencilName,
+        b.stencil(b.multistage(
+            LoopOrderKind::Parallel,
+            b.stage(LocType::Cells,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.loopStmtChain(b.stmt(b.assignExpr(b.at(tmp_s_f), b.lit(2.))),
+                                               {LocType::Cells, LocType::Edges}))),
+            b.stage(LocType::Cells,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.stmt(b.assignExpr(
+                                   b.at(tmp_a_f),
+                                   b.reduceOverNeighborExpr(
+                                       Op::plus,
+                                       b.binaryExpr(b.at(tmp_s_f), b.at(in_f), Op::multiply),
+                                       b.lit(0.), {LocType::Cells, LocType::Edges}))))),
+            b.stage(LocType::Cells,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.stmt(b.assignExpr(b.at(out_a_f),
+                                                   b.binaryExpr(b.at(tmp_a_f), b.lit(1.)))))),
+            b.stage(LocType::Edges,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.stmt(b.assignExpr(b.at(tmp_e_f), b.lit(1.))))),
+            b.stage(LocType::Cells,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.stmt(b.assignExpr(
+                                   b.at(tmp_b_f),
+                                   b.reduceOverNeighborExpr(Op::plus, b.at(tmp_e_f), b.lit(0.),
+                                                            {LocType::Cells, LocType::Edges}))))),
+            b.stage(LocType::Cells,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.stmt(b.assignExpr(b.at(out_b_f), b.at(tmp_b_f))))))));
+
+    // tmp_b shares the storage of tmp_a, tmp_e and tmp_s have other dimensions
+    dawn::PassSetDependencyGraph passSetDependencyGraph;
+    passSetDependencyGraph.run(stencilInstantiation);
+    dawn::PassTemporaryMerger passTemporaryMerger;
+    passTemporaryMerger.run(stencilInstantiation);
+
+    std::ofstream of("generated/generated_" + stencilName + ".hpp");
+    DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
+    auto tu = dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco);
+    of << dawn::codegen::generate(tu) << std::endl;
+  }
+
+  {
+    // the diffusion stencil, each thread computes blocks of 3 levels
+    using namespace dawn::iir;
+    using LocType = dawn::ast::LocationType;
+
+    UnstructuredIIRBuilder b;
+    auto in_f = b.field("in_field", LocType::Cells);
+    auto out_f = b.field("out_field", LocType::Cells);
+    auto cnt = b.localvar("cnt", dawn::BuiltinTypeID::Integer, {}, LocalVariableType::OnCells);
+
+    std::string stencilName = "diffusionKBlocked";
+
+    auto stencilInstantiation = b.build(
+        stencilName,
+        b.stencil(b.multistage(
+            dawn::iir::LoopOrderKind::Parallel,
+            b.stage(
+                LocType::Cells,
+                b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End, b.declareVar(cnt),
+                           b.stmt(b.assignExpr(
+                               b.at(cnt), b.reduceOverNeighborExpr(Op::plus, b.lit(1), b.lit(0),
+                                                                   {LocType::Cells, LocType::Edges,
+                                                                    LocType::Cells}))),
+                           b.stmt(b.assignExpr(
+                               b.at(out_f),
+                               b.reduceOverNeighborExpr(
+                                   Op::plus, b.at(in_f, HOffsetType::withOffset, 0),
+                                   b.binaryExpr(b.unaryExpr(b.at(cnt), Op::minus),
+                                                b.at(in_f, HOffsetType::noOffset, 0), Op::multiply),
+                                   {LocType::Cells, LocType::Edges, LocType::Cells}))),
+                           b.stmt(b.assignExpr(
+                               b.at(out_f),
+                               b.binaryExpr(b.at(in_f),
+                                            b.binaryExpr(b.lit(0.1), b.at(out_f), Op::multiply),
+                                            Op::plus))))))));
+
+    std::ofstream of("generated/generated_" + stencilName + ".hpp");
+    DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
+    dawn::codegen::Options options;
+    options.LevelsPerThread = 3;
+    auto tu =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    of << dawn::codegen::generate(tu) << std::endl;
+  }
+
+  {
+    // the gradient stencil, each thread computes blocks of 3 levels
+    using namespace dawn::iir;
+    using LocType = dawn::ast::LocationType;
+
+    UnstructuredIIRBuilder b;
+    auto cell_f = b.field("cell_field", LocType::Cells);
+    auto edge_f = b.field("edge_field", LocType::Edges);
+
+    std::string stencilName = "gradientKBlocked";
+
+    auto stencilInstantiation = b.build(
+        stencilName,
+        b.stencil(b.multistage(
+            dawn::iir::LoopOrderKind::Parallel,
+            b.stage(
+                LocType::Edges,
+                b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                           b.stmt(b.assignExpr(
+                               b.at(edge_f), b.reduceOverNeighborExpr<float>(
+                                                 Op::plus, b.at(cell_f, HOffsetType::withOffset, 0),
+                                                 b.lit(0.), {LocType::Edges, LocType::Cells},
+                                                 std::vector<float>({1., -1.})))))),
+            b.stage(
+                LocType::Cells,
+                b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                           b.stmt(b.assignExpr(
+                               b.at(cell_f), b.reduceOverNeighborExpr<float>(
+                                                 Op::plus, b.at(edge_f, HOffsetType::withOffset, 0),
+                                                 b.lit(0.), {LocType::Cells, LocType::Edges},
+                                                 std::vector<float>({0.5, 0., 0., 0.5})))))))));
+
+    std::ofstream of("generated/generated_" + stencilName + ".hpp");
+    DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
+    dawn::codegen::Options options;
+    options.LevelsPerThread = 3;
+    auto tu =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    of << dawn::codegen::generate(tu) << std::endl;
+  }
+
+  {
+    // the diffusion stencil indexing flat neighbor tables, boundary cells of toylib have missing
+    // neighbors, which are skipped with AtlasCompatible
+    using namespace dawn::iir;
+    using LocType = dawn::ast::LocationType;
+
+    UnstructuredIIRBuilder b;
+    auto in_f = b.field("in_field", LocType::Cells);
+    auto out_f = b.field("out_field", LocType::Cells);
+    auto cnt = b.localvar("cnt", dawn::BuiltinTypeID::Integer, {}, LocalVariableType::OnCells);
+
+    std::string stencilName = "diffusionFlat";
+
+    auto stencilInstantiation = b.build(
+        stencilName,
+        b.stencil(b.multistage(
+            dawn::iir::LoopOrderKind::Parallel,
+            b.stage(
+                LocType::Cells,
+                b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End, b.declareVar(cnt),
+                           b.stmt(b.assignExpr(
+                               b.at(cnt), b.reduceOverNeighborExpr(Op::plus, b.lit(1), b.lit(0),
+                                                                   {LocType::Cells, LocType::Edges,
+                                                                    LocType::Cells}))),
+                           b.stmt(b.assignExpr(
+                               b.at(out_f),
+                               b.reduceOverNeighborExpr(
+                                   Op::plus, b.at(in_f, HOffsetType::withOffset, 0),
+                                   b.binaryExpr(b.unaryExpr(b.at(cnt), Op::minus),
+                                                b.at(in_f, HOffsetType::noOffset, 0), Op::multiply),
+                                   {LocType::Cells, LocType::Edges, LocType::Cells}))),
+                           b.stmt(b.assignExpr(
+                               b.at(out_f),
+                               b.binaryExpr(b.at(in_f),
+                                            b.binaryExpr(b.lit(0.1), b.at(out_f), Op::multiply),
+                                            Op::plus))))))));
+
+    std::ofstream of("generated/generated_" + stencilName + ".hpp");
+    DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
+    dawn::codegen::Options options;
+    options.FlatNeighborTables = true;
+    options.AtlasCompatible = true;
+    auto tu =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    of << dawn::codegen::generate(tu) << std::endl;
+  }
+
+  {
+    // the sparseDimension stencil indexing flat neighbor tables
+    using namespace dawn::iir;
+    using LocType = dawn::ast::LocationType;
+
+    UnstructuredIIRBuilder b;
+    auto cell_f = b.field("cell_field", LocType::Cells);
+    auto edge_f = b.field("edge_field", LocType::Edges);
+    auto sparse_f = b.field("sparse_dim", {LocType::Cells, LocType::Edges});
+
+    std::string stencilName = "sparseDimensionFlat";
+
+    auto stencilInstantiation = b.build(
+        stencilName,
+        b.stencil(b.multistage(
+            dawn::iir::LoopOrderKind::Parallel,
+            b.stage(LocType::Cells,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.stmt(b.assignExpr(
+                                   b.at(cell_f),
+                                   b.reduceOverNeighborExpr<float>(
+                                       Op::plus,
+                                       b.binaryExpr(b.at(edge_f, HOffsetType::withOffset, 0),
+                                                    b.at(sparse_f, HOffsetType::withOffset, 0),
+                                                    Op::multiply),
+                                       b.lit(0.), {LocType::Cells, LocType::Edges},
+                                       std::vector<float>({1., 1., 1., 1})))))))));
+
+    std::ofstream of("generated/generated_" + stencilName + ".hpp");
+    DAWN_ASSERT_MSG(of, "couldn't open output file!\n");
+    dawn::codegen::Options options;
+    options.FlatNeighborTables = true;
+    auto tu =
+        dawn::codegen::run(stencilInstantiation, dawn::codegen::Backend::CXXNaiveIco, options);
+    of << dawn::codegen::generate(tu) << std::endl;
+  }
+
   return 0;
 }
\ No newline at end of file
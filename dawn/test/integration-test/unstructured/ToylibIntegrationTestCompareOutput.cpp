@@ -21,6 +21,7 @@
 //
 //===------------------------------------------------------------------------------------------===//
 
+#include "driver-includes/cpu_mesh.hpp"
 #include "driver-includes/unstructured_domain.hpp"
 #include "driver-includes/unstructured_interface.hpp"
 
@@ -57,6 +58,43 @@ std::tuple<double, double> cellMidpoint(const toylib::Face& f) {
   return {x / 3., y / 3.};
 }
 
+// Flat neighbor tables and fields are indexed by the ids of the toylib elements. Edge ids range
+// over all_edges(), which includes the edges outside of the domain.
+dawn::GlobalCpuTriMesh makeCpuMesh(const toylib::Grid& mesh) {
+  dawn::GlobalCpuTriMesh cpuMesh;
+  cpuMesh.NumCells = cpuMesh.CellStride = mesh.faces().size();
+  cpuMesh.NumEdges = cpuMesh.EdgeStride = mesh.all_edges().size();
+  cpuMesh.NumVertices = cpuMesh.VertexStride = mesh.vertices().size();
+  return cpuMesh;
+}
+
+// Flat neighbor table of a chain (see dawn::GlobalCpuTriMesh)
+std::vector<int> makeFlatNbhTable(const toylib::Grid& mesh, const dawn::GlobalCpuTriMesh& cpuMesh,
+                                  const std::vector<dawn::LocationType>& chain,
+                                  int numNbhPerElement) {
+  using toylibInterface::toylibTag;
+  std::vector<const toylib::ToylibElement*> elements;
+  switch(chain.front()) {
+  case dawn::LocationType::Cells:
+    elements = toylibInterface::getCells(toylibTag{}, mesh);
+    break;
+  case dawn::LocationType::Edges:
+    elements = toylibInterface::getEdges(toylibTag{}, mesh);
+    break;
+  case dawn::LocationType::Vertices:
+    elements = toylibInterface::getVertices(toylibTag{}, mesh);
+    break;
+  }
+  const int stride = cpuMesh.stride(chain.front());
+  std::vector<int> table(stride * numNbhPerElement, DEVICE_MISSING_VALUE);
+  for(const auto* elem : elements) {
+    auto neighbors = toylibInterface::getNeighbors(toylibTag{}, mesh, chain, elem);
+    for(size_t nbh = 0; nbh < neighbors.size(); ++nbh)
+      table[elem->id() + nbh * stride] = neighbors[nbh]->id();
+  }
+  return table;
+}
+
 namespace {
 #include <generated_copyCell.hpp>
 TEST(ToylibIntegrationTestCompareOutput, CopyCell) {
@@ -231,6 +269,125 @@ TEST(ToylibIntegrationTestCompareOutput, Gradient) {
 }
 } // namespace
 
+namespace {
+#include <generated_diffusionKBlocked.hpp>
+TEST(ToylibIntegrationTestCompareOutput, DiffusionKBlocked) {
+  toylib::Grid mesh(32, 32, false, 1., 1.);
+  // blocks of 3 levels, the last one is incomplete
+  const int nb_levels = 7;
+
+  toylib::FaceData<double> in_ref(mesh, nb_levels);
+  toylib::FaceData<double> out_ref(mesh, nb_levels);
+  toylib::FaceData<double> in_gen(mesh, nb_levels);
+  toylib::FaceData<double> out_gen(mesh, nb_levels);
+
+  for(const auto& cell : mesh.faces()) {
+    auto [x, y] = cellMidpoint(cell);
+    for(int level = 0; level < nb_levels; ++level) {
+      in_ref(cell, level) = x * (level + 1) + y;
+      in_gen(cell, level) = x * (level + 1) + y;
+    }
+  }
+
+  dawn_generated::cxxnaiveico::reference_diffusion<toylibInterface::toylibTag>(mesh, nb_levels,
+                                                                               in_ref, out_ref)
+      .run();
+  dawn_generated::cxxnaiveico::diffusionKBlocked<toylibInterface::toylibTag>(mesh, nb_levels,
+                                                                             in_gen, out_gen)
+      .run();
+
+  {
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(mesh.faces(), out_ref, out_gen, nb_levels))
+        << "while comparing output (on cells)";
+  }
+}
+} // namespace
+
+namespace {
+#include <generated_gradientKBlocked.hpp>
+TEST(ToylibIntegrationTestCompareOutput, GradientKBlocked) {
+  // the gradient of the Gradient test, scaled differently on each level
+  const int numCell = 10;
+  auto mesh = toylib::Grid(numCell, numCell, false, M_PI, M_PI);
+  // blocks of 3 levels, the last one is incomplete
+  const int nb_levels = 7;
+
+  toylib::FaceData<double> ref_cells(mesh, nb_levels);
+  toylib::EdgeData<double> ref_edges(mesh, nb_levels);
+  toylib::FaceData<double> gen_cells(mesh, nb_levels);
+  toylib::EdgeData<double> gen_edges(mesh, nb_levels);
+
+  for(const auto& f : mesh.faces()) {
+    auto [x, y] = cellMidpoint(f);
+    for(int level = 0; level < nb_levels; ++level) {
+      double val = (level + 1) * sin(x) * sin(y);
+      ref_cells(f, level) = val;
+      gen_cells(f, level) = val;
+    }
+  }
+
+  dawn_generated::cxxnaiveico::gradientKBlocked<toylibInterface::toylibTag>(
+      mesh, nb_levels, gen_cells, gen_edges)
+      .run();
+  dawn_generated::cxxnaiveico::reference_gradient<toylibInterface::toylibTag>(
+      mesh, nb_levels, ref_cells, ref_edges)
+      .run();
+
+  {
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(mesh.faces(), ref_cells, gen_cells, nb_levels))
+        << "while comparing output (on cells)";
+  }
+}
+} // namespace
+
+namespace {
+#include <generated_diffusionFlat.hpp>
+TEST(ToylibIntegrationTestCompareOutput, DiffusionFlatNeighborTables) {
+  toylib::Grid mesh(32, 32, false, 1., 1.);
+  const int nb_levels = 2;
+  const std::vector<dawn::LocationType> cec{dawn::LocationType::Cells, dawn::LocationType::Edges,
+                                            dawn::LocationType::Cells};
+
+  // boundary cells have only two neighbors, the table is padded
+  dawn::GlobalCpuTriMesh cpuMesh = makeCpuMesh(mesh);
+  std::vector<int> cecTable = makeFlatNbhTable(mesh, cpuMesh, cec, 3);
+  cpuMesh.NeighborTables[dawn::UnstructuredIterationSpace{cec, false}] = cecTable.data();
+
+  toylib::FaceData<double> in_ref(mesh, nb_levels);
+  toylib::FaceData<double> out_ref(mesh, nb_levels);
+  toylib::FaceData<double> out_gen(mesh, nb_levels);
+  auto in_flat = dawn::allocateField(dawn::NoLibCpuTag{}, cpuMesh.NumCells, nb_levels);
+  auto out_flat = dawn::allocateField(dawn::NoLibCpuTag{}, cpuMesh.NumCells, nb_levels);
+
+  for(const auto& cell : mesh.faces()) {
+    auto [x, y] = cellMidpoint(cell);
+    for(int level = 0; level < nb_levels; ++level) {
+      in_ref(cell, level) = x * (level + 1) + y;
+      in_flat(cell.id(), level) = x * (level + 1) + y;
+    }
+  }
+
+  dawn_generated::cxxnaiveico::reference_diffusion<toylibInterface::toylibTag>(mesh, nb_levels,
+                                                                               in_ref, out_ref)
+      .run();
+  dawn_generated::cxxnaiveico::diffusionFlat<dawn::NoLibCpuTag>(cpuMesh, nb_levels, in_flat,
+                                                                out_flat)
+      .run();
+
+  for(const auto& cell : mesh.faces())
+    for(int level = 0; level < nb_levels; ++level)
+      out_gen(cell, level) = out_flat(cell.id(), level);
+
+  {
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(mesh.faces(), out_ref, out_gen, nb_levels))
+        << "while comparing output (on cells)";
+  }
+}
+} // namespace
+
 namespace {
 #include <generated_diamond.hpp>
 #include <reference_diamond.hpp>
@@ -452,6 +609,60 @@ TEST(ToylibIntegrationTestCompareOutput, sparseDimensions) {
 }
 } // namespace
 
+namespace {
+#include <generated_sparseDimensionFlat.hpp>
+TEST(ToylibIntegrationTestCompareOutput, sparseDimensionsFlatNeighborTables) {
+  auto mesh = toylib::Grid(10, 10);
+  const int edgesPerCell = 3;
+  const int nb_levels = 2;
+  const std::vector<dawn::LocationType> ce{dawn::LocationType::Cells, dawn::LocationType::Edges};
+
+  dawn::GlobalCpuTriMesh cpuMesh = makeCpuMesh(mesh);
+  std::vector<int> ceTable = makeFlatNbhTable(mesh, cpuMesh, ce, edgesPerCell);
+  cpuMesh.NeighborTables[dawn::UnstructuredIterationSpace{ce, false}] = ceTable.data();
+
+  toylib::FaceData<double> cells_ref(mesh, nb_levels);
+  toylib::FaceData<double> cells_gen(mesh, nb_levels);
+  toylib::EdgeData<double> edges(mesh, nb_levels);
+  toylib::SparseFaceData<double> sparseDim(mesh, edgesPerCell, nb_levels);
+  auto cells_flat = dawn::allocateField(dawn::NoLibCpuTag{}, cpuMesh.NumCells, nb_levels);
+  auto edges_flat = dawn::allocateField(dawn::NoLibCpuTag{}, cpuMesh.NumEdges, nb_levels);
+  auto sparseDim_flat =
+      dawn::allocateField(dawn::NoLibCpuTag{}, cpuMesh.NumCells, nb_levels, edgesPerCell);
+
+  // the sparse entries differ per neighbor, the tables have to list them in toylib's order
+  for(int level = 0; level < nb_levels; ++level) {
+    for(const toylib::Edge& e : mesh.edges()) {
+      edges(e, level) = e.id() + level;
+      edges_flat(e.id(), level) = e.id() + level;
+    }
+    for(const auto& f : mesh.faces()) {
+      for(int nbh = 0; nbh < edgesPerCell; ++nbh) {
+        sparseDim(f, nbh, level) = nbh + 1.;
+        sparseDim_flat(f.id(), nbh, level) = nbh + 1.;
+      }
+    }
+  }
+
+  dawn_generated::cxxnaiveico::sparseDimension<toylibInterface::toylibTag>(
+      mesh, nb_levels, cells_ref, edges, sparseDim)
+      .run();
+  dawn_generated::cxxnaiveico::sparseDimensionFlat<dawn::NoLibCpuTag>(
+      cpuMesh, nb_levels, cells_flat, edges_flat, sparseDim_flat)
+      .run();
+
+  for(const auto& f : mesh.faces())
+    for(int level = 0; level < nb_levels; ++level)
+      cells_gen(f, level) = cells_flat(f.id(), level);
+
+  {
+    UnstructuredVerifier v;
+    EXPECT_TRUE(v.compareToylibField(mesh.faces(), cells_ref, cells_gen, nb_levels))
+        << "while comparing output (on cells)";
+  }
+}
+} // namespace
+
 namespace {
 #include <generated_nestedWithSparse.hpp>
 TEST(ToylibIntegrationTestCompareOutput, nestedReduceSparseDimensions) {
@@ -0,0 +1,188 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+//===------------------------------------------------------------------------------------------===//
+//
+//  Runs the generated diffusion and gradient stencils on a toylib grid whose elements are numbered
+//  randomly (as delivered by a mesh generator without any locality ordering) and on the same grid
+//  renumbered with reverse Cuthill-McKee and along a Hilbert curve.
+//
+//  Usage: ToylibRenumberingBenchmark [num_cells_per_dim=256] [k_size=10] [repetitions=10]
+//
+//  The results of all numberings are verified to be identical. Cache misses can be measured by
+//  running the benchmark under e.g. `perf stat -e cache-references,cache-misses`, the mean index
+//  distance between neighboring cells is printed as a machine-independent locality measure.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/benchmark.hpp"
+#include "driver-includes/mesh_renumbering.hpp"
+#include "driver-includes/unstructured_domain.hpp"
+#include "driver-includes/unstructured_interface.hpp"
+
+#include "interface/toylib_interface.hpp"
+#include "toylib/toylib.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+#include <generated_diffusion.hpp>
+#include <generated_gradient.hpp>
+
+std::tuple<double, double> cellMidpoint(const toylib::Face& f) {
+  double x = f.vertices()[0]->x() + f.vertices()[1]->x() + f.vertices()[2]->x();
+  double y = f.vertices()[0]->y() + f.vertices()[1]->y() + f.vertices()[2]->y();
+  return {x / 3., y / 3.};
+}
+
+toylib::GridRenumbering shuffledNumbering(toylib::Grid const& mesh) {
+  std::mt19937 gen(42);
+  auto shuffled = [&](size_t size) {
+    std::vector<int> newIndex(size);
+    std::iota(newIndex.begin(), newIndex.end(), 0);
+    std::shuffle(newIndex.begin(), newIndex.end(), gen);
+    return newIndex;
+  };
+  return {shuffled(mesh.vertices().size()), shuffled(mesh.faces().size()),
+          shuffled(mesh.all_edges().size())};
+}
+
+double meanCellNeighborDistance(toylib::Grid const& mesh) {
+  std::vector<std::vector<int>> adjacency;
+  for(auto const& f : mesh.faces()) {
+    adjacency.emplace_back();
+    for(auto const* neighbor : f.faces())
+      adjacency.back().push_back(neighbor->id());
+  }
+  return dawn::mean_neighbor_distance(adjacency);
+}
+
+struct NumberingResult {
+  double cellDistance;
+  double diffusionTime;
+  double gradientTime;
+  // outputs of a single run of the stencils, indexed by the original cell index
+  std::vector<double> diffusionOut;
+  std::vector<double> gradientOut;
+};
+
+NumberingResult runNumbering(int numCell, int kSize, int repetitions,
+                             std::optional<toylib::renumbering_strategy> strategy) {
+  toylib::Grid mesh(numCell, numCell, false, 1., 1.);
+  std::vector<int> faceIndex(mesh.faces().size());
+  std::iota(faceIndex.begin(), faceIndex.end(), 0);
+
+  auto renumber = [&](toylib::GridRenumbering const& renumbering) {
+    mesh.renumber(renumbering);
+    for(auto& idx : faceIndex)
+      idx = renumbering.faces[idx];
+  };
+  renumber(shuffledNumbering(mesh));
+  if(strategy)
+    renumber(toylib::compute_renumbering(mesh, *strategy));
+
+  toylib::FaceData<double> in(mesh, kSize);
+  toylib::FaceData<double> out(mesh, kSize);
+  toylib::FaceData<double> cells(mesh, kSize);
+  toylib::EdgeData<double> edges(mesh, kSize);
+  auto init = [&]() {
+    for(int k = 0; k < kSize; ++k) {
+      for(const auto& f : mesh.faces()) {
+        auto [x, y] = cellMidpoint(f);
+        in(f, k) = (x > 0.375 && x < 0.625 && y > 0.375 && y < 0.625) ? 1 : 0;
+        out(f, k) = 0;
+        cells(f, k) = sin(M_PI * x) * sin(M_PI * y);
+      }
+      for(toylib::Edge const& e : mesh.edges())
+        edges(e, k) = 0;
+    }
+  };
+
+  auto diffusion = [&]() {
+    dawn_generated::cxxnaiveico::diffusion<toylibInterface::toylibTag>(mesh, kSize, in, out).run();
+  };
+  auto gradient = [&]() {
+    dawn_generated::cxxnaiveico::gradient<toylibInterface::toylibTag>(mesh, kSize, cells, edges)
+        .run();
+  };
+
+  NumberingResult result;
+  result.cellDistance = meanCellNeighborDistance(mesh);
+
+  init();
+  diffusion();
+  gradient();
+  for(size_t idx = 0; idx < faceIndex.size(); ++idx) {
+    const auto& f = mesh.faces()[faceIndex[idx]];
+    result.diffusionOut.push_back(out(f, kSize - 1));
+    result.gradientOut.push_back(cells(f, kSize - 1));
+  }
+
+  gridtools::dawn::benchmark_result timings;
+  init();
+  gridtools::dawn::set_time_statistics(timings,
+                                       gridtools::dawn::time_repeated(diffusion, 1, repetitions));
+  result.diffusionTime = timings.median_time;
+  gridtools::dawn::set_time_statistics(timings,
+                                       gridtools::dawn::time_repeated(gradient, 1, repetitions));
+  result.gradientTime = timings.median_time;
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const int numCell = argc > 1 ? std::atoi(argv[1]) : 256;
+  const int kSize = argc > 2 ? std::atoi(argv[2]) : 10;
+  const int repetitions = argc > 3 ? std::atoi(argv[3]) : 10;
+
+  std::vector<std::pair<std::string, std::optional<toylib::renumbering_strategy>>> numberings{
+      {"shuffled", std::nullopt},
+      {"reverse_cuthill_mckee", toylib::renumbering_strategy::reverse_cuthill_mckee},
+      {"hilbert", toylib::renumbering_strategy::hilbert}};
+
+  std::printf("grid %dx%d (%d cells), %d levels, median of %d runs\n", numCell, numCell,
+              2 * numCell * numCell, kSize, repetitions);
+  std::printf("%-24s %16s %14s %9s %14s %9s\n", "numbering", "cell nbh dist", "diffusion [s]",
+              "speedup", "gradient [s]", "speedup");
+
+  std::optional<NumberingResult> reference;
+  int status = 0;
+  for(const auto& [name, strategy] : numberings) {
+    auto result = runNumbering(numCell, kSize, repetitions, strategy);
+    if(!reference)
+      reference = result;
+
+    std::printf("%-24s %16.1f %14.3e %8.2fx %14.3e %8.2fx\n", name.c_str(), result.cellDistance,
+                result.diffusionTime, reference->diffusionTime / result.diffusionTime,
+                result.gradientTime, reference->gradientTime / result.gradientTime);
+
+    if(result.diffusionOut != reference->diffusionOut ||
+       result.gradientOut != reference->gradientOut) {
+      std::printf("ERROR: results of numbering %s differ from the shuffled numbering\n",
+                  name.c_str());
+      status = 1;
+    }
+  }
+  return status;
+}
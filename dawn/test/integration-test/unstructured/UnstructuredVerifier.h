@@ -17,6 +17,7 @@
 #ifndef GTCLANG_ATLAS_VERIFYER_H
 #define GTCLANG_ATLAS_VERIFYER_H
 
+#include "driver-includes/field_comparison.hpp"
 #include "interface/atlas_interface.hpp"
 #include <type_traits>
 
@@ -61,6 +62,13 @@ private:
     return {outcome, error};
   }
 
+  template <typename Value>
+  auto withinPrecision() const {
+    return [precision = Value(precision_), this](Value expected, Value actual) {
+      return std::get<0>(compare_below_threshold(expected, actual, precision));
+    };
+  }
+
 public:
   UnstructuredVerifier() : use_default_precision_(true) {}
   UnstructuredVerifier(double precision) : use_default_precision_(false), precision_(precision) {}
@@ -87,23 +95,21 @@ public:
     }
 
     // then the values
-    bool verified = true;
-    for(int i = 0; i < lhs.shape(0); i++) {
-      for(int k = 0; k < lhs.shape(1); k++) {
-        Value valueLhs = lhs(i, k);
-        Value valueRhs = rhs(i, k);
-        auto [result, error] = compare_below_threshold(valueLhs, valueRhs, Value(precision_));
-        if(!result) {
-          if(--max_erros >= 0) {
-            std::cerr << "( idx: " << i << " lvl: " << k << " ) : "
-                      << "  error: " << error << std::endl;
-          }
-          verified = false;
-        }
-      }
+    auto result = dawn::compare_fields(
+        lhs.shape(0), lhs.shape(1), [&](int i, int k) { return lhs(i, k); },
+        [&](int i, int k) { return rhs(i, k); }, withinPrecision<Value>(), {},
+        std::max(max_erros, 0));
+    for(const auto& failure : result.failures) {
+      auto [outcome, error] = compare_below_threshold(
+          lhs(failure.idx, failure.k), rhs(failure.idx, failure.k), Value(precision_));
+      std::cerr << "( idx: " << failure.idx << " lvl: " << failure.k << " ) : "
+                << "  error: " << error << std::endl;
+    }
+    if(!result.verified()) {
+      result.report(std::cerr, "UnstructuredVerifier:");
     }
 
-    return verified;
+    return result.verified();
   }
 
   template <typename ValT, typename iteratorT, template <typename> class FieldT>
@@ -114,23 +120,23 @@ public:
       setDefaultPrecision<ValT>();
     }
 
-    bool verified = true;
-    for(size_t level = 0; level < kSize; level++) {
-      for(const auto& e : iter) {
-        ValT valueLhs = lhs(e, level);
-        ValT valueRhs = rhs(e, level);
-        auto [result, error] = compare_below_threshold(valueLhs, valueRhs, ValT(precision_));
-        if(!result) {
-          if(--max_erros >= 0) {
-            std::cerr << "( idx: " << e.id() << " lvl: " << level << " ) : "
-                      << "  error: " << error << std::endl;
-          }
-          verified = false;
-        }
-      }
+    // elements are looked up by position, the iteration space has to be random access
+    auto result = dawn::compare_fields(
+        iter.size(), kSize, [&](int idx, int k) { return lhs(iter[idx], k); },
+        [&](int idx, int k) { return rhs(iter[idx], k); }, withinPrecision<ValT>(), {},
+        std::max(max_erros, 0));
+    for(const auto& failure : result.failures) {
+      const auto& e = iter[failure.idx];
+      auto [outcome, error] =
+          compare_below_threshold(lhs(e, failure.k), rhs(e, failure.k), ValT(precision_));
+      std::cerr << "( idx: " << e.id() << " lvl: " << failure.k << " ) : "
+                << "  error: " << error << std::endl;
+    }
+    if(!result.verified()) {
+      result.report(std::cerr, "UnstructuredVerifier:");
     }
 
-    return verified;
+    return result.verified();
   }
 };
 
@@ -0,0 +1,34 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "CodeGenTestUtils.h"
+#include "dawn/CodeGen/Driver.h"
+
+namespace dawn {
+
+int countOccurrences(const std::string& code, const std::string& pattern) {
+  int count = 0;
+  for(auto pos = code.find(pattern); pos != std::string::npos;
+      pos = code.find(pattern, pos + pattern.size()))
+    ++count;
+  return count;
+}
+
+std::string generateStencil(const std::shared_ptr<iir::StencilInstantiation>& instantiation,
+                            codegen::Backend backend, const codegen::Options& options) {
+  auto tu = codegen::run(instantiation, backend, options);
+  return tu->getStencils().at(instantiation->getName());
+}
+
+} // namespace dawn
@@ -12,8 +12,21 @@
 //
 //===------------------------------------------------------------------------------------------===//
 
-#include "dawn/Support/IndexGenerator.h"
+#pragma once
+
+#include "dawn/CodeGen/Options.h"
+#include "dawn/IIR/StencilInstantiation.h"
+
+#include <memory>
+#include <string>
+
 namespace dawn {
-std::unique_ptr<IndexGenerator> IndexGenerator::instance;
+
+/// @brief Number of non-overlapping occurrences of `pattern` in `code`
+int countOccurrences(const std::string& code, const std::string& pattern);
+
+/// @brief Generate the code of the stencil instantiation with `backend`
+std::string generateStencil(const std::shared_ptr<iir::StencilInstantiation>& instantiation,
+                            codegen::Backend backend, const codegen::Options& options = {});
 
 } // namespace dawn
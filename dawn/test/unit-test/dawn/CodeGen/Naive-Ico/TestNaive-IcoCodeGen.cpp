@@ -12,17 +12,326 @@
 //
 //===------------------------------------------------------------------------------------------===//
 
+#include "CodeGenTestUtils.h"
 #include "UnstructuredStencils.h"
 #include "dawn/CodeGen/Options.h"
 #include "dawn/Serialization/IIRSerializer.h"
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
 namespace {
 
 constexpr auto backend = dawn::codegen::Backend::CXXNaiveIco;
 
+using dawn::countOccurrences;
+using dawn::generateStencil;
+
 // NOTE: Often-changing backend. For the moment we prefer to test code generation through end-to-end
 // tests checking the output. To be reconsidered once this is stable.
 
-} // namespace
\ No newline at end of file
+TEST(NaiveIco, MergedReductions) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // lhs_a = reduce(Edges > Cells, cell_a); lhs_b = reduce(Edges > Cells, cell_b);
+  UnstructuredIIRBuilder b;
+  auto lhs_a = b.field("lhs_a", LocType::Edges);
+  auto lhs_b = b.field("lhs_b", LocType::Edges);
+  auto cell_a = b.field("cell_a", LocType::Cells);
+  auto cell_b = b.field("cell_b", LocType::Cells);
+
+  auto instantiation = b.build(
+      "merged_reductions",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Edges,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(lhs_a),
+                                                 b.reduceOverNeighborExpr(
+                                                     Op::plus, b.at(cell_a), b.lit(0.),
+                                                     {LocType::Edges, LocType::Cells}))),
+                             b.stmt(b.assignExpr(b.at(lhs_b),
+                                                 b.reduceOverNeighborExpr(
+                                                     Op::plus, b.at(cell_b), b.lit(1.),
+                                                     {LocType::Edges, LocType::Cells}))))))));
+
+  const std::string code = generateStencil(instantiation, backend);
+  // neighbors are resolved once, both results are accumulated in the same loop
+  EXPECT_EQ(countOccurrences(code, "reduce(LibTag{}"), 0) << code;
+  EXPECT_EQ(countOccurrences(code, "getNeighbors(LibTag{}"), 1) << code;
+  EXPECT_EQ(countOccurrences(code, "red_acc"), 6) << code;
+}
+
+TEST(NaiveIco, MergedReductionsWeighted) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // lhs = reduce(Cells > Edges, edge_a, weights) + reduce(Cells > Edges, edge_b)
+  UnstructuredIIRBuilder b;
+  auto lhs = b.field("lhs", LocType::Cells);
+  auto edge_a = b.field("edge_a", LocType::Edges);
+  auto edge_b = b.field("edge_b", LocType::Edges);
+
+  auto instantiation = b.build(
+      "merged_weighted_reductions",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Cells,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(
+                                 b.at(lhs),
+                                 b.binaryExpr(b.reduceOverNeighborExpr(
+                                                  Op::plus, b.at(edge_a), b.lit(0.),
+                                                  {LocType::Cells, LocType::Edges},
+                                                  std::vector<double>({1., -1., 1.})),
+                                              b.reduceOverNeighborExpr(
+                                                  Op::plus, b.at(edge_b), b.lit(0.),
+                                                  {LocType::Cells, LocType::Edges})))))))));
+
+  const std::string code = generateStencil(instantiation, backend);
+  EXPECT_EQ(countOccurrences(code, "reduce(LibTag{}"), 0) << code;
+  EXPECT_EQ(countOccurrences(code, "getNeighbors(LibTag{}"), 1) << code;
+  EXPECT_EQ(countOccurrences(code, "red_weights"), 2) << code;
+}
+
+TEST(NaiveIco, ReductionsNotMerged) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // lhs_a = reduce(Edges > Cells, cell_a);
+  // lhs_b = reduce(Edges > Vertices, vertex_b);  (different chain)
+  // lhs_c = reduce(Edges > Vertices, vertex_b * lhs_b);  (reads the result of the previous one)
+  UnstructuredIIRBuilder b;
+  auto lhs_a = b.field("lhs_a", LocType::Edges);
+  auto lhs_b = b.field("lhs_b", LocType::Edges);
+  auto lhs_c = b.field("lhs_c", LocType::Edges);
+  auto cell_a = b.field("cell_a", LocType::Cells);
+  auto vertex_b = b.field("vertex_b", LocType::Vertices);
+
+  auto instantiation = b.build(
+      "unmerged_reductions",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Edges,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(lhs_a),
+                                                 b.reduceOverNeighborExpr(
+                                                     Op::plus, b.at(cell_a), b.lit(0.),
+                                                     {LocType::Edges, LocType::Cells}))),
+                             b.stmt(b.assignExpr(b.at(lhs_b),
+                                                 b.reduceOverNeighborExpr(
+                                                     Op::plus, b.at(vertex_b), b.lit(0.),
+                                                     {LocType::Edges, LocType::Vertices}))),
+                             b.stmt(b.assignExpr(b.at(lhs_c),
+                                                 b.reduceOverNeighborExpr(
+                                                     Op::plus,
+                                                     b.binaryExpr(b.at(vertex_b), b.at(lhs_b),
+                                                                  Op::multiply),
+                                                     b.lit(0.),
+                                                     {LocType::Edges, LocType::Vertices}))))))));
+
+  const std::string code = generateStencil(instantiation, backend);
+  EXPECT_EQ(countOccurrences(code, "reduce(LibTag{}"), 3) << code;
+  EXPECT_EQ(countOccurrences(code, "red_acc"), 0) << code;
+}
+
+TEST(NaiveIco, ReductionWeights) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // lhs_a = reduce(Edges > Cells, cell_a, weights = [1, -1]);
+  // lhs_b = reduce(Edges > Cells, cell_a, weights = [edge_w, -edge_w]);
+  UnstructuredIIRBuilder b;
+  auto lhs_a = b.field("lhs_a", LocType::Edges);
+  auto lhs_b = b.field("lhs_b", LocType::Edges);
+  auto edge_w = b.field("edge_w", LocType::Edges);
+  auto cell_a = b.field("cell_a", LocType::Cells);
+
+  auto instantiation = b.build(
+      "weighted_reductions",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Edges,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(lhs_a),
+                                                 b.reduceOverNeighborExpr(
+                                                     Op::plus, b.at(cell_a), b.lit(0.),
+                                                     {LocType::Edges, LocType::Cells},
+                                                     std::vector<double>({1., -1.})))),
+                             b.stmt(b.assignExpr(
+                                 b.at(lhs_b),
+                                 b.reduceOverNeighborExpr(
+                                     Op::plus, b.at(cell_a), b.lit(0.),
+                                     {LocType::Edges, LocType::Cells},
+                                     {b.at(edge_w), b.unaryExpr(b.at(edge_w), Op::minus)}))))))));
+
+  // weights are declared as arrays (compile-time constants if possible) instead of being passed to
+  // the library as a vector
+  const std::string code = generateStencil(instantiation, backend);
+  EXPECT_EQ(countOccurrences(code, "std::vector<::dawn::float_type>"), 0) << code;
+  EXPECT_EQ(countOccurrences(code, "static constexpr ::dawn::float_type red_weights"), 1) << code;
+  EXPECT_EQ(countOccurrences(code, "const ::dawn::float_type red_weights"), 1) << code;
+}
+
+TEST(NaiveIco, FlatNeighborTables) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // lhs_a = reduce(Edges > Cells, cell_a); lhs_b = reduce(Edges > Vertices, vertex_b)
+  UnstructuredIIRBuilder b;
+  auto lhs_a = b.field("lhs_a", LocType::Edges);
+  auto lhs_b = b.field("lhs_b", LocType::Edges);
+  auto cell_a = b.field("cell_a", LocType::Cells);
+  auto vertex_b = b.field("vertex_b", LocType::Vertices);
+
+  auto instantiation = b.build(
+      "flat_neighbor_tables",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Edges,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(lhs_a),
+                                                 b.reduceOverNeighborExpr(
+                                                     Op::plus, b.at(cell_a), b.lit(0.),
+                                                     {LocType::Edges, LocType::Cells}))),
+                             b.stmt(b.assignExpr(b.at(lhs_b),
+                                                 b.reduceOverNeighborExpr(
+                                                     Op::plus, b.at(vertex_b), b.lit(0.),
+                                                     {LocType::Edges, LocType::Vertices}))))))));
+
+  dawn::codegen::Options options;
+  options.FlatNeighborTables = true;
+  std::string code = generateStencil(instantiation, backend, options);
+  // tables are looked up once per stencil run and indexed directly in the neighbor loops
+  EXPECT_EQ(countOccurrences(code, "reduce(LibTag{}"), 0) << code;
+  EXPECT_EQ(countOccurrences(code, "getNeighbors(LibTag{}"), 0) << code;
+  EXPECT_EQ(countOccurrences(code, "m_mesh.NeighborTables.at("), 2) << code;
+  EXPECT_EQ(countOccurrences(code, "ecTable["), 1) << code;
+  EXPECT_EQ(countOccurrences(code, "evTable["), 1) << code;
+  // edges always have two cells and two vertices
+  EXPECT_EQ(countOccurrences(code, "DEVICE_MISSING_VALUE"), 0) << code;
+
+  options.AtlasCompatible = true;
+  code = generateStencil(instantiation, backend, options);
+  EXPECT_EQ(countOccurrences(code, "DEVICE_MISSING_VALUE"), 2) << code;
+}
+
+TEST(NaiveIco, RawInterface) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // lhs = reduce(Edges > Cells, cell_a * sparse) + vert
+  UnstructuredIIRBuilder b;
+  auto lhs = b.field("lhs", LocType::Edges);
+  auto cell_a = b.field("cell_a", LocType::Cells);
+  auto sparse = b.field("sparse", {LocType::Edges, LocType::Cells});
+  auto vert = b.vertical_field("vert");
+
+  auto instantiation = b.build(
+      "raw_interface",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Edges,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(
+                                 b.at(lhs),
+                                 b.binaryExpr(b.reduceOverNeighborExpr(
+                                                  Op::plus,
+                                                  b.binaryExpr(b.at(cell_a), b.at(sparse),
+                                                               Op::multiply),
+                                                  b.lit(0.), {LocType::Edges, LocType::Cells}),
+                                              b.at(vert), Op::plus))))))));
+
+  const std::string header = "raw_interface_ico.h";
+  dawn::codegen::Options options;
+  options.OutputCHeader = header;
+  // the interface runs the stencil on the flat neighbor tables of NoLibCpuTag
+  EXPECT_ANY_THROW(generateStencil(instantiation, backend, options));
+
+  options.FlatNeighborTables = true;
+  std::string code = generateStencil(instantiation, backend, options);
+  EXPECT_EQ(countOccurrences(code, "extern \"C\""), 1) << code;
+  EXPECT_EQ(countOccurrences(code, "void run_raw_interface(::dawn::GlobalCpuTriMesh* mesh, "
+                                   "int k_size, ::dawn::float_type* lhs, int lhs_stride, "),
+            1)
+      << code;
+  EXPECT_EQ(countOccurrences(code, "cpu_dense_field<::dawn::float_type> lhs_view(lhs, "
+                                   "lhs_stride)"),
+            1)
+      << code;
+  EXPECT_EQ(countOccurrences(code, "cpu_sparse_field<::dawn::float_type> sparse_view(sparse, "
+                                   "sparse_stride, 2)"),
+            1)
+      << code;
+  EXPECT_EQ(countOccurrences(code, "cpu_vertical_field<::dawn::float_type> vert_view(vert)"), 1)
+      << code;
+  EXPECT_EQ(countOccurrences(code, "raw_interface<::dawn::NoLibCpuTag> stencil(*mesh, k_size"), 1)
+      << code;
+
+  std::ifstream ifs(header);
+  ASSERT_TRUE(ifs.is_open());
+  const std::string decl((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  EXPECT_EQ(countOccurrences(decl, "void run_raw_interface("), 1) << decl;
+  EXPECT_EQ(countOccurrences(decl, "stencil.run()"), 0) << decl;
+  ifs.close();
+  std::remove(header.c_str());
+}
+
+TEST(NaiveIco, KBlocking) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // edge_f = reduce(Edges > Cells, cell_f); cell_f = reduce(Cells > Edges, edge_f)
+  auto makeStencil = [](LoopOrderKind loopOrder, int vOffset) {
+    UnstructuredIIRBuilder b;
+    auto cell_f = b.field("cell_f", LocType::Cells);
+    auto edge_f = b.field("edge_f", LocType::Edges);
+    return b.build(
+        "k_blocking",
+        b.stencil(b.multistage(
+            loopOrder,
+            b.stage(LocType::Edges,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                               b.stmt(b.assignExpr(b.at(edge_f),
+                                                   b.reduceOverNeighborExpr(
+                                                       Op::plus, b.at(cell_f), b.lit(0.),
+                                                       {LocType::Edges, LocType::Cells}))))),
+            b.stage(LocType::Cells,
+                    b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End, 0, -1,
+                               b.stmt(b.assignExpr(
+                                   b.at(cell_f),
+                                   b.reduceOverNeighborExpr(
+                                       Op::plus, b.at(edge_f, HOffsetType::withOffset, vOffset),
+                                       b.lit(0.), {LocType::Cells, LocType::Edges}))))))));
+  };
+
+  dawn::codegen::Options options;
+  std::string code = generateStencil(makeStencil(LoopOrderKind::Parallel, 0), backend, options);
+  EXPECT_EQ(countOccurrences(code, "kBlock"), 0) << code;
+
+  // the two intervals are computed in blocks of 4 levels, both stages compute all levels of the
+  // block of an element in a row
+  options.LevelsPerThread = 4;
+  code = generateStencil(makeStencil(LoopOrderKind::Parallel, 0), backend, options);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp parallel for\n"), 2) << code;
+  EXPECT_EQ(countOccurrences(code, "kBlock += 4)"), 2) << code;
+  EXPECT_EQ(countOccurrences(code, "const int kEnd = (kBlock+3 < "), 2) << code;
+  EXPECT_EQ(countOccurrences(code, "for(int k = kBlock; k <= kEnd; ++k)"), 4) << code;
+
+  // levels of other blocks are read, or the levels depend on each other
+  code = generateStencil(makeStencil(LoopOrderKind::Parallel, 1), backend, options);
+  EXPECT_EQ(countOccurrences(code, "kBlock"), 0) << code;
+  code = generateStencil(makeStencil(LoopOrderKind::Forward, 0), backend, options);
+  EXPECT_EQ(countOccurrences(code, "kBlock"), 0) << code;
+
+  options.LevelsPerThread = 0;
+  EXPECT_THROW(generateStencil(makeStencil(LoopOrderKind::Parallel, 0), backend, options),
+               std::invalid_argument);
+}
+
+} // namespace
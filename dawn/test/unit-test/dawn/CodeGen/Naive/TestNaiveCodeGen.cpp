@@ -12,9 +12,14 @@
 //
 //===------------------------------------------------------------------------------------------===//
 
+#include "CodeGenTestUtils.h"
 #include "Stencils.h"
+#include "dawn/CodeGen/Driver.h"
 #include "dawn/CodeGen/Options.h"
+#include "dawn/IIR/IIRNodeIterator.h"
 #include "dawn/Serialization/IIRSerializer.h"
+#include "dawn/Support/FileSystem.h"
+#include "dawn/Unittest/IIRBuilder.h"
 
 #include <gtest/gtest.h>
 
@@ -22,6 +27,9 @@ namespace {
 
 constexpr auto backend = dawn::codegen::Backend::CXXNaive;
 
+using dawn::countOccurrences;
+using dawn::generateStencil;
+
 TEST(Naive, GlobalIndexStencil) {
   runTest(dawn::getGlobalIndexStencil(), backend, "reference/global_indexing.cpp");
 }
@@ -34,6 +42,146 @@ TEST(Naive, LaplacianStencil) {
   runTest(dawn::getLaplacianStencil(), backend, "reference/laplacian_stencil.cpp");
 }
 
+TEST(Naive, LaplacianStencilHaloExchange) {
+  dawn::codegen::Options options;
+  options.HaloExchange = true;
+  runTest(dawn::getLaplacianStencil(), backend, "reference/laplacian_stencil_halo_exchange.cpp",
+          options);
+}
+
+std::string generateHaloExchange(const std::shared_ptr<dawn::iir::StencilInstantiation>& si) {
+  dawn::codegen::Options options;
+  options.HaloExchange = true;
+  return generateStencil(si, backend, options);
+}
+
+std::string exchangeStart(const std::string& field, const std::string& width) {
+  return "m_halo_exchange->start(make_raw_field(" + field + "_), m_dom, " + width + ")";
+}
+
+// Redundant computations of a stage, as derived by the stage extent pass
+void setStageExtents(const std::shared_ptr<dawn::iir::StencilInstantiation>& si, int stageIdx,
+                     const dawn::iir::Extents& extents) {
+  for(const auto& stage : dawn::iterateIIROver<dawn::iir::Stage>(*si->getIIR()))
+    if(stageIdx-- == 0) {
+      stage->setExtents(extents);
+      stage->update(dawn::iir::NodeUpdateType::levelAndTreeAbove);
+    }
+}
+
+TEST(Naive, HaloExchangeInPlaceOffCenterWrite) {
+  using namespace dawn::iir;
+
+  // a = a[i+1] reads points of the interior which the interior run has already updated when the
+  // boundary strips are computed, the exchange has to finish before the stencil runs
+  CartesianIIRBuilder b;
+  auto a = b.field("a");
+  std::string code = generateHaloExchange(b.build(
+      "in_place",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(a, AccessType::rw),
+                                                 b.at(a, {1, 0, 0})))))))));
+  EXPECT_EQ(countOccurrences(code, exchangeStart("a", "{0, 1, 0, 0}")), 1);
+  EXPECT_EQ(countOccurrences(code, "m_halo_exchange->finish()"), 1);
+  EXPECT_EQ(countOccurrences(code, "runOnSubdomain"), 0);
+
+  // written out of place the exchange is overlapped
+  CartesianIIRBuilder c;
+  auto in = c.field("in");
+  auto out = c.field("out");
+  code = generateHaloExchange(c.build(
+      "out_of_place",
+      c.stencil(c.multistage(
+          LoopOrderKind::Parallel,
+          c.stage(c.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             c.stmt(c.assignExpr(c.at(out), c.at(in, {1, 0, 0})))))))));
+  EXPECT_EQ(countOccurrences(code, exchangeStart("in", "{0, 1, 0, 0}")), 1);
+  EXPECT_EQ(countOccurrences(code, "runOnSubdomain(iMin + 0, iMax - 1, jMin + 0, jMax - 0)"), 1);
+}
+
+std::shared_ptr<dawn::iir::StencilInstantiation> getExtendedStageStencil(bool writeInputLater) {
+  using namespace dawn::iir;
+
+  // tmp = in on the extended stage, out = tmp[i-1] + tmp[i+1] (and optionally in = out)
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out = b.field("out");
+  auto tmp = b.tmpField("tmp");
+  auto stage1 = b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                                   b.stmt(b.assignExpr(b.at(tmp, AccessType::rw), b.at(in)))));
+  auto stage2 = b.stage(b.doMethod(
+      dawn::ast::Interval::Start, dawn::ast::Interval::End,
+      b.stmt(b.assignExpr(b.at(out, AccessType::rw),
+                          b.binaryExpr(b.at(tmp, {-1, 0, 0}), b.at(tmp, {1, 0, 0}))))));
+  auto stencil =
+      writeInputLater
+          ? b.stencil(b.multistage(
+                LoopOrderKind::Parallel, std::move(stage1), std::move(stage2),
+                b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                                   b.stmt(b.assignExpr(b.at(in, AccessType::rw), b.at(out)))))))
+          : b.stencil(
+                b.multistage(LoopOrderKind::Parallel, std::move(stage1), std::move(stage2)));
+  auto si = b.build("extended_stage", std::move(stencil));
+  setStageExtents(si, 0, dawn::iir::Extents(dawn::ast::cartesian, -1, 1, 0, 0, 0, 0));
+  return si;
+}
+
+TEST(Naive, HaloExchangeExtendedStage) {
+  // the extended stage reads the halo of in, the strips recompute tmp around them
+  std::string code = generateHaloExchange(getExtendedStageStencil(false));
+  EXPECT_EQ(countOccurrences(code, exchangeStart("in", "{1, 1, 0, 0}")), 1);
+  EXPECT_EQ(countOccurrences(code, "runOnSubdomain(iMin + 1, iMax - 1, jMin + 0, jMax - 0)"), 1);
+
+  // the extended stage of a strip would read in after the interior run updated it
+  code = generateHaloExchange(getExtendedStageStencil(true));
+  EXPECT_EQ(countOccurrences(code, exchangeStart("in", "{1, 1, 0, 0}")), 1);
+  EXPECT_EQ(countOccurrences(code, "runOnSubdomain"), 0);
+}
+
+TEST(Naive, HaloExchangeMultiStages) {
+  using namespace dawn::iir;
+
+  // the widths of a field read by several multistages are merged
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out1 = b.field("out1");
+  auto out2 = b.field("out2");
+  std::string code = generateHaloExchange(b.build(
+      "multistages",
+      b.stencil(
+          b.multistage(LoopOrderKind::Parallel,
+                       b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                                          b.stmt(b.assignExpr(b.at(out1, AccessType::rw),
+                                                              b.at(in, {1, 0, 0})))))),
+          b.multistage(LoopOrderKind::Parallel,
+                       b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                                          b.stmt(b.assignExpr(b.at(out2, AccessType::rw),
+                                                              b.at(in, {0, -1, 0})))))))));
+  EXPECT_EQ(countOccurrences(code, exchangeStart("in", "{0, 1, 1, 0}")), 1);
+  EXPECT_EQ(countOccurrences(code, "m_halo_exchange->start("), 1);
+  EXPECT_EQ(countOccurrences(code, "runOnSubdomain(iMin + 0, iMax - 1, jMin + 1, jMax - 0)"), 1);
+
+  // a field read off-center by the first multistage and written by the second one
+  CartesianIIRBuilder c;
+  auto a = c.field("a");
+  auto copy = c.field("copy");
+  code = generateHaloExchange(c.build(
+      "multistages_in_place",
+      c.stencil(
+          c.multistage(LoopOrderKind::Forward,
+                       c.stage(c.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                                          c.stmt(c.assignExpr(c.at(copy, AccessType::rw),
+                                                              c.at(a, {0, 1, 0})))))),
+          c.multistage(LoopOrderKind::Backward,
+                       c.stage(c.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                                          c.stmt(c.assignExpr(c.at(a, AccessType::rw),
+                                                              c.at(copy)))))))));
+  EXPECT_EQ(countOccurrences(code, exchangeStart("a", "{0, 0, 0, 1}")), 1);
+  EXPECT_EQ(countOccurrences(code, "runOnSubdomain"), 0);
+}
+
 TEST(Naive, ConditionalStencil) {
   runTest(dawn::IIRSerializer::deserialize("input/conditional_stencil.iir"), backend,
           "reference/conditional_stencil.cpp");
@@ -44,4 +192,15 @@ TEST(Naive, DzCStencil) {
           "reference/update_dz_c.cpp");
 }
 
+TEST(Naive, LaplacianStencilRawInterface) {
+  const fs::path tmpDir = fs::temp_directory_path();
+  dawn::codegen::Options options;
+  options.OutputCHeader = (tmpDir / "laplacian_stencil_raw.h").string();
+  options.OutputFortranInterface = (tmpDir / "laplacian_stencil_raw.f90").string();
+  dawn::codegen::run(dawn::getLaplacianStencil(), backend, options);
+
+  dawn::compareToReference(options.OutputCHeader, "reference/laplacian_stencil_raw.h");
+  dawn::compareToReference(options.OutputFortranInterface, "reference/laplacian_stencil_raw.f90");
+}
+
 } // namespace
@@ -12,18 +12,232 @@
 //
 //===------------------------------------------------------------------------------------------===//
 
+#include "CodeGenTestUtils.h"
 #include "Stencils.h"
 #include "dawn/CodeGen/Options.h"
 #include "dawn/Serialization/IIRSerializer.h"
+#include "dawn/Support/FileSystem.h"
+#include "dawn/Unittest/IIRBuilder.h"
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+
 namespace {
 
 constexpr auto backend = dawn::codegen::Backend::CXXOpt;
 
+using dawn::countOccurrences;
+using dawn::generateStencil;
+
 TEST(Opt, LaplacianStencil) {
   runTest(dawn::getLaplacianStencil(), backend, "reference/laplacian_stencil_opt.cpp");
 }
 
+TEST(Opt, LaplacianStencilFixedDomain) {
+  dawn::codegen::Options options;
+  options.DomainSizeI = 64;
+  options.DomainSizeJ = 64;
+  options.DomainSizeK = 80;
+  runTest(dawn::getLaplacianStencil(), backend, "reference/laplacian_stencil_opt_fixed_domain.cpp",
+          options);
+}
+
+TEST(Opt, LaplacianStencilTaskParallel) {
+  // a single stencil with a single multistage has no independent tasks, the serial code is kept
+  dawn::codegen::Options options;
+  options.TaskParallel = true;
+  runTest(dawn::getLaplacianStencil(), backend, "reference/laplacian_stencil_opt.cpp", options);
+}
+
+std::shared_ptr<dawn::iir::StencilInstantiation> getIndependentMultiStagesStencil() {
+  using namespace dawn;
+  using namespace dawn::iir;
+  UIDGenerator::getInstance()->reset();
+
+  // the multistages neither share nor exchange fields
+  CartesianIIRBuilder b;
+  auto in_a = b.field("in_a");
+  auto out_a = b.field("out_a");
+  auto in_b = b.field("in_b");
+  auto out_b = b.field("out_b");
+  return b.build(
+      "generated",
+      b.stencil(b.multistage(LoopOrderKind::Forward,
+                             b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                                b.stmt(b.assignExpr(b.at(out_a), b.at(in_a)))))),
+                b.multistage(LoopOrderKind::Forward,
+                             b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                                b.stmt(b.assignExpr(b.at(out_b), b.at(in_b))))))));
+}
+
+std::shared_ptr<dawn::iir::StencilInstantiation> getIndependentStencilsStencil() {
+  using namespace dawn;
+  using namespace dawn::iir;
+  UIDGenerator::getInstance()->reset();
+
+  // both stencils read `in`, the third one reads the outputs of the first two
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out_a = b.field("out_a");
+  auto out_b = b.field("out_b");
+  auto out = b.field("out");
+  std::vector<std::unique_ptr<Stencil>> stencils;
+  stencils.push_back(b.stencil(b.multistage(
+      LoopOrderKind::Parallel, b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                                  b.stmt(b.assignExpr(b.at(out_a), b.at(in))))))));
+  stencils.push_back(b.stencil(b.multistage(
+      LoopOrderKind::Parallel, b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                                  b.stmt(b.assignExpr(b.at(out_b), b.at(in))))))));
+  stencils.push_back(b.stencil(b.multistage(
+      LoopOrderKind::Parallel,
+      b.stage(b.doMethod(
+          ast::Interval::Start, ast::Interval::End,
+          b.stmt(b.assignExpr(b.at(out), b.binaryExpr(b.at(out_a), b.at(out_b)))))))));
+  return b.build("generated", std::move(stencils));
+}
+
+TEST(Opt, IndependentMultiStagesTaskParallel) {
+  dawn::codegen::Options options;
+  options.TaskParallel = true;
+  runTest(getIndependentMultiStagesStencil(), backend,
+          "reference/independent_multistages_opt_tasks.cpp", options);
+}
+
+TEST(Opt, IndependentStencilsTaskParallel) {
+  dawn::codegen::Options options;
+  options.TaskParallel = true;
+  runTest(getIndependentStencilsStencil(), backend, "reference/independent_stencils_opt_tasks.cpp",
+          options);
+}
+
+TEST(Opt, LaplacianStencilTiled) {
+  dawn::codegen::Options options;
+  options.TileSizeI = 32;
+  options.TileSizeJ = 8;
+  options.KParallel = false;
+  options.NumThreads = 4;
+  const std::string code = generateStencil(dawn::getLaplacianStencil(), backend, options);
+
+  // k is iterated sequentially, the tile loops are parallelized
+  EXPECT_EQ(countOccurrences(code, "#pragma omp parallel for num_threads(4) collapse(2)\n"
+                                   "for(int iTile = iMin+0; iTile <= iMax+0; iTile += 32)"),
+            1);
+  EXPECT_EQ(countOccurrences(code, "for(int jTile = jMin+0; jTile <= jMax+0; jTile += 8)"), 1);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp simd\n"
+                                   "for(int j = jTile; j <= (jTile+7 < jMax+0 ? jTile+7 : jMax+0); "
+                                   "++j)"),
+            1);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp parallel for\n"), 0);
+}
+
+TEST(Opt, LaplacianStencilLoopOrder) {
+  dawn::codegen::Options options;
+  options.LoopOrder = "ji";
+  options.TileSizeJ = 16;
+  const std::string code = generateStencil(dawn::getLaplacianStencil(), backend, options);
+
+  // only j is tiled, the k-loop stays parallel
+  EXPECT_EQ(countOccurrences(code, "#pragma omp parallel for\nfor(int k"), 1);
+  EXPECT_EQ(countOccurrences(code, "for(int jTile = jMin+0; jTile <= jMax+0; jTile += 16)"), 1);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp simd\nfor(int i = iMin+0;"), 1);
+  EXPECT_EQ(countOccurrences(code, "iTile"), 0);
+
+  options.LoopOrder = "kij";
+  EXPECT_THROW(generateStencil(dawn::getLaplacianStencil(), backend, options),
+               std::invalid_argument);
+}
+
+TEST(Opt, LaplacianStencilTuningDatabase) {
+  const std::string database =
+      (fs::temp_directory_path() / "laplacian_stencil_tuning.json").string();
+  std::ofstream(database) << R"({"records": [
+    {"backend": "c++-opt", "stencil": "generated", "domain_size": [64, 64, 80],
+     "tile_size": [0, 4], "loop_order": "ij", "k_parallel": false, "num_threads": 2,
+     "time": 1e-3},
+    {"backend": "c++-opt", "stencil": "generated", "domain_size": [512, 512, 80],
+     "tile_size": [0, 0], "loop_order": "ji", "k_parallel": true, "num_threads": 8,
+     "time": 1e-1}]})";
+
+  dawn::codegen::Options options;
+  options.TuningDatabaseFile = database;
+  options.NumThreads = 3; // overridden by the tuned configuration
+  options.DomainSizeI = 64;
+  options.DomainSizeJ = 64;
+  options.DomainSizeK = 80;
+  std::string code = generateStencil(dawn::getLaplacianStencil(), backend, options);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp parallel for num_threads(2)\n"
+                                   "for(int jTile = jMin+0; jTile <= jMax+0; jTile += 4)"),
+            1);
+  EXPECT_EQ(countOccurrences(code, "num_threads(3)"), 0);
+
+  // the closest tuned domain size
+  options.DomainSizeI = 400;
+  options.DomainSizeJ = 400;
+  code = generateStencil(dawn::getLaplacianStencil(), backend, options);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp parallel for num_threads(8)\nfor(int k"), 1);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp simd\nfor(int i = iMin+0;"), 1);
+  std::remove(database.c_str());
+
+  options.TuningDatabaseFile = database;
+  EXPECT_THROW(generateStencil(dawn::getLaplacianStencil(), backend, options), std::runtime_error);
+}
+
+std::shared_ptr<dawn::iir::StencilInstantiation> getPrefixSumStencil() {
+  using namespace dawn;
+  using namespace dawn::iir;
+
+  // forward: c = in + c[k-1], backward: out = c + out[k+1]
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out = b.field("out");
+  auto c = b.tmpField("c");
+  return b.build(
+      "prefix_sum",
+      b.stencil(
+          b.multistage(
+              LoopOrderKind::Forward,
+              b.stage(b.doMethod(ast::Interval::Start, ast::Interval::Start,
+                                 b.stmt(b.assignExpr(b.at(c, AccessType::rw), b.at(in)))),
+                      b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                                 b.stmt(b.assignExpr(
+                                     b.at(c, AccessType::rw),
+                                     b.binaryExpr(b.at(in), b.at(c, {0, 0, -1}))))))),
+          b.multistage(
+              LoopOrderKind::Backward,
+              b.stage(b.doMethod(ast::Interval::End, ast::Interval::End,
+                                 b.stmt(b.assignExpr(b.at(out, AccessType::rw), b.at(c)))),
+                      b.doMethod(ast::Interval::Start, ast::Interval::End, 0, -1,
+                                 b.stmt(b.assignExpr(
+                                     b.at(out, AccessType::rw),
+                                     b.binaryExpr(b.at(c), b.at(out, {0, 0, 1})))))))));
+}
+
+TEST(Opt, VerticalSolver) {
+  // vertical solvers are generated like other multistages by default
+  std::string code = generateStencil(getPrefixSumStencil(), backend);
+  EXPECT_EQ(countOccurrences(code, "iBatch"), 0);
+  EXPECT_EQ(countOccurrences(code, "_buffer"), 0);
+  EXPECT_EQ(countOccurrences(code, "make_host_view(m_"), 2);
+
+  dawn::codegen::Options options;
+  options.SolverBatchSize = 8;
+  code = generateStencil(getPrefixSumStencil(), backend, options);
+
+  // both sweeps run on batches of 8 columns, the coefficient is kept in a buffer of the batch
+  // which is allocated once per thread
+  EXPECT_EQ(countOccurrences(code, "for(int iBatch = iMin+0; iBatch <= iMax+0; iBatch += 8)"), 1);
+  EXPECT_EQ(countOccurrences(code, "thread_local std::vector<::dawn::float_type> "), 1);
+  EXPECT_EQ(countOccurrences(code, "_buffer.resize(8 * (kMax - kMin + 2))"), 1);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp simd\nfor(int i = iBatch; i <= iEnd; ++i)"), 4);
+  EXPECT_EQ(countOccurrences(code, "#pragma omp parallel for\n"), 1);
+  EXPECT_EQ(countOccurrences(code, "for(int j = jMin+0; j <= jMax+0; ++j)"), 1);
+
+  // the buffered coefficient has no 3D storage
+  EXPECT_EQ(countOccurrences(code, "make_host_view(m_"), 0);
+  EXPECT_EQ(countOccurrences(code, "m_tmp_meta_data"), 0);
+}
+
 } // namespace
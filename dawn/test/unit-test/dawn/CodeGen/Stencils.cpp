@@ -12,6 +12,7 @@
 //
 //===------------------------------------------------------------------------------------------===//
 
+#include "Stencils.h"
 #include "dawn/CodeGen/Driver.h"
 #include "dawn/SIR/SIR.h"
 #include "dawn/Support/FileSystem.h"
@@ -113,7 +114,12 @@ void runTest(const std::shared_ptr<iir::StencilInstantiation> stencilInstantiati
              codegen::Backend backend, const std::string& refFile, bool withSync) {
   dawn::codegen::Options options;
   options.RunWithSync = withSync;
+  runTest(stencilInstantiation, backend, refFile, options);
+}
 
+void runTest(const std::shared_ptr<iir::StencilInstantiation> stencilInstantiation,
+             codegen::Backend backend, const std::string& refFile,
+             const codegen::Options& options) {
   auto tu = dawn::codegen::run(stencilInstantiation, backend, options);
   const std::string code = dawn::codegen::generate(tu);
 
@@ -122,4 +128,14 @@ void runTest(const std::shared_ptr<iir::StencilInstantiation> stencilInstantiati
   ASSERT_EQ(code, ref) << "Generated code does not match reference code";
 }
 
+void compareToReference(const std::string& file, const std::string& refFile) {
+  std::ifstream f(file);
+  ASSERT_TRUE(f) << "Unable to open " << file;
+  const std::string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+  std::ifstream t(refFile);
+  const std::string ref((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+  ASSERT_EQ(content, ref) << file << " does not match " << refFile;
+}
+
 } // namespace dawn
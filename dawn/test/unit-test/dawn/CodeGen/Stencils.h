@@ -27,4 +27,10 @@ std::shared_ptr<iir::StencilInstantiation> getNonOverlappingInterval();
 void runTest(const std::shared_ptr<dawn::iir::StencilInstantiation> stencilInstantiation,
              codegen::Backend backend, const std::string& ref_file, bool withSync = true);
 
+void runTest(const std::shared_ptr<dawn::iir::StencilInstantiation> stencilInstantiation,
+             codegen::Backend backend, const std::string& ref_file,
+             const codegen::Options& options);
+
+void compareToReference(const std::string& file, const std::string& refFile);
+
 } // namespace dawn
@@ -108,6 +108,8 @@ private:
     }
   };
   static constexpr const char* s_name = "conditional_stencil";
+  static constexpr int s_fields_read = 1;
+  static constexpr int s_fields_written = 1;
   globals m_globals;
   stencil_21 m_stencil_21;
 
@@ -113,6 +113,8 @@ private:
     }
   };
   static constexpr const char* s_name = "generated";
+  static constexpr int s_fields_read = 1;
+  static constexpr int s_fields_written = 1;
   stencil_28 m_stencil_28;
 
 public:
@@ -93,6 +93,8 @@ private:
     }
   };
   static constexpr const char* s_name = "generated";
+  static constexpr int s_fields_read = 1;
+  static constexpr int s_fields_written = 1;
   stencil_47 m_stencil_47;
 
 public:
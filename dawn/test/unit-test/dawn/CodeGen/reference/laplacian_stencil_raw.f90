@@ -0,0 +1,75 @@
+module laplacian_stencil_raw
+use, intrinsic :: iso_c_binding
+implicit none
+  interface
+    subroutine &
+    setup_generated( &
+    isize, &
+    jsize, &
+    ksize, &
+    iminus, &
+    iplus, &
+    jminus, &
+    jplus, &
+    kminus, &
+    kplus &
+    ) bind(c)
+      use, intrinsic :: iso_c_binding
+      integer(c_int), value, target :: isize
+      integer(c_int), value, target :: jsize
+      integer(c_int), value, target :: ksize
+      integer(c_int), value, target :: iminus
+      integer(c_int), value, target :: iplus
+      integer(c_int), value, target :: jminus
+      integer(c_int), value, target :: jplus
+      integer(c_int), value, target :: kminus
+      integer(c_int), value, target :: kplus
+    end subroutine
+    subroutine &
+    run_generated( &
+    in, &
+    in_stride_i, &
+    in_stride_j, &
+    in_stride_k, &
+    out, &
+    out_stride_i, &
+    out_stride_j, &
+    out_stride_k &
+    ) bind(c)
+      use, intrinsic :: iso_c_binding
+      real(c_double), dimension(*), target :: in
+      integer(c_int), value, target :: in_stride_i
+      integer(c_int), value, target :: in_stride_j
+      integer(c_int), value, target :: in_stride_k
+      real(c_double), dimension(*), target :: out
+      integer(c_int), value, target :: out_stride_i
+      integer(c_int), value, target :: out_stride_j
+      integer(c_int), value, target :: out_stride_k
+    end subroutine
+    subroutine &
+    free_generated( ) bind(c)
+      use, intrinsic :: iso_c_binding
+    end subroutine
+  end interface
+  contains
+    subroutine &
+    wrap_run_generated( &
+    in, &
+    out &
+    )
+      use, intrinsic :: iso_c_binding
+      real(c_double), dimension(:,:,:), target :: in
+      real(c_double), dimension(:,:,:), target :: out
+      call run_generated &
+      ( &
+         in, &
+         1, &
+         size(in, 1), &
+         size(in, 1) * size(in, 2), &
+         out, &
+         1, &
+         size(out, 1), &
+         size(out, 1) * size(out, 2) &
+      )
+    end subroutine
+end module
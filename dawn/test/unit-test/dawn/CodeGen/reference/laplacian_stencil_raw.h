@@ -0,0 +1,7 @@
+#pragma once
+#include "driver-includes/defs.hpp"
+extern "C" {
+void setup_generated(int isize, int jsize, int ksize, int iminus, int iplus, int jminus, int jplus, int kminus, int kplus) ;
+void run_generated(::dawn::float_type* in, int in_stride_i, int in_stride_j, int in_stride_k, ::dawn::float_type* out, int out_stride_i, int out_stride_j, int out_stride_k) ;
+void free_generated() ;
+}
@@ -102,6 +102,8 @@ private:
     }
   };
   static constexpr const char* s_name = "generated";
+  static constexpr int s_fields_read = 1;
+  static constexpr int s_fields_written = 1;
   stencil_59 m_stencil_59;
 
 public:
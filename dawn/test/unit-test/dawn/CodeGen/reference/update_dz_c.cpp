@@ -442,6 +442,8 @@ private:
     }
   };
   static constexpr const char* s_name = "update_dz_c";
+  static constexpr int s_fields_read = 9;
+  static constexpr int s_fields_written = 3;
   globals m_globals;
   stencil_443 m_stencil_443;
 
@@ -19,9 +19,12 @@
 #include "dawn/IIR/Extents.h"
 #include "dawn/IIR/FieldAccessMetadata.h"
 #include "dawn/IIR/IIR.h"
+#include "dawn/IIR/IIR/IIR.pb.h"
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/SIR/SIR.h"
 #include "dawn/Serialization/IIRSerializer.h"
+#include "dawn/Serialization/ProtobufIO.h"
+#include "dawn/Support/FileSystem.h"
 #include "dawn/Support/STLExtras.h"
 #include "dawn/Support/Type.h"
 #include "dawn/Unittest/IIRBuilder.h"
@@ -152,6 +155,58 @@ bool compareStencilInstantiations(const std::shared_ptr<iir::StencilInstantiatio
   return true;
 }
 
+bool compareFields(const std::unordered_map<int, iir::Field>& lhs,
+                   const std::unordered_map<int, iir::Field>& rhs) {
+  IIR_EARLY_EXIT((lhs.size() == rhs.size()));
+  for(const auto& [accessID, lhsField] : lhs) {
+    IIR_EARLY_EXIT(rhs.count(accessID));
+    const auto& rhsField = rhs.at(accessID);
+    IIR_EARLY_EXIT((lhsField.getIntend() == rhsField.getIntend()));
+    IIR_EARLY_EXIT((lhsField.getReadExtents() == rhsField.getReadExtents()));
+    IIR_EARLY_EXIT((lhsField.getWriteExtents() == rhsField.getWriteExtents()));
+    IIR_EARLY_EXIT((lhsField.getReadExtentsRB() == rhsField.getReadExtentsRB()));
+    IIR_EARLY_EXIT((lhsField.getWriteExtentsRB() == rhsField.getWriteExtentsRB()));
+    IIR_EARLY_EXIT((lhsField.getInterval() == rhsField.getInterval()));
+    IIR_EARLY_EXIT((lhsField.getFieldDimensions() == rhsField.getFieldDimensions()));
+  }
+  return true;
+}
+
+template <typename NodeType>
+std::vector<const NodeType*> collectNodes(const std::shared_ptr<iir::StencilInstantiation>& si) {
+  std::vector<const NodeType*> nodes;
+  for(const auto& node : iterateIIROver<NodeType>(*si->getIIR()))
+    nodes.push_back(node.get());
+  return nodes;
+}
+
+bool compareDerivedInfo(const std::shared_ptr<iir::StencilInstantiation>& lhs,
+                        const std::shared_ptr<iir::StencilInstantiation>& rhs) {
+  auto lhsStages = collectNodes<iir::Stage>(lhs);
+  auto rhsStages = collectNodes<iir::Stage>(rhs);
+  IIR_EARLY_EXIT((lhsStages.size() == rhsStages.size()));
+  for(std::size_t i = 0; i < lhsStages.size(); ++i) {
+    const auto& lhsDoMethods = lhsStages[i]->getChildren();
+    const auto& rhsDoMethods = rhsStages[i]->getChildren();
+    for(std::size_t j = 0; j < lhsDoMethods.size(); ++j)
+      IIR_EARLY_EXIT(compareFields(lhsDoMethods[j]->getFields(), rhsDoMethods[j]->getFields()));
+    IIR_EARLY_EXIT(compareFields(lhsStages[i]->getFields(), rhsStages[i]->getFields()));
+    IIR_EARLY_EXIT(
+        (lhsStages[i]->getAllGlobalVariables() == rhsStages[i]->getAllGlobalVariables()));
+    IIR_EARLY_EXIT((lhsStages[i]->getExtents() == rhsStages[i]->getExtents()));
+    IIR_EARLY_EXIT((lhsStages[i]->getRequiresSync() == rhsStages[i]->getRequiresSync()));
+  }
+
+  auto lhsMSSs = collectNodes<iir::MultiStage>(lhs);
+  auto rhsMSSs = collectNodes<iir::MultiStage>(rhs);
+  for(std::size_t i = 0; i < lhsMSSs.size(); ++i)
+    IIR_EARLY_EXIT(compareFields(lhsMSSs[i]->getFields(), rhsMSSs[i]->getFields()));
+
+  IIR_EARLY_EXIT((lhs->getIIR()->getFields().size() == rhs->getIIR()->getFields().size()));
+  IIR_EARLY_EXIT((lhs->getIIR()->getStageIDToNameMap() == rhs->getIIR()->getStageIDToNameMap()));
+  return true;
+}
+
 class IIRSerializerTest : public ::testing::Test {
 protected:
   virtual void SetUp() {
@@ -514,4 +569,92 @@ TEST_F(IIRSerializerTest, IterationSpace) {
   IIR_EXPECT_EQ(instantiation, deserialized);
 }
 
+TEST_F(IIRSerializerTest, File) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in_f = b.field("in_f", FieldType::ijk);
+  auto out_f = b.field("out_f", FieldType::ijk);
+
+  auto instantiation =
+      b.build("file", b.stencil(b.multistage(
+                          LoopOrderKind::Parallel,
+                          b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                                             b.stmt(b.assignExpr(b.at(out_f),
+                                                                 b.at(in_f, {1, 0, 0}))))))));
+
+  const std::string file = (fs::temp_directory_path() / "iir_serializer_test.iir").string();
+  for(auto format : {IIRSerializer::Format::Json, IIRSerializer::Format::Byte}) {
+    IIRSerializer::serialize(file, instantiation, format);
+    IIR_EXPECT_EQ(instantiation, IIRSerializer::deserialize(file, format));
+  }
+  fs::remove(file);
+
+  EXPECT_THROW(IIRSerializer::deserialize(file), std::runtime_error);
+
+  // Large messages are printed piecewise, which must not change the JSON output
+  proto::iir::StencilInstantiation protoInstantiation;
+  ASSERT_TRUE(protoInstantiation.ParseFromString(
+      IIRSerializer::serializeToString(instantiation, IIRSerializer::Format::Byte)));
+  std::string whole, piecewise;
+  ASSERT_TRUE(writeProtoAsJson(protoInstantiation, whole).empty());
+  ASSERT_TRUE(writeProtoAsJson(protoInstantiation, piecewise, 0).empty());
+  EXPECT_EQ(whole, piecewise);
+}
+
+TEST_F(IIRSerializerTest, DerivedInfo) {
+  using namespace dawn::iir;
+
+  CartesianIIRBuilder b;
+  auto in_f = b.field("in_f", FieldType::ijk);
+  auto out_f = b.field("out_f", FieldType::ijk);
+  auto tmp_f = b.tmpField("tmp_f", FieldType::ijk);
+
+  auto instantiation = b.build(
+      "derived_info",
+      b.stencil(b.multistage(
+          LoopOrderKind::Forward,
+          b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(tmp_f), b.at(in_f, {1, 0, -1}))))),
+          b.stage(b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out_f), b.at(tmp_f, {0, -2, 0}))))))));
+  instantiation->computeDerivedInfo();
+  for(const auto& stage : iterateIIROver<Stage>(*instantiation->getIIR()))
+    instantiation->getIIR()->getStageIDToNameMap()[stage->getStageID()] =
+        "stage_" + std::to_string(stage->getStageID());
+
+  for(auto format : {IIRSerializer::Format::Json, IIRSerializer::Format::Byte}) {
+    auto recomputed = IIRSerializer::deserializeFromString(
+        IIRSerializer::serializeToString(instantiation, format), format);
+    auto restored = IIRSerializer::deserializeFromString(
+        IIRSerializer::serializeToString(instantiation, format, true), format);
+    IIR_EXPECT_EQ(instantiation, restored);
+    EXPECT_TRUE(compareDerivedInfo(instantiation, restored));
+
+    // The stage names are not recomputed on deserialization
+    recomputed->getIIR()->getStageIDToNameMap() = instantiation->getIIR()->getStageIDToNameMap();
+    EXPECT_TRUE(compareDerivedInfo(recomputed, restored));
+  }
+
+  // The derived information is used as is if the checksum matches ...
+  proto::iir::StencilInstantiation protoInstantiation;
+  ASSERT_TRUE(protoInstantiation.ParseFromString(
+      IIRSerializer::serializeToString(instantiation, IIRSerializer::Format::Byte, true)));
+  protoInstantiation.mutable_derivedinfo()
+      ->mutable_stencils(0)
+      ->mutable_multistages(0)
+      ->mutable_stages(0)
+      ->set_requiressync(true);
+  auto restored = IIRSerializer::deserializeFromString(protoInstantiation.SerializeAsString(),
+                                                       IIRSerializer::Format::Byte);
+  EXPECT_TRUE(restored->getStencils()[0]->getStage(0)->getRequiresSync());
+
+  // ... and recomputed if the IIR was modified after serialization
+  protoInstantiation.mutable_metadata()->set_stencilname("modified_derived_info");
+  auto recomputed = IIRSerializer::deserializeFromString(protoInstantiation.SerializeAsString(),
+                                                         IIRSerializer::Format::Byte);
+  EXPECT_FALSE(recomputed->getStencils()[0]->getStage(0)->getRequiresSync());
+  EXPECT_TRUE(recomputed->getIIR()->getStageIDToNameMap().empty());
+}
+
 } // anonymous namespace
@@ -0,0 +1,183 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/CodeGen/Driver.h"
+#include "dawn/IIR/ASTExpr.h"
+#include "dawn/IIR/IIRNodeIterator.h"
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Optimizer/PassConstantFolding.h"
+#include "dawn/Unittest/IIRBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace dawn;
+
+namespace {
+
+const iir::DoMethod& getFirstDoMethod(const iir::StencilInstantiation& instantiation) {
+  return **iterateIIROver<iir::DoMethod>(*instantiation.getIIR()).begin();
+}
+
+TEST(TestPassConstantFolding, DeadStageRemoved) {
+  using namespace dawn::iir;
+
+  /// stencil {
+  ///   stage_1 { if(false) out1 = in1; }
+  ///   stage_2 { out2 = in2; }
+  /// }
+  CartesianIIRBuilder b;
+  auto in1 = b.field("in1");
+  auto out1 = b.field("out1");
+  auto in2 = b.field("in2");
+  auto out2 = b.field("out2");
+
+  auto instantiation = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.ifStmt(b.lit(false), b.block(b.stmt(b.assignExpr(
+                                                         b.at(out1, AccessType::rw), b.at(in1))))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out2, AccessType::rw), b.at(in2))))))));
+
+  PassConstantFolding pass;
+  ASSERT_TRUE(pass.run(instantiation));
+
+  const auto& stencil = *instantiation->getStencils()[0];
+  ASSERT_EQ(stencil.getChildren().size(), 1);
+  ASSERT_EQ(stencil.getChildren().front()->getChildren().size(), 1);
+  ASSERT_EQ(stencil.getFields().count(in1.id), 0);
+  ASSERT_EQ(stencil.getFields().count(out1.id), 0);
+  ASSERT_EQ(stencil.getFields().count(in2.id), 1);
+}
+
+TEST(TestPassConstantFolding, DeadStencilRemoved) {
+  using namespace dawn::iir;
+
+  /// stencil_1 { if(false) tmp = in; }
+  /// stencil_2 { out = in; }
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto tmp = b.field("tmp");
+  auto out = b.field("out");
+
+  std::vector<std::unique_ptr<Stencil>> stencils;
+  stencils.push_back(b.stencil(b.multistage(
+      LoopOrderKind::Parallel,
+      b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                         b.ifStmt(b.lit(false), b.block(b.stmt(b.assignExpr(
+                                                    b.at(tmp, AccessType::rw), b.at(in))))))))));
+  stencils.push_back(b.stencil(b.multistage(
+      LoopOrderKind::Parallel,
+      b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                         b.stmt(b.assignExpr(b.at(out, AccessType::rw), b.at(in))))))));
+  const int deadID = stencils[0]->getStencilID();
+  const int liveID = stencils[1]->getStencilID();
+  auto instantiation = b.build("generated", std::move(stencils));
+
+  PassConstantFolding pass;
+  ASSERT_TRUE(pass.run(instantiation));
+
+  ASSERT_EQ(instantiation->getStencils().size(), 1);
+  ASSERT_EQ(instantiation->getStencils()[0]->getStencilID(), liveID);
+  ASSERT_EQ(instantiation->getIIR()->getControlFlowDescriptor().getStatements().size(), 1);
+  const auto& stencilIDToCall = instantiation->getMetaData().getStencilIDToStencilCallMap();
+  ASSERT_FALSE(stencilIDToCall.directHas(deadID));
+  ASSERT_TRUE(stencilIDToCall.directHas(liveID));
+
+  // the generated code neither declares nor calls the removed stencil
+  const std::regex deadName("stencil_" + std::to_string(deadID) + "\\b");
+  const std::string liveName = "stencil_" + std::to_string(liveID);
+  for(auto backend : {codegen::Backend::CXXNaive, codegen::Backend::CXXOpt}) {
+    const std::string code = codegen::generate(codegen::run(instantiation, backend));
+    ASSERT_FALSE(std::regex_search(code, deadName));
+    ASSERT_NE(code.find("m_" + liveName + ".run("), std::string::npos);
+  }
+}
+
+TEST(TestPassConstantFolding, ElseBranchInlined) {
+  using namespace dawn::iir;
+
+  /// stencil { if(1 > 2) out = in1; else out = in2; }
+  CartesianIIRBuilder b;
+  auto in1 = b.field("in1");
+  auto in2 = b.field("in2");
+  auto out = b.field("out");
+
+  auto instantiation = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.ifStmt(b.binaryExpr(b.lit(1), b.lit(2), Op::greater),
+                       b.block(b.stmt(b.assignExpr(b.at(out, AccessType::rw), b.at(in1)))),
+                       b.block(b.stmt(b.assignExpr(b.at(out, AccessType::rw), b.at(in2))))))))));
+
+  PassConstantFolding pass;
+  ASSERT_TRUE(pass.run(instantiation));
+
+  const auto& statements = getFirstDoMethod(*instantiation).getAST().getStatements();
+  ASSERT_EQ(statements.size(), 1);
+  ASSERT_EQ(statements[0]->getKind(), ast::Stmt::Kind::ExprStmt);
+  const auto& fields = instantiation->getStencils()[0]->getFields();
+  ASSERT_EQ(fields.count(in1.id), 0);
+  ASSERT_EQ(fields.count(in2.id), 1);
+}
+
+TEST(TestPassConstantFolding, FoldArithmetic) {
+  using namespace dawn::iir;
+
+  /// stencil { out = in * (2.0 + 0.5) + 7 / 2; }
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out = b.field("out");
+
+  auto instantiation = b.build(
+      "generated",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(
+                  b.at(out, AccessType::rw),
+                  b.binaryExpr(b.binaryExpr(b.at(in), b.binaryExpr(b.lit(2.0), b.lit(0.5)),
+                                            Op::multiply),
+                               b.binaryExpr(b.lit(7), b.lit(2), Op::divide)))))))));
+
+  PassConstantFolding pass;
+  ASSERT_TRUE(pass.run(instantiation));
+
+  const auto& stmt = getFirstDoMethod(*instantiation).getAST().getStatements()[0];
+  const auto& rhs = std::static_pointer_cast<ast::AssignmentExpr>(
+                        std::static_pointer_cast<ast::ExprStmt>(stmt)->getExpr())
+                        ->getRight();
+  const auto& sum = std::static_pointer_cast<ast::BinaryOperator>(rhs);
+
+  const auto& product = std::static_pointer_cast<ast::BinaryOperator>(sum->getLeft());
+  const auto factor = std::dynamic_pointer_cast<ast::LiteralAccessExpr>(product->getRight());
+  ASSERT_TRUE(factor);
+  ASSERT_EQ(factor->getValue(), "2.5");
+  ASSERT_EQ(factor->getBuiltinType(), BuiltinTypeID::Double);
+
+  // integer division is left to the compiler
+  ASSERT_EQ(sum->getRight()->getKind(), ast::Expr::Kind::BinaryOperator);
+}
+
+} // namespace
@@ -16,8 +16,12 @@
 #include "dawn/IIR/StencilInstantiation.h"
 #include "dawn/Optimizer/PassSetDependencyGraph.h"
 #include "dawn/Optimizer/PassSetStageGraph.h"
+#include "dawn/Optimizer/PassSetStageLocationType.h"
 #include "dawn/Optimizer/PassStageMerger.h"
+#include "dawn/Optimizer/PassStageReordering.h"
+#include "dawn/Optimizer/PassStageSplitAllStatements.h"
 #include "dawn/Serialization/IIRSerializer.h"
+#include "dawn/Unittest/IIRBuilder.h"
 
 #include <fstream>
 #include <gtest/gtest.h>
@@ -71,6 +75,34 @@ protected:
       stencilIdx += 1;
     }
   }
+
+  // Splits all statements into stages (as the lowering of unstructured stencils does), reorders
+  // and merges them. Returns the number of stages of each multi-stage.
+  std::vector<unsigned>
+  runUnstructuredTest(const std::shared_ptr<iir::StencilInstantiation>& instantiation) {
+    PassStageSplitAllStatements stageSplitPass;
+    EXPECT_TRUE(stageSplitPass.run(instantiation, options_));
+    PassSetStageLocationType stageLocationTypePass;
+    EXPECT_TRUE(stageLocationTypePass.run(instantiation, options_));
+
+    PassSetStageGraph stageGraphPass;
+    PassSetDependencyGraph dependencyGraphPass;
+    EXPECT_TRUE(stageGraphPass.run(instantiation, options_));
+    EXPECT_TRUE(dependencyGraphPass.run(instantiation, options_));
+    PassStageReordering stageReorderPass(ReorderStrategy::Kind::Greedy);
+    EXPECT_TRUE(stageReorderPass.run(instantiation, options_));
+
+    EXPECT_TRUE(stageGraphPass.run(instantiation, options_));
+    EXPECT_TRUE(dependencyGraphPass.run(instantiation, options_));
+    PassStageMerger stageMergerPass;
+    EXPECT_TRUE(stageMergerPass.run(instantiation, options_));
+
+    std::vector<unsigned> nStages;
+    for(const auto& stencil : instantiation->getStencils())
+      for(const auto& multiStage : stencil->getChildren())
+        nStages.push_back(multiStage->getChildren().size());
+    return nStages;
+  }
 };
 
 TEST_F(TestPassStageMerger, MergerTest1) {
@@ -188,4 +220,151 @@ TEST_F(TestPassStageMerger, MergerTestUnstrDependent) {
   runTest("input/StageMergerTestDependent.iir", 1, {1}, {3}, {1, 1, 1});
 }
 
+TEST_F(TestPassStageMerger, MergerTestUnstrDiffusion) {
+  // diffusion sample of the unstructured integration tests, the four statements end up in a single
+  // loop over cells:
+  //   var cnt;
+  //   cnt = sum_over(Cell > Edge > Cell, 1)
+  //   out = sum_over(Cell > Edge > Cell, in[Cell > Edge > Cell], init = -cnt * in)
+  //   out = in + 0.1 * out
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  UnstructuredIIRBuilder b;
+  auto in_f = b.field("in_field", LocType::Cells);
+  auto out_f = b.field("out_field", LocType::Cells);
+  auto cnt = b.localvar("cnt", dawn::BuiltinTypeID::Integer, {}, LocalVariableType::OnCells);
+
+  auto instantiation = b.build(
+      "diffusion",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Cells,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.declareVar(cnt),
+                             b.stmt(b.assignExpr(
+                                 b.at(cnt), b.reduceOverNeighborExpr(
+                                                Op::plus, b.lit(1), b.lit(0),
+                                                {LocType::Cells, LocType::Edges, LocType::Cells}))),
+                             b.stmt(b.assignExpr(
+                                 b.at(out_f),
+                                 b.reduceOverNeighborExpr(
+                                     Op::plus, b.at(in_f, HOffsetType::withOffset, 0),
+                                     b.binaryExpr(b.unaryExpr(b.at(cnt), Op::minus),
+                                                  b.at(in_f, HOffsetType::noOffset, 0),
+                                                  Op::multiply),
+                                     {LocType::Cells, LocType::Edges, LocType::Cells}))),
+                             b.stmt(b.assignExpr(
+                                 b.at(out_f),
+                                 b.binaryExpr(b.at(in_f),
+                                              b.binaryExpr(b.lit(0.1), b.at(out_f), Op::multiply),
+                                              Op::plus))))))));
+
+  ASSERT_EQ(runUnstructuredTest(instantiation), std::vector<unsigned>{1});
+}
+
+TEST_F(TestPassStageMerger, MergerTestUnstrReorderDependent) {
+  // same as MergerTestUnstrDependent, but with stage reordering the independent stage on cells is
+  // moved out of the way and the two stages on edges are merged:
+  //   eout0 = sum_over(Edge > Cell > Edge, ein0[Edge > Cell > Edge])
+  //   cout0 = sum_over(Cell > Edge > Cell, cin0[Cell > Edge > Cell])
+  //   eout1 = sum_over(Edge > Cell, cout0)
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  UnstructuredIIRBuilder b;
+  auto ein0 = b.field("ein0", LocType::Edges);
+  auto eout0 = b.field("eout0", LocType::Edges);
+  auto eout1 = b.field("eout1", LocType::Edges);
+  auto cin0 = b.field("cin0", LocType::Cells);
+  auto cout0 = b.field("cout0", LocType::Cells);
+
+  auto instantiation = b.build(
+      "reorderDependent",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              dawn::ast::Interval::Start, dawn::ast::Interval::End,
+              b.stmt(b.assignExpr(b.at(eout0),
+                                  b.reduceOverNeighborExpr(
+                                      Op::plus, b.at(ein0, HOffsetType::withOffset, 0), b.lit(0.),
+                                      {LocType::Edges, LocType::Cells, LocType::Edges}))),
+              b.stmt(b.assignExpr(b.at(cout0),
+                                  b.reduceOverNeighborExpr(
+                                      Op::plus, b.at(cin0, HOffsetType::withOffset, 0), b.lit(0.),
+                                      {LocType::Cells, LocType::Edges, LocType::Cells}))),
+              b.stmt(b.assignExpr(b.at(eout1),
+                                  b.reduceOverNeighborExpr(
+                                      Op::plus, b.at(cout0, HOffsetType::withOffset, 0), b.lit(0.),
+                                      {LocType::Edges, LocType::Cells}))))))));
+
+  ASSERT_EQ(runUnstructuredTest(instantiation), std::vector<unsigned>{2});
+  const auto& stages = instantiation->getStencils()[0]->getChild(0)->getChildren();
+  ASSERT_EQ(stages.front()->getLocationType(), LocType::Cells);
+  ASSERT_EQ(stages.back()->getLocationType(), LocType::Edges);
+}
+
+TEST_F(TestPassStageMerger, MergerTestUnstrGradient) {
+  // gradient sample of the unstructured integration tests, the loops over edges and cells can not
+  // be merged:
+  //   edge_field = sum_over(Edge > Cell, cell_field[Edge > Cell], weights = [1, -1])
+  //   cell_field = sum_over(Cell > Edge, edge_field[Cell > Edge], weights = [0.5, 0, 0, 0.5])
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  UnstructuredIIRBuilder b;
+  auto cell_f = b.field("cell_field", LocType::Cells);
+  auto edge_f = b.field("edge_field", LocType::Edges);
+
+  auto instantiation = b.build(
+      "gradient",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Edges,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(
+                                 b.at(edge_f),
+                                 b.reduceOverNeighborExpr<float>(
+                                     Op::plus, b.at(cell_f, HOffsetType::withOffset, 0), b.lit(0.),
+                                     {LocType::Edges, LocType::Cells},
+                                     std::vector<float>({1., -1.})))))),
+          b.stage(LocType::Cells,
+                  b.doMethod(dawn::ast::Interval::Start, dawn::ast::Interval::End,
+                             b.stmt(b.assignExpr(
+                                 b.at(cell_f),
+                                 b.reduceOverNeighborExpr<float>(
+                                     Op::plus, b.at(edge_f, HOffsetType::withOffset, 0), b.lit(0.),
+                                     {LocType::Cells, LocType::Edges},
+                                     std::vector<float>({0.5, 0., 0., 0.5})))))))));
+
+  ASSERT_EQ(runUnstructuredTest(instantiation), std::vector<unsigned>{2});
+}
+
+TEST_F(TestPassStageMerger, MergerTestUnstrNeighborWriteAfterRead) {
+  // the second statement writes a field read on the neighbors by the first one, they can not share
+  // a loop over cells:
+  //   cout = sum_over(Cell > Edge > Cell, cin[Cell > Edge > Cell])
+  //   cin = 1
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  UnstructuredIIRBuilder b;
+  auto cin = b.field("cin", LocType::Cells);
+  auto cout = b.field("cout", LocType::Cells);
+
+  auto instantiation = b.build(
+      "neighborWriteAfterRead",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              dawn::ast::Interval::Start, dawn::ast::Interval::End,
+              b.stmt(b.assignExpr(b.at(cout),
+                                  b.reduceOverNeighborExpr(
+                                      Op::plus, b.at(cin, HOffsetType::withOffset, 0), b.lit(0.),
+                                      {LocType::Cells, LocType::Edges, LocType::Cells}))),
+              b.stmt(b.assignExpr(b.at(cin), b.lit(1.))))))));
+
+  ASSERT_EQ(runUnstructuredTest(instantiation), std::vector<unsigned>{2});
+}
+
 } // anonymous namespace
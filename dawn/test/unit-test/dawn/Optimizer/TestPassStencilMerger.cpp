@@ -0,0 +1,159 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Optimizer/PassDataLocalityMetric.h"
+#include "dawn/Optimizer/PassStencilMerger.h"
+#include "dawn/Optimizer/PassTemporaryType.h"
+#include "dawn/Unittest/IIRBuilder.h"
+
+#include <gtest/gtest.h>
+
+using namespace dawn;
+
+namespace {
+
+// stencil { vertical_region(k_start, k_end) { lhs = rhs; } }
+std::unique_ptr<iir::Stencil> makeAssignmentStencil(iir::CartesianIIRBuilder& b,
+                                                    std::shared_ptr<ast::Expr> lhs,
+                                                    std::shared_ptr<ast::Expr> rhs) {
+  return b.stencil(b.multistage(iir::LoopOrderKind::Parallel,
+                                b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                                   b.stmt(b.assignExpr(std::move(lhs),
+                                                                       std::move(rhs)))))));
+}
+
+std::shared_ptr<iir::StencilInstantiation> buildTwoStencils(iir::CartesianIIRBuilder& b,
+                                                            std::unique_ptr<iir::Stencil> first,
+                                                            std::unique_ptr<iir::Stencil> second) {
+  std::vector<std::unique_ptr<iir::Stencil>> stencils;
+  stencils.push_back(std::move(first));
+  stencils.push_back(std::move(second));
+  auto instantiation = b.build("generated", std::move(stencils));
+  // temporaries used by both stencils are allocated by the stencil wrapper
+  PassTemporaryType::fixTemporariesSpanningMultipleStencils(instantiation.get(),
+                                                            instantiation->getStencils());
+  return instantiation;
+}
+
+TEST(TestPassStencilMerger, PointwiseConsumer) {
+  using namespace dawn::iir;
+
+  /// stencil_1 { out1 = in; }
+  /// stencil_2 { out2 = out1; }
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out1 = b.field("out1");
+  auto out2 = b.field("out2");
+
+  auto instantiation =
+      buildTwoStencils(b, makeAssignmentStencil(b, b.at(out1, AccessType::rw), b.at(in)),
+                       makeAssignmentStencil(b, b.at(out2, AccessType::rw), b.at(out1)));
+  ASSERT_EQ(computeInterStencilTraffic(*instantiation), 1);
+
+  PassStencilMerger pass;
+  ASSERT_TRUE(pass.run(instantiation));
+
+  ASSERT_EQ(instantiation->getStencils().size(), 1);
+  ASSERT_EQ(instantiation->getStencils()[0]->getChildren().size(), 2);
+  ASSERT_EQ(instantiation->getIIR()->getControlFlowDescriptor().getStatements().size(), 1);
+  ASSERT_EQ(instantiation->getMetaData().getStencilCallToStencilIDMap().size(), 1);
+  ASSERT_EQ(computeInterStencilTraffic(*instantiation), 0);
+}
+
+TEST(TestPassStencilMerger, TemporaryWithOffset) {
+  using namespace dawn::iir;
+
+  /// stencil_1 { tmp = in; }
+  /// stencil_2 { out = tmp(i+1); }
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out = b.field("out");
+  auto tmp = b.tmpField("tmp");
+
+  auto instantiation =
+      buildTwoStencils(b, makeAssignmentStencil(b, b.at(tmp, AccessType::rw), b.at(in)),
+                       makeAssignmentStencil(b, b.at(out, AccessType::rw), b.at(tmp, {1, 0, 0})));
+  ASSERT_TRUE(instantiation->getMetaData().isAccessType(
+      iir::FieldAccessType::InterStencilTemporary, tmp.id));
+
+  PassStencilMerger pass;
+  ASSERT_TRUE(pass.run(instantiation));
+
+  ASSERT_EQ(instantiation->getStencils().size(), 1);
+  ASSERT_TRUE(
+      instantiation->getMetaData().isAccessType(iir::FieldAccessType::StencilTemporary, tmp.id));
+  ASSERT_TRUE(instantiation->getStencils()[0]->getFields().at(tmp.id).IsTemporary);
+
+  // the producer of tmp is computed redundantly in the halo of the consumer
+  const auto& producer = *instantiation->getStencils()[0]->getStage(0);
+  const auto& extents =
+      iir::extent_cast<iir::CartesianExtent const&>(producer.getExtents().horizontalExtent());
+  ASSERT_EQ(extents.iPlus(), 1);
+}
+
+TEST(TestPassStencilMerger, ApiFieldWithOffset) {
+  using namespace dawn::iir;
+
+  /// stencil_1 { out1 = in; }
+  /// stencil_2 { out2 = out1(i+1); }
+  ///
+  /// merging would compute out1 in the halo, i.e. overwrite values visible to the user
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out1 = b.field("out1");
+  auto out2 = b.field("out2");
+
+  auto instantiation =
+      buildTwoStencils(b, makeAssignmentStencil(b, b.at(out1, AccessType::rw), b.at(in)),
+                       makeAssignmentStencil(b, b.at(out2, AccessType::rw), b.at(out1, {1, 0, 0})));
+
+  PassStencilMerger pass;
+  ASSERT_TRUE(pass.run(instantiation));
+
+  ASSERT_EQ(instantiation->getStencils().size(), 2);
+  ASSERT_EQ(instantiation->getIIR()->getControlFlowDescriptor().getStatements().size(), 2);
+  const auto& producer = *instantiation->getStencils()[0]->getStage(0);
+  ASSERT_TRUE(producer.getExtents().isHorizontalPointwise());
+}
+
+TEST(TestPassStencilMerger, ExceedsMaxHaloPoints) {
+  using namespace dawn::iir;
+
+  /// stencil_1 { tmp = in(i+1); }
+  /// stencil_2 { out = tmp(i+1); }
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto out = b.field("out");
+  auto tmp = b.tmpField("tmp");
+
+  auto instantiation =
+      buildTwoStencils(b, makeAssignmentStencil(b, b.at(tmp, AccessType::rw), b.at(in, {1, 0, 0})),
+                       makeAssignmentStencil(b, b.at(out, AccessType::rw), b.at(tmp, {1, 0, 0})));
+
+  dawn::Options options;
+  options.MaxHaloPoints = 1;
+  PassStencilMerger pass;
+  ASSERT_TRUE(pass.run(instantiation, options));
+
+  ASSERT_EQ(instantiation->getStencils().size(), 2);
+  ASSERT_TRUE(instantiation->getMetaData().isAccessType(
+      iir::FieldAccessType::InterStencilTemporary, tmp.id));
+
+  options.MaxHaloPoints = 2;
+  ASSERT_TRUE(pass.run(instantiation, options));
+  ASSERT_EQ(instantiation->getStencils().size(), 1);
+}
+
+} // namespace
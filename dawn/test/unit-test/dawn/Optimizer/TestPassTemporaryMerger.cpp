@@ -15,10 +15,12 @@
 #include "dawn/IIR/ASTMatcher.h"
 #include "dawn/IIR/IIR.h"
 #include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Optimizer/PassSetDependencyGraph.h"
 #include "dawn/Optimizer/PassSetStageGraph.h"
 #include "dawn/Optimizer/PassStageSplitter.h"
 #include "dawn/Optimizer/PassTemporaryMerger.h"
 #include "dawn/Serialization/IIRSerializer.h"
+#include "dawn/Unittest/IIRBuilder.h"
 
 #include <fstream>
 #include <gtest/gtest.h>
@@ -27,6 +29,20 @@ using namespace dawn;
 
 namespace {
 
+std::unordered_set<std::string> getAccessedFieldNames(iir::StencilInstantiation* instantiation) {
+  // Apply AST matcher to find all field access expressions
+  dawn::iir::ASTMatcher matcher(instantiation);
+  std::vector<std::shared_ptr<ast::Expr>>& accessExprs =
+      matcher.match(ast::Expr::Kind::FieldAccessExpr);
+
+  std::unordered_set<std::string> fieldNames;
+  for(const auto& accessExpr : accessExprs) {
+    const auto& fieldAccessExpr = std::dynamic_pointer_cast<ast::FieldAccessExpr>(accessExpr);
+    fieldNames.insert(fieldAccessExpr->getName());
+  }
+  return fieldNames;
+}
+
 class TestPassTemporaryMerger : public ::testing::Test {
 protected:
   explicit TestPassTemporaryMerger() { UIDGenerator::getInstance()->reset(); }
@@ -45,16 +61,7 @@ protected:
     EXPECT_TRUE(tempMergerPass.run(instantiation));
 
     if(mergedFields.size() > 0) {
-      // Apply AST matcher to find all field access expressions
-      dawn::iir::ASTMatcher matcher(instantiation.get());
-      std::vector<std::shared_ptr<ast::Expr>>& accessExprs =
-          matcher.match(ast::Expr::Kind::FieldAccessExpr);
-
-      std::unordered_set<std::string> fieldNames;
-      for(const auto& accessExpr : accessExprs) {
-        const auto& fieldAccessExpr = std::dynamic_pointer_cast<ast::FieldAccessExpr>(accessExpr);
-        fieldNames.insert(fieldAccessExpr->getName());
-      }
+      std::unordered_set<std::string> fieldNames = getAccessedFieldNames(instantiation.get());
 
       // Assert that merged fields are no longer accessed
       for(const auto& mergedField : mergedFields) {
@@ -123,4 +130,117 @@ TEST_F(TestPassTemporaryMerger, MergeTest5) {
   runTest("input/MergeTest05.iir", {"tmp_2", "tmp_3", "tmp_4", "tmp_5"});
 }
 
+TEST_F(TestPassTemporaryMerger, MergeUnstructured) {
+  /*
+    tmp_s(Cells > Edges) = 2;
+    tmp_a(Cells) = reduce(Cells > Edges, tmp_s * in);
+    out_a = tmp_a + 1;
+    tmp_e(Edges) = 1;
+    tmp_b(Cells) = reduce(Cells > Edges, tmp_e);
+    out_b = tmp_b; */
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  UnstructuredIIRBuilder b;
+  auto in = b.field("in", LocType::Cells);
+  auto out_a = b.field("out_a", LocType::Cells);
+  auto out_b = b.field("out_b", LocType::Cells);
+  auto tmp_s = b.tmpField("tmp_s", {LocType::Cells, LocType::Edges});
+  auto tmp_a = b.tmpField("tmp_a", LocType::Cells);
+  auto tmp_e = b.tmpField("tmp_e", LocType::Edges);
+  auto tmp_b = b.tmpField("tmp_b", LocType::Cells);
+
+  auto instantiation = b.build(
+      "merge_unstructured",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Cells,
+                  b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.loopStmtChain(b.stmt(b.assignExpr(b.at(tmp_s), b.lit(2.))),
+                                             {LocType::Cells, LocType::Edges}))),
+          b.stage(LocType::Cells,
+                  b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(
+                                 b.at(tmp_a),
+                                 b.reduceOverNeighborExpr(
+                                     Op::plus, b.binaryExpr(b.at(tmp_s), b.at(in), Op::multiply),
+                                     b.lit(0.), {LocType::Cells, LocType::Edges}))))),
+          b.stage(LocType::Cells, b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                             b.stmt(b.assignExpr(
+                                                 b.at(out_a),
+                                                 b.binaryExpr(b.at(tmp_a), b.lit(1.)))))),
+          b.stage(LocType::Edges, b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                             b.stmt(b.assignExpr(b.at(tmp_e), b.lit(1.))))),
+          b.stage(LocType::Cells,
+                  b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(tmp_b), b.reduceOverNeighborExpr(
+                                                                  Op::plus, b.at(tmp_e), b.lit(0.),
+                                                                  {LocType::Cells, LocType::Edges}))))),
+          b.stage(LocType::Cells, b.doMethod(ast::Interval::Start, ast::Interval::End,
+                                             b.stmt(b.assignExpr(b.at(out_b), b.at(tmp_b))))))));
+
+  PassSetDependencyGraph dependencyGraphPass;
+  EXPECT_TRUE(dependencyGraphPass.run(instantiation));
+
+  PassTemporaryMerger tempMergerPass;
+  EXPECT_TRUE(tempMergerPass.run(instantiation));
+
+  // Only the dense cell temporaries share their storage, tmp_e and tmp_s have other dimensions
+  std::unordered_set<std::string> fieldNames = getAccessedFieldNames(instantiation.get());
+  EXPECT_FALSE(fieldNames.count("tmp_b"));
+  EXPECT_TRUE(fieldNames.count("tmp_a"));
+  EXPECT_TRUE(fieldNames.count("tmp_e"));
+  EXPECT_TRUE(fieldNames.count("tmp_s"));
+  EXPECT_EQ(instantiation->getMetaData()
+                .getAccessesOfType<iir::FieldAccessType::StencilTemporary>()
+                .size(),
+            3);
+}
+
+TEST_F(TestPassTemporaryMerger, NoMergeOfVerticalDependencies) {
+  /*
+    vertical_region(k_start + 1, k_end) { // forward
+      tmp_a = tmp_a[k - 1] + in;
+      out_a = tmp_a;
+      tmp_b = in;
+      out_b = tmp_b;
+    } */
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  UnstructuredIIRBuilder b;
+  auto in = b.field("in", LocType::Cells);
+  auto out_a = b.field("out_a", LocType::Cells);
+  auto out_b = b.field("out_b", LocType::Cells);
+  auto tmp_a = b.tmpField("tmp_a", LocType::Cells);
+  auto tmp_b = b.tmpField("tmp_b", LocType::Cells);
+
+  auto instantiation = b.build(
+      "no_merge_vertical",
+      b.stencil(b.multistage(
+          LoopOrderKind::Forward,
+          b.stage(LocType::Cells,
+                  b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                             b.stmt(b.assignExpr(
+                                 b.at(tmp_a),
+                                 b.binaryExpr(b.at(tmp_a, HOffsetType::noOffset, -1), b.at(in)))))),
+          b.stage(LocType::Cells, b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                                             b.stmt(b.assignExpr(b.at(out_a), b.at(tmp_a))))),
+          b.stage(LocType::Cells, b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                                             b.stmt(b.assignExpr(b.at(tmp_b), b.at(in))))),
+          b.stage(LocType::Cells, b.doMethod(ast::Interval::Start, ast::Interval::End, 1, 0,
+                                             b.stmt(b.assignExpr(b.at(out_b), b.at(tmp_b))))))));
+
+  PassSetDependencyGraph dependencyGraphPass;
+  EXPECT_TRUE(dependencyGraphPass.run(instantiation));
+
+  PassTemporaryMerger tempMergerPass;
+  EXPECT_TRUE(tempMergerPass.run(instantiation));
+
+  // tmp_b would overwrite the level of tmp_a read by the next level
+  std::unordered_set<std::string> fieldNames = getAccessedFieldNames(instantiation.get());
+  EXPECT_TRUE(fieldNames.count("tmp_a"));
+  EXPECT_TRUE(fieldNames.count("tmp_b"));
+}
+
 } // anonymous namespace
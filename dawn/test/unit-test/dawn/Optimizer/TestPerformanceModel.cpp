@@ -0,0 +1,179 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/IIR/StencilInstantiation.h"
+#include "dawn/Optimizer/PerformanceModel.h"
+#include "dawn/Unittest/IIRBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace dawn;
+
+namespace {
+
+MachineModel makeMachine(double cacheSize) {
+  MachineModel machine;
+  machine.MemoryBandwidth = 1.0e4;
+  machine.PeakFlops = 1.0e3;
+  machine.CacheSize = cacheSize;
+  machine.BytesPerValue = 8;
+  machine.DomainSize = {10, 10, 4};
+  return machine;
+}
+
+std::shared_ptr<iir::StencilInstantiation> makeTwoStageStencil() {
+  using namespace dawn::iir;
+
+  // tmp = in * in + in; out = tmp + in;
+  CartesianIIRBuilder b;
+  auto in = b.field("in");
+  auto tmp = b.field("tmp");
+  auto out = b.field("out");
+  return b.build(
+      "two_stages",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(b.doMethod(
+              ast::Interval::Start, ast::Interval::End,
+              b.stmt(b.assignExpr(
+                  b.at(tmp, AccessType::rw),
+                  b.binaryExpr(b.binaryExpr(b.at(in), b.at(in), Op::multiply), b.at(in)))))),
+          b.stage(b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(b.at(out, AccessType::rw),
+                                                 b.binaryExpr(b.at(tmp), b.at(in)))))))));
+}
+
+TEST(PerformanceModel, Stages) {
+  auto instantiation = makeTwoStageStencil();
+  const PerformanceModel model(*instantiation, makeMachine(1.0e6));
+  const iir::MultiStage& multiStage = *instantiation->getStencils()[0]->getChildren().front();
+
+  // 400 grid points, two FLOPs and two fields (of 8 bytes) per point
+  const PerformanceEstimate first = model.estimate(**multiStage.getChildren().begin());
+  EXPECT_DOUBLE_EQ(first.Flops, 800);
+  EXPECT_DOUBLE_EQ(first.Bytes, 6400);
+  EXPECT_DOUBLE_EQ(first.arithmeticIntensity(), 0.125);
+  EXPECT_DOUBLE_EQ(first.Runtime, 0.8);
+  EXPECT_FALSE(first.isMemoryBound(model.getMachine()));
+
+  const PerformanceEstimate second = model.estimate(**std::next(multiStage.getChildren().begin()));
+  EXPECT_DOUBLE_EQ(second.Flops, 400);
+  EXPECT_DOUBLE_EQ(second.Bytes, 9600);
+  EXPECT_TRUE(second.isMemoryBound(model.getMachine()));
+}
+
+TEST(PerformanceModel, CacheReuse) {
+  auto instantiation = makeTwoStageStencil();
+  const iir::Stencil& stencil = *instantiation->getStencils()[0];
+  const iir::MultiStage& multiStage = *stencil.getChildren().front();
+
+  // in and out once, tmp is stored and loaded again
+  const PerformanceModel cached(*instantiation, makeMachine(1.0e6));
+  EXPECT_DOUBLE_EQ(cached.estimate(multiStage).Flops, 1200);
+  EXPECT_DOUBLE_EQ(cached.estimate(multiStage).Bytes, 12800);
+  EXPECT_DOUBLE_EQ(cached.estimate(multiStage).Runtime, 1.28);
+  EXPECT_DOUBLE_EQ(cached.estimate(stencil).Runtime, 1.28);
+
+  // a level of the fields doesn't fit into the cache, every stage loads its fields
+  const PerformanceModel uncached(*instantiation, makeMachine(1000));
+  EXPECT_DOUBLE_EQ(uncached.estimate(multiStage).Bytes, 16000);
+
+  const json::json node = cached.jsonDump();
+  EXPECT_EQ(node["name"], "two_stages");
+  EXPECT_EQ(node["stencils"].size(), 1);
+  EXPECT_EQ(node["stencils"][0]["multistages"][0]["stages"].size(), 2);
+  EXPECT_DOUBLE_EQ(node["total"]["bytes"].get<double>(), 12800);
+  EXPECT_EQ(node["total"]["memory_bound"], true);
+}
+
+TEST(PerformanceModel, Reduction) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // out = reduce(Cells > Edges, in * 2)
+  UnstructuredIIRBuilder b;
+  auto out = b.field("out", LocType::Cells);
+  auto in = b.field("in", LocType::Edges);
+  auto instantiation = b.build(
+      "reduction",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Cells,
+                  b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(
+                                 b.at(out),
+                                 b.reduceOverNeighborExpr(
+                                     Op::plus, b.binaryExpr(b.at(in), b.lit(2.), Op::multiply),
+                                     b.lit(0.), {LocType::Cells, LocType::Edges}))))))));
+
+  MachineModel machine = makeMachine(1.0e6);
+  machine.DomainSize = {100, 1, 1};
+  const PerformanceModel model(*instantiation, machine);
+  // the multiplication and the sum over 3 edges of each of the 100 cells
+  EXPECT_DOUBLE_EQ(model.estimate(*instantiation->getStencils()[0]).Flops, 600);
+}
+
+TEST(PerformanceModel, SparseChainSize) {
+  using namespace dawn::iir;
+  using LocType = dawn::ast::LocationType;
+
+  // out = reduce(Cells > Edges > Cells, in * sparse)
+  UnstructuredIIRBuilder b;
+  auto out = b.field("out", LocType::Cells);
+  auto in = b.field("in", LocType::Cells);
+  auto sparse = b.field("sparse", {LocType::Cells, LocType::Edges, LocType::Cells});
+  auto instantiation = b.build(
+      "sparse_chain",
+      b.stencil(b.multistage(
+          LoopOrderKind::Parallel,
+          b.stage(LocType::Cells,
+                  b.doMethod(ast::Interval::Start, ast::Interval::End,
+                             b.stmt(b.assignExpr(
+                                 b.at(out),
+                                 b.reduceOverNeighborExpr(
+                                     Op::plus, b.binaryExpr(b.at(in), b.at(sparse), Op::multiply),
+                                     b.lit(0.),
+                                     {LocType::Cells, LocType::Edges, LocType::Cells}))))))));
+
+  MachineModel machine = makeMachine(1.0e6);
+  machine.DomainSize = {100, 1, 1};
+  const PerformanceModel model(*instantiation, machine);
+  // a cell has 3 distinct neighbors over its edges (not 3 * 2 of the product of the hops), hence
+  // the multiplication and the sum over 3 neighbors and 1 + 1 + 3 values for each of the 100 cells
+  const auto estimate = model.estimate(*instantiation->getStencils()[0]);
+  EXPECT_DOUBLE_EQ(estimate.Flops, 600);
+  EXPECT_DOUBLE_EQ(estimate.Bytes, 4000);
+}
+
+TEST(PerformanceModel, LoadMachine) {
+  const std::string file = "machine_model_test.json";
+  std::ofstream(file) << R"({"memory_bandwidth": 2.0e10, "peak_flops": 5.0e11,
+                            "domain_size": [64, 64, 80]})";
+  const MachineModel machine = MachineModel::load(file);
+  EXPECT_DOUBLE_EQ(machine.MemoryBandwidth, 2.0e10);
+  EXPECT_DOUBLE_EQ(machine.PeakFlops, 5.0e11);
+  EXPECT_DOUBLE_EQ(machine.CacheSize, MachineModel().CacheSize);
+  EXPECT_EQ(machine.DomainSize, (Array3i{64, 64, 80}));
+
+  std::ofstream(file) << R"({"memory_bandwidth": 0})";
+  EXPECT_THROW(MachineModel::load(file), std::runtime_error);
+  std::remove(file.c_str());
+  EXPECT_THROW(MachineModel::load(file), std::runtime_error);
+}
+
+} // namespace
@@ -17,6 +17,7 @@
 #include "dawn/SIR/ASTStmt.h"
 #include "dawn/SIR/SIR.h"
 #include "dawn/Serialization/SIRSerializer.h"
+#include "dawn/Support/FileSystem.h"
 #include "dawn/Support/Type.h"
 #include "driver-includes/unstructured_interface.hpp"
 #include <gtest/gtest.h>
@@ -180,6 +181,22 @@ TEST_P(StencilTest, AST_ForLoopChain) {
   SIR_EXCPECT_EQ(sirRef, serializeAndDeserializeRef());
 }
 
+TEST_P(StencilTest, File) {
+  sirRef->Stencils[0]->Name = "foo";
+  sirRef->Stencils[0]->StencilDescAst =
+      std::make_shared<ast::AST>(sir::makeBlockStmt(std::vector<std::shared_ptr<ast::Stmt>>{
+          sir::makeExprStmt(std::make_shared<ast::AssignmentExpr>(
+              std::make_shared<ast::FieldAccessExpr>("lhs"),
+              std::make_shared<ast::FieldAccessExpr>("rhs")))}));
+
+  const std::string file = (fs::temp_directory_path() / "sir_serializer_test.sir").string();
+  SIRSerializer::serialize(file, sirRef.get(), this->GetParam());
+  SIR_EXCPECT_EQ(sirRef, SIRSerializer::deserialize(file, this->GetParam()));
+  fs::remove(file);
+
+  EXPECT_THROW(SIRSerializer::deserialize(file, this->GetParam()), std::runtime_error);
+}
+
 INSTANTIATE_TEST_CASE_P(SIRSerializeTest, StencilTest,
                         ::testing::Values(SIRSerializer::Format::Json,
                                           SIRSerializer::Format::Byte));
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <gtest/gtest.h>
 #include <sstream>
+#include <thread>
 
 using namespace dawn;
 
@@ -115,6 +116,43 @@ TEST(Logger, size_and_clear) {
   EXPECT_EQ(log.size(), 0);
 }
 
+TEST(Logger, enqueued_by_this_thread) {
+  std::ostringstream buffer;
+  Logger log(makeMessageFormatter(), makeDiagnosticFormatter(), buffer);
+  log("TestLogger.cpp", 42) << "A message\n";
+  std::thread([&]() {
+    EXPECT_EQ(log.numEnqueuedByThisThread(), 0);
+    log("TestLogger.cpp", 42) << "Another message\n";
+    EXPECT_EQ(log.numEnqueuedByThisThread(), 1);
+  }).join();
+  log.clear();
+  EXPECT_EQ(log.size(), 0);
+  EXPECT_EQ(log.numEnqueuedByThisThread(), 1);
+}
+
+TEST(Logger, clear_this_thread) {
+  std::ostringstream buffer;
+  Logger log([](const std::string& msg, const std::string& file, int line) { return msg; },
+             makeDiagnosticFormatter(), buffer);
+  log("TestLogger.cpp", 42) << "main 1";
+  std::thread([&]() { log("TestLogger.cpp", 42) << "other"; }).join();
+  log("TestLogger.cpp", 42) << "main 2";
+  EXPECT_EQ(log.size(), 3);
+
+  // Messages of other threads are kept
+  log.clearThisThread();
+  ASSERT_EQ(log.size(), 1);
+  EXPECT_EQ(*log.begin(), "other");
+  EXPECT_EQ(log.numEnqueuedByThisThread(), 2);
+
+  std::thread([&]() {
+    log("TestLogger.cpp", 42) << "another";
+    log.clearThisThread();
+  }).join();
+  ASSERT_EQ(log.size(), 1);
+  EXPECT_EQ(*log.begin(), "other");
+}
+
 TEST(Logger, show_and_hide) {
   std::ostringstream buffer;
   Logger log(makeMessageFormatter(), makeDiagnosticFormatter(), buffer, false);
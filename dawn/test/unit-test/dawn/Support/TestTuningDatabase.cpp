@@ -0,0 +1,94 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/TuningDatabase.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace dawn;
+
+namespace {
+
+TuningRecord makeRecord(const std::string& stencil, const Array3i& domainSize, int tileSize) {
+  TuningRecord record;
+  record.Backend = "c++-opt";
+  record.Stencil = stencil;
+  record.DomainSize = domainSize;
+  record.Configuration.TileSize = {tileSize, tileSize};
+  record.Time = 1.0;
+  return record;
+}
+
+TEST(TuningDatabase, load) {
+  const std::string file = "tuning_database_test.json";
+  std::ofstream(file) << R"({"records": [
+    {"backend": "c++-opt", "stencil": "hori_diff", "domain_size": [128, 128, 80],
+     "tile_size": [32, 8], "loop_order": "ji", "k_parallel": false, "num_threads": 4,
+     "time": 0.5},
+    {"backend": "c++-opt", "stencil": "vert_adv", "domain_size": [64, 64, 80]}]})";
+  const TuningDatabase database = TuningDatabase::load(file);
+  std::remove(file.c_str());
+
+  ASSERT_EQ(database.getRecords().size(), 2);
+  const TuningRecord& record = database.getRecords()[0];
+  EXPECT_EQ(record.Stencil, "hori_diff");
+  EXPECT_EQ(record.DomainSize, (Array3i{128, 128, 80}));
+  EXPECT_EQ(record.Configuration.TileSize, (Array2i{32, 8}));
+  EXPECT_EQ(record.Configuration.LoopOrder, "ji");
+  EXPECT_FALSE(record.Configuration.KParallel);
+  EXPECT_EQ(record.Configuration.NumThreads, 4);
+  EXPECT_EQ(record.Time, 0.5);
+
+  // the parameters default to the untuned code generation
+  const TuningConfiguration& defaults = database.getRecords()[1].Configuration;
+  EXPECT_EQ(defaults.TileSize, (Array2i{0, 0}));
+  EXPECT_EQ(defaults.LoopOrder, "ij");
+  EXPECT_TRUE(defaults.KParallel);
+  EXPECT_EQ(defaults.NumThreads, 0);
+}
+
+TEST(TuningDatabase, loadErrors) {
+  EXPECT_THROW(TuningDatabase::load("does_not_exist.json"), std::runtime_error);
+
+  const std::string file = "tuning_database_invalid.json";
+  std::ofstream(file) << R"({"records": [{"backend": "c++-opt", "stencil": "s",
+    "domain_size": [8, 8, 8], "loop_order": "ik"}]})";
+  EXPECT_THROW(TuningDatabase::load(file), std::runtime_error);
+  std::ofstream(file) << R"({"records": [{"stencil": "s"}]})";
+  EXPECT_THROW(TuningDatabase::load(file), std::runtime_error);
+  std::remove(file.c_str());
+}
+
+TEST(TuningDatabase, lookup) {
+  const TuningDatabase database(
+      {makeRecord("s", {32, 32, 80}, 8), makeRecord("s", {256, 256, 80}, 32),
+       makeRecord("s", {128, 128, 80}, 16), makeRecord("t", {128, 128, 80}, 4)});
+
+  EXPECT_EQ(database.lookup("c++-opt", "u", {128, 128, 80}), nullptr);
+  EXPECT_EQ(database.lookup("cuda", "s", {128, 128, 80}), nullptr);
+
+  // exact domain size
+  EXPECT_EQ(database.lookup("c++-opt", "s", {128, 128, 80})->Configuration.TileSize[0], 16);
+  EXPECT_EQ(database.lookup("c++-opt", "t", {128, 128, 80})->Configuration.TileSize[0], 4);
+  // closest number of grid points
+  EXPECT_EQ(database.lookup("c++-opt", "s", {40, 40, 80})->Configuration.TileSize[0], 8);
+  EXPECT_EQ(database.lookup("c++-opt", "s", {200, 200, 80})->Configuration.TileSize[0], 32);
+  EXPECT_EQ(database.lookup("c++-opt", "t", {16, 16, 16})->Configuration.TileSize[0], 4);
+  // largest domain if the domain size is only known at runtime
+  EXPECT_EQ(database.lookup("c++-opt", "s", {0, 0, 0})->Configuration.TileSize[0], 32);
+}
+
+} // namespace
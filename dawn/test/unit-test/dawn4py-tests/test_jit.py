@@ -0,0 +1,140 @@
+##===-----------------------------------------------------------------------------*- Python -*-===##
+##                          _
+##                         | |
+##                       __| | __ ___      ___ ___
+##                      / _` |/ _` \ \ /\ / / '_  |
+##                     | (_| | (_| |\ V  V /| | | |
+##                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+##
+##
+##  This file is distributed under the MIT License (MIT).
+##  See LICENSE.txt for details.
+##
+##===------------------------------------------------------------------------------------------===##
+
+import os
+import shlex
+import shutil
+
+import pytest
+
+import dawn4py
+import dawn4py.jit
+from dawn4py.serialization import AST
+from dawn4py.serialization import utils as serial_utils
+
+import utils
+
+np = pytest.importorskip("numpy")
+
+pytestmark = pytest.mark.skipif(
+    shutil.which(shlex.split(os.environ.get("CXX", "c++"))[0]) is None,
+    reason="no host C++ compiler",
+)
+
+
+def make_unstructured_reduction_sir(name="unstructured_reduction"):
+    interval = serial_utils.make_interval(AST.Interval.Start, AST.Interval.End, 0, 0)
+
+    # out = reduce(Edge > Cell, +, in, 0.0)
+    body_ast = serial_utils.make_ast(
+        [
+            serial_utils.make_assignment_stmt(
+                serial_utils.make_unstructured_field_access_expr("out"),
+                serial_utils.make_reduction_over_neighbor_expr(
+                    "+",
+                    serial_utils.make_unstructured_field_access_expr("in"),
+                    serial_utils.make_literal_access_expr("0.0", AST.BuiltinType.Double),
+                    chain=[AST.LocationType.Value("Edge"), AST.LocationType.Value("Cell")],
+                ),
+                "=",
+            )
+        ]
+    )
+
+    vertical_region_stmt = serial_utils.make_vertical_region_decl_stmt(
+        body_ast, interval, AST.VerticalRegion.Forward
+    )
+
+    return serial_utils.make_sir(
+        f"{name}.cpp",
+        serial_utils.GridType.Value("Unstructured"),
+        [
+            serial_utils.make_stencil(
+                name,
+                serial_utils.make_ast([vertical_region_stmt]),
+                [
+                    serial_utils.make_field(
+                        "in",
+                        serial_utils.make_field_dimensions_unstructured(
+                            [AST.LocationType.Value("Cell")], 1
+                        ),
+                    ),
+                    serial_utils.make_field(
+                        "out",
+                        serial_utils.make_field_dimensions_unstructured(
+                            [AST.LocationType.Value("Edge")], 1
+                        ),
+                    ),
+                ],
+            )
+        ],
+    )
+
+
+def test_unstructured_jit(tmp_path):
+    sir = make_unstructured_reduction_sir()
+    module = dawn4py.jit.build(
+        sir, backend=dawn4py.CodeGenBackend.CXXNaiveIco, cache_dir=str(tmp_path)
+    )
+    assert list(module.stencils) == ["unstructured_reduction"]
+    assert module.unstructured_reduction.fields == ["in", "out"]
+
+    num_edges, num_cells, k_size = 5, 4, 3
+    ec_table = np.array([[0, 1, 2, 3, 0], [1, 2, 3, 0, 2]], dtype=np.int32)
+    mesh = dawn4py.jit.Mesh(
+        num_edges=num_edges,
+        num_cells=num_cells,
+        neighbor_tables={
+            ((dawn4py.jit.Location.Edges, dawn4py.jit.Location.Cells), False): ec_table
+        },
+    )
+
+    in_field = np.random.rand(k_size, num_cells)
+    # the output is a view into a larger array, which is updated in place
+    storage = np.zeros((k_size, 2 * num_edges))
+    out_field = storage[:, :num_edges]
+    module.run(mesh=mesh, **{"in": in_field, "out": out_field})
+
+    assert np.allclose(storage[:, :num_edges], in_field[:, ec_table].sum(axis=1))
+    assert np.all(storage[:, num_edges:] == 0.0)
+
+    # the shared object is cached by the hash of the code
+    assert (
+        dawn4py.jit.build(sir, backend=dawn4py.CodeGenBackend.CXXNaiveIco, cache_dir=str(tmp_path))
+        is module
+    )
+
+    with pytest.raises(TypeError):
+        module.run(mesh=mesh, **{"in": in_field.astype(np.float32), "out": out_field})
+    with pytest.raises(TypeError):
+        module.run(mesh=mesh, out=out_field)
+
+
+@pytest.mark.skipif(
+    "DAWN4PY_JIT_INCLUDE_DIRS" not in os.environ,
+    reason="needs GridTools and Boost (set DAWN4PY_JIT_INCLUDE_DIRS)",
+)
+def test_structured_jit(tmp_path):
+    sir = utils.make_copy_stencil_sir()
+    module = dawn4py.jit.build(
+        sir, backend=dawn4py.CodeGenBackend.CXXNaive, cache_dir=str(tmp_path)
+    )
+
+    in_field = np.random.rand(10, 12, 5)
+    out_field = np.zeros((10, 12, 5))
+    module.run(halo=(3, 3, 0), **{"in": in_field, "out": out_field})
+
+    # out = in[i+1] on the compute domain
+    assert np.array_equal(out_field[3:-3, 3:-3, :], in_field[4:-2, 3:-3, :])
+    assert np.all(out_field[:3, :, :] == 0.0)
@@ -60,3 +60,44 @@ def test_compilation(grid_sir_with_reference_code):
             backend=backend,
         )
         # TODO There was not test here...
+
+
+def test_compilation_with_handles(grid_sir_with_reference_code):
+    sir, reference_code = grid_sir_with_reference_code
+    sir_handle = dawn4py.load_sir(sir)
+    assert sir_handle.filename == sir.filename
+    sir_from_handle = dawn4py.serialization.from_bytes(sir_handle.to_string(), SIR.SIR)
+    assert [stencil.name for stencil in sir_from_handle.stencils] == [
+        stencil.name for stencil in sir.stencils
+    ]
+
+    for backend in (
+        dawn4py.CodeGenBackend.CXXNaive,
+        dawn4py.CodeGenBackend.GridTools,
+        dawn4py.CodeGenBackend.CUDA,
+    ):
+        assert sir.stencils[0].name in dawn4py.compile(sir_handle, backend=backend)
+
+        instantiations = dawn4py.lower_and_optimize(sir_handle, groups=[])
+        assert all(
+            isinstance(si, dawn4py.StencilInstantiation) for si in instantiations.values()
+        )
+        # handles are optimized in place
+        optimized = dawn4py.optimize(instantiations, groups=dawn4py.default_pass_groups())
+        assert all(optimized[name] is si for name, si in instantiations.items())
+        assert sir.stencils[0].name in dawn4py.codegen(optimized, backend=backend)
+
+
+def test_compile_batch():
+    sirs = [getattr(utils, f"make_{name}_sir")(name=name) for name in utils.GRID_TEST_CASES]
+    # the same handle may be compiled concurrently
+    sir_handles = [dawn4py.load_sir(sir) for sir in sirs] * 4
+    codes = dawn4py.compile_batch(
+        sir_handles, max_workers=4, backend=dawn4py.CodeGenBackend.CXXNaive
+    )
+    assert len(codes) == len(sir_handles)
+    for sir, code in zip(sirs * 4, codes):
+        assert sir.stencils[0].name in code
+
+    future = dawn4py.compile_async(sirs[0], backend=dawn4py.CodeGenBackend.CXXNaive)
+    assert sirs[0].stencils[0].name in future.result()
@@ -0,0 +1,95 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/cpu_mesh.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace rowlib {
+// three cells in a row, cell 1 has two neighbors, the outer cells only one
+struct rowMesh {};
+struct rowTag {};
+rowMesh meshType(rowTag);
+inline dawn::index_range getCells(rowTag, rowMesh const&) { return dawn::index_range(0, 3); }
+inline dawn::index_range getEdges(rowTag, rowMesh const&) { return dawn::index_range(0, 0); }
+inline dawn::index_range getVertices(rowTag, rowMesh const&) { return dawn::index_range(0, 0); }
+inline std::vector<int> getNeighbors(rowTag, rowMesh const&,
+                                     std::vector<dawn::LocationType> const&, int idx,
+                                     bool includeCenter) {
+  std::vector<int> neighbors;
+  if(includeCenter)
+    neighbors.push_back(idx);
+  if(idx > 0)
+    neighbors.push_back(idx - 1);
+  if(idx < 2)
+    neighbors.push_back(idx + 1);
+  return neighbors;
+}
+} // namespace rowlib
+
+namespace {
+using rowlib::rowMesh;
+using rowlib::rowTag;
+
+const std::vector<dawn::LocationType> cec{dawn::LocationType::Cells, dawn::LocationType::Edges,
+                                          dawn::LocationType::Cells};
+
+TEST(driver_includes_cpu_mesh, NeighborTable) {
+  std::vector<int> table = dawn::generateNbhTable<rowTag>(rowMesh{}, cec, 3, 2);
+  const int M = DEVICE_MISSING_VALUE;
+  // transposed: first neighbor of all cells, then second neighbor of all cells
+  ASSERT_EQ(table, (std::vector<int>{1, 0, 1, M, 2, M}));
+
+  dawn::GlobalCpuTriMesh mesh;
+  mesh.NumCells = 3;
+  mesh.CellStride = 3;
+  mesh.NeighborTables[dawn::UnstructuredIterationSpace{cec, false}] = table.data();
+  ASSERT_EQ(dawn::getNeighbors(mesh, cec, 0, false, 2), (std::vector<int>{1}));
+  ASSERT_EQ(dawn::getNeighbors(mesh, cec, 1, false, 2), (std::vector<int>{0, 2}));
+
+  std::vector<int> tableWithCenter = dawn::generateNbhTable<rowTag>(rowMesh{}, cec, 3, 3, true);
+  ASSERT_EQ(tableWithCenter, (std::vector<int>{0, 1, 2, 1, 0, 1, M, 2, M}));
+}
+
+TEST(driver_includes_cpu_mesh, Fields) {
+  const int numCells = 3;
+  const int kSize = 2;
+  const int sparseSize = 2;
+
+  auto dense = dawn::allocateField(dawn::NoLibCpuTag{}, numCells, kSize);
+  auto sparse = dawn::allocateField(dawn::NoLibCpuTag{}, numCells, kSize, sparseSize);
+  auto vertical = dawn::allocateField(dawn::NoLibCpuTag{}, kSize);
+  dense(2, 1) = 1.;
+  sparse(2, 1, 1) = 2.;
+  vertical(1) = 3.;
+  ASSERT_EQ(dense.data()[1 * numCells + 2], 1.);
+  ASSERT_EQ(sparse.data()[(1 * sparseSize + 1) * numCells + 2], 2.);
+  ASSERT_EQ(vertical.data()[1], 3.);
+
+  // views share the storage with the allocated field
+  dawn::cell_field_t<dawn::NoLibCpuTag, dawn::float_type> view(dense.data(), numCells);
+  ASSERT_EQ(view(2, 1), 1.);
+  ASSERT_EQ(view(1 * numCells + 2), 1.);
+
+  dawn::GlobalCpuTriMesh mesh;
+  mesh.NumCells = numCells;
+  int count = 0;
+  for(auto cell : getCells(dawn::NoLibCpuTag{}, mesh))
+    count += cell;
+  ASSERT_EQ(count, 0 + 1 + 2);
+}
+
+} // namespace
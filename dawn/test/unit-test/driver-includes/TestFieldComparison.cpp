@@ -0,0 +1,110 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/cpu_verify.hpp"
+#include "driver-includes/field_comparison.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+TEST(driver_includes_field_comparison, UlpDistance) {
+  ASSERT_EQ(dawn::ulp_distance(1., 1.), 0u);
+  ASSERT_EQ(dawn::ulp_distance(1., std::nextafter(1., 2.)), 1u);
+  ASSERT_EQ(dawn::ulp_distance(std::nextafter(1., 2.), 1.), 1u);
+  ASSERT_EQ(dawn::ulp_distance(-0., 0.), 0u);
+  const double denorm = std::numeric_limits<double>::denorm_min();
+  ASSERT_EQ(dawn::ulp_distance(-denorm, denorm), 2u);
+  ASSERT_EQ(dawn::ulp_distance(1.f, std::nextafter(1.f, 0.f)), 1u);
+  ASSERT_EQ(dawn::ulp_distance(3, -2), 5u);
+}
+
+TEST(driver_includes_field_comparison, Statistics) {
+  // 4 elements on 2 levels, stored with a stride of 5
+  const std::vector<double> expected{1., 2., 4., 8., -1., 1., 2., 4., 8., -1.};
+  const std::vector<double> actual{1., 2.2, 4., 8., 0., 1., 2., 4., 6., 0.};
+  auto result = dawn::compare_fields(4, 2, 5, expected.data(), 5, actual.data(),
+                                     dawn::is_close{0.05, 0.});
+
+  ASSERT_EQ(result.num_points, 8u);
+  ASSERT_EQ(result.num_failures, 2u);
+  ASSERT_EQ(result.num_nans, 0u);
+  ASSERT_FALSE(result.verified());
+  ASSERT_DOUBLE_EQ(result.max_abs_error, 2.);
+  ASSERT_DOUBLE_EQ(result.min_abs_error, 0.);
+  ASSERT_DOUBLE_EQ(result.mean_abs_error(), (0.2 + 2.) / 8);
+  ASSERT_DOUBLE_EQ(result.max_rel_error, 0.25);
+  ASSERT_DOUBLE_EQ(result.mean_rel_error(), (0.1 + 0.25) / 8);
+  ASSERT_EQ(result.max_ulp_distance, dawn::ulp_distance(8., 6.));
+
+  ASSERT_EQ(result.failures_per_level, (std::vector<std::size_t>{1, 1}));
+  ASSERT_EQ(result.failures_per_subdomain, (std::vector<std::size_t>{2}));
+  ASSERT_EQ(result.failures.size(), 2u);
+  ASSERT_EQ(result.failures[0].idx, 1);
+  ASSERT_EQ(result.failures[0].k, 0);
+  ASSERT_EQ(result.failures[1].idx, 3);
+  ASSERT_EQ(result.failures[1].k, 1);
+
+  std::stringstream ss;
+  result.report(ss, "field");
+  ASSERT_NE(ss.str().find("field points outside tolerance: 2 of 8 (0 NaN)"), std::string::npos);
+  ASSERT_NE(ss.str().find("field points outside tolerance per level: 0: 1 1: 1"),
+            std::string::npos);
+}
+
+TEST(driver_includes_field_comparison, SubdomainsAndNaNs) {
+  const int numElements = 10000;
+  const int numLevels = 3;
+  std::vector<double> expected(numElements * numLevels, 1.);
+  std::vector<double> actual(expected);
+  actual[2 * numElements + 9999] = 2.;
+  actual[1 * numElements + 5000] = std::numeric_limits<double>::quiet_NaN();
+  actual[0 * numElements + 10] = 1.5;
+  actual[0 * numElements + 11] = 1. + 1e-12;
+
+  // subdomains [0, 100), [100, 9000), [9000, 10000)
+  auto result = dawn::compare_fields(numElements, numLevels, numElements, expected.data(),
+                                     numElements, actual.data(), dawn::is_close{1e-9, 0.},
+                                     std::vector<int>{100, 9000}, 2);
+
+  ASSERT_EQ(result.num_points, std::size_t(numElements * numLevels));
+  ASSERT_EQ(result.num_failures, 3u);
+  ASSERT_EQ(result.num_nans, 1u);
+  ASSERT_DOUBLE_EQ(result.max_abs_error, 1.);
+  ASSERT_EQ(result.max_ulp_distance, dawn::ulp_distance(1., 2.));
+  ASSERT_EQ(result.failures_per_level, (std::vector<std::size_t>{1, 1, 1}));
+  ASSERT_EQ(result.failures_per_subdomain, (std::vector<std::size_t>{1, 1, 1}));
+
+  // only the first failing points are kept
+  ASSERT_EQ(result.failures.size(), 2u);
+  ASSERT_EQ(result.failures[0].idx, 10);
+  ASSERT_EQ(result.failures[0].k, 0);
+  ASSERT_EQ(result.failures[1].idx, 5000);
+  ASSERT_EQ(result.failures[1].k, 1);
+}
+
+TEST(driver_includes_field_comparison, VerifyField) {
+  const std::vector<double> reference{1., 2., 3.};
+  const std::vector<double> close{1., 2. + 1e-13, 3.};
+  const std::vector<double> wrong{1., 2.5, 3.};
+  ASSERT_TRUE(dawn::verify_field(3, close.data(), reference.data(), "close", 1e-12, 0.));
+  ASSERT_FALSE(dawn::verify_field(3, wrong.data(), reference.data(), "wrong", 1e-12, 0.));
+}
+
+} // namespace
@@ -0,0 +1,138 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                          _
+//                         | |
+//                       __| | __ ___      ___ ___
+//                      / _` |/ _` \ \ /\ / / '_  |
+//                     | (_| | (_| |\ V  V /| | | |
+//                      \__,_|\__,_| \_/\_/ |_| |_| - Compiler Toolchain
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "driver-includes/halo_exchange.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+using gridtools::dawn::domain;
+using gridtools::dawn::halo_exchange;
+using gridtools::dawn::raw_field;
+using gridtools::dawn::thread_halo_exchange_world;
+
+// subdomains of 4 x 5 x 2 points with a halo of 2, i.e. allocated on 8 x 9 x 2 points
+const int isize = 4, jsize = 5, ksize = 2, haloSize = 2;
+
+domain makeDomain() {
+  domain dom(isize + 2 * haloSize, jsize + 2 * haloSize, ksize);
+  dom.set_halos(haloSize, haloSize, haloSize, haloSize, 0, 0);
+  return dom;
+}
+
+double globalValue(int i, int j, int k) { return 1000. * k + 100. * i + j; }
+
+// field of `rank` holding `globalValue` on its compute domain and -1 in the halo
+std::vector<double> makeField(int rank, int xcols) {
+  std::vector<double> data((isize + 2 * haloSize) * (jsize + 2 * haloSize) * ksize, -1.);
+  raw_field<double> field(data.data(), 1, isize + 2 * haloSize,
+                          (isize + 2 * haloSize) * (jsize + 2 * haloSize));
+  for(int i = 0; i < isize; ++i)
+    for(int j = 0; j < jsize; ++j)
+      for(int k = 0; k < ksize; ++k)
+        field(i + haloSize, j + haloSize, k) =
+            globalValue((rank % xcols) * isize + i, (rank / xcols) * jsize + j, k);
+  return data;
+}
+
+// check the halo of `rank` against the global field of `xcols` x `ycols` ranks
+void checkHalo(std::vector<double>& data, int rank, int xcols, int ycols,
+               const std::array<int, 4>& width, bool periodic) {
+  raw_field<double> field(data.data(), 1, isize + 2 * haloSize,
+                          (isize + 2 * haloSize) * (jsize + 2 * haloSize));
+  for(int i = -haloSize; i < isize + haloSize; ++i)
+    for(int j = -haloSize; j < jsize + haloSize; ++j) {
+      const bool isInterior = i >= 0 && i < isize && j >= 0 && j < jsize;
+      const bool isExchanged =
+          i >= -width[0] && i < isize + width[1] && j >= -width[2] && j < jsize + width[3];
+      int gi = (rank % xcols) * isize + i, gj = (rank / xcols) * jsize + j;
+      if(periodic) {
+        gi = (gi + xcols * isize) % (xcols * isize);
+        gj = (gj + ycols * jsize) % (ycols * jsize);
+      }
+      const bool isInGlobalDomain = gi >= 0 && gi < xcols * isize && gj >= 0 && gj < ycols * jsize;
+      for(int k = 0; k < ksize; ++k) {
+        const double expected =
+            isInterior || (isExchanged && isInGlobalDomain) ? globalValue(gi, gj, k) : -1.;
+        ASSERT_EQ(field(i + haloSize, j + haloSize, k), expected)
+            << "rank " << rank << " at (" << i << ", " << j << ", " << k << ")";
+      }
+    }
+}
+
+TEST(driver_includes_halo_exchange, Neighbors) {
+  thread_halo_exchange_world world(3, 2);
+  ASSERT_EQ(world.size(), 6);
+  ASSERT_EQ(world.neighbor(1, 1, 0), 2);
+  ASSERT_EQ(world.neighbor(1, 1, 1), 5);
+  ASSERT_EQ(world.neighbor(2, 1, 0), -1);
+  ASSERT_EQ(world.neighbor(0, 0, -1), -1);
+
+  thread_halo_exchange_world periodicWorld(3, 2, /*periodic*/ true);
+  ASSERT_EQ(periodicWorld.neighbor(2, 1, 0), 0);
+  ASSERT_EQ(periodicWorld.neighbor(0, -1, -1), 5);
+}
+
+TEST(driver_includes_halo_exchange, Exchange) {
+  const int xcols = 3, ycols = 2;
+  const std::array<int, 4> width{1, 2, 2, 0};
+  thread_halo_exchange_world world(xcols, ycols);
+
+  std::vector<std::vector<double>> fields;
+  for(int rank = 0; rank < world.size(); ++rank)
+    fields.push_back(makeField(rank, xcols));
+
+  world.run([&](int rank, halo_exchange& comm) {
+    raw_field<double> field(fields[rank].data(), 1, isize + 2 * haloSize,
+                            (isize + 2 * haloSize) * (jsize + 2 * haloSize));
+    comm.start(field, makeDomain(), width);
+    comm.finish();
+  });
+
+  for(int rank = 0; rank < world.size(); ++rank)
+    checkHalo(fields[rank], rank, xcols, ycols, width, /*periodic*/ false);
+}
+
+TEST(driver_includes_halo_exchange, PeriodicMultipleFields) {
+  const int xcols = 2, ycols = 2;
+  const std::array<int, 4> widthA{2, 2, 2, 2}, widthB{0, 1, 1, 0};
+  thread_halo_exchange_world world(xcols, ycols, /*periodic*/ true);
+
+  std::vector<std::vector<double>> fieldsA, fieldsB;
+  for(int rank = 0; rank < world.size(); ++rank) {
+    fieldsA.push_back(makeField(rank, xcols));
+    fieldsB.push_back(makeField(rank, xcols));
+  }
+
+  // two exchanges in flight at once, repeated to check that the messages are matched in order
+  world.run([&](int rank, halo_exchange& comm) {
+    const int stride_j = isize + 2 * haloSize, stride_k = stride_j * (jsize + 2 * haloSize);
+    for(int iteration = 0; iteration < 3; ++iteration) {
+      comm.start(raw_field<double>(fieldsA[rank].data(), 1, stride_j, stride_k), makeDomain(),
+                 widthA);
+      comm.start(raw_field<double>(fieldsB[rank].data(), 1, stride_j, stride_k), makeDomain(),
+                 widthB);
+      comm.finish();
+    }
+  });
+
+  for(int rank = 0; rank < world.size(); ++rank) {
+    checkHalo(fieldsA[rank], rank, xcols, ycols, widthA, /*periodic*/ true);
+    checkHalo(fieldsB[rank], rank, xcols, ycols, widthB, /*periodic*/ true);
+  }
+}
+
+} // namespace
@@ -14,9 +14,13 @@
 
 #include <gtest/gtest.h>
 
+#include "driver-includes/mesh_renumbering.hpp"
 #include "interface/toylib_interface.hpp"
 #include "toylib/toylib.hpp"
 
+#include <numeric>
+#include <random>
+
 namespace {
 
 // compare two (partial neighborhoods)
@@ -185,4 +189,176 @@ TEST(TestToylibInterface, Intp) {
   ASSERT_TRUE(nbhsValidAndEqual(intpHi, intpHiRef));
 }
 
-} // namespace
\ No newline at end of file
+toylib::GridRenumbering shuffledNumbering(toylib::Grid const& mesh) {
+  std::mt19937 gen(42);
+  auto shuffled = [&](size_t size) {
+    std::vector<int> newIndex(size);
+    std::iota(newIndex.begin(), newIndex.end(), 0);
+    std::shuffle(newIndex.begin(), newIndex.end(), gen);
+    return newIndex;
+  };
+  return {shuffled(mesh.vertices().size()), shuffled(mesh.faces().size()),
+          shuffled(mesh.all_edges().size())};
+}
+
+// every element of the renumbered grid has the (renumbered) neighbors of the original element, in
+// the same order
+void checkRenumberedConnectivity(toylib::Grid const& ref, toylib::Grid const& mesh,
+                                 toylib::GridRenumbering const& renumbering) {
+  ASSERT_EQ(ref.edges().size(), mesh.edges().size());
+  for(auto const& v : ref.vertices()) {
+    auto const& newV = mesh.vertices()[renumbering.vertices[v.id()]];
+    ASSERT_EQ(newV.id(), renumbering.vertices[v.id()]);
+    ASSERT_EQ(newV.x(), v.x());
+    ASSERT_EQ(newV.y(), v.y());
+    ASSERT_EQ(newV.edges().size(), v.edges().size());
+    for(size_t i = 0; i < v.edges().size(); ++i)
+      ASSERT_EQ(newV.edge(i).id(), renumbering.edges[v.edge(i).id()]);
+    ASSERT_EQ(newV.faces().size(), v.faces().size());
+    for(size_t i = 0; i < v.faces().size(); ++i)
+      ASSERT_EQ(newV.face(i).id(), renumbering.faces[v.face(i).id()]);
+  }
+  for(auto const& f : ref.faces()) {
+    auto const& newF = mesh.faces()[renumbering.faces[f.id()]];
+    ASSERT_EQ(newF.id(), renumbering.faces[f.id()]);
+    ASSERT_EQ(newF.color(), f.color());
+    for(size_t i = 0; i < 3; ++i) {
+      ASSERT_EQ(newF.vertex(i).id(), renumbering.vertices[f.vertex(i).id()]);
+      ASSERT_EQ(newF.edge(i).id(), renumbering.edges[f.edge(i).id()]);
+    }
+  }
+  for(toylib::Edge const& e : ref.edges()) {
+    auto const& newE = mesh.all_edges()[renumbering.edges[e.id()]];
+    ASSERT_EQ(newE.id(), renumbering.edges[e.id()]);
+    for(size_t i = 0; i < 2; ++i)
+      ASSERT_EQ(newE.vertex(i).id(), renumbering.vertices[e.vertex(i).id()]);
+    ASSERT_EQ(newE.faces().size(), e.faces().size());
+    for(size_t i = 0; i < e.faces().size(); ++i)
+      ASSERT_EQ(newE.face(i).id(), renumbering.faces[e.face(i).id()]);
+  }
+}
+
+TEST(TestToylibInterface, RenumberingKeepsConnectivity) {
+  int w = 10;
+  const toylib::Grid ref(w, w, false, 1., 1., true);
+  for(auto strategy : {toylib::renumbering_strategy::reverse_cuthill_mckee,
+                       toylib::renumbering_strategy::hilbert}) {
+    toylib::Grid mesh(w, w, false, 1., 1., true);
+    auto renumbering = toylib::compute_renumbering(mesh, strategy);
+    mesh.renumber(renumbering);
+    checkRenumberedConnectivity(ref, mesh, renumbering);
+
+    // edges outside of the domain are moved to the end
+    for(size_t i = 0; i < mesh.all_edges().size(); ++i)
+      ASSERT_EQ(bool(mesh.all_edges()[i]), i < mesh.edges().size());
+  }
+  toylib::Grid mesh(w, w, false, 1., 1., true);
+  auto renumbering = shuffledNumbering(mesh);
+  mesh.renumber(renumbering);
+  checkRenumberedConnectivity(ref, mesh, renumbering);
+}
+
+TEST(TestToylibInterface, RenumberingFields) {
+  int w = 10;
+  toylib::Grid mesh(w, w, false, 1., 1., true);
+  toylib::VertexData<double> vertexField(mesh, 2);
+  toylib::SparseFaceData<double> sparseField(mesh, 3, 2);
+  auto cellSum = [&](toylib::Face const& f, int k) {
+    return toylibInterface::reduce(
+        toylibInterface::toylibTag{}, mesh, &f, 0.,
+        std::vector<dawn::LocationType>{dawn::LocationType::Cells, dawn::LocationType::Vertices},
+        [&, m_sparse_dimension_idx = 0](auto& lhs, auto const* v) mutable {
+          lhs += sparseField(f, m_sparse_dimension_idx++, k) * vertexField(v, k);
+        });
+  };
+  for(int k = 0; k < 2; ++k) {
+    for(auto const& v : mesh.vertices())
+      vertexField(v, k) = v.x() + 2 * v.y() + k;
+    for(auto const& f : mesh.faces())
+      for(int i = 0; i < 3; ++i)
+        sparseField(f, i, k) = i + 1;
+  }
+  std::vector<double> ref;
+  for(auto const& f : mesh.faces())
+    ref.push_back(cellSum(f, 1));
+
+  auto renumbering = shuffledNumbering(mesh);
+  mesh.renumber(renumbering);
+  vertexField.renumber(renumbering.vertices);
+  sparseField.renumber(renumbering.faces);
+
+  for(size_t i = 0; i < ref.size(); ++i)
+    ASSERT_EQ(cellSum(mesh.faces()[renumbering.faces[i]], 1), ref[i]);
+}
+
+TEST(TestToylibInterface, RenumberingImprovesLocality) {
+  int w = 32;
+  toylib::Grid mesh(w, w, false, 1., 1., true);
+  mesh.renumber(shuffledNumbering(mesh));
+
+  auto faceAdjacency = [](toylib::Grid const& grid) {
+    std::vector<std::vector<int>> adjacency;
+    for(auto const& f : grid.faces()) {
+      adjacency.emplace_back();
+      for(auto const* neighbor : f.faces())
+        adjacency.back().push_back(neighbor->id());
+    }
+    return adjacency;
+  };
+  const double shuffledDistance = dawn::mean_neighbor_distance(faceAdjacency(mesh));
+
+  for(auto strategy : {toylib::renumbering_strategy::reverse_cuthill_mckee,
+                       toylib::renumbering_strategy::hilbert}) {
+    // grids can't be copied (the elements would refer to the copied grid)
+    toylib::Grid renumbered(w, w, false, 1., 1., true);
+    renumbered.renumber(shuffledNumbering(renumbered));
+    renumbered.renumber(toylib::compute_renumbering(renumbered, strategy));
+    EXPECT_LT(dawn::mean_neighbor_distance(faceAdjacency(renumbered)), shuffledDistance / 10);
+  }
+}
+
+TEST(TestToylibInterface, RenumberingRespectsSubdomains) {
+  // a path graph 0 - 1 - ... - 11, split into lateral boundary, interior and halo
+  dawn::unstructured_domain domain;
+  domain.set_splitter_index({dawn::LocationType::Cells, dawn::UnstructuredSubdomain::Interior, 0},
+                            4);
+  domain.set_splitter_index({dawn::LocationType::Cells, dawn::UnstructuredSubdomain::Halo, 0}, 9);
+  domain.set_splitter_index({dawn::LocationType::Cells, dawn::UnstructuredSubdomain::End, 0}, 12);
+  domain.set_splitter_index({dawn::LocationType::Edges, dawn::UnstructuredSubdomain::Halo, 0}, 1);
+  auto boundaries = domain.splitter_indices(dawn::LocationType::Cells);
+  ASSERT_EQ(boundaries, (std::vector<int>{4, 9, 12}));
+
+  // shuffle the path such that the renumbering has something to do
+  std::vector<int> path{3, 1, 0, 2, 8, 4, 6, 7, 5, 11, 9, 10};
+  std::vector<std::vector<int>> adjacency(path.size());
+  std::vector<double> x(path.size()), y(path.size(), 0.);
+  for(size_t i = 0; i < path.size(); ++i) {
+    if(i > 0)
+      adjacency[path[i]].push_back(path[i - 1]);
+    if(i + 1 < path.size())
+      adjacency[path[i]].push_back(path[i + 1]);
+    x[path[i]] = i;
+  }
+
+  auto subdomain = [&](int idx) {
+    return std::upper_bound(boundaries.begin(), boundaries.end(), idx) - boundaries.begin();
+  };
+  auto rcm = dawn::reverse_cuthill_mckee(adjacency, boundaries);
+  for(auto newIndex : {rcm, dawn::hilbert_order(x, y, boundaries)}) {
+    auto sorted = newIndex;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> identity(path.size());
+    std::iota(identity.begin(), identity.end(), 0);
+    ASSERT_EQ(sorted, identity);
+
+    for(size_t i = 0; i < path.size(); ++i)
+      ASSERT_EQ(subdomain(i), subdomain(newIndex[i]));
+  }
+
+  // within the subdomains the path is numbered contiguously
+  for(size_t i = 0; i + 1 < path.size(); ++i)
+    if(subdomain(path[i]) == subdomain(path[i + 1]))
+      ASSERT_EQ(std::abs(rcm[path[i]] - rcm[path[i + 1]]), 1);
+}
+
+} // namespace
@@ -16,21 +16,255 @@
 
 #include "gtclang/Driver/Driver.h"
 #include "dawn/Support/Logger.h"
+#include "dawn/Support/UIDGenerator.h"
 #include "gtclang/Driver/CompilerInstance.h"
 #include "gtclang/Driver/OptionsParser.h"
+#include "gtclang/Driver/PrecompiledHeader.h"
 #include "gtclang/Frontend/GTClangASTAction.h"
 #include "gtclang/Frontend/GTClangContext.h"
 #include "gtclang/Frontend/GTClangIncludeChecker.h"
 #include "gtclang/Frontend/GTClangPreprocessorAction.h"
 #include "gtclang/Support/Logger.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
 
 namespace gtclang {
 
+namespace {
+
+/// @brief Use the gtclang formatters for the dawn loggers while in scope
+class ScopedGTClangFormatters : public dawn::NonCopyable {
+  dawn::Logger::MessageFormatter infoMessageFormatter_;
+  dawn::Logger::MessageFormatter warnMessageFormatter_;
+  dawn::Logger::MessageFormatter errorMessageFormatter_;
+  dawn::Logger::DiagnosticFormatter infoDiagnosticFormatter_;
+  dawn::Logger::DiagnosticFormatter warnDiagnosticFormatter_;
+  dawn::Logger::DiagnosticFormatter errorDiagnosticFormatter_;
+
+public:
+  ScopedGTClangFormatters()
+      : infoMessageFormatter_(dawn::log::info.messageFormatter()),
+        warnMessageFormatter_(dawn::log::warn.messageFormatter()),
+        errorMessageFormatter_(dawn::log::error.messageFormatter()),
+        infoDiagnosticFormatter_(dawn::log::info.diagnosticFormatter()),
+        warnDiagnosticFormatter_(dawn::log::warn.diagnosticFormatter()),
+        errorDiagnosticFormatter_(dawn::log::error.diagnosticFormatter()) {
+    dawn::log::info.messageFormatter(makeGTClangMessageFormatter("[INFO]"));
+    dawn::log::warn.messageFormatter(makeGTClangMessageFormatter("[WARNING]"));
+    dawn::log::error.messageFormatter(makeGTClangMessageFormatter("[ERROR]"));
+
+    dawn::log::info.diagnosticFormatter(makeGTClangDiagnosticFormatter("[INFO]"));
+    dawn::log::warn.diagnosticFormatter(makeGTClangDiagnosticFormatter("[WARNING]"));
+    dawn::log::error.diagnosticFormatter(makeGTClangDiagnosticFormatter("[ERROR]"));
+  }
+
+  ~ScopedGTClangFormatters() {
+    dawn::log::info.messageFormatter(infoMessageFormatter_);
+    dawn::log::warn.messageFormatter(warnMessageFormatter_);
+    dawn::log::error.messageFormatter(errorMessageFormatter_);
+
+    dawn::log::info.diagnosticFormatter(infoDiagnosticFormatter_);
+    dawn::log::warn.diagnosticFormatter(warnDiagnosticFormatter_);
+    dawn::log::error.diagnosticFormatter(errorDiagnosticFormatter_);
+  }
+};
+
+/// @brief Run the preprocessor and the AST action (i.e the SIR generation and, if enabled, Dawn)
+/// on the clang arguments `clangArgs` of a single input file
+/// @returns `0` on success, `1` otherwise
+int runCompilerInstance(GTClangContext* context, llvm::SmallVectorImpl<const char*>& clangArgs,
+                        std::shared_ptr<dawn::SIR>& SIR) {
+  // Create GTClang
+  std::unique_ptr<clang::CompilerInstance> GTClang(createCompilerInstance(clangArgs));
+  if(!GTClang)
+    return 1;
+
+  int ret = 0;
+  context->startTimer("preprocessing");
+  std::unique_ptr<clang::FrontendAction> PPAction(new GTClangPreprocessorAction(context));
+  ret |= !GTClang->ExecuteAction(*PPAction);
+  context->stopTimer("preprocessing");
+
+  if(ret == 0) {
+    // The AST consumer switches from parsing to the SIR generation and Dawn
+    context->startTimer("parsing");
+    std::unique_ptr<GTClangASTAction> ASTAction(new GTClangASTAction(context));
+    ret |= !GTClang->ExecuteAction(*ASTAction);
+    context->stopTimer("parsing");
+    context->stopTimer("SIR generation, optimization and code generation");
+    SIR = ASTAction->getSIR();
+  }
+  DAWN_LOG(INFO) << "Compilation finished " << (ret ? "with errors" : "successfully");
+
+  context->printTimingReport(llvm::errs(), clangArgs.size() > 1 ? clangArgs[1] : "");
+  return ret;
+}
+
+/// @brief Use the precompiled DSL header for the invocation (if enabled), the clang options
+/// (`clangArgs` without the program and the input file) have to be final
+///
+/// `PCHFile` stores the path to the precompiled header referenced by `clangArgs`.
+void usePrecompiledDSLHeader(GTClangContext* context, const char* program,
+                             llvm::SmallVectorImpl<const char*>& clangArgs, std::string& PCHFile) {
+  const Options& options = context->getOptions();
+  if(!options.PCH || options.Serialized || clangArgs.size() < 2)
+    return;
+
+  context->startTimer("precompiled DSL header");
+  PCHFile = getPrecompiledDSLHeader(program, llvm::makeArrayRef(clangArgs).drop_front(2),
+                                    options.PCHCacheDir);
+  context->stopTimer("precompiled DSL header");
+
+  if(!PCHFile.empty()) {
+    clangArgs.push_back("-include-pch");
+    clangArgs.push_back(PCHFile.c_str());
+  }
+}
+
+//===------------------------------------------------------------------------------------------===//
+//     Batch mode
+//===------------------------------------------------------------------------------------------===//
+
+/// @brief A single invocation of a batch
+struct BatchJob {
+  std::vector<std::string> Arguments; ///< Storage of the arguments given in the batch file
+  std::unique_ptr<GTClangContext> Context;
+  llvm::SmallVector<const char*, 16> ClangArgs;
+  std::string PCHFile;
+  int ExitCode = 0;
+};
+
+/// @brief Compile all invocations of the batch file `options.Batch`
+///
+/// The invocations share the process (and thus the LLVM/clang initialization) as well as the
+/// precompiled DSL headers and up to `options.Jobs` invocations are compiled concurrently.
+ReturnValue runBatch(const char* program, const Options& options) {
+  auto bufferOrError = llvm::MemoryBuffer::getFile(options.Batch);
+  if(!bufferOrError) {
+    llvm::errs() << "error: cannot read batch file '" << options.Batch
+                 << "': " << bufferOrError.getError().message() << "\n";
+    return ReturnValue{1, nullptr};
+  }
+
+  // Parse the invocations
+  std::vector<std::unique_ptr<BatchJob>> jobs;
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  (*bufferOrError)->getBuffer().split(lines, '\n');
+  for(std::size_t lineIdx = 0; lineIdx < lines.size(); ++lineIdx) {
+    std::vector<std::string> arguments = splitBatchLine(lines[lineIdx]);
+    if(arguments.empty())
+      continue;
+
+    auto job = std::make_unique<BatchJob>();
+    job->Arguments = std::move(arguments);
+    job->Context = std::make_unique<GTClangContext>();
+
+    llvm::SmallVector<const char*, 16> args{program};
+    for(const auto& arg : job->Arguments)
+      args.push_back(arg.c_str());
+
+    OptionsParser optionsParser(&job->Context->getOptions());
+    if(!optionsParser.parse(args, job->ClangArgs))
+      return ReturnValue{1, nullptr};
+
+    if(!job->Context->getOptions().Batch.empty() || job->ClangArgs.size() < 2) {
+      llvm::errs() << options.Batch << ":" << (lineIdx + 1) << ": error: "
+                   << (job->ClangArgs.size() < 2 ? "no input file" : "nested batch") << "\n";
+      return ReturnValue{1, nullptr};
+    }
+    jobs.push_back(std::move(job));
+  }
+
+  // Add the DSL includes to every input file (once, as several invocations may share a file)
+  std::map<std::string, GTClangIncludeChecker> includeCheckers;
+  for(const auto& job : jobs) {
+    std::string sourceFile = job->ClangArgs[1];
+    if(!includeCheckers.count(sourceFile))
+      includeCheckers[sourceFile].Update(sourceFile);
+  }
+
+  // Look up the precompiled DSL headers, serially as they may need to be generated
+  for(const auto& job : jobs)
+    usePrecompiledDSLHeader(job->Context.get(), program, job->ClangArgs, job->PCHFile);
+
+  // Compile the invocations, the main thread takes part in the work
+  std::atomic<std::size_t> nextJob(0);
+  auto worker = [&]() {
+    for(std::size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+      // Number the IR of every invocation from scratch, as a separate gtclang process would
+      dawn::UIDGenerator::getInstance()->reset();
+      std::shared_ptr<dawn::SIR> SIR;
+      jobs[i]->ExitCode = runCompilerInstance(jobs[i]->Context.get(), jobs[i]->ClangArgs, SIR);
+    }
+  };
+
+  const std::size_t numThreads =
+      std::min(static_cast<std::size_t>(std::max(options.Jobs, 1)), jobs.size());
+  std::vector<std::thread> threads;
+  for(std::size_t i = 1; i < numThreads; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for(auto& thread : threads)
+    thread.join();
+
+  for(auto& sourceFileCheckerPair : includeCheckers)
+    sourceFileCheckerPair.second.Restore();
+
+  int ret = 0;
+  for(const auto& job : jobs) {
+    if(job->ExitCode)
+      llvm::errs() << "error: compilation of '" << job->ClangArgs[1] << "' failed\n";
+    ret |= job->ExitCode;
+  }
+  DAWN_LOG(INFO) << "Batch of " << jobs.size() << " invocations finished "
+                 << (ret ? "with errors" : "successfully");
+  return ReturnValue{ret, nullptr};
+}
+
+} // anonymous namespace
+
+std::vector<std::string> splitBatchLine(llvm::StringRef line) {
+  std::vector<std::string> arguments;
+  line = line.trim();
+  if(line.startswith("#"))
+    return arguments;
+
+  std::string current;
+  bool inArgument = false, inQuotes = false;
+  for(std::size_t i = 0; i < line.size(); ++i) {
+    const char c = line[i];
+    if(c == '\\' && i + 1 < line.size()) {
+      current += line[++i];
+      inArgument = true;
+    } else if(c == '"') {
+      inQuotes = !inQuotes;
+      inArgument = true;
+    } else if(!inQuotes && (c == ' ' || c == '\t')) {
+      if(inArgument)
+        arguments.push_back(current);
+      current.clear();
+      inArgument = false;
+    } else {
+      current += c;
+      inArgument = true;
+    }
+  }
+  if(inArgument)
+    arguments.push_back(current);
+  return arguments;
+}
+
 bool Driver::isInitialized = false;
 
 ReturnValue Driver::run(const llvm::SmallVectorImpl<const char*>& args) {
@@ -57,52 +291,23 @@ ReturnValue Driver::run(const llvm::SmallVectorImpl<const char*>& args) {
   if(!optionsParser.parse(args, clangArgs))
     return ReturnValue{1, returnSIR};
 
-  // Save existing formatter and set to gtclang
-  auto infoMessageFormatter = dawn::log::info.messageFormatter();
-  auto warnMessageFormatter = dawn::log::warn.messageFormatter();
-  auto errorMessageFormatter = dawn::log::error.messageFormatter();
-  dawn::log::info.messageFormatter(makeGTClangMessageFormatter("[INFO]"));
-  dawn::log::warn.messageFormatter(makeGTClangMessageFormatter("[WARNING]"));
-  dawn::log::error.messageFormatter(makeGTClangMessageFormatter("[ERROR]"));
-
-  auto infoDiagnosticFormatter = dawn::log::info.diagnosticFormatter();
-  auto warnDiagnosticFormatter = dawn::log::warn.diagnosticFormatter();
-  auto errorDiagnosticFormatter = dawn::log::error.diagnosticFormatter();
-  dawn::log::info.diagnosticFormatter(makeGTClangDiagnosticFormatter("[INFO]"));
-  dawn::log::warn.diagnosticFormatter(makeGTClangDiagnosticFormatter("[WARNING]"));
-  dawn::log::error.diagnosticFormatter(makeGTClangDiagnosticFormatter("[ERROR]"));
+  // Set the formatters to gtclang (the existing ones are restored on exit)
+  ScopedGTClangFormatters formatters;
+
+  if(!context->getOptions().Batch.empty())
+    return runBatch(args[0], context->getOptions());
 
   GTClangIncludeChecker includeChecker;
   if(clangArgs.size() > 1)
     includeChecker.Update(clangArgs[1]);
 
-  // Create GTClang
-  std::unique_ptr<clang::CompilerInstance> GTClang(createCompilerInstance(clangArgs));
+  std::string PCHFile;
+  usePrecompiledDSLHeader(context.get(), args[0], clangArgs, PCHFile);
 
-  int ret = 0;
-  if(GTClang) {
-    std::unique_ptr<clang::FrontendAction> PPAction(new GTClangPreprocessorAction(context.get()));
-    ret |= !GTClang->ExecuteAction(*PPAction);
-
-    if(ret == 0) {
-      std::unique_ptr<GTClangASTAction> ASTAction(new GTClangASTAction(context.get()));
-      ret |= !GTClang->ExecuteAction(*ASTAction);
-      returnSIR = ASTAction->getSIR();
-    }
-    DAWN_LOG(INFO) << "Compilation finished " << (ret ? "with errors" : "successfully");
-  }
+  int ret = runCompilerInstance(context.get(), clangArgs, returnSIR);
 
   includeChecker.Restore();
 
-  // Reset formatters
-  dawn::log::info.messageFormatter(infoMessageFormatter);
-  dawn::log::warn.messageFormatter(warnMessageFormatter);
-  dawn::log::error.messageFormatter(errorMessageFormatter);
-
-  dawn::log::info.diagnosticFormatter(infoDiagnosticFormatter);
-  dawn::log::warn.diagnosticFormatter(warnDiagnosticFormatter);
-  dawn::log::error.diagnosticFormatter(errorDiagnosticFormatter);
-
   return ReturnValue{ret, returnSIR};
 }
 
@@ -123,57 +328,19 @@ std::shared_ptr<dawn::SIR> run(const std::string& fileName, const ParseOptions&
   clangArgs.push_back("gtc-parse");
   clangArgs.push_back(fileName.c_str());
 
-  // Save existing formatter and set to gtclang
-  auto infoMessageFormatter = dawn::log::info.messageFormatter();
-  auto warnMessageFormatter = dawn::log::warn.messageFormatter();
-  auto errorMessageFormatter = dawn::log::error.messageFormatter();
-  dawn::log::info.messageFormatter(makeGTClangMessageFormatter("[INFO]"));
-  dawn::log::warn.messageFormatter(makeGTClangMessageFormatter("[WARNING]"));
-  dawn::log::error.messageFormatter(makeGTClangMessageFormatter("[ERROR]"));
-
-  auto infoDiagnosticFormatter = dawn::log::info.diagnosticFormatter();
-  auto warnDiagnosticFormatter = dawn::log::warn.diagnosticFormatter();
-  auto errorDiagnosticFormatter = dawn::log::error.diagnosticFormatter();
-  dawn::log::info.diagnosticFormatter(makeGTClangDiagnosticFormatter("[INFO]"));
-  dawn::log::warn.diagnosticFormatter(makeGTClangDiagnosticFormatter("[WARNING]"));
-  dawn::log::error.diagnosticFormatter(makeGTClangDiagnosticFormatter("[ERROR]"));
+  // Set the formatters to gtclang (the existing ones are restored on exit)
+  ScopedGTClangFormatters formatters;
 
   gtclang::GTClangIncludeChecker includeChecker;
   if(clangArgs.size() > 1)
     includeChecker.Update(clangArgs[1]);
 
-  // Create GTClang
-  std::unique_ptr<clang::CompilerInstance> GTClang(gtclang::createCompilerInstance(clangArgs));
-
   // Create SIR as return value
   std::shared_ptr<dawn::SIR> stencilIR = nullptr;
-
-  int ret = 0;
-  if(GTClang) {
-    std::unique_ptr<clang::FrontendAction> PPAction(
-        new gtclang::GTClangPreprocessorAction(context.get()));
-    ret |= !GTClang->ExecuteAction(*PPAction);
-
-    if(ret == 0) {
-      std::unique_ptr<gtclang::GTClangASTAction> ASTAction(
-          new gtclang::GTClangASTAction(context.get()));
-      ret |= !GTClang->ExecuteAction(*ASTAction);
-      stencilIR = ASTAction->getSIR();
-    }
-    DAWN_LOG(INFO) << "Compilation finished " << (ret ? "with errors" : "successfully");
-  }
+  runCompilerInstance(context.get(), clangArgs, stencilIR);
 
   includeChecker.Restore();
 
-  // Reset formatters
-  dawn::log::info.messageFormatter(infoMessageFormatter);
-  dawn::log::warn.messageFormatter(warnMessageFormatter);
-  dawn::log::error.messageFormatter(errorMessageFormatter);
-
-  dawn::log::info.diagnosticFormatter(infoDiagnosticFormatter);
-  dawn::log::warn.diagnosticFormatter(warnDiagnosticFormatter);
-  dawn::log::error.diagnosticFormatter(errorDiagnosticFormatter);
-
   return stencilIR;
 }
 
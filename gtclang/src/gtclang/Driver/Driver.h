@@ -21,6 +21,7 @@
 #include "dawn/Support/NonCopyable.h"
 #include "gtclang/Driver/Options.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 #include <string>
 #include <vector>
 
@@ -38,6 +39,11 @@ struct ReturnValue {
 struct Driver : public dawn::NonCopyable {
 
   /// @brief Run gtclang on the given arguments
+  ///
+  /// With `-batch=<file>` all invocations listed in the file are compiled within this process (up
+  /// to `-jobs` of them concurrently), sharing a precompiled header of the DSL. No SIR is returned
+  /// in this case.
+  ///
   /// @returns The Stencil Intermediate Representation and an integer that is `0` on success, `1`
   /// otherwise
   static ReturnValue run(const llvm::SmallVectorImpl<const char*>& args);
@@ -45,6 +51,14 @@ struct Driver : public dawn::NonCopyable {
   static bool isInitialized;
 };
 
+/// @brief Split a line of a batch file (see `-batch`) into the arguments of an invocation
+///
+/// Arguments are separated by whitespace, double quotes group an argument containing whitespace
+/// and a backslash escapes the next character. Empty lines and lines starting with `#` yield no
+/// arguments.
+/// @ingroup driver
+std::vector<std::string> splitBatchLine(llvm::StringRef line);
+
 /// @brief Driver for the gtclang parser
 /// @ingroup driver
 std::shared_ptr<dawn::SIR> run(const std::string& fileName, const ParseOptions& options = {});
@@ -74,7 +74,8 @@ DAWN_ATTRIBUTE_NORETURN static void helpPrinter() {
   const int maxLineLen = 80;
 
   llvm::outs() << "OVERVIEW: gtclang - gridtools clang DSL compiler\n\n";
-  llvm::outs() << "USAGE: gtclang [options] file -- [clang-options]\n\n";
+  llvm::outs() << "USAGE: gtclang [options] file -- [clang-options]\n";
+  llvm::outs() << "       gtclang -batch=<file> [-jobs=<n>]\n\n";
   llvm::outs() << "OPTIONS:\n";
   llvm::outs() << splitString("Options not recognized by gtclang are automatically forwarded to "
                               "clang. Options after '--' are directly passed to clang. Options "
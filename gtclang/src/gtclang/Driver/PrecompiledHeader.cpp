@@ -0,0 +1,184 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "gtclang/Driver/PrecompiledHeader.h"
+#include "dawn/Support/Logger.h"
+#include "gtclang/Driver/CompilerInstance.h"
+#include "gtclang/Support/Config.h"
+#include "clang/Basic/Version.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+#include <algorithm>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define GTCLANG_PCH_CHECK_OWNER
+#endif
+
+namespace gtclang {
+
+namespace {
+
+/// @brief Locate `gtclang_dsl_defs/gtclang_dsl.hpp` in the DSL include paths
+/// @returns the path to the header or an empty string if the header was not found
+std::string findDSLHeader() {
+  llvm::SmallVector<llvm::StringRef, 2> DSLIncludes;
+  llvm::StringRef(GTCLANG_DSL_INCLUDES).split(DSLIncludes, ';');
+  for(const auto& path : DSLIncludes) {
+    llvm::SmallString<256> header(path);
+    llvm::sys::path::append(header, "gtclang_dsl_defs", "gtclang_dsl.hpp");
+    if(llvm::sys::fs::exists(header))
+      return std::string(header.str());
+  }
+  return "";
+}
+
+/// @brief Compute the cache key of the precompiled DSL header
+std::string computeCacheKey(const std::string& header, llvm::ArrayRef<const char*> clangOptions) {
+  llvm::MD5 hash;
+  auto update = [&hash](llvm::StringRef str) {
+    hash.update(str);
+    hash.update("\n");
+  };
+
+  update(GTCLANG_FULL_VERSION_STR);
+  update(clang::getClangFullVersion());
+  update(header);
+  for(const char* option : clangOptions)
+    update(option);
+
+  // Any change of the DSL headers invalidates the precompiled header (clang would reject it)
+  std::vector<std::string> headerStates;
+  std::error_code ec;
+  llvm::sys::fs::recursive_directory_iterator it(llvm::sys::path::parent_path(header), ec), end;
+  for(; it != end && !ec; it.increment(ec)) {
+    llvm::sys::fs::file_status status;
+    if(llvm::sys::fs::status(it->path(), status) || !llvm::sys::fs::is_regular_file(status))
+      continue;
+    headerStates.push_back(
+        it->path() + ":" + std::to_string(status.getSize()) + ":" +
+        std::to_string(status.getLastModificationTime().time_since_epoch().count()));
+  }
+  std::sort(headerStates.begin(), headerStates.end());
+  for(const auto& headerState : headerStates)
+    update(headerState);
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  llvm::SmallString<32> key;
+  llvm::MD5::stringifyResult(result, key);
+  return std::string(key.str());
+}
+
+/// @brief Create the cache directory `dir` accessible by the user only, or check that an existing
+/// one is owned by the user and not writable by anyone else
+///
+/// Whoever can write to the cache directory controls the code parsed into the stencils, hence a
+/// directory shared with other users is rejected.
+std::error_code prepareCacheDir(llvm::StringRef dir) {
+  if(std::error_code ec =
+         llvm::sys::fs::create_directories(dir, /*IgnoreExisting=*/true, llvm::sys::fs::owner_all))
+    return ec;
+
+  llvm::sys::fs::file_status status;
+  if(std::error_code ec = llvm::sys::fs::status(dir, status))
+    return ec;
+  if(!llvm::sys::fs::is_directory(status))
+    return std::make_error_code(std::errc::not_a_directory);
+#ifdef GTCLANG_PCH_CHECK_OWNER
+  if(status.getUser() != ::getuid())
+    return std::make_error_code(std::errc::permission_denied);
+#endif
+  if(status.permissions() & (llvm::sys::fs::group_write | llvm::sys::fs::others_write))
+    return std::make_error_code(std::errc::permission_denied);
+  return std::error_code();
+}
+
+} // anonymous namespace
+
+std::string getDefaultPCHCacheDir() {
+  llvm::SmallString<256> cacheDir;
+  if(!llvm::sys::path::cache_directory(cacheDir))
+    return "";
+  llvm::sys::path::append(cacheDir, "gtclang", "pch");
+  return std::string(cacheDir.str());
+}
+
+std::string getPrecompiledDSLHeader(const char* program, llvm::ArrayRef<const char*> clangOptions,
+                                    llvm::StringRef cacheDir) {
+  const std::string header = findDSLHeader();
+  if(header.empty()) {
+    DAWN_LOG(WARNING) << "DSL header not found, parsing it without precompiled header";
+    return "";
+  }
+
+  llvm::SmallString<256> PCHFile(cacheDir.empty() ? getDefaultPCHCacheDir() : cacheDir.str());
+  if(PCHFile.empty()) {
+    DAWN_LOG(WARNING) << "No PCH cache directory (neither $XDG_CACHE_HOME nor $HOME is set), "
+                         "parsing the DSL header without precompiled header";
+    return "";
+  }
+  if(std::error_code ec = prepareCacheDir(PCHFile)) {
+    DAWN_LOG(WARNING) << "Cannot use PCH cache directory " << PCHFile.str().str() << ": "
+                      << ec.message() << ", parsing the DSL header without precompiled header";
+    return "";
+  }
+  llvm::sys::path::append(PCHFile, "gtclang_dsl-" + computeCacheKey(header, clangOptions) + ".pch");
+
+  if(llvm::sys::fs::exists(PCHFile)) {
+    DAWN_LOG(INFO) << "Using precompiled DSL header " << PCHFile.str().str();
+    return std::string(PCHFile.str());
+  }
+
+  // Generate into a unique file which is renamed in the end, concurrent gtclang processes thus
+  // never see a partially written precompiled header
+  DAWN_LOG(INFO) << "Precompiling DSL header " << header << " into " << PCHFile.str().str();
+  llvm::SmallString<256> tmpFile;
+  if(llvm::sys::fs::createUniqueFile(llvm::Twine(PCHFile) + "-%%%%%%%%.tmp", tmpFile)) {
+    DAWN_LOG(WARNING) << "Cannot create temporary file in the PCH cache directory";
+    return "";
+  }
+
+  llvm::SmallVector<const char*, 16> args{program, "-x", "c++-header", header.c_str()};
+  args.append(clangOptions.begin(), clangOptions.end());
+
+  bool success = false;
+  std::unique_ptr<clang::CompilerInstance> GTClang(createCompilerInstance(args));
+  if(GTClang) {
+    GTClang->getFrontendOpts().OutputFile = std::string(tmpFile.str());
+    clang::GeneratePCHAction PCHAction;
+    success = GTClang->ExecuteAction(PCHAction);
+  }
+
+  if(!success || llvm::sys::fs::rename(tmpFile, PCHFile)) {
+    llvm::sys::fs::remove(tmpFile);
+    DAWN_LOG(WARNING) << "Failed to precompile DSL header " << header
+                      << ", parsing it without precompiled header";
+    return "";
+  }
+  return std::string(PCHFile.str());
+}
+
+} // namespace gtclang
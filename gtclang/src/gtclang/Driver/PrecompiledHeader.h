@@ -0,0 +1,54 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#ifndef GTCLANG_DRIVER_PRECOMPILEDHEADER_H
+#define GTCLANG_DRIVER_PRECOMPILEDHEADER_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+
+namespace gtclang {
+
+/// @brief Get the precompiled header of the DSL (`gtclang_dsl_defs/gtclang_dsl.hpp`) for the given
+/// clang options, generating it if it is not yet in the cache
+///
+/// The precompiled headers are keyed on the version of gtclang and clang, the clang options and
+/// the state (size and modification time) of the DSL headers. They are written atomically, hence
+/// concurrent gtclang processes can share the cache.
+///
+/// The cache directory has to be owned by the user and must not be writable by anyone else (it is
+/// created accessible by the user only), otherwise no precompiled header is used.
+///
+/// @param program        Name of the program (`argv[0]`)
+/// @param clangOptions   Options passed to clang (without the input file)
+/// @param cacheDir       Cache directory, `getDefaultPCHCacheDir()` if empty
+/// @returns Path to the precompiled header or an empty string if it could not be generated
+///
+/// @ingroup driver
+std::string getPrecompiledDSLHeader(const char* program, llvm::ArrayRef<const char*> clangOptions,
+                                    llvm::StringRef cacheDir);
+
+/// @brief Per-user cache directory of the precompiled headers, `gtclang/pch` in `$XDG_CACHE_HOME`
+/// (or `~/.cache`)
+/// @returns the directory or an empty string if the user has no cache directory
+///
+/// @ingroup driver
+std::string getDefaultPCHCacheDir();
+
+} // namespace gtclang
+
+#endif
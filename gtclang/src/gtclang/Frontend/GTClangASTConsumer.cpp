@@ -57,8 +57,10 @@ namespace {
 /// @brief Get current time-stamp
 static const std::string currentDateTime() {
   std::time_t now = time(0);
+  struct tm localTime;
+  localtime_r(&now, &localTime);
   char buf[80];
-  std::strftime(buf, sizeof(buf), "%Y-%m-%d  %X", std::localtime(&now));
+  std::strftime(buf, sizeof(buf), "%Y-%m-%d  %X", &localTime);
   return buf;
 }
 
@@ -72,6 +74,10 @@ GTClangASTConsumer::GTClangASTConsumer(GTClangContext* context, const std::strin
 }
 
 void GTClangASTConsumer::HandleTranslationUnit(clang::ASTContext& ASTContext) {
+  // Clang is done parsing, the timer of the remaining phase is stopped by the driver
+  context_->stopTimer("parsing");
+  context_->startTimer("SIR generation, optimization and code generation");
+
   context_->setASTContext(&ASTContext);
   if(!context_->hasDiagnostics())
     context_->setDiagnostics(&ASTContext.getDiagnostics());
@@ -139,6 +145,12 @@ void GTClangASTConsumer::HandleTranslationUnit(clang::ASTContext& ASTContext) {
   if(context_->getOptions().SetStageName || context_->getOptions().DefaultOptimization)
     passGroup.push_back(dawn::PassGroup::SetStageName);
 
+  if(context_->getOptions().ConstantFolding)
+    passGroup.push_back(dawn::PassGroup::ConstantFolding);
+
+  if(context_->getOptions().StencilMerger)
+    passGroup.push_back(dawn::PassGroup::StencilMerger);
+
   if(context_->getOptions().StageReordering || context_->getOptions().DefaultOptimization)
     passGroup.push_back(dawn::PassGroup::StageReordering);
 
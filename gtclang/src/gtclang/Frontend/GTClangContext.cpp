@@ -17,6 +17,9 @@
 #include "gtclang/Frontend/GTClangContext.h"
 #include "dawn/Support/Assert.h"
 #include "clang/AST/ASTContext.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 
 namespace gtclang {
 
@@ -99,4 +102,48 @@ void GTClangContext::setStencilAttribute(const std::string& name, dawn::ast::Att
   stencilNameToAttributeMap_.emplace(name, attr);
 }
 
+void GTClangContext::startTimer(const std::string& phase) {
+  if(options_->ReportTiming)
+    runningTimers_[phase] = std::chrono::steady_clock::now();
+}
+
+void GTClangContext::stopTimer(const std::string& phase) {
+  auto timer = runningTimers_.find(phase);
+  if(timer == runningTimers_.end())
+    return;
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - timer->second;
+  runningTimers_.erase(timer);
+
+  auto timing = std::find_if(timings_.begin(), timings_.end(),
+                             [&](const std::pair<std::string, double>& phaseTimePair) {
+                               return phaseTimePair.first == phase;
+                             });
+  if(timing == timings_.end())
+    timings_.emplace_back(phase, elapsed.count());
+  else
+    timing->second += elapsed.count();
+}
+
+const std::vector<std::pair<std::string, double>>& GTClangContext::getTimings() const {
+  return timings_;
+}
+
+void GTClangContext::printTimingReport(llvm::raw_ostream& os, const std::string& title) const {
+  if(timings_.empty())
+    return;
+
+  // Assemble the report first, such that reports of concurrent compilations do not interleave
+  std::string report;
+  llvm::raw_string_ostream ss(report);
+  ss << "===-- gtclang timing report: " << title << " --===\n";
+  double total = 0.0;
+  for(const auto& phaseTimePair : timings_) {
+    ss << llvm::format("  %-50s %10.4f s\n", phaseTimePair.first.c_str(), phaseTimePair.second);
+    total += phaseTimePair.second;
+  }
+  ss << llvm::format("  %-50s %10.4f s\n", "total", total);
+  os << ss.str();
+  os.flush();
+}
+
 } // namespace gtclang
@@ -21,13 +21,21 @@
 #include "dawn/Support/NonCopyable.h"
 #include "gtclang/Driver/Options.h"
 #include "gtclang/Frontend/Diagnostics.h"
+#include <chrono>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace clang {
 class ASTContext;
 }
 
+namespace llvm {
+class raw_ostream;
+}
+
 namespace gtclang {
 
 /// @brief Context of the GTClang tool
@@ -44,6 +52,11 @@ class GTClangContext : dawn::NonCopyable {
 
   bool useDawn_;
 
+  // Accumulated wall-clock time (in seconds) of the compilation phases in order of their first
+  // occurrence and the start of the running phases
+  std::vector<std::pair<std::string, double>> timings_;
+  std::unordered_map<std::string, std::chrono::steady_clock::time_point> runningTimers_;
+
 public:
   GTClangContext();
 
@@ -96,6 +109,17 @@ public:
   dawn::ast::Attr getStencilAttribute(const std::string& name) const;
   void setStencilAttribute(const std::string& name, dawn::ast::Attr attr);
   /// @}
+
+  /// @name Timing of the compilation phases
+  ///
+  /// The timers are only running if `-report-timing` is set, stopping a timer which is not running
+  /// has no effect.
+  /// @{
+  void startTimer(const std::string& phase);
+  void stopTimer(const std::string& phase);
+  void printTimingReport(llvm::raw_ostream& os, const std::string& title) const;
+  const std::vector<std::pair<std::string, double>>& getTimings() const;
+  /// @}
 };
 
 } // namespace gtclang
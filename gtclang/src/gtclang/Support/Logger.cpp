@@ -17,6 +17,7 @@
 #include "gtclang/Support/Logger.h"
 #include "dawn/Support/Format.h"
 #include <chrono>
+#include <ctime>
 #include <sstream>
 
 namespace gtclang {
@@ -30,10 +31,11 @@ dawn::Logger::MessageFormatter makeGTClangMessageFormatter(const std::string& pr
     auto tm_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now_ms - now_sec);
 
     std::time_t currentTime = std::chrono::system_clock::to_time_t(now);
-    struct tm* localTime = std::localtime(&currentTime);
+    struct tm localTime;
+    localtime_r(&currentTime, &localTime);
 
-    auto timeStr = dawn::format("%02i:%02i:%02i.%03i", localTime->tm_hour, localTime->tm_min,
-                                localTime->tm_sec, tm_ms.count());
+    auto timeStr = dawn::format("%02i:%02i:%02i.%03i", localTime.tm_hour, localTime.tm_min,
+                                localTime.tm_sec, tm_ms.count());
 
     std::stringstream ss;
     ss << "[" << timeStr << "] ";
@@ -54,10 +56,11 @@ dawn::Logger::DiagnosticFormatter makeGTClangDiagnosticFormatter(const std::stri
     auto tm_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now_ms - now_sec);
 
     std::time_t currentTime = std::chrono::system_clock::to_time_t(now);
-    struct tm* localTime = std::localtime(&currentTime);
+    struct tm localTime;
+    localtime_r(&currentTime, &localTime);
 
-    auto timeStr = dawn::format("%02i:%02i:%02i.%03i", localTime->tm_hour, localTime->tm_min,
-                                localTime->tm_sec, tm_ms.count());
+    auto timeStr = dawn::format("%02i:%02i:%02i.%03i", localTime.tm_hour, localTime.tm_min,
+                                localTime.tm_sec, tm_ms.count());
 
     std::stringstream ss;
     ss << "[" << timeStr << "] ";
@@ -0,0 +1,55 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#ifndef TEST_INTEGRATIONTEST_CODEGEN_BENCHMARK_H
+#define TEST_INTEGRATIONTEST_CODEGEN_BENCHMARK_H
+
+#include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Macros.hpp"
+#include "test/integration-test/CodeGen/Options.hpp"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * Times `stencil.run(storages...)` if the test was started with `--benchmark=<file>` and appends
+ * the result to <file>, one JSON object per line. Results are tagged with the test name and the
+ * backend, `run_benchmarks.py` collects them into a single report.
+ */
+template <typename Stencil, typename... Storages>
+void benchmark(const gridtools::dawn::verifier& verif, const std::string& backend,
+               Stencil& stencil, Storages&... storages) {
+  const auto& options = dawn::Options::getInstance();
+  if(options.m_benchmarkFile.empty())
+    return;
+
+  auto result = verif.runBenchmarks(stencil, options.m_benchmarkWarmup,
+                                    options.m_benchmarkRepetitions, storages...);
+
+  const auto* testInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+  std::ofstream out(options.m_benchmarkFile, std::ios::app);
+  result.to_json(out, {{"test", "\"" + std::string(testInfo->test_case_name()) + "." +
+                                    testInfo->name() + "\""},
+                       {"backend", "\"" + backend + "\""}});
+  out << "\n";
+}
+
+/// Name of the optimized backend the test is compiled with, variants of a backend (e.g. code
+/// generated for a fixed domain size) define their own name
+#ifndef OPTBACKEND_NAME
+#define OPTBACKEND_NAME STRINGIFY(OPTBACKEND)
+#endif
+
+#endif
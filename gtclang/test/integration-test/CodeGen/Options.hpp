@@ -40,6 +40,11 @@ public:
 
   int m_size[4] = {12, 12, 12, 10};
   bool m_verify;
+
+  /// Benchmark results are appended to this file (JSON lines), no benchmarks are run if empty
+  std::string m_benchmarkFile;
+  int m_benchmarkWarmup = 3;
+  int m_benchmarkRepetitions = 10;
 };
 } // namespace dawn
 
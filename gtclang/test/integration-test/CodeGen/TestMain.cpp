@@ -15,6 +15,7 @@
 //===------------------------------------------------------------------------------------------===//
 #include <gtest/gtest.h>
 #include "test/integration-test/CodeGen/Options.hpp"
+#include <string>
 
 using namespace dawn;
 
@@ -23,12 +24,28 @@ int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
   if(argc < 4) {
-    printf("Usage: <pack>_stencil_<whatever> dimx dimy dimz\n where args are integer sizes of the data fields\n");
+    printf("Usage: <pack>_stencil_<whatever> dimx dimy dimz [--benchmark=<file>] [--warmup=<n>] "
+           "[--repetitions=<n>]\n where args are integer sizes of the data fields\n");
     return 1;
   }
 
   for(int i = 0; i != 3; ++i) {
     Options::getInstance().m_size[i] = atoi(argv[i + 1]);
   }
+
+  for(int i = 4; i < argc; ++i) {
+    std::string arg(argv[i]);
+    auto value = arg.substr(arg.find('=') + 1);
+    if(arg.rfind("--benchmark=", 0) == 0) {
+      Options::getInstance().m_benchmarkFile = value;
+    } else if(arg.rfind("--warmup=", 0) == 0) {
+      Options::getInstance().m_benchmarkWarmup = atoi(value.c_str());
+    } else if(arg.rfind("--repetitions=", 0) == 0) {
+      Options::getInstance().m_benchmarkRepetitions = atoi(value.c_str());
+    } else {
+      printf("Unknown argument: %s\n", argv[i]);
+      return 1;
+    }
+  }
   return RUN_ALL_TESTS();
 }
@@ -25,6 +25,7 @@
 #define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
 
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/asymmetric_c++-naive.cpp"
@@ -59,4 +60,7 @@ TEST(asymmetric, test) {
   stencil_naive.run(in, out_naive);
 
   ASSERT_TRUE(verif.verify(out_opt, out_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, stencil_opt, in, out_opt);
+  benchmark(verif, "cxxnaive", stencil_naive, in, out_naive);
 }
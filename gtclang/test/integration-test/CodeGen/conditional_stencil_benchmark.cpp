@@ -27,6 +27,7 @@
 #include <gtest/gtest.h>
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/conditional_stencil_c++-naive.cpp"
 
@@ -62,4 +63,7 @@ TEST(conditional_stencil, test) {
   conditional_naive.run(in, out_naive);
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, conditional_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", conditional_naive, in, out_naive);
 }
@@ -27,6 +27,7 @@
 #include <gtest/gtest.h>
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/copy_stencil_c++-naive.cpp"
 
@@ -59,4 +60,7 @@ TEST(copy_stencil, test) {
   copy_naive.run(in, out_naive);
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, copy_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", copy_naive, in, out_naive);
 }
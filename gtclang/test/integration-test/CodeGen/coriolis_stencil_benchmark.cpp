@@ -26,6 +26,7 @@
 
 #include <gtest/gtest.h>
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/coriolis_stencil_c++-naive.cpp"
@@ -63,4 +64,8 @@ TEST(coriolis_stencil, test) {
 
   ASSERT_TRUE(verif.verify(u_tens_gt, u_tens_cxxnaive));
   ASSERT_TRUE(verif.verify(v_tens_gt, v_tens_cxxnaive));
+
+  benchmark(verif, OPTBACKEND_NAME, coriolis_gt, u_tens_gt, u_nnow, v_tens_gt, v_nnow, fc);
+  benchmark(verif, "cxxnaive", coriolis_cxxnaive, u_tens_cxxnaive, u_nnow, v_tens_cxxnaive, v_nnow,
+            fc);
 }
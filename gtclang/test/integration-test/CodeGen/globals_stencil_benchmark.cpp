@@ -27,6 +27,7 @@
 
 #include <gtest/gtest.h>
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 
@@ -59,4 +60,7 @@ TEST(globals_stencil, test) {
   globals_naive.run(in, out_naive);
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, globals_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", globals_naive, in, out_naive);
 }
@@ -26,6 +26,7 @@
 #define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
 
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/hd_smagorinsky_c++-naive.cpp"
@@ -96,4 +97,10 @@ TEST(hd_smagorinsky, test) {
 
   ASSERT_TRUE(verif.verify(u_out_gt, u_out_naive));
   ASSERT_TRUE(verif.verify(v_out_gt, v_out_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, hd_smagorinsky_gt, u_out_gt, v_out_gt, u_in, v_in, hdmaskvel,
+            crlavo, crlavu, crlato, crlatu, acrlat0, eddlon, eddlat, tau_smag, weight_smag);
+  benchmark(verif, "cxxnaive", hd_smagorinsky_naive, u_out_naive, v_out_naive, u_in, v_in,
+            hdmaskvel, crlavo, crlavu, crlato, crlatu, acrlat0, eddlon, eddlat, tau_smag,
+            weight_smag);
 }
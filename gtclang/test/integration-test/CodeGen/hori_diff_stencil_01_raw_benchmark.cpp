@@ -0,0 +1,77 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#define DAWN_GENERATED 1
+#define GRIDTOOLS_DAWN_HALO_EXTENT 3
+#define GT_VECTOR_LIMIT_SIZE 30
+
+#undef FUSION_MAX_VECTOR_SIZE
+#undef FUSION_MAX_MAP_SIZE
+#define FUSION_MAX_VECTOR_SIZE GT_VECTOR_LIMIT_SIZE
+#define FUSION_MAX_MAP_SIZE FUSION_MAX_VECTOR_SIZE
+#define BOOST_MPL_LIMIT_VECTOR_SIZE FUSION_MAX_VECTOR_SIZE
+#define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "test/integration-test/CodeGen/Macros.hpp"
+#include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Options.hpp"
+#include "test/integration-test/CodeGen/generated/hori_diff_stencil_01_raw_c++-naive.h"
+#include "test/integration-test/CodeGen/generated/hori_diff_stencil_01_raw_c++-naive.cpp"
+
+using namespace dawn;
+TEST(hori_diff_stencil_01_raw, test) {
+  domain dom(Options::getInstance().m_size[0], Options::getInstance().m_size[1],
+             Options::getInstance().m_size[2]);
+  dom.set_halos(halo::value, halo::value, halo::value, halo::value, 0, 0);
+
+  verifier verif(dom);
+
+  meta_data_t meta_data(dom.isize(), dom.jsize(), dom.ksize() + 1);
+  storage_t u(meta_data, "u"), out_ref(meta_data, "out-ref");
+
+  verif.fillMath(8.0, 2.0, 1.5, 1.5, 2.0, 4.0, u);
+  verif.fill(-1.0, out_ref);
+
+  dawn_generated::cxxnaive::hori_diff_stencil hori_diff_ref(dom);
+  hori_diff_ref.run(u, out_ref);
+
+  // Caller owned arrays in Fortran (column major) layout, they are passed to the stencil as they
+  // are and the result is written in place
+  const int isize = dom.isize(), jsize = dom.jsize(), ksize = dom.ksize() + 1;
+  std::vector<::dawn::float_type> u_raw(isize * jsize * ksize);
+  std::vector<::dawn::float_type> out_raw(isize * jsize * ksize, -1.0);
+  auto index = [&](int i, int j, int k) { return i + j * isize + k * isize * jsize; };
+
+  auto u_view = make_host_view(u);
+  for(int k = 0; k < ksize; ++k)
+    for(int j = 0; j < jsize; ++j)
+      for(int i = 0; i < isize; ++i)
+        u_raw[index(i, j, k)] = u_view(i, j, k);
+
+  setup_hori_diff_stencil(dom.isize(), dom.jsize(), dom.ksize(), dom.iminus(), dom.iplus(),
+                          dom.jminus(), dom.jplus(), dom.kminus(), dom.kplus());
+  run_hori_diff_stencil(u_raw.data(), 1, isize, isize * jsize, out_raw.data(), 1, isize,
+                        isize * jsize);
+  free_hori_diff_stencil();
+
+  auto out_view = make_host_view(out_ref);
+  for(int k = dom.kminus(); k < dom.ksize() - dom.kplus(); ++k)
+    for(int j = dom.jminus(); j < dom.jsize() - dom.jplus(); ++j)
+      for(int i = dom.iminus(); i < dom.isize() - dom.iplus(); ++i)
+        ASSERT_NEAR(out_raw[index(i, j, k)], out_view(i, j, k), 1e-10)
+            << "at (" << i << ", " << j << ", " << k << ")";
+}
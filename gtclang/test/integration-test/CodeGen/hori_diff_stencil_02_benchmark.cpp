@@ -26,6 +26,7 @@
 
 #include <gtest/gtest.h>
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/hori_diff_stencil_02_c++-naive.cpp"
@@ -59,4 +60,7 @@ TEST(hori_diff_stencil_02, test) {
   hori_diff_naive.run(u, out_naive);
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, hori_diff_gt, u, out_gt);
+  benchmark(verif, "cxxnaive", hori_diff_naive, u, out_naive);
 }
@@ -26,6 +26,7 @@
 
 #include <gtest/gtest.h>
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/hori_diff_type2_stencil_c++-naive.cpp"
@@ -70,4 +71,7 @@ TEST(hori_diff_type2_stencil, test) {
   hd_naive.run(u_out_naive, u, crlato, crlatu, hdmask);
 
   ASSERT_TRUE(verif.verify(u_out_gt, u_out_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, hd_gt, u_out_gt, u, crlato, crlatu, hdmask);
+  benchmark(verif, "cxxnaive", hd_naive, u_out_naive, u, crlato, crlatu, hdmask);
 }
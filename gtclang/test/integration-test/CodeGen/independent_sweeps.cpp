@@ -0,0 +1,32 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#include "gtclang_dsl_defs/gtclang_dsl.hpp"
+
+using namespace gtclang::dsl;
+
+// A forward and a backward sweep on disjoint fields, their multistages can run concurrently
+stencil independent_sweeps {
+  storage in_a, out_a, in_b, out_b;
+
+  Do {
+    vertical_region(k_start + 1, k_end) {
+      out_a = in_a + out_a[k - 1];
+    }
+    vertical_region(k_end - 1, k_start) {
+      out_b = in_b + out_b[k + 1];
+    }
+  }
+};
@@ -0,0 +1,71 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#define DAWN_GENERATED 1
+#define GRIDTOOLS_DAWN_HALO_EXTENT 3
+#define GT_VECTOR_LIMIT_SIZE 30
+
+#undef FUSION_MAX_VECTOR_SIZE
+#undef FUSION_MAX_MAP_SIZE
+#define FUSION_MAX_VECTOR_SIZE GT_VECTOR_LIMIT_SIZE
+#define FUSION_MAX_MAP_SIZE FUSION_MAX_VECTOR_SIZE
+#define BOOST_MPL_LIMIT_VECTOR_SIZE FUSION_MAX_VECTOR_SIZE
+#define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
+
+#include <gtest/gtest.h>
+#include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
+#include "test/integration-test/CodeGen/Macros.hpp"
+#include "test/integration-test/CodeGen/Options.hpp"
+#include "test/integration-test/CodeGen/generated/independent_sweeps_c++-naive.cpp"
+
+#ifndef OPTBACKEND
+#define OPTBACKEND gt
+#endif
+
+// clang-format off
+#include INCLUDE_FILE(test/integration-test/CodeGen/generated/independent_sweeps_,OPTBACKEND.cpp)
+// clang-format on
+
+using namespace dawn;
+TEST(independent_sweeps, test) {
+  domain dom(Options::getInstance().m_size[0], Options::getInstance().m_size[1],
+             Options::getInstance().m_size[2]);
+  dom.set_halos(halo::value, halo::value, halo::value, halo::value, 0, 0);
+
+  verifier verif(dom);
+
+  meta_data_t meta_data(dom.isize(), dom.jsize(), dom.ksize() + 1);
+  storage_t in_a(meta_data, "in_a"), in_b(meta_data, "in_b"), out_a_gt(meta_data, "out_a_gt"),
+      out_a_naive(meta_data, "out_a_naive"), out_b_gt(meta_data, "out_b_gt"),
+      out_b_naive(meta_data, "out_b_naive");
+
+  verif.fillMath(8.0, 2.0, 1.5, 1.5, 2.0, 4.0, in_a);
+  verif.fillMath(7.4, 2.0, 1.5, 1.3, 2.1, 3.0, in_b);
+  verif.fillMath(8.0, 2.0, 1.4, 1.2, 2.3, 3.0, out_a_gt, out_a_naive);
+  verif.fillMath(7.8, 2.0, 1.1, 1.7, 1.9, 4.1, out_b_gt, out_b_naive);
+
+  dawn_generated::OPTBACKEND::independent_sweeps independent_sweeps_gt(dom);
+  dawn_generated::cxxnaive::independent_sweeps independent_sweeps_naive(dom);
+
+  independent_sweeps_gt.run(in_a, out_a_gt, in_b, out_b_gt);
+  independent_sweeps_naive.run(in_a, out_a_naive, in_b, out_b_naive);
+
+  ASSERT_TRUE(verif.verify(out_a_gt, out_a_naive));
+  ASSERT_TRUE(verif.verify(out_b_gt, out_b_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, independent_sweeps_gt, in_a, out_a_gt, in_b, out_b_gt);
+  benchmark(verif, "cxxnaive", independent_sweeps_naive, in_a, out_a_naive, in_b, out_b_naive);
+}
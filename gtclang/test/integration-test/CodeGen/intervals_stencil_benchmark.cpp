@@ -26,6 +26,7 @@
 #include "test/integration-test/CodeGen/generated/intervals_stencil_c++-naive.cpp"
 
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include <gtest/gtest.h>
@@ -59,5 +60,8 @@ TEST(intervals_stencil, test) {
   intervals_stencil_naive.run(in, out_naive);
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, intervals_stencil_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", intervals_stencil_naive, in, out_naive);
 }
 } // namespace
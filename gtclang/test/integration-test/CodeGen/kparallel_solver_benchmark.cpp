@@ -26,6 +26,7 @@
 
 #include <gtest/gtest.h>
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/kparallel_solver_c++-naive.cpp"
@@ -64,4 +65,7 @@ TEST(kparallel_solver, test) {
   kparallel_solver_naive.run(d_naive, a, b, c_naive);
 
   ASSERT_TRUE(verif.verify(d_gt, d_naive));
+
+  benchmark(verif, OPTBACKEND_NAME, kparallel_solver_gt, d_gt, a, b, c_gt);
+  benchmark(verif, "cxxnaive", kparallel_solver_naive, d_naive, a, b, c_naive);
 }
@@ -0,0 +1,106 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+#define DAWN_GENERATED 1
+#define GRIDTOOLS_DAWN_HALO_EXTENT 3
+#define GT_VECTOR_LIMIT_SIZE 30
+
+#undef FUSION_MAX_VECTOR_SIZE
+#undef FUSION_MAX_MAP_SIZE
+#define FUSION_MAX_VECTOR_SIZE GT_VECTOR_LIMIT_SIZE
+#define FUSION_MAX_MAP_SIZE FUSION_MAX_VECTOR_SIZE
+#define BOOST_MPL_LIMIT_VECTOR_SIZE FUSION_MAX_VECTOR_SIZE
+#define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "test/integration-test/CodeGen/Macros.hpp"
+#include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Options.hpp"
+#include "test/integration-test/CodeGen/generated/lap_halo_exchange_c++-naive.cpp"
+
+using namespace dawn;
+TEST(lap_halo_exchange, test) {
+  // Subdomains large enough for the interior (shrunk by the halo widths) to be computed while the
+  // halos are exchanged, the global domain is the union of the xcols x ycols subdomains
+  const int xcols = 3, ycols = 2;
+  const int isize = 8, jsize = 9, ksize = Options::getInstance().m_size[2];
+  const int h = halo::value;
+
+  auto value = [](int i, int j, int k) {
+    return std::sin(0.3 * i) * std::cos(0.2 * j) + 0.1 * k + 0.01 * i * j;
+  };
+
+  // single domain run
+  domain globalDom(xcols * isize + 2 * h, ycols * jsize + 2 * h, ksize);
+  globalDom.set_halos(h, h, h, h, 0, 0);
+  meta_data_t globalMetaData(globalDom.isize(), globalDom.jsize(), globalDom.ksize() + 1);
+  storage_t in(globalMetaData, "in"), out(globalMetaData, "out");
+  auto inView = make_host_view(in);
+  for(int i = 0; i < globalDom.isize(); ++i)
+    for(int j = 0; j < globalDom.jsize(); ++j)
+      for(int k = 0; k < globalDom.ksize() + 1; ++k)
+        inView(i, j, k) = value(i, j, k);
+  verifier(globalDom).fill(-1.0, out);
+
+  dawn_generated::cxxnaive::lap lapGlobal(globalDom);
+  lapGlobal.run(in, out);
+
+  // decomposed run, the halos between the subdomains are only filled by the exchange while the
+  // halos at the boundary of the global domain are the same as the ones of the single domain
+  domain dom(isize + 2 * h, jsize + 2 * h, ksize);
+  dom.set_halos(h, h, h, h, 0, 0);
+  meta_data_t metaData(dom.isize(), dom.jsize(), dom.ksize() + 1);
+  gridtools::dawn::thread_halo_exchange_world world(xcols, ycols);
+
+  std::vector<storage_t> ins, outs;
+  std::vector<std::unique_ptr<dawn_generated::cxxnaive::lap>> stencils;
+  for(int rank = 0; rank < world.size(); ++rank) {
+    const int iOffset = (rank % xcols) * isize, jOffset = (rank / xcols) * jsize;
+    ins.emplace_back(metaData, "in");
+    outs.emplace_back(metaData, "out");
+    auto view = make_host_view(ins.back());
+    for(int i = 0; i < dom.isize(); ++i)
+      for(int j = 0; j < dom.jsize(); ++j) {
+        const int gi = iOffset + i, gj = jOffset + j;
+        const bool isComputeDomain = i >= h && i < h + isize && j >= h && j < h + jsize;
+        const bool isGlobalHalo = gi < h || gi >= h + xcols * isize || gj < h ||
+                                  gj >= h + ycols * jsize;
+        for(int k = 0; k < dom.ksize() + 1; ++k)
+          view(i, j, k) = isComputeDomain || isGlobalHalo ? value(gi, gj, k) : -1.0;
+      }
+    verifier(dom).fill(-1.0, outs.back());
+
+    stencils.emplace_back(new dawn_generated::cxxnaive::lap(dom, rank, xcols, ycols));
+    stencils.back()->set_halo_exchange(&world.communicator(rank));
+  }
+
+  world.run([&](int rank, gridtools::dawn::halo_exchange&) {
+    stencils[rank]->run(ins[rank], outs[rank]);
+  });
+
+  auto outView = make_host_view(out);
+  for(int rank = 0; rank < world.size(); ++rank) {
+    const int iOffset = (rank % xcols) * isize, jOffset = (rank / xcols) * jsize;
+    auto view = make_host_view(outs[rank]);
+    for(int i = h; i < h + isize; ++i)
+      for(int j = h; j < h + jsize; ++j)
+        for(int k = 0; k < dom.ksize(); ++k)
+          ASSERT_NEAR(view(i, j, k), outView(iOffset + i, jOffset + j, k), 1e-10)
+              << "rank " << rank << " at (" << i << ", " << j << ", " << k << ")";
+  }
+}
@@ -25,6 +25,7 @@
 #define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
 
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/p_grad_c_c++-naive.cpp"
@@ -94,4 +95,8 @@ TEST(p_grad_c, test) {
   ASSERT_TRUE(verif.verify(uc_gt, uc_cxxnaive));
   ASSERT_TRUE(verif.verify(vc_gt, vc_cxxnaive));
   // }
+
+  benchmark(verif, OPTBACKEND_NAME, p_grad_c_gt, delpc, pkc, gz, uc_gt, vc_gt, rdxc, rdyc);
+  benchmark(verif, "cxxnaive", p_grad_c_cxxnaive, delpc, pkc, gz, uc_cxxnaive, vc_cxxnaive, rdxc,
+            rdyc);
 }
@@ -0,0 +1,163 @@
+"""
+Run the CodeGen test executables in benchmark mode and merge their results into a JSON report.
+
+Every executable times its optimized backend (gt or c++-opt) and the c++-naive reference, the
+naive timings of a test are kept only once. The report is sorted so that reports of different
+commits can be compared with a plain diff. An executable given as <executable>@i,j,k only runs on
+that domain size, which is used for code generated for a fixed domain size (-domain-size-*).
+
+With --perf-models, the run times predicted by the performance models written by gtclang
+(-write-perf-model) are added to the results of their stencils, scaled to the benchmarked domain.
+"""
+import argparse
+import json
+import math
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+
+
+def parse_size(size):
+    dims = [int(dim) for dim in size.split(",")]
+    if len(dims) != 3:
+        raise argparse.ArgumentTypeError("expected a size of the form i,j,k: " + size)
+    return dims
+
+
+def git_revision():
+    try:
+        return subprocess.check_output(
+            ["git", "rev-parse", "HEAD"],
+            cwd=os.path.dirname(os.path.abspath(__file__)),
+            stderr=subprocess.DEVNULL,
+            universal_newlines=True,
+        ).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def run_benchmark(executable, size, warmup, repetitions):
+    with tempfile.TemporaryDirectory() as tmpdir:
+        result_file = os.path.join(tmpdir, "results.json")
+        command = [executable] + [str(dim) for dim in size]
+        command += [
+            "--benchmark=" + result_file,
+            "--warmup={}".format(warmup),
+            "--repetitions={}".format(repetitions),
+        ]
+        print("RUN:", " ".join(command))
+        subprocess.check_call(command, stdout=subprocess.DEVNULL)
+        if not os.path.exists(result_file):
+            return []
+        with open(result_file) as f:
+            return [json.loads(line) for line in f if line.strip()]
+
+
+def points(domain):
+    return domain[0] * domain[1] * domain[2]
+
+
+def add_predictions(results, perf_model_dir):
+    """Add the predicted run time and the ratio of measured to predicted time to the results."""
+    models = {}
+    for result in results:
+        name = result["name"]
+        if name not in models:
+            path = os.path.join(perf_model_dir, name + ".perf.json")
+            models[name] = None
+            if os.path.exists(path):
+                with open(path) as f:
+                    models[name] = json.load(f)
+        model = models[name]
+        if model is None:
+            continue
+        scale = points(result["domain"]) / points(model["machine"]["domain_size"])
+        result["predicted_time"] = model["total"]["runtime"] * scale
+        result["memory_bound"] = model["total"]["memory_bound"]
+        if result["predicted_time"] > 0:
+            result["model_ratio"] = result["median_time"] / result["predicted_time"]
+
+
+def print_model_summary(results):
+    ratios = {}
+    for result in results:
+        if "model_ratio" in result:
+            ratios.setdefault(result["backend"], []).append(result["model_ratio"])
+    for backend, values in sorted(ratios.items()):
+        logs = [math.log(value) for value in values]
+        mean = sum(logs) / len(logs)
+        spread = math.sqrt(sum((log - mean) ** 2 for log in logs) / len(logs))
+        print(
+            "Measured / predicted time of {} ({} results): geometric mean {:.2f}, "
+            "geometric standard deviation {:.2f}".format(
+                backend, len(values), math.exp(mean), math.exp(spread)
+            )
+        )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "executables", nargs="+", help="CodeGen test executables, optionally as <executable>@i,j,k"
+    )
+    parser.add_argument(
+        "--sizes",
+        default="64,64,80",
+        help="Space separated domain sizes i,j,k (default: %(default)s)",
+    )
+    parser.add_argument("--warmup", type=int, default=3, help="Untimed runs per stencil")
+    parser.add_argument("--repetitions", type=int, default=10, help="Timed runs per stencil")
+    parser.add_argument("--output", default="codegen_benchmarks.json", help="JSON report")
+    parser.add_argument(
+        "--perf-models", help="Directory of the performance models (<stencil>.perf.json)"
+    )
+    args = parser.parse_args()
+
+    sizes = [parse_size(size) for size in args.sizes.split()]
+
+    results = {}
+    for executable in args.executables:
+        executable_sizes = sizes
+        if "@" in executable:
+            executable, size = executable.rsplit("@", 1)
+            executable_sizes = [parse_size(size)]
+        for size in executable_sizes:
+            for result in run_benchmark(executable, size, args.warmup, args.repetitions):
+                key = (result["test"], result["name"], result["backend"], tuple(result["domain"]))
+                results.setdefault(key, result)
+
+    if args.perf_models:
+        add_predictions(results.values(), args.perf_models)
+
+    report = {
+        "revision": git_revision(),
+        "host": platform.node(),
+        "warmup": args.warmup,
+        "repetitions": args.repetitions,
+        "results": [results[key] for key in sorted(results)],
+    }
+    with open(args.output, "w") as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+        f.write("\n")
+
+    for result in report["results"]:
+        print(
+            "{:<40} {:<10} {:>16} {:>12.3e} s {:>8.2f} GB/s {:>12.3e} points/s".format(
+                result["test"],
+                result["backend"],
+                "x".join(str(dim) for dim in result["domain"]),
+                result["median_time"],
+                result["bandwidth_gbs"],
+                result["points_per_second"],
+            )
+        )
+    if args.perf_models:
+        print_model_summary(report["results"])
+    print("Report written to", args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
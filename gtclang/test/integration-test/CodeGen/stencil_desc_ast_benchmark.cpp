@@ -26,6 +26,7 @@
 
 #include <gtest/gtest.h>
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/stencil_desc_ast_c++-naive.cpp"
@@ -248,6 +249,9 @@ TEST(stencil_desc_ast, test_01) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_01_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_01_naive, in, out_naive);
 }
 
 TEST(stencil_desc_ast, test_02) {
@@ -275,6 +279,9 @@ TEST(stencil_desc_ast, test_02) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_02_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_02_naive, in, out_naive);
 }
 
 TEST(stencil_desc_ast, test_03) {
@@ -302,6 +309,9 @@ TEST(stencil_desc_ast, test_03) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_03_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_03_naive, in, out_naive);
 }
 
 TEST(stencil_desc_ast, test_04) {
@@ -329,6 +339,9 @@ TEST(stencil_desc_ast, test_04) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_04_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_04_naive, in, out_naive);
 }
 
 TEST(stencil_desc_ast, test_05) {
@@ -356,6 +369,9 @@ TEST(stencil_desc_ast, test_05) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_05_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_05_naive, in, out_naive);
 }
 TEST(stencil_desc_ast, test_06) {
   domain dom(Options::getInstance().m_size[0], Options::getInstance().m_size[1],
@@ -381,6 +397,9 @@ TEST(stencil_desc_ast, test_06) {
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_06_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_06_naive, in, out_naive);
 }
 TEST(stencil_desc_ast, test_07) {
   domain dom(Options::getInstance().m_size[0], Options::getInstance().m_size[1],
@@ -406,6 +425,9 @@ TEST(stencil_desc_ast, test_07) {
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_07_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_07_naive, in, out_naive);
 }
 
 TEST(stencil_desc_ast, test_08) {
@@ -432,6 +454,9 @@ TEST(stencil_desc_ast, test_08) {
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_08_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_08_naive, in, out_naive);
 }
 
 TEST(stencil_desc_ast, test_09) {
@@ -458,4 +483,7 @@ TEST(stencil_desc_ast, test_09) {
 
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_09_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_09_naive, in, out_naive);
 }
@@ -26,6 +26,7 @@
 
 #include <gtest/gtest.h>
 #include "driver-includes/verify.hpp"
+#include "test/integration-test/CodeGen/Benchmark.hpp"
 #include "test/integration-test/CodeGen/Macros.hpp"
 #include "test/integration-test/CodeGen/Options.hpp"
 #include "test/integration-test/CodeGen/generated/stencil_functions_c++-naive.cpp"
@@ -139,6 +140,9 @@ TEST(stencil_functions, test_01) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_01_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_01_naive, in, out_naive);
 }
 
 TEST(stencil_functions, test_02) {
@@ -166,6 +170,9 @@ TEST(stencil_functions, test_02) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_02_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_02_naive, in, out_naive);
 }
 
 TEST(stencil_functions, test_03) {
@@ -193,6 +200,9 @@ TEST(stencil_functions, test_03) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_03_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_03_naive, in, out_naive);
 }
 
 TEST(stencil_functions, test_06) {
@@ -220,6 +230,9 @@ TEST(stencil_functions, test_06) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_06_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_06_naive, in, out_naive);
 }
 
 TEST(stencil_functions, test_07) {
@@ -247,4 +260,7 @@ TEST(stencil_functions, test_07) {
   ASSERT_TRUE(verif.verify(out_gt, out_naive));
 
   ASSERT_TRUE(verif.verify(out_naive, out_ref));
+
+  benchmark(verif, OPTBACKEND_NAME, test_07_gt, in, out_gt);
+  benchmark(verif, "cxxnaive", test_07_naive, in, out_naive);
 }
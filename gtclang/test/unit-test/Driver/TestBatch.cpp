@@ -0,0 +1,124 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/UIDGenerator.h"
+#include "gtclang/Driver/Driver.h"
+#include "gtclang/Unittest/GTClang.h"
+#include "gtclang/Unittest/UnittestEnvironment.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gtclang;
+
+namespace {
+
+using Arguments = std::vector<std::string>;
+
+TEST(BatchTest, SplitLine) {
+  EXPECT_EQ(splitBatchLine("lap.cpp -backend=c++-opt -o lap_cxxopt.cpp"),
+            (Arguments{"lap.cpp", "-backend=c++-opt", "-o", "lap_cxxopt.cpp"}));
+
+  // Whitespace (including a carriage return of Windows line endings) only separates arguments
+  EXPECT_EQ(splitBatchLine("  lap.cpp \t -fno-pch\r"), (Arguments{"lap.cpp", "-fno-pch"}));
+}
+
+TEST(BatchTest, SplitLineQuotes) {
+  EXPECT_EQ(splitBatchLine("\"my dir/lap.cpp\" -o \"out dir/lap.cpp\""),
+            (Arguments{"my dir/lap.cpp", "-o", "out dir/lap.cpp"}));
+
+  // Quotes group the enclosed whitespace only and may start within an argument
+  EXPECT_EQ(splitBatchLine("-I\"/path with spaces\"/include"),
+            (Arguments{"-I/path with spaces/include"}));
+
+  // An empty pair of quotes is an empty argument
+  EXPECT_EQ(splitBatchLine("-o \"\" lap.cpp"), (Arguments{"-o", "", "lap.cpp"}));
+}
+
+TEST(BatchTest, SplitLineEscapes) {
+  EXPECT_EQ(splitBatchLine("my\\ dir/lap.cpp"), (Arguments{"my dir/lap.cpp"}));
+  EXPECT_EQ(splitBatchLine("-DNAME=\\\"lap\\\""), (Arguments{"-DNAME=\"lap\""}));
+  EXPECT_EQ(splitBatchLine("C:\\\\lap.cpp"), (Arguments{"C:\\lap.cpp"}));
+
+  // Escaped quotes within quotes
+  EXPECT_EQ(splitBatchLine("\"a \\\"b\\\" c\""), (Arguments{"a \"b\" c"}));
+
+  // A trailing backslash is kept
+  EXPECT_EQ(splitBatchLine("lap.cpp\\"), (Arguments{"lap.cpp\\"}));
+}
+
+TEST(BatchTest, SplitLineEmptyAndComments) {
+  EXPECT_TRUE(splitBatchLine("").empty());
+  EXPECT_TRUE(splitBatchLine(" \t\r").empty());
+  EXPECT_TRUE(splitBatchLine("# lap.cpp -backend=c++-opt").empty());
+  EXPECT_TRUE(splitBatchLine("   #lap.cpp").empty());
+
+  // Only a leading '#' starts a comment
+  EXPECT_EQ(splitBatchLine("lap.cpp -DX=#1"), (Arguments{"lap.cpp", "-DX=#1"}));
+}
+
+std::string readFile(const std::string& filename) {
+  std::ifstream file(filename);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+TEST(BatchTest, ConcurrentJobsMatchSerialInvocations) {
+  auto flags = UnittestEnvironment::getSingleton().getFlagManager().getDefaultFlags();
+
+  const std::vector<std::pair<std::string, std::string>> invocations = {
+      {"input/batch_copy.cpp", "c++-naive"},      {"input/batch_copy.cpp", "c++-opt"},
+      {"input/batch_copy.cpp", "gridtools"},      {"input/batch_laplacian.cpp", "c++-naive"},
+      {"input/batch_laplacian.cpp", "c++-opt"},   {"input/batch_laplacian.cpp", "gridtools"}};
+
+  // Compile every invocation on its own and list it in the batch file
+  const std::string batchFilename = "batch_jobs.txt";
+  std::ofstream batchFile(batchFilename);
+  batchFile << "# invocations of BatchTest.ConcurrentJobsMatchSerialInvocations\n\n";
+  for(std::size_t i = 0; i < invocations.size(); ++i) {
+    const auto& [sourceFile, backend] = invocations[i];
+    const std::string serialFile = "batch_serial_" + std::to_string(i) + ".cpp";
+    const std::string jobFile = "batch_jobs_" + std::to_string(i) + ".cpp";
+    std::remove(jobFile.c_str());
+
+    dawn::UIDGenerator::getInstance()->reset();
+    auto [passed, SIR] = GTClang::run(
+        {sourceFile, "-backend=" + backend, "-fno-clang-format", "-o", serialFile}, flags);
+    ASSERT_TRUE(passed) << sourceFile << " (" << backend << ")";
+
+    batchFile << sourceFile << " -backend=" << backend << " -fno-clang-format -o " << jobFile;
+    for(const auto& flag : flags)
+      batchFile << " \"" << flag << "\"";
+    batchFile << "\n";
+  }
+  batchFile.close();
+
+  dawn::UIDGenerator::getInstance()->reset();
+  auto [passed, SIR] = GTClang::run({"-batch=" + batchFilename, "-jobs=4"}, {});
+  ASSERT_TRUE(passed);
+
+  for(std::size_t i = 0; i < invocations.size(); ++i) {
+    const std::string serialCode = readFile("batch_serial_" + std::to_string(i) + ".cpp");
+    const std::string batchCode = readFile("batch_jobs_" + std::to_string(i) + ".cpp");
+    EXPECT_FALSE(serialCode.empty());
+    EXPECT_EQ(serialCode, batchCode)
+        << invocations[i].first << " (" << invocations[i].second << ")";
+  }
+}
+
+} // anonymous namespace
@@ -0,0 +1,137 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/UIDGenerator.h"
+#include "gtclang/Driver/PrecompiledHeader.h"
+#include "gtclang/Unittest/Config.h"
+#include "gtclang/Unittest/GTClang.h"
+#include "gtclang/Unittest/UnittestEnvironment.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gtclang;
+
+namespace {
+
+class PrecompiledHeaderTest : public ::testing::Test {
+protected:
+  llvm::SmallString<256> cacheDir_;
+  std::vector<std::string> flags_;
+
+  void SetUp() override {
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("gtclang-pch-test", cacheDir_));
+    flags_ = UnittestEnvironment::getSingleton().getFlagManager().getDefaultFlags();
+  }
+
+  void TearDown() override { llvm::sys::fs::remove_directories(cacheDir_); }
+
+  std::string getPCH(llvm::StringRef cacheDir, const std::vector<std::string>& extraFlags = {}) {
+    std::vector<const char*> clangOptions;
+    for(const auto& flag : flags_)
+      clangOptions.push_back(flag.c_str());
+    for(const auto& flag : extraFlags)
+      clangOptions.push_back(flag.c_str());
+    return getPrecompiledDSLHeader(GTCLANG_EXECUTABLE, clangOptions, cacheDir);
+  }
+
+  static std::string readFile(const std::string& filename) {
+    std::ifstream file(filename);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+  }
+};
+
+TEST_F(PrecompiledHeaderTest, GenerateAndReuse) {
+  const std::string PCHFile = getPCH(cacheDir_);
+  ASSERT_FALSE(PCHFile.empty());
+  EXPECT_EQ(llvm::sys::path::parent_path(PCHFile), cacheDir_.str());
+  ASSERT_TRUE(llvm::sys::fs::exists(PCHFile));
+
+  llvm::sys::fs::file_status status;
+  ASSERT_FALSE(llvm::sys::fs::status(PCHFile, status));
+
+  // The second lookup uses the cached header
+  EXPECT_EQ(getPCH(cacheDir_), PCHFile);
+  llvm::sys::fs::file_status cachedStatus;
+  ASSERT_FALSE(llvm::sys::fs::status(PCHFile, cachedStatus));
+  EXPECT_EQ(status.getLastModificationTime(), cachedStatus.getLastModificationTime());
+
+  // Other clang options need another precompiled header
+  const std::string otherPCHFile = getPCH(cacheDir_, {"-DGTCLANG_PCH_TEST"});
+  ASSERT_FALSE(otherPCHFile.empty());
+  EXPECT_NE(otherPCHFile, PCHFile);
+}
+
+TEST_F(PrecompiledHeaderTest, CreatePrivateCacheDir) {
+  llvm::SmallString<256> cacheDir(cacheDir_);
+  llvm::sys::path::append(cacheDir, "gtclang", "pch");
+  ASSERT_FALSE(getPCH(cacheDir).empty());
+
+  auto permissions = llvm::sys::fs::getPermissions(cacheDir);
+  ASSERT_TRUE(bool(permissions));
+  EXPECT_EQ(*permissions & llvm::sys::fs::all_all, llvm::sys::fs::owner_all);
+}
+
+TEST_F(PrecompiledHeaderTest, RejectSharedCacheDir) {
+  // Anyone could place a precompiled header into a directory writable by others
+  ASSERT_FALSE(llvm::sys::fs::setPermissions(cacheDir_, llvm::sys::fs::all_all));
+  EXPECT_TRUE(getPCH(cacheDir_).empty());
+
+  ASSERT_FALSE(llvm::sys::fs::setPermissions(cacheDir_, llvm::sys::fs::owner_all |
+                                                            llvm::sys::fs::group_read |
+                                                            llvm::sys::fs::group_write));
+  EXPECT_TRUE(getPCH(cacheDir_).empty());
+
+  std::error_code ec;
+  llvm::sys::fs::directory_iterator it(cacheDir_, ec), end;
+  EXPECT_TRUE(it == end) << "no precompiled header may be written to a shared directory";
+}
+
+TEST_F(PrecompiledHeaderTest, SameCodeWithoutPCH) {
+  const std::string sourceFile = "input/batch_laplacian.cpp";
+  for(const std::string backend : {"c++-naive", "c++-opt"}) {
+    dawn::UIDGenerator::getInstance()->reset();
+    auto [passedPCH, SIRPCH] =
+        GTClang::run({sourceFile, "-backend=" + backend, "-fno-clang-format", "-fpch",
+                      "-pch-cache-dir=" + std::string(cacheDir_.str()), "-o", "pch_gen.cpp"},
+                     flags_);
+    ASSERT_TRUE(passedPCH) << backend;
+
+    dawn::UIDGenerator::getInstance()->reset();
+    auto [passed, SIR] = GTClang::run({sourceFile, "-backend=" + backend, "-fno-clang-format",
+                                       "-fno-pch", "-o", "no_pch_gen.cpp"},
+                                      flags_);
+    ASSERT_TRUE(passed) << backend;
+
+    const std::string code = readFile("no_pch_gen.cpp");
+    EXPECT_FALSE(code.empty()) << backend;
+    EXPECT_EQ(readFile("pch_gen.cpp"), code) << backend;
+  }
+
+  // The precompiled header was generated once and reused
+  std::error_code ec;
+  int numFiles = 0;
+  for(llvm::sys::fs::directory_iterator it(cacheDir_, ec), end; it != end && !ec; it.increment(ec))
+    ++numFiles;
+  EXPECT_EQ(numFiles, 1);
+}
+
+} // anonymous namespace
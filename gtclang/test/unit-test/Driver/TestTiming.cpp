@@ -0,0 +1,113 @@
+//===--------------------------------------------------------------------------------*- C++ -*-===//
+//                         _       _
+//                        | |     | |
+//                    __ _| |_ ___| | __ _ _ __   __ _
+//                   / _` | __/ __| |/ _` | '_ \ / _` |
+//                  | (_| | || (__| | (_| | | | | (_| |
+//                   \__, |\__\___|_|\__,_|_| |_|\__, | - GridTools Clang DSL
+//                    __/ |                       __/ |
+//                   |___/                       |___/
+//
+//
+//  This file is distributed under the MIT License (MIT).
+//  See LICENSE.txt for details.
+//
+//===------------------------------------------------------------------------------------------===//
+
+#include "dawn/Support/UIDGenerator.h"
+#include "gtclang/Frontend/GTClangContext.h"
+#include "gtclang/Unittest/GTClang.h"
+#include "gtclang/Unittest/UnittestEnvironment.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <gtest/gtest.h>
+
+using namespace gtclang;
+
+namespace {
+
+TEST(TimingTest, AccumulatePhases) {
+  GTClangContext context;
+  context.getOptions().ReportTiming = true;
+
+  context.startTimer("parsing");
+  context.stopTimer("parsing");
+  context.startTimer("code generation");
+  context.stopTimer("code generation");
+  context.startTimer("parsing");
+  context.stopTimer("parsing");
+
+  // Stopping a timer which is not running has no effect
+  context.stopTimer("preprocessing");
+
+  const auto& timings = context.getTimings();
+  ASSERT_EQ(timings.size(), 2u);
+  EXPECT_EQ(timings[0].first, "parsing");
+  EXPECT_EQ(timings[1].first, "code generation");
+  EXPECT_GE(timings[0].second, 0.0);
+  EXPECT_GE(timings[1].second, 0.0);
+
+  std::string report;
+  llvm::raw_string_ostream os(report);
+  context.printTimingReport(os, "lap.cpp");
+  os.flush();
+  EXPECT_NE(report.find("gtclang timing report: lap.cpp"), std::string::npos);
+  EXPECT_NE(report.find("parsing"), std::string::npos);
+  EXPECT_NE(report.find("code generation"), std::string::npos);
+  EXPECT_NE(report.find("total"), std::string::npos);
+  EXPECT_EQ(report.find("preprocessing"), std::string::npos);
+}
+
+TEST(TimingTest, DisabledByDefault) {
+  GTClangContext context;
+  context.startTimer("parsing");
+  context.stopTimer("parsing");
+  EXPECT_TRUE(context.getTimings().empty());
+
+  std::string report;
+  llvm::raw_string_ostream os(report);
+  context.printTimingReport(os, "lap.cpp");
+  EXPECT_TRUE(os.str().empty());
+}
+
+/// @brief Compile `input/batch_laplacian.cpp` and return what gtclang printed to stderr
+std::string compileCaptureStderr(const std::vector<std::string>& gtclangFlags) {
+  auto flags = UnittestEnvironment::getSingleton().getFlagManager().getDefaultFlags();
+  std::vector<std::string> args = {"input/batch_laplacian.cpp", "-backend=c++-naive",
+                                   "-fno-clang-format", "-o", "timing_gen.cpp"};
+  args.insert(args.end(), gtclangFlags.begin(), gtclangFlags.end());
+
+  dawn::UIDGenerator::getInstance()->reset();
+  testing::internal::CaptureStderr();
+  auto [passed, SIR] = GTClang::run(args, flags);
+  std::string output = testing::internal::GetCapturedStderr();
+  EXPECT_TRUE(passed) << output;
+  return output;
+}
+
+TEST(TimingTest, ReportCompilationPhases) {
+  llvm::SmallString<256> cacheDir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("gtclang-timing-test", cacheDir));
+
+  std::string output =
+      compileCaptureStderr({"-report-timing", "-pch-cache-dir=" + std::string(cacheDir.str())});
+  EXPECT_NE(output.find("gtclang timing report: input/batch_laplacian.cpp"), std::string::npos)
+      << output;
+  for(const char* phase : {"precompiled DSL header", "preprocessing", "parsing",
+                           "SIR generation, optimization and code generation", "total"})
+    EXPECT_NE(output.find(phase), std::string::npos) << phase << " missing in:\n" << output;
+
+  // Without precompiled header there is no such phase
+  output = compileCaptureStderr({"-report-timing", "-fno-pch"});
+  EXPECT_NE(output.find("gtclang timing report"), std::string::npos) << output;
+  EXPECT_EQ(output.find("precompiled DSL header"), std::string::npos) << output;
+
+  // No report unless requested
+  output = compileCaptureStderr({"-fno-pch"});
+  EXPECT_EQ(output.find("gtclang timing report"), std::string::npos) << output;
+
+  llvm::sys::fs::remove_directories(cacheDir);
+}
+
+} // anonymous namespace
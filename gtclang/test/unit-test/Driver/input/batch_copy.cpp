@@ -0,0 +1,9 @@
+#include "gtclang_dsl_defs/gtclang_dsl.hpp"
+using namespace gtclang::dsl;
+
+stencil batch_copy {
+  storage in, out;
+  void Do() {
+    vertical_region(k_start, k_end) { out = in; }
+  }
+};
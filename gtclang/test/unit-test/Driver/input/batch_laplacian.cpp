@@ -0,0 +1,13 @@
+#include "gtclang_dsl_defs/gtclang_dsl.hpp"
+using namespace gtclang::dsl;
+
+stencil batch_laplacian {
+  storage in, out;
+  var tmp;
+  void Do() {
+    vertical_region(k_start, k_end) {
+      tmp = in[i + 1] + in[i - 1] + in[j + 1] + in[j - 1] - 4.0 * in;
+      out = tmp[i + 1] + tmp[i - 1] + tmp[j + 1] + tmp[j - 1] - 4.0 * tmp;
+    }
+  }
+};